@@ -0,0 +1,635 @@
+/**
+@file	 AsyncAudioAdaptiveJitterBuffer.cpp
+@brief   A jitter buffer for encoded audio frames with adaptive delay
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/time.h>
+#include <cmath>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+#include <AsyncMetrics.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioDecoder.h"
+#include "AsyncAudioAdaptiveJitterBuffer.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+namespace {
+  struct JitterBufferMetrics
+  {
+    Metrics::Counter& late;
+    Metrics::Counter& concealed;
+    Metrics::Counter& underruns;
+  };
+
+  JitterBufferMetrics& jitterBufferMetrics(void)
+  {
+    auto& m = Metrics::instance();
+    static JitterBufferMetrics metrics {
+      m.counter("async_jitter_buffer_late_frames_total",
+                "Number of audio frames arriving after their playout time"),
+      m.counter("async_jitter_buffer_concealed_frames_total",
+                "Number of lost audio frames concealed by the decoder"),
+      m.counter("async_jitter_buffer_underruns_total",
+                "Number of times a jitter buffer ran dry during a spurt")
+    };
+    return metrics;
+  }
+};
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioAdaptiveJitterBuffer::AudioAdaptiveJitterBuffer(void)
+  : m_playout_timer(PLAYOUT_INTERVAL, Timer::TYPE_PERIODIC, false),
+    m_frame_samples(DEFAULT_FRAME_TIME * INTERNAL_SAMPLE_RATE / 1000)
+{
+  m_playout_timer.expired.connect(
+      sigc::mem_fun(*this, &AudioAdaptiveJitterBuffer::playout));
+} /* AudioAdaptiveJitterBuffer::AudioAdaptiveJitterBuffer */
+
+
+AudioAdaptiveJitterBuffer::~AudioAdaptiveJitterBuffer(void)
+{
+} /* AudioAdaptiveJitterBuffer::~AudioAdaptiveJitterBuffer */
+
+
+void AudioAdaptiveJitterBuffer::setDecoder(AudioDecoder *dec)
+{
+  reset();
+  m_dec = dec;
+} /* AudioAdaptiveJitterBuffer::setDecoder */
+
+
+void AudioAdaptiveJitterBuffer::setDelayRange(unsigned min_delay,
+                                              unsigned max_delay)
+{
+  m_min_delay = min_delay;
+  m_max_delay = max(min_delay, max_delay);
+  m_target_delay = min(max(m_target_delay, m_min_delay), m_max_delay);
+  m_stats.delay = m_target_delay;
+} /* AudioAdaptiveJitterBuffer::setDelayRange */
+
+
+void AudioAdaptiveJitterBuffer::writeFrame(uint64_t seq, const void *buf,
+                                           int size)
+{
+  if ((m_dec == 0) || (size <= 0))
+  {
+    return;
+  }
+
+  if (seq < m_next_seq)
+  {
+      // The playout have already passed this frame. If it was concealed, it
+      // was late rather than lost. Otherwise it is a duplicate.
+    auto it = m_missed.find(seq);
+    if (it != m_missed.end())
+    {
+      m_missed.erase(it);
+      if (m_stats.lost > 0)
+      {
+        m_stats.lost -= 1;
+      }
+      m_stats.late += 1;
+      jitterBufferMetrics().late.inc();
+      m_spurt_late += 1;
+    }
+    return;
+  }
+
+  if ((m_frames.count(seq) > 0) || (m_frames.size() >= MAX_FRAMES))
+  {
+    return;
+  }
+
+  Frame& frame = m_frames[seq];
+  frame.type = FRAME_AUDIO;
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(buf);
+  frame.data.assign(data, data + size);
+  m_stats.received += 1;
+
+  if (m_state == STATE_IDLE)
+  {
+    startSpurt();
+  }
+  else
+  {
+    if (m_buffer_start < 0)
+    {
+      m_buffer_start = now();
+    }
+    m_playout_timer.setEnable(true);
+  }
+  updateJitter(seq);
+} /* AudioAdaptiveJitterBuffer::writeFrame */
+
+
+void AudioAdaptiveJitterBuffer::skipSequence(uint64_t seq)
+{
+  addNonAudioSeq(seq);
+  if (seq < m_next_seq)
+  {
+    return;
+  }
+  if (m_state == STATE_IDLE)
+  {
+    m_next_seq = seq + 1;
+  }
+  else if (m_frames.count(seq) == 0)
+  {
+    m_frames[seq].type = FRAME_SKIP;
+    m_playout_timer.setEnable(true);
+  }
+} /* AudioAdaptiveJitterBuffer::skipSequence */
+
+
+void AudioAdaptiveJitterBuffer::flushAt(uint64_t seq)
+{
+  addNonAudioSeq(seq);
+  if (seq < m_next_seq)
+  {
+      // The playout have concealed past the flush so it arrived late
+    if (m_state != STATE_IDLE)
+    {
+      flush();
+    }
+    return;
+  }
+  if (m_state == STATE_IDLE)
+  {
+    m_next_seq = seq + 1;
+    if (m_dec != 0)
+    {
+      m_dec->flushEncodedSamples();
+    }
+  }
+  else
+  {
+    m_frames[seq].type = FRAME_FLUSH;
+    if (m_buffer_start < 0)
+    {
+      m_buffer_start = now();
+    }
+    m_playout_timer.setEnable(true);
+  }
+} /* AudioAdaptiveJitterBuffer::flushAt */
+
+
+void AudioAdaptiveJitterBuffer::flush(void)
+{
+  if (m_state == STATE_IDLE)
+  {
+    if (m_dec != 0)
+    {
+      m_dec->flushEncodedSamples();
+    }
+  }
+  else
+  {
+    m_flushing = true;
+    if (m_frames.empty())
+    {
+      endSpurt();
+    }
+  }
+} /* AudioAdaptiveJitterBuffer::flush */
+
+
+void AudioAdaptiveJitterBuffer::reset(void)
+{
+  bool was_active = (m_state != STATE_IDLE);
+  m_playout_timer.setEnable(false);
+  m_frames.clear();
+  m_missed.clear();
+  m_non_audio.clear();
+  m_state = STATE_IDLE;
+  m_next_seq = 0;
+  m_buffer_start = -1;
+  m_flushing = false;
+  m_conceal_cnt = 0;
+  m_have_prev = false;
+  if (was_active && (m_dec != 0))
+  {
+    m_dec->flushEncodedSamples();
+  }
+} /* AudioAdaptiveJitterBuffer::reset */
+
+
+void AudioAdaptiveJitterBuffer::resetStats(void)
+{
+  m_stats = Stats();
+  m_stats.delay = m_target_delay;
+  m_stats.jitter = m_jitter;
+} /* AudioAdaptiveJitterBuffer::resetStats */
+
+
+int AudioAdaptiveJitterBuffer::writeSamples(const float *samples, int count)
+{
+  m_played_samples += count;
+  return sinkWriteSamples(samples, count);
+} /* AudioAdaptiveJitterBuffer::writeSamples */
+
+
+void AudioAdaptiveJitterBuffer::flushSamples(void)
+{
+  sinkFlushSamples();
+} /* AudioAdaptiveJitterBuffer::flushSamples */
+
+
+void AudioAdaptiveJitterBuffer::resumeOutput(void)
+{
+  sourceResumeOutput();
+} /* AudioAdaptiveJitterBuffer::resumeOutput */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+void AudioAdaptiveJitterBuffer::allSamplesFlushed(void)
+{
+  sourceAllSamplesFlushed();
+} /* AudioAdaptiveJitterBuffer::allSamplesFlushed */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+int64_t AudioAdaptiveJitterBuffer::now(void) const
+{
+  struct timespec ts;
+  Application::app().getMonotonicTime(&ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+} /* AudioAdaptiveJitterBuffer::now */
+
+
+unsigned AudioAdaptiveJitterBuffer::frameTime(void) const
+{
+  return m_frame_samples * 1000 / INTERNAL_SAMPLE_RATE;
+} /* AudioAdaptiveJitterBuffer::frameTime */
+
+
+void AudioAdaptiveJitterBuffer::startSpurt(void)
+{
+    // The delay may grow as much as needed but only shrink by one frame
+    // per talk spurt so that a single calm spurt does not undo the
+    // adaptation to a jittery connection
+  unsigned frame_time = frameTime();
+  unsigned delay = frame_time + lround(JITTER_FACTOR * m_jitter);
+  if (m_spurt_late > 0)
+  {
+    delay = max(delay, m_target_delay + frame_time);
+  }
+  if (delay < m_target_delay)
+  {
+    delay = max(delay, m_target_delay - min(m_target_delay, frame_time));
+  }
+  m_target_delay = min(max(delay, m_min_delay), m_max_delay);
+  m_stats.delay = m_target_delay;
+  m_spurt_late = 0;
+
+  m_state = STATE_BUFFERING;
+  m_buffer_start = now();
+  m_have_prev = false;
+  m_flushing = false;
+  m_conceal_cnt = 0;
+  m_playout_timer.setEnable(true);
+} /* AudioAdaptiveJitterBuffer::startSpurt */
+
+
+void AudioAdaptiveJitterBuffer::endSpurt(void)
+{
+  m_playout_timer.setEnable(false);
+  m_state = STATE_IDLE;
+  m_buffer_start = -1;
+  m_flushing = false;
+  if (m_dec != 0)
+  {
+    m_dec->flushEncodedSamples();
+  }
+  m_stats.jitter = m_jitter;
+  talkSpurtEnded(m_stats);
+
+    // Frames from the next talk spurt may already have arrived
+  if ((m_state == STATE_IDLE) && !m_frames.empty())
+  {
+    startSpurt();
+  }
+} /* AudioAdaptiveJitterBuffer::endSpurt */
+
+
+void AudioAdaptiveJitterBuffer::playout(Timer *t)
+{
+  if (m_state == STATE_BUFFERING)
+  {
+    if (m_frames.empty())
+    {
+      if (m_flushing)
+      {
+        endSpurt();
+      }
+      else
+      {
+          // Nothing to do until a frame arrive so the timer is restarted
+          // when the next frame is written
+        m_playout_timer.setEnable(false);
+      }
+      return;
+    }
+    int64_t t_now = now();
+    if ((m_buffer_start < 0) || (t_now - m_buffer_start < m_target_delay))
+    {
+      return;
+    }
+    if (m_frames.begin()->first > m_next_seq)
+    {
+        // Nothing before the first buffered frame can be told apart from
+        // silence between talk spurts so start playing from there
+      if (m_conceal_cnt == 0)
+      {
+        m_next_seq = m_frames.begin()->first;
+      }
+    }
+    m_state = STATE_PLAYING;
+    m_play_start = t_now;
+    m_played_samples = 0;
+  }
+
+    // Keep one frame ahead of the playout clock so that the sink always
+    // has audio to play
+  while (m_state == STATE_PLAYING)
+  {
+    int64_t ahead = now() - m_play_start + frameTime();
+    if (static_cast<int64_t>(m_played_samples) * 1000 >=
+        ahead * INTERNAL_SAMPLE_RATE)
+    {
+      break;
+    }
+    if (!playNextFrame())
+    {
+      break;
+    }
+  }
+} /* AudioAdaptiveJitterBuffer::playout */
+
+
+bool AudioAdaptiveJitterBuffer::playNextFrame(void)
+{
+  while (!m_frames.empty() && (m_frames.begin()->first == m_next_seq))
+  {
+    auto it = m_frames.begin();
+    FrameType type = it->second.type;
+    std::vector<uint8_t> data;
+    data.swap(it->second.data);
+    m_frames.erase(it);
+    m_next_seq += 1;
+
+    if (type == FRAME_AUDIO)
+    {
+      uint64_t played = m_played_samples;
+      m_dec->writeEncodedSamples(data.data(), data.size());
+      if (m_played_samples > played)
+      {
+        m_frame_samples = m_played_samples - played;
+      }
+      m_conceal_cnt = 0;
+      return true;
+    }
+    else if (type == FRAME_FLUSH)
+    {
+      endSpurt();
+      return false;
+    }
+  }
+
+  if (m_frames.empty() && m_flushing)
+  {
+    endSpurt();
+    return false;
+  }
+
+  if (m_conceal_cnt * frameTime() >= MAX_CONCEAL_TIME)
+  {
+    if (m_frames.empty())
+    {
+        // The buffer ran dry. Stop playing and wait for more frames so that
+        // the playout delay is rebuilt before playing again.
+      m_stats.underruns += 1;
+      jitterBufferMetrics().underruns.inc();
+      m_state = STATE_BUFFERING;
+      m_buffer_start = -1;
+      return false;
+    }
+
+      // Too many frames missing in a row to conceal. Skip ahead to the
+      // next buffered frame.
+    uint64_t first = m_frames.begin()->first;
+    addMissed(m_next_seq, first);
+    m_next_seq = first;
+    m_conceal_cnt = 0;
+    return true;
+  }
+
+  concealFrame();
+  return true;
+} /* AudioAdaptiveJitterBuffer::playNextFrame */
+
+
+void AudioAdaptiveJitterBuffer::concealFrame(void)
+{
+  const void *next_buf = 0;
+  int next_size = 0;
+  auto next = m_frames.find(m_next_seq + 1);
+  if ((next != m_frames.end()) && (next->second.type == FRAME_AUDIO))
+  {
+    next_buf = next->second.data.data();
+    next_size = next->second.data.size();
+  }
+  if (m_dec->concealLostFrame(next_buf, next_size))
+  {
+    m_stats.concealed += 1;
+    jitterBufferMetrics().concealed.inc();
+  }
+  else
+  {
+    std::vector<float> silence(m_frame_samples, 0.0f);
+    writeSamples(silence.data(), silence.size());
+  }
+
+  addMissed(m_next_seq, m_next_seq + 1);
+  m_next_seq += 1;
+  m_conceal_cnt += 1;
+} /* AudioAdaptiveJitterBuffer::concealFrame */
+
+
+void AudioAdaptiveJitterBuffer::addMissed(uint64_t begin, uint64_t end)
+{
+    // Only the last MAX_FRAMES sequence numbers are remembered since frames
+    // older than that would not fit in the buffer anyway
+  m_stats.lost += static_cast<unsigned>(end - begin);
+  for (uint64_t seq=max(begin, end - min(end, uint64_t(MAX_FRAMES)));
+       seq<end; ++seq)
+  {
+    m_missed.insert(seq);
+  }
+  while (!m_missed.empty() && (*m_missed.begin() + MAX_FRAMES < end))
+  {
+    m_missed.erase(m_missed.begin());
+  }
+} /* AudioAdaptiveJitterBuffer::addMissed */
+
+
+void AudioAdaptiveJitterBuffer::addNonAudioSeq(uint64_t seq)
+{
+  m_non_audio.insert(seq);
+  while (m_non_audio.size() > MAX_FRAMES)
+  {
+    m_non_audio.erase(m_non_audio.begin());
+  }
+} /* AudioAdaptiveJitterBuffer::addNonAudioSeq */
+
+
+void AudioAdaptiveJitterBuffer::updateJitter(uint64_t seq)
+{
+    // Inter-arrival jitter estimate as described in RFC 3550. There is no
+    // media timestamp so the difference in send time between two frames is
+    // taken to be the number of audio frames between them times the frame
+    // length. Sequence numbers used for other messages are not counted.
+  int64_t t_now = now();
+  if (m_have_prev)
+  {
+    uint64_t lo = min(seq, m_prev_seq);
+    uint64_t hi = max(seq, m_prev_seq);
+    uint64_t frames = hi - lo;
+    for (auto it = m_non_audio.upper_bound(lo);
+         (it != m_non_audio.end()) && (*it < hi); ++it)
+    {
+      frames -= 1;
+    }
+    double send_diff = static_cast<double>(frames) * m_frame_samples *
+                       1000 / INTERNAL_SAMPLE_RATE;
+    if (seq < m_prev_seq)
+    {
+      send_diff = -send_diff;
+    }
+    double d = fabs((t_now - m_prev_arrival) - send_diff);
+    m_jitter += (d - m_jitter) / 16.0;
+  }
+  m_prev_seq = seq;
+  m_prev_arrival = t_now;
+  m_have_prev = true;
+} /* AudioAdaptiveJitterBuffer::updateJitter */
+
+
+
+/*
+ * This file has not been truncated
+ */
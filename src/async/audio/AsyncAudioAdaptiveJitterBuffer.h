@@ -0,0 +1,339 @@
+/**
+@file	 AsyncAudioAdaptiveJitterBuffer.h
+@brief   A jitter buffer for encoded audio frames with adaptive delay
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef ASYNC_AUDIO_ADAPTIVE_JITTER_BUFFER_INCLUDED
+#define ASYNC_AUDIO_ADAPTIVE_JITTER_BUFFER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+#include <AsyncAudioSink.h>
+#include <AsyncAudioSource.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class AudioDecoder;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A jitter buffer for encoded audio frames with adaptive delay
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class buffer encoded audio frames, tagged with a sequence number, before
+they are handed over to an audio decoder. Frames that arrive out of order are
+put back in order. The frames are played out at the pace given by the number
+of samples each frame decode to, after an initial playout delay.
+
+The inter-arrival jitter is estimated from the arrival times and sequence
+numbers of the frames in the same way as described in RFC 3550. Sequence
+numbers given to skipSequence and flushAt are not counted as audio frames.
+Arrival times are measured using the monotonic clock. At the start of each
+talk spurt the playout delay is set to a number of times the estimated
+jitter, limited to the range set using setDelayRange. The delay grows
+directly but shrink by at most one frame per talk spurt. The delay is not
+changed within a talk spurt.
+
+A frame that has not arrived when it is time to play it is concealed by the
+decoder, see AudioDecoder::concealLostFrame. If the frame arrive later it is
+thrown away and counted as late.
+
+The decoder should be connected to this object, which is both an audio sink
+and an audio source. The decoded audio is passed through unchanged. Since the
+playout is timer driven, the sink connected to this object should accept all
+samples, e.g. an Async::AudioFifo.
+*/
+class AudioAdaptiveJitterBuffer : public AudioSink, public AudioSource,
+                                  public sigc::trackable
+{
+  public:
+    /**
+     * @brief Statistics for the jitter buffer
+     */
+    struct Stats
+    {
+      unsigned  delay       = 0;  ///< Current playout delay in milliseconds
+      float     jitter      = 0;  ///< Estimated jitter in milliseconds
+      unsigned  received    = 0;  ///< Number of audio frames received
+      unsigned  late        = 0;  ///< Frames arriving after their playout
+      unsigned  lost        = 0;  ///< Frames that never arrived
+      unsigned  concealed   = 0;  ///< Frames concealed by the decoder
+      unsigned  underruns   = 0;  ///< Times the buffer ran dry in a spurt
+    };
+
+    /**
+     * @brief 	Default constuctor
+     */
+    AudioAdaptiveJitterBuffer(void);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioAdaptiveJitterBuffer(void);
+
+    /**
+     * @brief   Set the decoder to feed the encoded frames into
+     * @param   dec The decoder
+     *
+     * The decoder output should be connected to this object by the caller.
+     * Any buffered frames are thrown away.
+     */
+    void setDecoder(AudioDecoder *dec);
+
+    /**
+     * @brief   Set the range within which the playout delay may vary
+     * @param   min_delay The minimum delay in milliseconds
+     * @param   max_delay The maximum delay in milliseconds
+     */
+    void setDelayRange(unsigned min_delay, unsigned max_delay);
+
+    /**
+     * @brief   Write an encoded frame into the buffer
+     * @param   seq The sequence number of the frame
+     * @param   buf The encoded frame
+     * @param   size The size of the encoded frame
+     *
+     * Sequence numbers must increase by one for each frame sent. If the
+     * transport use the same sequence number space for other messages, those
+     * sequence numbers should be given to the skipSequence function so that
+     * they are not seen as lost frames.
+     */
+    void writeFrame(uint64_t seq, const void *buf, int size);
+
+    /**
+     * @brief   Tell the buffer that a sequence number was not an audio frame
+     * @param   seq The sequence number
+     */
+    void skipSequence(uint64_t seq);
+
+    /**
+     * @brief   Mark the end of a talk spurt
+     * @param   seq The sequence number of the flush message
+     *
+     * The decoder will be flushed when all frames before the given sequence
+     * number have been played.
+     */
+    void flushAt(uint64_t seq);
+
+    /**
+     * @brief   Flush the decoder when all buffered frames have been played
+     */
+    void flush(void);
+
+    /**
+     * @brief   Throw away all buffered frames and restart sequence numbering
+     *
+     * This function should be called when the sequence numbering restart,
+     * e.g. on a reconnect. If a talk spurt was in progress the decoder is
+     * flushed.
+     */
+    void reset(void);
+
+    /**
+     * @brief   Get the statistics
+     * @return  Returns the statistics counted since the last resetStats
+     */
+    const Stats& stats(void) const { return m_stats; }
+
+    /**
+     * @brief   Reset the statistics counters
+     */
+    void resetStats(void);
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief Resume audio output to the sink
+     */
+    virtual void resumeOutput(void);
+
+    /**
+     * @brief A signal emitted when a talk spurt has been played out
+     * @param stats The statistics at the end of the talk spurt
+     */
+    sigc::signal<void(const Stats&)> talkSpurtEnded;
+
+  protected:
+    /**
+     * @brief The registered sink has flushed all samples
+     */
+    virtual void allSamplesFlushed(void);
+
+  private:
+    static const unsigned PLAYOUT_INTERVAL    = 5;    // Milliseconds
+    static const unsigned MAX_CONCEAL_TIME    = 100;  // Milliseconds
+    static const unsigned DEFAULT_FRAME_TIME  = 20;   // Milliseconds
+    static const unsigned JITTER_FACTOR       = 3;
+    static const unsigned MAX_FRAMES          = 500;
+
+    typedef enum
+    {
+      STATE_IDLE, STATE_BUFFERING, STATE_PLAYING
+    } State;
+
+    typedef enum
+    {
+      FRAME_AUDIO, FRAME_SKIP, FRAME_FLUSH
+    } FrameType;
+
+    struct Frame
+    {
+      FrameType             type;
+      std::vector<uint8_t>  data;
+    };
+    typedef std::map<uint64_t, Frame> FrameMap;
+
+    AudioDecoder*       m_dec             = 0;
+    Timer               m_playout_timer;
+    FrameMap            m_frames;
+    std::set<uint64_t>  m_missed;
+    std::set<uint64_t>  m_non_audio;
+    State               m_state           = STATE_IDLE;
+    Stats               m_stats;
+    unsigned            m_min_delay       = 0;
+    unsigned            m_max_delay       = 0;
+    unsigned            m_target_delay    = 0;
+    uint64_t            m_next_seq        = 0;
+    int64_t             m_buffer_start    = -1;
+    int64_t             m_play_start      = 0;
+    uint64_t            m_played_samples  = 0;
+    unsigned            m_frame_samples;
+    double              m_jitter          = 0.0;
+    uint64_t            m_prev_seq        = 0;
+    int64_t             m_prev_arrival    = 0;
+    bool                m_have_prev       = false;
+    bool                m_flushing        = false;
+    unsigned            m_conceal_cnt     = 0;
+    unsigned            m_spurt_late      = 0;
+
+    AudioAdaptiveJitterBuffer(const AudioAdaptiveJitterBuffer&);
+    AudioAdaptiveJitterBuffer& operator=(const AudioAdaptiveJitterBuffer&);
+    int64_t now(void) const;
+    unsigned frameTime(void) const;
+    void startSpurt(void);
+    void endSpurt(void);
+    void playout(Timer *t=0);
+    bool playNextFrame(void);
+    void concealFrame(void);
+    void addMissed(uint64_t begin, uint64_t end);
+    void addNonAudioSeq(uint64_t seq);
+    void updateJitter(uint64_t seq);
+
+};  /* class AudioAdaptiveJitterBuffer */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_ADAPTIVE_JITTER_BUFFER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
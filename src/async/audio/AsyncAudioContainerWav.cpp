@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2020 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -150,7 +150,7 @@ int AudioContainerWav::writeSamples(const float *samples, int count)
     if (m_block_ptr >= m_block+m_block_size)
     {
       writeBlock(reinterpret_cast<char*>(m_block), m_block_size);
-      m_samples_written += m_block_size;
+      m_samples_written += m_block_size / (NUM_CHANNELS * sizeof(short));
       m_block_ptr = m_block;
     }
   }
@@ -163,7 +163,8 @@ void AudioContainerWav::flushSamples(void)
   if (m_block_ptr > m_block)
   {
     writeBlock(reinterpret_cast<char*>(m_block), m_block_ptr - m_block);
-    m_samples_written += m_block_ptr - m_block;
+    m_samples_written +=
+      (m_block_ptr - m_block) / (NUM_CHANNELS * sizeof(short));
     m_block_ptr = m_block;
   }
 } /* AudioContainerWav::flushSamples */
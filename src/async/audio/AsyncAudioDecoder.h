@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2008 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -164,6 +164,25 @@ class AudioDecoder : public AudioSource, public sigc::trackable
      * @brief Call this function when all encoded samples have been received
      */
     virtual void flushEncodedSamples(void) { sinkFlushSamples(); }
+
+    /**
+     * @brief   Generate audio for a lost frame
+     * @param   next_buf The frame following the lost one, if available
+     * @param   next_size The size of the next frame
+     * @return  Returns \em true if audio was generated or \em false if not
+     *
+     * Call this function in place of writeEncodedSamples when a frame has
+     * been lost. A decoder that support packet loss concealment will write
+     * a frame of synthesized audio to the sink. If the next frame is given,
+     * the decoder may use forward error correction data in that frame to
+     * recover the lost one. The next frame should still be written using
+     * writeEncodedSamples afterwards. The default implementation does
+     * nothing and return false.
+     */
+    virtual bool concealLostFrame(const void *next_buf=0, int next_size=0)
+    {
+      return false;
+    }
     
     /**
      * @brief Resume audio output to the sink
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2013 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -241,6 +241,30 @@ void AudioDecoderOpus::writeEncodedSamples(void *buf, int size)
 } /* AudioDecoderOpus::writeEncodedSamples */
 
 
+bool AudioDecoderOpus::concealLostFrame(const void *next_buf, int next_size)
+{
+  if (frame_size <= 0)
+  {
+    return false;
+  }
+  float samples[frame_size];
+  const unsigned char *next =
+    reinterpret_cast<const unsigned char *>(next_buf);
+  int cnt = opus_decode_float(dec, next, (next != 0) ? next_size : 0,
+                              samples, frame_size, (next != 0) ? 1 : 0);
+  if (cnt <= 0)
+  {
+    if (cnt < 0)
+    {
+      cerr << "*** ERROR: Opus decoder error: " << opus_strerror(cnt) << endl;
+    }
+    return false;
+  }
+  sinkWriteSamples(samples, cnt);
+  return true;
+} /* AudioDecoderOpus::concealLostFrame */
+
+
 
 /****************************************************************************
  *
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2013 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -166,6 +166,19 @@ class AudioDecoderOpus : public AudioDecoder
      * @param 	size The size of the buffer
      */
     virtual void writeEncodedSamples(void *buf, int size);
+
+    /**
+     * @brief   Generate audio for a lost frame
+     * @param   next_buf The frame following the lost one, if available
+     * @param   next_size The size of the next frame
+     * @return  Returns \em true if audio was generated or \em false if not
+     *
+     * The Opus packet loss concealment is used to synthesize a frame of the
+     * same length as the last decoded one. If the next frame is given, the
+     * in-band forward error correction data in that frame is used if the
+     * encoder included any.
+     */
+    virtual bool concealLostFrame(const void *next_buf=0, int next_size=0);
     
 
   protected:
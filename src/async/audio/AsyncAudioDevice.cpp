@@ -9,7 +9,7 @@ hardware audio devices.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -253,7 +253,19 @@ void AudioDevice::close(void)
 
 
 AudioDevice::AudioDevice(const string& dev_name)
-  : dev_name(dev_name), current_mode(MODE_NONE), use_count(0)
+  : dev_name(dev_name), current_mode(MODE_NONE), use_count(0),
+    m_capture_frames(Metrics::instance().counter("async_audio_frames_total",
+        "Number of audio frames read from or written to an audio device",
+        {{"device", dev_name}, {"direction", "capture"}})),
+    m_playback_frames(Metrics::instance().counter("async_audio_frames_total",
+        "Number of audio frames read from or written to an audio device",
+        {{"device", dev_name}, {"direction", "playback"}})),
+    m_capture_xruns(Metrics::instance().counter("async_audio_xruns_total",
+        "Number of overruns and underruns on an audio device",
+        {{"device", dev_name}, {"direction", "capture"}})),
+    m_playback_xruns(Metrics::instance().counter("async_audio_xruns_total",
+        "Number of overruns and underruns on an audio device",
+        {{"device", dev_name}, {"direction", "playback"}}))
 {
   reopen_timer.setEnable(false);
   reopen_timer.expired.connect(
@@ -269,6 +281,7 @@ AudioDevice::~AudioDevice(void)
 void AudioDevice::putBlocks(int16_t *buf, size_t frame_cnt)
 {
   //printf("putBlocks: frame_cnt=%zu\n", frame_cnt);
+  m_capture_frames.inc(frame_cnt);
   float samples[frame_cnt];
   for (size_t ch=0; ch<channels; ch++)
   {
@@ -385,7 +398,8 @@ size_t AudioDevice::getBlocks(int16_t *buf, size_t block_cnt)
     frames_to_write /= block_size;
     frames_to_write = (frames_to_write + 1) * block_size;
   }
-  
+
+  m_playback_frames.inc(frames_to_write);
   return frames_to_write / block_size;
   
 } /* AudioDevice::getBlocks */
@@ -402,6 +416,12 @@ void AudioDevice::setDeviceError(void)
 } /* AudioDevice::setDeviceError */
 
 
+void AudioDevice::countXrun(bool playback)
+{
+  (playback ? m_playback_xruns : m_capture_xruns).inc();
+} /* AudioDevice::countXrun */
+
+
 /****************************************************************************
  *
  * Private member functions
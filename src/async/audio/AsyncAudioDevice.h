@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2004-2025  Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026  Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -50,6 +50,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
+#include <AsyncMetrics.h>
 
 
 /****************************************************************************
@@ -360,6 +361,15 @@ class AudioDevice : public sigc::trackable
      */
     void setDeviceError(void);
 
+    /**
+     * @brief   Called by the device object when samples have been lost
+     * @param   playback Set to \em true for playback or \em false for capture
+     *
+     * This function should be called when the audio device buffer has
+     * overflowed on capture or underflowed on playback, that is an xrun.
+     */
+    void countXrun(bool playback);
+
   private:
     static const int    DEFAULT_SAMPLE_RATE = INTERNAL_SAMPLE_RATE;
     static const size_t DEFAULT_CHANNELS = 2;
@@ -372,6 +382,10 @@ class AudioDevice : public sigc::trackable
     size_t              use_count;
     std::list<AudioIO*> aios;
     Async::Timer        reopen_timer  {1000, Async::Timer::TYPE_PERIODIC};
+    Metrics::Counter&   m_capture_frames;
+    Metrics::Counter&   m_playback_frames;
+    Metrics::Counter&   m_capture_xruns;
+    Metrics::Counter&   m_playback_xruns;
 
     void reopenDevice(void);
 
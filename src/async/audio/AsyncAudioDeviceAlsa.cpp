@@ -8,7 +8,7 @@ Implements the low level interface to an Alsa audio device.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -434,6 +434,7 @@ void AudioDeviceAlsa::audioReadHandler(FdWatch *watch, unsigned short revents)
   snd_pcm_sframes_t frames_avail = snd_pcm_avail_update(rec_handle);
   if (frames_avail < 0)
   {
+    countXrun(false);
     if (!startCapture(rec_handle))
     {
       watch->setEnabled(false);
@@ -454,6 +455,7 @@ void AudioDeviceAlsa::audioReadHandler(FdWatch *watch, unsigned short revents)
     const auto frames_read = snd_pcm_readi(rec_handle, buf, frames_avail);
     if (frames_read < 0)
     {
+      countXrun(false);
       if (!startCapture(rec_handle))
       {
         setDeviceError();
@@ -497,6 +499,7 @@ void AudioDeviceAlsa::writeSpaceAvailable(FdWatch *watch, unsigned short revents
       // Bail out if there's an error
     if (space_avail < 0)
     {
+      countXrun(true);
       if (!startPlayback(play_handle))
       {
         setDeviceError();
@@ -537,6 +540,7 @@ void AudioDeviceAlsa::writeSpaceAvailable(FdWatch *watch, unsigned short revents
     //       blocks_gotten, (int)frames_written);
     if (frames_written < 0)
     {
+      countXrun(true);
       if (!startPlayback(play_handle))
       {
         setDeviceError();
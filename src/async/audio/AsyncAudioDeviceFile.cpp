@@ -0,0 +1,612 @@
+/**
+@file	 AsyncAudioDeviceFile.cpp
+@brief   Handle reading and writing of audio samples from/to files
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+Implements an "audio interface" that read samples from a file and write
+samples to a file. Together with the virtual clock in the application
+object this can be used to replay recorded audio through an application
+faster than real time.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <time.h>
+
+#include <cassert>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioDeviceFile.h"
+#include "AsyncAudioDeviceFactory.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+  uint32_t le32(const char *ptr)
+  {
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(ptr);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+  }
+
+  uint16_t le16(const char *ptr)
+  {
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(ptr);
+    return p[0] | (p[1] << 8);
+  }
+
+  void putLe32(char *ptr, uint32_t val)
+  {
+    for (int i=0; i<4; ++i)
+    {
+      ptr[i] = (val >> (8 * i)) & 0xff;
+    }
+  }
+
+  void putLe16(char *ptr, uint16_t val)
+  {
+    ptr[0] = val & 0xff;
+    ptr[1] = (val >> 8) & 0xff;
+  }
+
+  double threadCpuTime(void)
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+  }
+};
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+REGISTER_AUDIO_DEVICE_TYPE("file", AudioDeviceFile);
+
+unsigned AudioDeviceFile::active_readers = 0;
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+size_t AudioDeviceFile::readBlocksize(void)
+{
+  return block_size;
+} /* AudioDeviceFile::readBlocksize */
+
+
+size_t AudioDeviceFile::writeBlocksize(void)
+{
+  return block_size;
+} /* AudioDeviceFile::writeBlocksize */
+
+
+bool AudioDeviceFile::isFullDuplexCapable(void)
+{
+  return true;
+} /* AudioDeviceFile::isFullDuplexCapable */
+
+
+void AudioDeviceFile::audioToWriteAvailable(void)
+{
+  if (!write_timer.isEnabled())
+  {
+    audioWriteHandler();
+  }
+} /* AudioDeviceFile::audioToWriteAvailable */
+
+
+void AudioDeviceFile::flushSamples(void)
+{
+  if (!write_timer.isEnabled())
+  {
+    audioWriteHandler();
+  }
+} /* AudioDeviceFile::flushSamples */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+AudioDeviceFile::AudioDeviceFile(const string& dev_name)
+  : AudioDevice(dev_name), block_size(0), in_file(0), out_file(0),
+    in_silent(false), out_discard(false), in_channels(0), in_eof(false),
+    in_data_left(0), read_buf(0), file_buf(0),
+    read_timer(0, Timer::TYPE_PERIODIC, false),
+    write_timer(0, Timer::TYPE_PERIODIC, false), out_data_size(0),
+    rd_block_cnt(0), wr_block_cnt(0), rd_cpu(0.0), wr_cpu(0.0)
+{
+  assert(AudioDeviceFile_creator_registered);
+  assert(sampleRate() > 0);
+  size_t pace_interval = 1000 * block_size_hint / sampleRate();
+  block_size = pace_interval * sampleRate() / 1000;
+
+  read_buf = new int16_t[block_size * channels];
+  file_buf = new int16_t[block_size * channels];
+
+  read_timer.setTimeout(pace_interval);
+  read_timer.expired.connect(
+      sigc::hide(mem_fun(*this, &AudioDeviceFile::audioReadHandler)));
+  write_timer.setTimeout(pace_interval);
+  write_timer.expired.connect(
+      sigc::hide(mem_fun(*this, &AudioDeviceFile::audioWriteHandler)));
+
+  size_t comma = dev_name.find(',');
+  in_filename = dev_name.substr(0, comma);
+  if (comma != string::npos)
+  {
+    out_filename = dev_name.substr(comma + 1);
+  }
+} /* AudioDeviceFile::AudioDeviceFile */
+
+
+AudioDeviceFile::~AudioDeviceFile(void)
+{
+  closeDevice();
+  delete [] read_buf;
+  delete [] file_buf;
+} /* AudioDeviceFile::~AudioDeviceFile */
+
+
+bool AudioDeviceFile::openDevice(Mode mode)
+{
+  switch (mode)
+  {
+    case MODE_RD:
+      return openInput();
+
+    case MODE_WR:
+      return openOutput();
+
+    case MODE_RDWR:
+      return openInput() && openOutput();
+
+    case MODE_NONE:
+      break;
+  }
+
+  return true;
+
+} /* AudioDeviceFile::openDevice */
+
+
+void AudioDeviceFile::closeDevice(void)
+{
+  closeInput();
+  closeOutput();
+  printStats();
+} /* AudioDeviceFile::closeDevice */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+bool AudioDeviceFile::openInput(void)
+{
+  if ((in_file != 0) || in_silent)
+  {
+    return true;
+  }
+
+    // Without an input file, silence is produced until the device is
+    // closed. It is not counted as an active reader since it never end.
+  if (in_filename.empty())
+  {
+    in_silent = true;
+    read_timer.setEnable(true);
+    return true;
+  }
+
+  in_file = fopen(in_filename.c_str(), "r");
+  if (in_file == 0)
+  {
+    cerr << "*** ERROR: Could not open audio input file \"" << in_filename
+         << "\": " << strerror(errno) << endl;
+    return false;
+  }
+
+  in_channels = channels;
+  in_data_left = std::numeric_limits<unsigned long>::max();
+  char hdr[12];
+  if ((fread(hdr, 1, sizeof(hdr), in_file) == sizeof(hdr)) &&
+      (memcmp(hdr, "RIFF", 4) == 0) && (memcmp(hdr + 8, "WAVE", 4) == 0))
+  {
+    bool fmt_ok = false;
+    for (;;)
+    {
+      char chunk_hdr[8];
+      if (fread(chunk_hdr, 1, sizeof(chunk_hdr), in_file) != sizeof(chunk_hdr))
+      {
+        cerr << "*** ERROR: No data chunk found in WAV file \""
+             << in_filename << "\"\n";
+        closeInput();
+        return false;
+      }
+      uint32_t chunk_size = le32(chunk_hdr + 4);
+      if (memcmp(chunk_hdr, "fmt ", 4) == 0)
+      {
+        char fmt[16];
+        if ((chunk_size < sizeof(fmt)) ||
+            (fread(fmt, 1, sizeof(fmt), in_file) != sizeof(fmt)))
+        {
+          break;
+        }
+        in_channels = le16(fmt + 2);
+        if ((le16(fmt) != 1) || (le16(fmt + 14) != 16) ||
+            (static_cast<int>(le32(fmt + 4)) != sampleRate()) ||
+            (in_channels == 0) || (in_channels > channels))
+        {
+          cerr << "*** ERROR: The WAV file \"" << in_filename << "\" must "
+                  "be 16 bit PCM, have a sample rate of " << sampleRate()
+               << "Hz and have at most " << channels << " channel(s)\n";
+          closeInput();
+          return false;
+        }
+        fmt_ok = true;
+        chunk_size -= sizeof(fmt);
+      }
+      else if (memcmp(chunk_hdr, "data", 4) == 0)
+      {
+          // Only the data chunk is played. Chunks after it, like metadata,
+          // must not be read as audio. A size of zero or 0xffffffff is
+          // written by some programs when the length is not known so the
+          // rest of the file is read in that case.
+        if ((chunk_size != 0) && (chunk_size != 0xffffffff))
+        {
+          in_data_left = chunk_size;
+        }
+        break;
+      }
+      if (fseek(in_file, chunk_size + (chunk_size & 1), SEEK_CUR) == -1)
+      {
+        break;
+      }
+    }
+    if (!fmt_ok)
+    {
+      cerr << "*** ERROR: Malformed WAV file \"" << in_filename << "\"\n";
+      closeInput();
+      return false;
+    }
+  }
+  else
+  {
+    rewind(in_file);
+  }
+
+  in_eof = false;
+  ++active_readers;
+  read_timer.setEnable(true);
+
+  return true;
+
+} /* AudioDeviceFile::openInput */
+
+
+bool AudioDeviceFile::openOutput(void)
+{
+  if ((out_file != 0) || out_discard)
+  {
+    return true;
+  }
+
+    // Without an output file, written audio is just thrown away
+  if (out_filename.empty())
+  {
+    out_discard = true;
+    return true;
+  }
+
+  out_file = fopen(out_filename.c_str(), "w");
+  if (out_file == 0)
+  {
+    cerr << "*** ERROR: Could not open audio output file \"" << out_filename
+         << "\": " << strerror(errno) << endl;
+    return false;
+  }
+
+    // Write a placeholder header. The sizes are filled in on close.
+  char hdr[44] = {0};
+  if (fwrite(hdr, 1, sizeof(hdr), out_file) != sizeof(hdr))
+  {
+    cerr << "*** ERROR: Could not write to audio output file \""
+         << out_filename << "\": " << strerror(errno) << endl;
+    closeOutput();
+    return false;
+  }
+  out_data_size = 0;
+
+  return true;
+
+} /* AudioDeviceFile::openOutput */
+
+
+void AudioDeviceFile::closeInput(void)
+{
+  read_timer.setEnable(false);
+  in_silent = false;
+  if (in_file != 0)
+  {
+    if (!in_eof)
+    {
+      assert(active_readers > 0);
+      --active_readers;
+    }
+    fclose(in_file);
+    in_file = 0;
+  }
+} /* AudioDeviceFile::closeInput */
+
+
+void AudioDeviceFile::closeOutput(void)
+{
+  write_timer.setEnable(false);
+  out_discard = false;
+  if (out_file == 0)
+  {
+    return;
+  }
+
+  char hdr[44];
+  memcpy(hdr, "RIFF", 4);
+  putLe32(hdr + 4, 36 + out_data_size);
+  memcpy(hdr + 8, "WAVEfmt ", 8);
+  putLe32(hdr + 16, 16);
+  putLe16(hdr + 20, 1);
+  putLe16(hdr + 22, channels);
+  putLe32(hdr + 24, sampleRate());
+  putLe32(hdr + 28, sampleRate() * channels * sizeof(int16_t));
+  putLe16(hdr + 32, channels * sizeof(int16_t));
+  putLe16(hdr + 34, 16);
+  memcpy(hdr + 36, "data", 4);
+  putLe32(hdr + 40, out_data_size);
+  if ((fseek(out_file, 0, SEEK_SET) == -1) ||
+      (fwrite(hdr, 1, sizeof(hdr), out_file) != sizeof(hdr)))
+  {
+    cerr << "*** WARNING: Could not write WAV header to \""
+         << out_filename << "\"\n";
+  }
+  fclose(out_file);
+  out_file = 0;
+} /* AudioDeviceFile::closeOutput */
+
+
+void AudioDeviceFile::audioReadHandler(void)
+{
+  if (in_silent)
+  {
+    memset(read_buf, 0, block_size * channels * sizeof(*read_buf));
+    double start = threadCpuTime();
+    putBlocks(read_buf, block_size);
+    rd_cpu += threadCpuTime() - start;
+    ++rd_block_cnt;
+    return;
+  }
+
+  assert(in_file != 0);
+
+  const size_t frame_size = in_channels * sizeof(int16_t);
+  size_t frames_to_read = block_size;
+  if (in_data_left / frame_size < frames_to_read)
+  {
+    frames_to_read = in_data_left / frame_size;
+  }
+  size_t frames_read = 0;
+  if (frames_to_read > 0)
+  {
+    frames_read = fread(file_buf, frame_size, frames_to_read, in_file);
+  }
+  if (in_data_left != std::numeric_limits<unsigned long>::max())
+  {
+    in_data_left -= frames_read * frame_size;
+  }
+  if (frames_read == 0)
+  {
+    inputDone();
+    return;
+  }
+
+  memset(read_buf, 0, block_size * channels * sizeof(*read_buf));
+  for (size_t i=0; i<frames_read; ++i)
+  {
+    for (size_t ch=0; ch<in_channels; ++ch)
+    {
+      read_buf[i * channels + ch] = file_buf[i * in_channels + ch];
+    }
+  }
+
+  double start = threadCpuTime();
+  putBlocks(read_buf, block_size);
+  rd_cpu += threadCpuTime() - start;
+  ++rd_block_cnt;
+
+  if (frames_read < block_size)
+  {
+    inputDone();
+  }
+} /* AudioDeviceFile::audioReadHandler */
+
+
+void AudioDeviceFile::audioWriteHandler(void)
+{
+  assert((mode() == MODE_WR) || (mode() == MODE_RDWR));
+  if ((out_file == 0) && !out_discard)
+  {
+    write_timer.setEnable(false);
+    return;
+  }
+
+  int16_t buf[block_size * channels];
+  double start = threadCpuTime();
+  unsigned frags_read = getBlocks(buf, 1);
+  wr_cpu += threadCpuTime() - start;
+  if (frags_read == 0)
+  {
+    write_timer.setEnable(false);
+    return;
+  }
+  ++wr_block_cnt;
+
+  const size_t frag_size = block_size * sizeof(int16_t) * channels;
+  if (out_file != 0)
+  {
+    if (fwrite(buf, 1, frag_size, out_file) != frag_size)
+    {
+      perror("fwrite in AudioDeviceFile::audioWriteHandler");
+      write_timer.setEnable(false);
+      return;
+    }
+    out_data_size += frag_size;
+  }
+
+  write_timer.setEnable(true);
+
+} /* AudioDeviceFile::audioWriteHandler */
+
+
+void AudioDeviceFile::inputDone(void)
+{
+  read_timer.setEnable(false);
+  if (in_eof)
+  {
+    return;
+  }
+  in_eof = true;
+
+  cout << "Audio device file:" << devName() << ": End of input file reached"
+       << endl;
+  assert(active_readers > 0);
+  if ((--active_readers == 0) && Application::app().virtualClockEnabled())
+  {
+    Application::app().quit();
+  }
+} /* AudioDeviceFile::inputDone */
+
+
+void AudioDeviceFile::printStats(void)
+{
+  if ((rd_block_cnt == 0) && (wr_block_cnt == 0))
+  {
+    return;
+  }
+
+  std::ios_base::fmtflags flags(cout.flags());
+  cout << fixed << setprecision(3);
+  cout << "--- Audio device file:" << devName() << " statistics\n";
+  cout << "  Read   : " << rd_block_cnt << " blocks ("
+       << (static_cast<double>(rd_block_cnt) * block_size / sampleRate())
+       << "s audio, " << rd_cpu << "s CPU in receive chain)\n";
+  cout << "  Written: " << wr_block_cnt << " blocks ("
+       << (static_cast<double>(wr_block_cnt) * block_size / sampleRate())
+       << "s audio, " << wr_cpu << "s CPU in transmit chain)" << endl;
+  cout.flags(flags);
+  rd_block_cnt = wr_block_cnt = 0;
+  rd_cpu = wr_cpu = 0.0;
+} /* AudioDeviceFile::printStats */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,256 @@
+/**
+@file	 AsyncAudioDeviceFile.h
+@brief   Handle reading and writing of audio samples from/to files
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+Implements an "audio interface" that read samples from a file and write
+samples to a file. Together with the virtual clock in the application
+object this can be used to replay recorded audio through an application
+faster than real time.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_DEVICE_FILE_INCLUDED
+#define ASYNC_AUDIO_DEVICE_FILE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstdio>
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioDevice.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	An audio device that read from and write to files
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+Implements an "audio interface" that read samples from a file and write
+samples to a file. The device is specified as:
+
+  file:<input file>[,<output file>]
+
+Either file name may be left empty. If the input file name is empty, the
+device will produce silence. If the output file name is empty, the written
+audio is discarded at the same pace as it would have been written to a file.
+That way a device that is shared between RX and TX, like file:in.wav, can
+be opened in read/write mode. The input file may be a 16 bit PCM WAV
+file or a raw file containing 16 bit signed native endian samples. Only the
+data chunk of a WAV file is played. Any chunks after it are ignored. If the
+input file have fewer channels than the device, the remaining channels will
+be silent. The output file is always written as a WAV file.
+
+The samples are paced by timers so when the virtual clock is enabled in the
+application object (Async::Application::setVirtualClock), the file will be
+processed as fast as the CPU allows. When all input files have reached end
+of file and the virtual clock is enabled, the application will be told to
+quit.
+
+When the device is closed, a report is printed showing how many blocks that
+have been processed and how much CPU time was spent in the audio pipelines
+connected to the device.
+*/
+class AudioDeviceFile : public Async::AudioDevice
+{
+  public:
+    /**
+     * @brief 	Constuctor
+     * @param 	dev_name  The name of the device to associate this object with
+     */
+    explicit AudioDeviceFile(const std::string& dev_name);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioDeviceFile(void);
+
+    /**
+     * @brief 	Find out what the read (recording) blocksize is set to
+     * @return	Returns the currently set blocksize in samples per channel
+     */
+    virtual size_t readBlocksize(void);
+
+    /**
+     * @brief 	Find out what the write (playback) blocksize is set to
+     * @return	Returns the currently set blocksize in samples per channel
+     */
+    virtual size_t writeBlocksize(void);
+
+    /**
+     * @brief 	Check if the audio device has full duplex capability
+     * @return	Returns \em true if the device has full duplex capability
+     *	      	or else \em false
+     */
+    virtual bool isFullDuplexCapable(void);
+
+    /**
+     * @brief 	Tell the audio device handler that there are audio to be
+     *	      	written in the buffer
+     */
+    virtual void audioToWriteAvailable(void);
+
+    /**
+     * @brief	Tell the audio device to flush its buffers
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief 	Find out how many samples there are in the output buffer
+     * @return	Returns the number of samples in the output buffer on
+     *          success or -1 on failure.
+     *
+     * Samples are written to the file immediately so this function will
+     * always return zero.
+     */
+    virtual int samplesToWrite(void) const { return 0; }
+
+
+  protected:
+    /**
+     * @brief 	Open the audio device
+     * @param 	mode The mode to open the audio device in (See AudioIO::Mode)
+     * @return	Returns \em true on success or else \em false
+     */
+    virtual bool openDevice(Mode mode);
+
+    /**
+     * @brief 	Close the audio device
+     */
+    virtual void closeDevice(void);
+
+
+  private:
+    static unsigned     active_readers;
+
+    size_t              block_size;
+    std::string         in_filename;
+    std::string         out_filename;
+    FILE                *in_file;
+    FILE                *out_file;
+    bool                in_silent;
+    bool                out_discard;
+    size_t              in_channels;
+    bool                in_eof;
+    unsigned long       in_data_left;
+    int16_t             *read_buf;
+    int16_t             *file_buf;
+    Async::Timer        read_timer;
+    Async::Timer        write_timer;
+    unsigned long       out_data_size;
+    unsigned long       rd_block_cnt;
+    unsigned long       wr_block_cnt;
+    double              rd_cpu;
+    double              wr_cpu;
+
+    AudioDeviceFile(const AudioDeviceFile&);
+    AudioDeviceFile& operator=(const AudioDeviceFile&);
+    bool openInput(void);
+    bool openOutput(void);
+    void closeInput(void);
+    void closeOutput(void);
+    void audioReadHandler(void);
+    void audioWriteHandler(void);
+    void inputDone(void);
+    void printStats(void);
+
+};  /* class AudioDeviceFile */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_DEVICE_FILE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,381 @@
+/**
+@file	 AsyncAudioFilterBank.cpp
+@brief   A multi channel filter running the same filter on many channels
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+
+#include <cstring>
+#include <cstdlib>
+#include <locale>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+extern "C" {
+#include "fidlib.h"
+};
+
+#include "AsyncAudioFilterBank.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioFilterBank::AudioFilterBank(int sample_rate, size_t channels)
+  : sample_rate(sample_rate), m_channels(channels), gain(1.0)
+{
+  work.resize(m_channels);
+} /* AudioFilterBank::AudioFilterBank */
+
+
+AudioFilterBank::AudioFilterBank(const string &filter_spec, int sample_rate,
+                                 size_t channels)
+  : sample_rate(sample_rate), m_channels(channels), gain(1.0)
+{
+  work.resize(m_channels);
+  if (!parseFilterSpec(filter_spec))
+  {
+    cerr << "***ERROR: Filter creation error: " << error_str << endl;
+    exit(1);
+  }
+} /* AudioFilterBank::AudioFilterBank */
+
+
+AudioFilterBank::~AudioFilterBank(void)
+{
+} /* AudioFilterBank::~AudioFilterBank */
+
+
+bool AudioFilterBank::parseFilterSpec(const std::string &filter_spec)
+{
+  sections.clear();
+  gain = 1.0;
+
+  char spec_buf[256];
+  strncpy(spec_buf, filter_spec.c_str(), sizeof(spec_buf));
+  spec_buf[sizeof(spec_buf) - 1] = 0;
+  char *spec = spec_buf;
+  FidFilter *ff = 0;
+  char *old_locale = setlocale(LC_ALL, "C");
+  char *fferr = fid_parse(sample_rate, &spec, &ff);
+  setlocale(LC_ALL, old_locale);
+  if (fferr != 0)
+  {
+    error_str = fferr;
+    free(fferr);
+    return false;
+  }
+
+    // Split the filter into IIR/FIR pairs in the same way as the fidlib
+    // filter runner does. Each pair is run as a direct form II section
+    // sharing the same delay line.
+  FidFilter *filt = ff;
+  while (filt->len != 0)
+  {
+    double *iir = 0;
+    double *fir = 0;
+    int n_iir = 0;
+    int n_fir = 0;
+    if ((filt->typ == 'F') && (filt->len == 1))
+    {
+      gain *= filt->val[0];
+      filt = FFNEXT(filt);
+      continue;
+    }
+    if (filt->typ == 'F')
+    {
+      fir = filt->val;
+      n_fir = filt->len;
+      filt = FFNEXT(filt);
+    }
+    else if (filt->typ == 'I')
+    {
+      iir = filt->val;
+      n_iir = filt->len;
+      filt = FFNEXT(filt);
+      while ((filt->typ == 'F') && (filt->len == 1))
+      {
+        gain *= filt->val[0];
+        filt = FFNEXT(filt);
+      }
+      if (filt->typ == 'F')
+      {
+        fir = filt->val;
+        n_fir = filt->len;
+        filt = FFNEXT(filt);
+      }
+    }
+    else
+    {
+      error_str = "Unsupported filter element type";
+      free(ff);
+      sections.clear();
+      return false;
+    }
+
+    Section sec;
+    size_t order = max(n_iir, n_fir) - 1;
+    sec.a.assign(order, 0.0);
+    sec.b.assign(order + 1, 0.0);
+    double adj = 1.0;
+    if (n_iir > 0)
+    {
+      adj = 1.0 / iir[0];
+      gain *= adj;
+      for (int i=1; i<n_iir; ++i)
+      {
+        sec.a[i-1] = iir[i] * adj;
+      }
+    }
+    if (n_fir > 0)
+    {
+      copy(fir, fir + n_fir, sec.b.begin());
+    }
+    else
+    {
+      sec.b[0] = 1.0;
+    }
+    sec.state.assign(order * m_channels, 0.0);
+    sections.push_back(sec);
+  }
+  free(ff);
+
+  return true;
+} /* AudioFilterBank::parseFilterSpec */
+
+
+void AudioFilterBank::setChannels(size_t channels)
+{
+  for (auto& sec : sections)
+  {
+    size_t order = sec.a.size();
+    std::vector<double> state(order * channels, 0.0);
+    for (size_t k=0; k<order; ++k)
+    {
+      copy(sec.state.begin() + k * m_channels,
+           sec.state.begin() + k * m_channels + min(m_channels, channels),
+           state.begin() + k * channels);
+    }
+    sec.state.swap(state);
+  }
+  m_channels = channels;
+  work.resize(m_channels);
+} /* AudioFilterBank::setChannels */
+
+
+void AudioFilterBank::reset(void)
+{
+  for (auto& sec : sections)
+  {
+    fill(sec.state.begin(), sec.state.end(), 0.0);
+  }
+} /* AudioFilterBank::reset */
+
+
+void AudioFilterBank::reset(size_t channel)
+{
+  if (channel >= m_channels)
+  {
+    return;
+  }
+  for (auto& sec : sections)
+  {
+    for (size_t k=0; k<sec.a.size(); ++k)
+    {
+      sec.state[k * m_channels + channel] = 0.0;
+    }
+  }
+} /* AudioFilterBank::reset */
+
+
+void AudioFilterBank::processFrames(float *dest, const float *src,
+                                    size_t frames)
+{
+  const size_t nch = m_channels;
+  double *w = work.data();
+  for (size_t f=0; f<frames; ++f)
+  {
+    const float *in = src + f * nch;
+    for (size_t ch=0; ch<nch; ++ch)
+    {
+      w[ch] = gain * in[ch];
+    }
+
+      // All loops over channels below are free from dependencies between
+      // iterations so they are straight forward to vectorize
+    for (auto& sec : sections)
+    {
+      const size_t order = sec.a.size();
+      double *s = sec.state.data();
+      if (order == 2)
+      {
+        const double a1 = sec.a[0];
+        const double a2 = sec.a[1];
+        const double b0 = sec.b[0];
+        const double b1 = sec.b[1];
+        const double b2 = sec.b[2];
+        double *s1 = s;
+        double *s2 = s + nch;
+        for (size_t ch=0; ch<nch; ++ch)
+        {
+          double v = w[ch] - a1 * s1[ch] - a2 * s2[ch];
+          w[ch] = b0 * v + b1 * s1[ch] + b2 * s2[ch];
+          s2[ch] = s1[ch];
+          s1[ch] = v;
+        }
+      }
+      else
+      {
+        for (size_t ch=0; ch<nch; ++ch)
+        {
+          double v = w[ch];
+          for (size_t k=0; k<order; ++k)
+          {
+            v -= sec.a[k] * s[k * nch + ch];
+          }
+          double y = sec.b[0] * v;
+          for (size_t k=0; k<order; ++k)
+          {
+            y += sec.b[k+1] * s[k * nch + ch];
+          }
+          for (size_t k=order; k>1; --k)
+          {
+            s[(k-1) * nch + ch] = s[(k-2) * nch + ch];
+          }
+          if (order > 0)
+          {
+            s[ch] = v;
+          }
+          w[ch] = y;
+        }
+      }
+    }
+
+    float *out = dest + f * nch;
+    for (size_t ch=0; ch<nch; ++ch)
+    {
+      out[ch] = static_cast<float>(w[ch]);
+    }
+  }
+} /* AudioFilterBank::processFrames */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,239 @@
+/**
+@file	 AsyncAudioFilterBank.h
+@brief   A multi channel filter running the same filter on many channels
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef ASYNC_AUDIO_FILTER_BANK_INCLUDED
+#define ASYNC_AUDIO_FILTER_BANK_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioProcessor.h>
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A multi channel filter running the same filter on many channels
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class use the same filter specification syntax as the Async::AudioFilter
+class but run the filter on multiple channels at once. The samples are
+given as interleaved frames, that is one sample for each channel after each
+other. The filter state for all channels is stored channel by channel for each
+filter section so that the compiler can vectorize the inner loop over the
+channels. The filter response is exactly the same as for an
+Async::AudioFilter created with the same filter specification.
+
+This class is not an audio sink or source since it handle multiple channels.
+It is meant to be used by code that collect audio from many sources, like
+a signal level detector for many receivers.
+*/
+class AudioFilterBank
+{
+  public:
+    /**
+     * @brief 	Constuctor
+     * @param 	sample_rate The sampling rate
+     * @param   channels The number of channels
+     */
+    explicit AudioFilterBank(int sample_rate = INTERNAL_SAMPLE_RATE,
+                             size_t channels = 1);
+
+    /**
+     * @brief 	Constuctor
+     * @param 	filter_spec The filter specification
+     * @param 	sample_rate The sampling rate
+     * @param   channels The number of channels
+     *
+     * Use this constructor to set up at filter and call parseFilterSpec on
+     * the given filter specification. If the filter creation fails, this
+     * function will do an "exit(1)".
+     */
+    AudioFilterBank(const std::string &filter_spec,
+                    int sample_rate = INTERNAL_SAMPLE_RATE,
+                    size_t channels = 1);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~AudioFilterBank(void);
+
+    /**
+     * @brief   Create the filter from the given filter specification
+     * @param 	filter_spec The filter specification
+     * @return  Returns \em true on success or else \em false
+     *
+     * The filter specification use the same syntax as for the
+     * Async::AudioFilter class. The filter state for all channels is
+     * cleared.
+     */
+    bool parseFilterSpec(const std::string &filter_spec);
+
+    /**
+     * @brief   Get the latest filter creation error
+     * @return  Returns an error string if an error has occured previously
+     */
+    std::string errorString(void) const { return error_str; }
+
+    /**
+     * @brief   Set the number of channels
+     * @param   channels The new number of channels
+     *
+     * The filter state for existing channels is kept. Added channels will
+     * start out with a cleared filter state.
+     */
+    void setChannels(size_t channels);
+
+    /**
+     * @brief   Get the number of channels
+     * @return  Returns the number of channels
+     */
+    size_t channels(void) const { return m_channels; }
+
+    /**
+     * @brief   Reset the filter state for all channels
+     */
+    void reset(void);
+
+    /**
+     * @brief   Reset the filter state for a single channel
+     * @param   channel The channel to reset
+     */
+    void reset(size_t channel);
+
+    /**
+     * @brief   Filter a number of interleaved sample frames
+     * @param   dest  Destination buffer (frames * channels() samples)
+     * @param   src   Source buffer (frames * channels() samples)
+     * @param   frames The number of frames to process
+     *
+     * The source and destination buffers may be the same buffer.
+     */
+    void processFrames(float *dest, const float *src, size_t frames);
+
+
+  private:
+    struct Section
+    {
+      std::vector<double> a;      // Normalized feedback coefficients a1..aN
+      std::vector<double> b;      // Feedforward coefficients b0..bN
+      std::vector<double> state;  // N delay elements, channel by channel
+    };
+    typedef std::vector<Section> Sections;
+
+    int                 sample_rate;
+    size_t              m_channels;
+    double              gain;
+    Sections            sections;
+    std::vector<double> work;
+    std::string         error_str;
+
+    AudioFilterBank(const AudioFilterBank&);
+    AudioFilterBank& operator=(const AudioFilterBank&);
+
+};  /* class AudioFilterBank */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_FILTER_BANK_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -9,7 +9,7 @@ application that use the Async classes.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2015 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -165,6 +165,18 @@ void Application::runTask(sigc::slot<void()> task)
 } /* Application::runTask */
 
 
+void Application::getTimeOfDay(struct timeval *tv) const
+{
+  gettimeofday(tv, NULL);
+} /* Application::getTimeOfDay */
+
+
+void Application::getMonotonicTime(struct timespec *ts) const
+{
+  clock_gettime(CLOCK_MONOTONIC, ts);
+} /* Application::getMonotonicTime */
+
+
 
 /****************************************************************************
  *
@@ -9,7 +9,7 @@ application that use the Async classes.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2022 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -38,6 +38,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <sigc++/sigc++.h>
+#include <sys/time.h>
+#include <time.h>
 
 #include <string>
 
@@ -177,7 +179,50 @@ class Application : public sigc::trackable
      * and the second is an integer.
      */
     void runTask(sigc::slot<void()> task);
-    
+
+    /**
+     * @brief   Enable or disable the virtual clock
+     * @param   enable Set to \em true to enable the virtual clock
+     * @return  Returns \em true if the mode could be set
+     *
+     * When the virtual clock is enabled, timers are driven by simulated time
+     * instead of by the system clock. When there is nothing else to do, the
+     * main loop immediately advance the clock to the expiration time of the
+     * next timer. This make it possible to for example replay recorded audio
+     * files through an application as fast as the CPU allows.
+     * The default implementation does not support a virtual clock so it
+     * will only accept disabling it.
+     */
+    virtual bool setVirtualClock(bool enable) { return !enable; }
+
+    /**
+     * @brief   Check if the virtual clock is enabled
+     * @return  Returns \em true if the virtual clock is enabled
+     */
+    virtual bool virtualClockEnabled(void) const { return false; }
+
+    /**
+     * @brief   Get the current time of day as seen by the application
+     * @param   tv Will be filled in with the current time
+     *
+     * This function should be used instead of gettimeofday() by code that
+     * measure time intervals or calculate timer timeouts. When the virtual
+     * clock is enabled, the returned time will follow the simulated time.
+     */
+    virtual void getTimeOfDay(struct timeval *tv) const;
+
+    /**
+     * @brief   Get the current monotonic time as seen by the application
+     * @param   ts Will be filled in with the current time
+     *
+     * Like getTimeOfDay but the time is not affected by changes to the
+     * system clock, e.g. when NTP step the clock. The time has no relation
+     * to the time of day so it is only useful for measuring time intervals.
+     * When the virtual clock is enabled, the returned time will follow the
+     * simulated time.
+     */
+    virtual void getMonotonicTime(struct timespec *ts) const;
+
   protected:
     void clearTasks(void);
     
@@ -55,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "AsyncApplication.h"
 #include "AsyncAtTimer.h"
 
 
@@ -218,11 +219,7 @@ void AtTimer::stop(void)
 int AtTimer::msecToTimeout(void)
 {
   struct timeval now;
-  if (gettimeofday(&now, 0) == -1)
-  {
-    perror("gettimeofday[AtTimer::msecToTimeout]");
-    return -1;
-  }
+  Application::app().getTimeOfDay(&now);
 
   struct timeval diff;
   timersub(&m_expire_at, &now, &diff);
@@ -12,7 +12,7 @@ is shown below.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -249,11 +249,19 @@ void Config::setValue(const std::string& section, const std::string& tag,
                       const std::string& value)
 {
   Values &values = sections[section];
-  if (value != values[tag].val)
+  Values::iterator val_it = values.find(tag);
+  if (val_it == values.end())
   {
-    values[tag].val = value;
+    val_it = values.emplace(tag, Value()).first;
+    ++tags_added;
+  }
+  Value& v = val_it->second;
+  if (value != v.val)
+  {
+    v.val = value;
+    ++v.serial;
     valueUpdated(section, tag);
-    for (const auto& func : values[tag].subs)
+    for (const auto& func : v.subs)
     {
       func(value);
     }
@@ -292,6 +300,25 @@ void Config::setValue(const std::string& section, const std::string& tag,
  *
  ****************************************************************************/
 
+const Config::Value* Config::findValue(const std::string& section,
+                                       const std::string& tag) const
+{
+  Sections::const_iterator sec_it = sections.find(section);
+  if (sec_it == sections.end())
+  {
+    return nullptr;
+  }
+
+  Values::const_iterator val_it = sec_it->second.find(tag);
+  if (val_it == sec_it->second.end())
+  {
+    return nullptr;
+  }
+
+  return &val_it->second;
+} /* Config::findValue */
+
+
 
 /*
  *----------------------------------------------------------------------------
@@ -365,9 +392,9 @@ bool Config::parseCfgFile(FILE *file)
 	}
 	assert(!current_sec.empty());
 	
-	Values &values = sections[current_sec];
-	string& value = values[current_tag].val;
-	value += val;
+	Value& v = sections[current_sec][current_tag];
+	v.val += val;
+	++v.serial;
 	break;
       }
       
@@ -390,7 +417,14 @@ bool Config::parseCfgFile(FILE *file)
 	}
 	Values &values = sections[current_sec];
 	current_tag = tag;
-	values[current_tag].val = value;
+	Values::iterator val_it = values.find(current_tag);
+	if (val_it == values.end())
+	{
+	  val_it = values.emplace(current_tag, Value()).first;
+	  ++tags_added;
+	}
+	val_it->second.val = value;
+	++val_it->second.serial;
       	break;
       }
     }
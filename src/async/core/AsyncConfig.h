@@ -12,7 +12,7 @@ is shown below.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2004-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -134,10 +134,18 @@ is shown below.
 \include test.cfg
 
 \include AsyncConfig_demo.cpp
+
+Code that read a configuration variable often, e.g. each time a client
+connect, should get a handle to the variable using the variable function
+and keep it. Reading the value through the handle does not look up the
+section and tag and the value is only parsed again if it has been changed
+using setValue.
 */
 class Config
 {
   public:
+    template <typename T> class Variable;
+
     /**
      * @brief 	Default constuctor
      */
@@ -233,14 +241,8 @@ class Config
       {
 	return missing_ok;
       }
-      std::stringstream ssval(str_val);
       Rsp tmp;
-      ssval >> tmp;
-      if(!ssval.eof())
-      {
-        ssval >> std::ws;
-      }
-      if (ssval.fail() || !ssval.eof())
+      if (!stringToValue(str_val, tmp))
       {
 	return false;
       }
@@ -461,14 +463,8 @@ class Config
       {
 	return missing_ok;
       }
-      std::stringstream ssval(str_val);
       Rsp tmp;
-      ssval >> tmp;
-      if(!ssval.eof())
-      {
-        ssval >> std::ws;
-      }
-      if (ssval.fail() || !ssval.eof() || (tmp < min) || (tmp > max))
+      if (!stringToValue(str_val, tmp) || (tmp < min) || (tmp > max))
       {
 	return false;
       }
@@ -476,6 +472,29 @@ class Config
       return true;
     } /* Config::getValue */
 
+    /**
+     * @brief   Get a handle to a configuration variable
+     * @param   section The name of the section where the configuration
+     *                  variable is located
+     * @param   tag     The name of the configuration variable
+     * @param   def     The value to use if the variable is missing or invalid
+     * @return  Returns a handle that can be used to read the variable
+     *
+     * This function is used to get a handle to a configuration variable
+     * that is read often. The handle keep a reference to the variable and a
+     * parsed copy of its value so reading it is cheap. The value is parsed
+     * the same way as for the getValue function and it's parsed again only
+     * if the variable is changed using setValue. The variable does not have
+     * to exist when the handle is created. The handle must not be used after
+     * this Config object has been destroyed.
+     */
+    template <typename T>
+    Variable<T> variable(const std::string& section, const std::string& tag,
+                         const T& def=T()) const
+    {
+      return Variable<T>(this, section, tag, def);
+    } /* Config::variable */
+
     /**
      * @brief Subscribe to the given configuration variable (char*)
      * @param section The name of the section where the configuration
@@ -697,6 +716,7 @@ class Config
     {
       std::string             val;
       std::vector<Subscriber> subs;
+      unsigned                serial  = 0;
     };
     typedef std::map<std::string, Value>  Values;
     typedef std::map<std::string, Values> Sections;
@@ -730,6 +750,7 @@ class Config
     };
 
     Sections  sections;
+    unsigned  tags_added  = 0;
 
     bool parseCfgFile(FILE *file);
     char *trimSpaces(char *line);
@@ -739,6 +760,37 @@ class Config
     char *parseValue(char *value);
     char *translateEscapedChars(char *val);
 
+    template <typename T>
+    static bool stringToValue(const std::string& str, T& val)
+    {
+      std::stringstream ssval(str);
+      ssval >> val;
+      if(!ssval.eof())
+      {
+        ssval >> std::ws;
+      }
+      return !ssval.fail() && ssval.eof();
+    }
+
+    static bool stringToValue(const std::string& str, std::string& val)
+    {
+      val = str;
+      return true;
+    }
+
+    static bool stringToValue(const std::string& str, char& val)
+    {
+      if (str.size() != 1)
+      {
+        return false;
+      }
+      val = str[0];
+      return true;
+    }
+
+    const Value* findValue(const std::string& section,
+                           const std::string& tag) const;
+
     template <class T>
     bool setValueFromString(T& val, const std::string &str) const
     {
@@ -767,6 +819,136 @@ class Config
 }; /* class Config */
 
 
+/**
+@brief  A handle to a configuration variable
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+A handle is created using the Config::variable function. It keep a pointer
+to the variable in the configuration so that it does not have to be looked
+up each time it's read, and a copy of the value parsed into the type T. The
+value is parsed again when it has been changed. If the variable does not
+exist, it's looked up again only when new variables have been added to the
+configuration.
+
+\code
+auto timeout = cfg.variable<unsigned>("GLOBAL", "TIMEOUT", 30);
+...
+setTimer(timeout.value());
+\endcode
+*/
+template <typename T>
+class Config::Variable
+{
+  public:
+    /**
+     * @brief   Default constructor
+     *
+     * Create a handle that is not associated with any configuration.
+     */
+    Variable(void) {}
+
+    /**
+     * @brief   Constructor
+     * @param   cfg     The configuration object
+     * @param   section The name of the section where the variable is located
+     * @param   tag     The name of the configuration variable
+     * @param   def     The value to use if the variable is missing or invalid
+     */
+    Variable(const Config* cfg, const std::string& section,
+             const std::string& tag, const T& def)
+      : m_cfg(cfg), m_section(section), m_tag(tag), m_def(def)
+    {
+    }
+
+    /**
+     * @brief   Check if the configuration variable is set
+     * @return  Returns \em true if the variable exist in the configuration
+     */
+    bool isSet(void) const { return update() != nullptr; }
+
+    /**
+     * @brief   Check if the configuration variable is set to a valid value
+     * @return  Returns \em true if the variable exist and could be parsed
+     */
+    bool isValid(void) const { return (update() != nullptr) && m_valid; }
+
+    /**
+     * @brief   Get the value of the configuration variable
+     * @return  Returns the value or the default value if the variable is
+     *          missing or invalid
+     */
+    const T& value(void) const
+    {
+      return ((update() != nullptr) && m_valid) ? m_value : m_def;
+    }
+
+    /**
+     * @brief   Get the value of the configuration variable
+     * @param   rsp        The value is returned in this argument
+     * @param   missing_ok If set to \em true, return \em true if the
+     *                     configuration variable is missing
+     * @return  Returns \em true on success or else \em false on failure
+     *
+     * This function work like Config::getValue. The rsp argument is left
+     * unchanged if the variable is missing or invalid.
+     */
+    bool getValue(T& rsp, bool missing_ok=false) const
+    {
+      if (update() == nullptr)
+      {
+        return missing_ok;
+      }
+      if (!m_valid)
+      {
+        return false;
+      }
+      rsp = m_value;
+      return true;
+    }
+
+  private:
+    const Config*         m_cfg         = nullptr;
+    std::string           m_section;
+    std::string           m_tag;
+    T                     m_def         {};
+    mutable T             m_value       {};
+    mutable const Value*  m_val         = nullptr;
+    mutable unsigned      m_tags_added  = 0;
+    mutable unsigned      m_serial      = 0;
+    mutable bool          m_looked_up   = false;
+    mutable bool          m_valid       = false;
+
+    const Value* update(void) const
+    {
+      if (m_cfg == nullptr)
+      {
+        return nullptr;
+      }
+      bool parse = false;
+      if ((m_val == nullptr) &&
+          (!m_looked_up || (m_tags_added != m_cfg->tags_added)))
+      {
+        m_val = m_cfg->findValue(m_section, m_tag);
+        m_tags_added = m_cfg->tags_added;
+        m_looked_up = true;
+        parse = (m_val != nullptr);
+      }
+      if ((m_val != nullptr) && (parse || (m_serial != m_val->serial)))
+      {
+        T tmp;
+        m_valid = Config::stringToValue(m_val->val, tmp);
+        if (m_valid)
+        {
+          m_value = std::move(tmp);
+        }
+        m_serial = m_val->serial;
+      }
+      return m_val;
+    }
+}; /* class Config::Variable */
+
+
 } /* namespace */
 
 #endif /* ASYNC_CONFIG_INCLUDED */
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2023 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -52,6 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "AsyncMetrics.h"
 #include "AsyncEncryptedUdpSocket.h"
 
 
@@ -95,6 +96,23 @@ namespace {
  *
  ****************************************************************************/
 
+struct CryptMetrics
+{
+  Metrics::Counter& encrypt_failures;
+  Metrics::Counter& decrypt_failures;
+};
+
+CryptMetrics& cryptMetrics(void)
+{
+  auto& m = Metrics::instance();
+  static CryptMetrics metrics {
+    m.counter("async_udp_encrypt_failures_total",
+              "Number of UDP datagrams that could not be encrypted"),
+    m.counter("async_udp_decrypt_failures_total",
+              "Number of received UDP datagrams that could not be decrypted")
+  };
+  return metrics;
+}
 
 
 }; /* End of anonymous namespace */
@@ -142,8 +160,8 @@ bool EncryptedUdpSocket::randomBytes(std::vector<uint8_t>& bytes)
 
 
 EncryptedUdpSocket::EncryptedUdpSocket(uint16_t local_port,
-    const IpAddress &bind_ip)
-  : UdpSocket(local_port, bind_ip)
+    const IpAddress &bind_ip, bool reuse_port)
+  : UdpSocket(local_port, bind_ip, reuse_port)
 {
   m_cipher_ctx = EVP_CIPHER_CTX_new();
 } /* EncryptedUdpSocket::EncryptedUdpSocket */
@@ -288,6 +306,7 @@ bool EncryptedUdpSocket::write(const IpAddress& remote_ip, int remote_port,
     {
       std::cout << "### EVP_EncryptUpdate with AAD failed" << std::endl;
       ERR_print_errors_fp(stderr);
+      cryptMetrics().encrypt_failures.inc();
       return false;
     }
   }
@@ -296,6 +315,7 @@ bool EncryptedUdpSocket::write(const IpAddress& remote_ip, int remote_port,
   if(!EVP_EncryptUpdate(m_cipher_ctx, outbufp, &outlen, inbuf, cnt))
   {
     std::cout << "### EVP_EncryptUpdate failed" << std::endl;
+    cryptMetrics().encrypt_failures.inc();
     return false;
   }
   outbufp += outlen;
@@ -304,6 +324,7 @@ bool EncryptedUdpSocket::write(const IpAddress& remote_ip, int remote_port,
   if(!EVP_EncryptFinal_ex(m_cipher_ctx, outbufp, &outlen))
   {
     std::cout << "### EVP_EncryptFinal failed" << std::endl;
+    cryptMetrics().encrypt_failures.inc();
     return false;
   }
   totoutlen += outlen;
@@ -316,6 +337,7 @@ bool EncryptedUdpSocket::write(const IpAddress& remote_ip, int remote_port,
     {
       std::cout << "### EVP_CIPHER_CTX_ctrl(EVP_CTRL_AEAD_GET_TAG) failed"
                 << std::endl;
+      cryptMetrics().encrypt_failures.inc();
       return false;
     }
   }
@@ -379,11 +401,13 @@ void EncryptedUdpSocket::onDataReceived(const IpAddress& ip, uint16_t port,
     {
       std::cout << "### EncryptedUdpSocket::onDataReceived: count=" << count
                 << " m_aadlen=" << m_aadlen << std::endl;
+      cryptMetrics().decrypt_failures.inc();
       return;
     }
     if(!EVP_DecryptUpdate(m_cipher_ctx, nullptr, &outlen, inbuf, m_aadlen))
     {
       std::cout << "### : EVP_DecryptUpdate AAD failed" << std::endl;
+      cryptMetrics().decrypt_failures.inc();
       return;
     }
     assert(static_cast<size_t>(outlen) == m_aadlen);
@@ -400,6 +424,7 @@ void EncryptedUdpSocket::onDataReceived(const IpAddress& ip, uint16_t port,
     {
       std::cout << "### Required tag does not fit within incoming data"
                 << std::endl;
+      cryptMetrics().decrypt_failures.inc();
       return;
     }
     if (!EVP_CIPHER_CTX_ctrl(
@@ -407,6 +432,7 @@ void EncryptedUdpSocket::onDataReceived(const IpAddress& ip, uint16_t port,
     {
       std::cout << "### EVP_CIPHER_CTX_ctrl(EVP_CTRL_AEAD_SET_TAG) failed"
                 << std::endl;
+      cryptMetrics().decrypt_failures.inc();
       return;
     }
     inbuf += m_taglen;
@@ -416,6 +442,7 @@ void EncryptedUdpSocket::onDataReceived(const IpAddress& ip, uint16_t port,
   if(!EVP_DecryptUpdate(m_cipher_ctx, outbuf, &outlen, inbuf, count))
   {
     std::cout << "### EVP_DecryptUpdate failed" << std::endl;
+    cryptMetrics().decrypt_failures.inc();
     return;
   }
 
@@ -423,6 +450,7 @@ void EncryptedUdpSocket::onDataReceived(const IpAddress& ip, uint16_t port,
   if(!EVP_DecryptFinal_ex(m_cipher_ctx, outbuf+outlen, &outlen))
   {
     std::cout << "### EVP_DecryptFinal_ex failed" << std::endl;
+    cryptMetrics().decrypt_failures.inc();
     return;
   }
   totoutlen += outlen;
@@ -434,6 +462,17 @@ void EncryptedUdpSocket::onDataReceived(const IpAddress& ip, uint16_t port,
 } /* EncryptedUdpSocket::onDataReceived */
 
 
+void EncryptedUdpSocket::onDatagramsReceived(Datagram* dgs, size_t count)
+{
+    // Each datagram may use a different key so they are always decrypted
+    // and delivered one by one
+  for (size_t i=0; i<count; ++i)
+  {
+    onDataReceived(dgs[i].ip, dgs[i].port, dgs[i].buf, dgs[i].count);
+  }
+} /* EncryptedUdpSocket::onDatagramsReceived */
+
+
 /****************************************************************************
  *
  * Private member functions
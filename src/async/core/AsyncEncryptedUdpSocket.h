@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2023 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -165,9 +165,10 @@ class EncryptedUdpSocket : public UdpSocket
      * @brief   Constructor
      * @param   local_port  The local UDP port to bind to, 0=ephemeral
      * @param   bind_ip     The local interface (IP) to bind to
+     * @param   reuse_port  Set to \em true to set the SO_REUSEPORT option
      */
     EncryptedUdpSocket(uint16_t local_port=0,
-        const IpAddress &bind_ip=IpAddress());
+        const IpAddress &bind_ip=IpAddress(), bool reuse_port=false);
 
     /**
      * @brief   Disallow copy construction
@@ -348,6 +349,7 @@ class EncryptedUdpSocket : public UdpSocket
   protected:
     void onDataReceived(const IpAddress& ip, uint16_t port, void* buf,
         int count) override;
+    void onDatagramsReceived(Datagram* dgs, size_t count) override;
 
   private:
     EVP_CIPHER_CTX*       m_cipher_ctx  = nullptr;
@@ -9,7 +9,7 @@ file descriptor, a signal is emitted.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2022 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -125,7 +125,8 @@ class FdWatch : public sigc::trackable
     typedef enum
     { 
       FD_WATCH_RD,  ///< File descriptor watch for incoming data
-      FD_WATCH_WR   ///< File descriptor watch for outgoing data
+      FD_WATCH_WR,  ///< File descriptor watch for outgoing data
+      FD_WATCH_PRI  ///< File descriptor watch for exceptional conditions
     } FdWatchType;
     
     /**
@@ -140,8 +141,10 @@ class FdWatch : public sigc::trackable
      * @brief Constructor
      *
      * Add the given file descriptor to the watch list and watch it for
-     * incoming data (FD_WATCH_RD) or write buffer space available
-     * (FD_WATCH_WR).
+     * incoming data (FD_WATCH_RD), write buffer space available
+     * (FD_WATCH_WR) or exceptional conditions (FD_WATCH_PRI). The latter is
+     * for example used by sysfs files, like GPIO pins, to signal that the
+     * value has changed.
      * @param fd    The file descriptor to watch
      * @param type  The type of watch to create (see @ref FdWatchType)
      */
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <cstring>
 #include <cerrno>
+#include <cassert>
 
 
 /****************************************************************************
@@ -116,10 +117,6 @@ FramedTcpConnection::FramedTcpConnection(size_t recv_buf_len)
   : TcpConnection(recv_buf_len), m_max_rx_frame_size(DEFAULT_MAX_FRAME_SIZE),
     m_max_tx_frame_size(DEFAULT_MAX_FRAME_SIZE), m_size_received(false)
 {
-#if 0
-  TcpConnection::sendBufferFull.connect(
-      sigc::mem_fun(*this, &FramedTcpConnection::onSendBufferFull));
-#endif
 } /* FramedTcpConnection::FramedTcpConnection */
 
 
@@ -130,20 +127,11 @@ FramedTcpConnection::FramedTcpConnection(
     m_max_rx_frame_size(DEFAULT_MAX_FRAME_SIZE),
     m_max_tx_frame_size(DEFAULT_MAX_FRAME_SIZE), m_size_received(false)
 {
-#if 0
-  TcpConnection::sendBufferFull.connect(
-      sigc::mem_fun(*this, &FramedTcpConnection::onSendBufferFull));
-#endif
 } /* FramedTcpConnection::FramedTcpConnection */
 
 
 FramedTcpConnection::~FramedTcpConnection(void)
 {
-  for (auto& item : m_txq)
-  {
-    delete item;
-  }
-  m_txq.clear();
 } /* FramedTcpConnection::~FramedTcpConnection */
 
 
@@ -169,13 +157,24 @@ TcpConnection& FramedTcpConnection::operator=(TcpConnection&& other_base)
   m_frame.swap(other.m_frame);
   other.m_frame.clear();
 
-  m_txq.swap(other.m_txq);
-  other.m_txq.clear();
+  m_tx_frames = other.m_tx_frames;
+  other.m_tx_frames = 0;
 
   return *this;
 } /* FramedTcpConnection::operator=(TcpConnection&&) */
 
 
+FramedTcpConnection::Frame FramedTcpConnection::makeFrame(const void *buf,
+                                                          int count)
+{
+  assert(count >= 0);
+  auto frame = std::make_shared<std::vector<uint8_t>>(4 + count);
+  putFrameSize(frame->data(), count);
+  std::memcpy(frame->data() + 4, buf, count);
+  return frame;
+} /* FramedTcpConnection::makeFrame */
+
+
 int FramedTcpConnection::write(const void *buf, int count)
 {
   //cout << "### FramedTcpConnection::write: count=" << count << "\n";
@@ -189,59 +188,46 @@ int FramedTcpConnection::write(const void *buf, int count)
     return -1;
   }
 
-  QueueItem *qi = new QueueItem(buf, count);
-  if (m_txq.empty())
+    // The header and the payload is written in one go so that a TLS
+    // connection only create one record per frame. The buffer is reused so
+    // no memory is allocated in the normal case.
+  m_tx_buf.resize(4 + count);
+  putFrameSize(m_tx_buf.data(), count);
+  std::memcpy(m_tx_buf.data() + 4, buf, count);
+  if (TcpConnection::write(m_tx_buf.data(), m_tx_buf.size()) < 0)
   {
-    int ret = TcpConnection::write(qi->m_buf, qi->m_size);
-    //cout << "###   count=" << (qi->m_size-qi->m_pos) << " ret=" << ret << endl;
-    if (ret < 0)
-    {
-      delete qi;
-      qi = 0;
-      return -1;
-    }
-    if (ret >= qi->m_size)
-    {
-      delete qi;
-      qi = 0;
-    }
-    else
-    {
-      //cout << "### Not all bytes were sent: count=" << count
-      //     << " ret=" << ret << endl;
-      qi->m_pos += ret;
-    }
+    return -1;
   }
+  m_tx_frames += 1;
+  return count;
+} /* FramedTcpConnection::write */
+
 
-  if (qi != 0)
+int FramedTcpConnection::write(const Frame& frame)
+{
+  assert(frame->size() >= 4);
+  const uint32_t count = frame->size() - 4;
+  if (count > m_max_tx_frame_size)
   {
-    m_txq.push_back(qi);
+    errno = EMSGSIZE;
+    return -1;
   }
-
+  if (TcpConnection::write(frame->data(), frame->size()) < 0)
+  {
+    return -1;
+  }
+  m_tx_frames += 1;
   return count;
 } /* FramedTcpConnection::write */
 
 
+
 /****************************************************************************
  *
  * Protected member functions
  *
  ****************************************************************************/
 
-void FramedTcpConnection::closeConnection(void)
-{
-  disconnectCleanup();
-  TcpConnection::closeConnection();
-} /* FramedTcpConnection::closeConnection */
-
-
-void FramedTcpConnection::onDisconnected(DisconnectReason reason)
-{
-  disconnectCleanup();
-  TcpConnection::onDisconnected(reason);
-} /* FramedTcpConnection::onDisconnected */
-
-
 int FramedTcpConnection::onDataReceived(void *buf, int count)
 {
   int orig_count = count;
@@ -296,44 +282,13 @@ int FramedTcpConnection::onDataReceived(void *buf, int count)
  *
  ****************************************************************************/
 
-#if 0
-void FramedTcpConnection::onSendBufferFull(bool is_full)
-{
-  //cout << "### FramedTcpConnection::onSendBufferFull: is_full="
-  //     << is_full << "\n";
-  if (!is_full)
-  {
-    while (!m_txq.empty())
-    {
-      QueueItem *qi = m_txq.front();
-      int ret = TcpConnection::write(qi->m_buf+qi->m_pos, qi->m_size-qi->m_pos);
-      //cout << "###   count=" << (qi->m_size-qi->m_pos) << " ret=" << ret << endl;
-      if (ret <= 0)
-      {
-        return;
-      }
-      qi->m_pos += ret;
-      if (qi->m_pos < qi->m_size)
-      {
-        break;
-      }
-      m_txq.pop_front();
-      delete qi;
-      qi = 0;
-    }
-  }
-} /* FramedTcpConnection::onSendBufferFull */
-#endif
-
-
-void FramedTcpConnection::disconnectCleanup(void)
+void FramedTcpConnection::putFrameSize(uint8_t* ptr, uint32_t count)
 {
-  for (TxQueue::iterator it = m_txq.begin(); it != m_txq.end(); ++it)
-  {
-    delete *it;
-  }
-  m_txq.clear();
-} /* FramedTcpConnection::disconnectCleanup */
+  *ptr++ = count >> 24;
+  *ptr++ = (count >> 16) & 0xff;
+  *ptr++ = (count >> 8) & 0xff;
+  *ptr++ = count & 0xff;
+} /* FramedTcpConnection::putFrameSize */
 
 
 /*
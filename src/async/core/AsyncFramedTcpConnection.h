@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2024 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -45,8 +45,7 @@ An example of how to use the FramedTcpConnection class in a server
 
 #include <stdint.h>
 #include <vector>
-#include <deque>
-#include <cstring>
+#include <memory>
 
 
 /****************************************************************************
@@ -131,6 +130,22 @@ that only want to see completely transfered messages at the other end.
 class FramedTcpConnection : public TcpConnection
 {
   public:
+    /**
+     * @brief   A frame, including the length header, that can be shared
+     *
+     * A frame is immutable so the same frame can be written to any number of
+     * connections without being copied or formatted again.
+     */
+    using Frame = std::shared_ptr<const std::vector<uint8_t>>;
+
+    /**
+     * @brief   Create a frame that can be written to many connections
+     * @param   buf The buffer containing the frame payload
+     * @param   count The number of bytes in the payload
+     * @return  Returns the new frame
+     */
+    static Frame makeFrame(const void *buf, int count);
+
     /**
      * @brief 	Constructor
      * @param 	recv_buf_len  The length of the receiver buffer to use
@@ -219,6 +234,26 @@ class FramedTcpConnection : public TcpConnection
      */
     virtual int write(const void *buf, int count) override;
 
+    /**
+     * @brief   Send a shared frame on the TCP connection
+     * @param   frame The frame to send, created using makeFrame
+     * @return  Return the payload size or -1 on failure
+     *
+     * This function works like the write function above but the frame is
+     * already formatted so it is handed to the connection as is. Use it
+     * when sending the same frame to many connections.
+     */
+    int write(const Frame& frame);
+
+    /**
+     * @brief   Get the number of frames written to this connection
+     * @return  Returns the number of frames written
+     *
+     * Use the sendBufferSize function to find out how much of the written
+     * data that is still waiting to be sent.
+     */
+    uint64_t txFrames(void) const { return m_tx_frames; }
+
     /**
      * @brief 	A signal that is emitted when a connection has been terminated
      * @param 	con   	The connection object
@@ -243,23 +278,6 @@ class FramedTcpConnection : public TcpConnection
 
     FramedTcpConnection& operator=(const FramedTcpConnection&) = delete;
 
-    /**
-     * @brief   Disconnect from the remote peer
-     *
-     * This function is used internally to close the connection to the remote
-     * peer.
-     */
-    virtual void closeConnection(void) override;
-
-    /**
-     * @brief 	Called when a connection has been terminated
-     * @param 	reason  The reason for the disconnect
-     *
-     * This function will be called when the connection has been terminated.
-     * The default action for this function is to emit the disconnected signal.
-     */
-    virtual void onDisconnected(DisconnectReason reason) override;
-
     /**
      * @brief 	Called when data has been received on the connection
      * @param 	buf   A buffer containg the read data
@@ -289,37 +307,16 @@ class FramedTcpConnection : public TcpConnection
   private:
     static const uint32_t DEFAULT_MAX_FRAME_SIZE = 1024 * 1024; // 1MB
 
-    struct QueueItem
-    {
-      char* m_buf;
-      int   m_size;
-      int   m_pos;
-
-      QueueItem(const void* buf, int count)
-        : m_buf(0), m_size(4+count), m_pos(0)
-      {
-        m_buf = new char[4+count];
-        char *ptr = m_buf;
-        *ptr++ = static_cast<uint32_t>(count) >> 24;
-        *ptr++ = (static_cast<uint32_t>(count) >> 16) & 0xff;
-        *ptr++ = (static_cast<uint32_t>(count) >> 8) & 0xff;
-        *ptr++ = (static_cast<uint32_t>(count)) & 0xff;
-        std::memcpy(ptr, buf, count);
-      }
-      ~QueueItem(void) { delete [] m_buf; }
-    };
-    typedef std::deque<QueueItem*> TxQueue;
-
     uint32_t              m_max_rx_frame_size;
     uint32_t              m_max_tx_frame_size;
     bool                  m_size_received;
     uint32_t              m_frame_size;
     std::vector<uint8_t>  m_frame;
-    TxQueue               m_txq;
+    std::vector<uint8_t>  m_tx_buf;
+    uint64_t              m_tx_frames = 0;
 
     FramedTcpConnection(const FramedTcpConnection&) = delete;
-    //void onSendBufferFull(bool is_full);
-    void disconnectCleanup(void);
+    static void putFrameSize(uint8_t* ptr, uint32_t count);
 
 };  /* class FramedTcpConnection */
 
@@ -0,0 +1,384 @@
+/**
+@file	 AsyncMetrics.cpp
+@brief   A registry of counters, gauges and histograms
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncMetrics.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+namespace {
+  std::string formatValue(double value)
+  {
+    if (std::isinf(value))
+    {
+      return (value > 0) ? "+Inf" : "-Inf";
+    }
+    if (std::isnan(value))
+    {
+      return "NaN";
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.10g", value);
+    return buf;
+  }
+
+  std::string escapeLabelValue(const std::string& value)
+  {
+    std::string escaped;
+    for (char ch : value)
+    {
+      switch (ch)
+      {
+        case '\\': escaped += "\\\\"; break;
+        case '"':  escaped += "\\\""; break;
+        case '\n': escaped += "\\n";  break;
+        default:   escaped += ch;     break;
+      }
+    }
+    return escaped;
+  }
+
+  std::string formatLabels(const Metrics::Labels& labels)
+  {
+    std::string str;
+    for (const auto& label : labels)
+    {
+      if (!str.empty())
+      {
+        str += ",";
+      }
+      str += label.first + "=\"" + escapeLabelValue(label.second) + "\"";
+    }
+    return str;
+  }
+
+  void writeSample(std::string& out, const std::string& name,
+                   const std::string& labels, const std::string& value)
+  {
+    out += name;
+    if (!labels.empty())
+    {
+      out += "{" + labels + "}";
+    }
+    out += " " + value + "\n";
+  }
+
+  void atomicAdd(std::atomic<double>& sum, double value)
+  {
+    double old_sum = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(old_sum, old_sum + value,
+                                      std::memory_order_relaxed))
+    {
+    }
+  }
+};
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+void Metrics::Counter::write(std::string& out, const std::string& name,
+                             const std::string& labels) const
+{
+  writeSample(out, name, labels, std::to_string(value()));
+} /* Metrics::Counter::write */
+
+
+void Metrics::Gauge::add(double value)
+{
+  atomicAdd(m_value, value);
+} /* Metrics::Gauge::add */
+
+
+void Metrics::Gauge::write(std::string& out, const std::string& name,
+                           const std::string& labels) const
+{
+  writeSample(out, name, labels, formatValue(value()));
+} /* Metrics::Gauge::write */
+
+
+Metrics::Histogram::Histogram(const std::vector<double>& bounds)
+  : m_bounds(bounds), m_buckets(new std::atomic<uint64_t>[bounds.size()])
+{
+  assert(std::is_sorted(m_bounds.begin(), m_bounds.end()));
+  for (size_t i=0; i<m_bounds.size(); ++i)
+  {
+    m_buckets[i] = 0;
+  }
+} /* Metrics::Histogram::Histogram */
+
+
+void Metrics::Histogram::observe(double value)
+{
+    // Each bucket count the values that are less than or equal to its bound.
+    // Values above the last bound are only counted in the total count.
+  auto it = std::lower_bound(m_bounds.begin(), m_bounds.end(), value);
+  if (it != m_bounds.end())
+  {
+    m_buckets[it - m_bounds.begin()].fetch_add(1, std::memory_order_relaxed);
+  }
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  atomicAdd(m_sum, value);
+} /* Metrics::Histogram::observe */
+
+
+void Metrics::Histogram::write(std::string& out, const std::string& name,
+                               const std::string& labels) const
+{
+  const std::string sep = labels.empty() ? "" : ",";
+  uint64_t cumulative = 0;
+  for (size_t i=0; i<m_bounds.size(); ++i)
+  {
+    cumulative += m_buckets[i].load(std::memory_order_relaxed);
+    writeSample(out, name + "_bucket",
+                labels + sep + "le=\"" + formatValue(m_bounds[i]) + "\"",
+                std::to_string(cumulative));
+  }
+  uint64_t cnt = std::max(count(), cumulative);
+  writeSample(out, name + "_bucket", labels + sep + "le=\"+Inf\"",
+              std::to_string(cnt));
+  writeSample(out, name + "_sum", labels,
+              formatValue(m_sum.load(std::memory_order_relaxed)));
+  writeSample(out, name + "_count", labels, std::to_string(cnt));
+} /* Metrics::Histogram::write */
+
+
+Metrics& Metrics::instance(void)
+{
+  static Metrics metrics;
+  return metrics;
+} /* Metrics::instance */
+
+
+std::vector<double> Metrics::exponentialBuckets(double start, double factor,
+                                                unsigned count)
+{
+  std::vector<double> bounds;
+  double bound = start;
+  for (unsigned i=0; i<count; ++i)
+  {
+    bounds.push_back(bound);
+    bound *= factor;
+  }
+  return bounds;
+} /* Metrics::exponentialBuckets */
+
+
+Metrics::Counter& Metrics::counter(const std::string& name,
+                                   const std::string& help,
+                                   const Labels& labels)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto& metric = family(name, help, TYPE_COUNTER).metrics[formatLabels(labels)];
+  if (metric == nullptr)
+  {
+    metric.reset(new Counter);
+  }
+  return static_cast<Counter&>(*metric);
+} /* Metrics::counter */
+
+
+Metrics::Gauge& Metrics::gauge(const std::string& name,
+                               const std::string& help,
+                               const Labels& labels)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto& metric = family(name, help, TYPE_GAUGE).metrics[formatLabels(labels)];
+  if (metric == nullptr)
+  {
+    metric.reset(new Gauge);
+  }
+  return static_cast<Gauge&>(*metric);
+} /* Metrics::gauge */
+
+
+Metrics::Histogram& Metrics::histogram(const std::string& name,
+                                       const std::string& help,
+                                       const std::vector<double>& bounds,
+                                       const Labels& labels)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto& metric =
+    family(name, help, TYPE_HISTOGRAM).metrics[formatLabels(labels)];
+  if (metric == nullptr)
+  {
+    metric.reset(new Histogram(bounds));
+  }
+  return static_cast<Histogram&>(*metric);
+} /* Metrics::histogram */
+
+
+std::string Metrics::exposition(void)
+{
+  collect();
+
+  std::string out;
+
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) == 0)
+  {
+    double cpu = ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+                 (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1.0e6;
+    out += "# HELP process_cpu_seconds_total "
+           "Total user and system CPU time spent in seconds\n";
+    out += "# TYPE process_cpu_seconds_total counter\n";
+    writeSample(out, "process_cpu_seconds_total", "", formatValue(cpu));
+  }
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  for (const auto& item : m_families)
+  {
+    const std::string& name = item.first;
+    const Family& family = item.second;
+    static const char* type_str[] = { "counter", "gauge", "histogram" };
+    out += "# HELP " + name + " " + family.help + "\n";
+    out += "# TYPE " + name + " " + type_str[family.type] + "\n";
+    for (const auto& metric : family.metrics)
+    {
+      metric.second->write(out, name, metric.first);
+    }
+  }
+  return out;
+} /* Metrics::exposition */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+Metrics::Family& Metrics::family(const std::string& name,
+                                 const std::string& help, Type type)
+{
+  auto it = m_families.find(name);
+  if (it == m_families.end())
+  {
+    Family& family = m_families[name];
+    family.type = type;
+    family.help = help;
+    return family;
+  }
+  assert(it->second.type == type);
+  return it->second;
+} /* Metrics::family */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,326 @@
+/**
+@file	 AsyncMetrics.h
+@brief   A registry of counters, gauges and histograms
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_METRICS_INCLUDED
+#define ASYNC_METRICS_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A registry of counters, gauges and histograms
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class keep track of metrics that can be read by a monitoring system, like
+Prometheus. A metric is created, or looked up if it already exist, using one
+of the counter, gauge or histogram functions. That take a mutex so it should
+be done once, for example when an object is created, and the returned
+reference should be saved. Updating a metric is lock free so it is cheap and
+it can be done from any thread. Metrics are never removed from the registry
+so the references stay valid until the application exit.
+
+The exposition function return all metrics in the Prometheus text format.
+Async::MetricsHttpServer can be used to serve them over HTTP.
+
+\code
+static auto& rx_packets = Metrics::instance().counter(
+    "myapp_rx_packets_total", "Number of received packets");
+rx_packets.inc();
+\endcode
+*/
+class Metrics
+{
+  public:
+    using Labels = std::map<std::string, std::string>;
+
+    /**
+     * @brief   The base class for all metrics
+     */
+    class Metric
+    {
+      public:
+        virtual ~Metric(void) {}
+
+        /**
+         * @brief   Write the metric in Prometheus text format
+         * @param   out The string to append to
+         * @param   name The name of the metric
+         * @param   labels The formatted labels, without braces
+         */
+        virtual void write(std::string& out, const std::string& name,
+                           const std::string& labels) const = 0;
+    };
+
+    /**
+     * @brief   A counter that can only increase
+     */
+    class Counter : public Metric
+    {
+      public:
+        void inc(uint64_t n=1)
+        {
+          m_value.fetch_add(n, std::memory_order_relaxed);
+        }
+        uint64_t value(void) const
+        {
+          return m_value.load(std::memory_order_relaxed);
+        }
+        void write(std::string& out, const std::string& name,
+                   const std::string& labels) const override;
+
+      private:
+        std::atomic<uint64_t> m_value {0};
+    };
+
+    /**
+     * @brief   A value that can go up and down
+     */
+    class Gauge : public Metric
+    {
+      public:
+        void set(double value)
+        {
+          m_value.store(value, std::memory_order_relaxed);
+        }
+        void add(double value);
+        double value(void) const
+        {
+          return m_value.load(std::memory_order_relaxed);
+        }
+        void write(std::string& out, const std::string& name,
+                   const std::string& labels) const override;
+
+      private:
+        std::atomic<double> m_value {0.0};
+    };
+
+    /**
+     * @brief   Count observations in buckets with fixed upper bounds
+     */
+    class Histogram : public Metric
+    {
+      public:
+        explicit Histogram(const std::vector<double>& bounds);
+        void observe(double value);
+        uint64_t count(void) const
+        {
+          return m_count.load(std::memory_order_relaxed);
+        }
+        void write(std::string& out, const std::string& name,
+                   const std::string& labels) const override;
+
+      private:
+        const std::vector<double>                 m_bounds;
+        std::unique_ptr<std::atomic<uint64_t>[]>  m_buckets;
+        std::atomic<uint64_t>                     m_count {0};
+        std::atomic<double>                       m_sum   {0.0};
+    };
+
+    /**
+     * @brief   Get the metrics registry
+     * @return  Returns the one and only metrics registry
+     */
+    static Metrics& instance(void);
+
+    /**
+     * @brief   Create bucket bounds that grow exponentially
+     * @param   start The upper bound of the first bucket
+     * @param   factor The factor between each bucket bound
+     * @param   count The number of buckets
+     * @return  Returns a vector of bucket bounds
+     */
+    static std::vector<double> exponentialBuckets(double start, double factor,
+                                                  unsigned count);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    Metrics(const Metrics&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief   Get or create a counter
+     * @param   name The name of the metric
+     * @param   help A short description of the metric
+     * @param   labels Labels that identify this instance of the metric
+     * @return  Returns a reference to the counter
+     */
+    Counter& counter(const std::string& name, const std::string& help,
+                     const Labels& labels=Labels());
+
+    /**
+     * @brief   Get or create a gauge
+     * @param   name The name of the metric
+     * @param   help A short description of the metric
+     * @param   labels Labels that identify this instance of the metric
+     * @return  Returns a reference to the gauge
+     */
+    Gauge& gauge(const std::string& name, const std::string& help,
+                 const Labels& labels=Labels());
+
+    /**
+     * @brief   Get or create a histogram
+     * @param   name The name of the metric
+     * @param   help A short description of the metric
+     * @param   bounds The upper bounds of the buckets in increasing order
+     * @param   labels Labels that identify this instance of the metric
+     * @return  Returns a reference to the histogram
+     *
+     * All histograms with the same name should use the same bucket bounds.
+     */
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& bounds,
+                         const Labels& labels=Labels());
+
+    /**
+     * @brief   Get all metrics in the Prometheus text format
+     * @return  Returns the text to serve on the metrics endpoint
+     *
+     * The collect signal is emitted before the metrics are read. This
+     * function should be called from the main thread.
+     */
+    std::string exposition(void);
+
+    /**
+     * @brief   A signal that is emitted before the metrics are read
+     *
+     * Connect to this signal to update gauges that are expensive to keep
+     * up to date all the time, like the number of connected clients.
+     */
+    sigc::signal<void()> collect;
+
+  private:
+    enum Type { TYPE_COUNTER, TYPE_GAUGE, TYPE_HISTOGRAM };
+    struct Family
+    {
+      Type                                            type;
+      std::string                                     help;
+      std::map<std::string, std::unique_ptr<Metric>>  metrics;
+    };
+
+    std::mutex                    m_mutex;
+    std::map<std::string, Family> m_families;
+
+    Metrics(void) {}
+    Family& family(const std::string& name, const std::string& help,
+                   Type type);
+
+};  /* class Metrics */
+
+
+} /* namespace */
+
+#endif /* ASYNC_METRICS_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,176 @@
+/**
+@file	 AsyncMetricsHttpServer.cpp
+@brief   A HTTP server that serve metrics to a monitoring system
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncMetrics.h"
+#include "AsyncMetricsHttpServer.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+const char* MetricsHttpServer::CONTENT_TYPE = "text/plain; version=0.0.4";
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+MetricsHttpServer::MetricsHttpServer(const std::string& port_str,
+                                     const IpAddress& bind_ip)
+  : m_server(port_str, bind_ip)
+{
+  m_server.clientConnected.connect(
+      sigc::mem_fun(*this, &MetricsHttpServer::clientConnected));
+} /* MetricsHttpServer::MetricsHttpServer */
+
+
+void MetricsHttpServer::handleRequest(HttpServerConnection* con,
+                                      HttpServerConnection::Request& req)
+{
+  HttpServerConnection::Response res;
+  if ((req.method != "GET") && (req.method != "HEAD"))
+  {
+    res.setCode(501);
+    res.setContent("text/plain", req.method + ": Method not implemented\n");
+    con->write(res);
+    return;
+  }
+
+  if (req.target != "/metrics")
+  {
+    res.setCode(404);
+    res.setContent("text/plain", "Not found!\n");
+    con->write(res);
+    return;
+  }
+
+  res.setContent(CONTENT_TYPE, Metrics::instance().exposition());
+  res.setSendContent(req.method == "GET");
+  res.setCode(200);
+  con->write(res);
+} /* MetricsHttpServer::handleRequest */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void MetricsHttpServer::clientConnected(HttpServerConnection* con)
+{
+  con->requestReceived.connect(
+      sigc::ptr_fun(&MetricsHttpServer::handleRequest));
+} /* MetricsHttpServer::clientConnected */
+
+
+
+/*
+ * This file has not been truncated
+ */
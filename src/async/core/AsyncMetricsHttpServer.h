@@ -0,0 +1,179 @@
+/**
+@file	 AsyncMetricsHttpServer.h
+@brief   A HTTP server that serve metrics to a monitoring system
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_METRICS_HTTP_SERVER_INCLUDED
+#define ASYNC_METRICS_HTTP_SERVER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTcpServer.h>
+#include <AsyncHttpServerConnection.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A HTTP server that serve metrics to a monitoring system
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class set up a HTTP server that answer GET requests for /metrics with
+the metrics from the Async::Metrics registry in the Prometheus text format.
+All other requests are answered with an error.
+
+\code
+auto metrics_server = new MetricsHttpServer("9100");
+\endcode
+*/
+class MetricsHttpServer : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The content type of the Prometheus text format
+     */
+    static const char* CONTENT_TYPE;
+
+    /**
+     * @brief   Constructor
+     * @param   port_str A port number or service name to listen to
+     * @param   bind_ip The IP to bind the server to
+     */
+    MetricsHttpServer(const std::string& port_str,
+                      const IpAddress& bind_ip=IpAddress());
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    /**
+     * @brief   Destructor
+     */
+    ~MetricsHttpServer(void) {}
+
+    /**
+     * @brief   Answer a request for metrics
+     * @param   con The connection the request was received on
+     * @param   req The received request
+     *
+     * This function can be used by applications that already have a HTTP
+     * server to answer requests for the metrics endpoint.
+     */
+    static void handleRequest(HttpServerConnection* con,
+                              HttpServerConnection::Request& req);
+
+  private:
+    TcpServer<HttpServerConnection> m_server;
+
+    void clientConnected(HttpServerConnection* con);
+
+};  /* class MetricsHttpServer */
+
+
+} /* namespace */
+
+#endif /* ASYNC_METRICS_HTTP_SERVER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
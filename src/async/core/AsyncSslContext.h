@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -37,9 +37,19 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <openssl/err.h>
 #include <openssl/pem.h>
 #include <openssl/ssl.h>
+#include <openssl/rand.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <ctime>
 
 
 /****************************************************************************
@@ -158,6 +168,21 @@ class SslContext
      */
     SslContext(SSL_CTX* ctx) : m_ctx(ctx) {}
 
+    /**
+     * @brief   The length of the session ticket key file
+     */
+    static const size_t TICKET_KEY_LEN = 80;
+
+    /**
+     * @brief   The default number of seconds a TLS session can be resumed
+     */
+    static const long SESSION_TIMEOUT = 600;
+
+    /**
+     * @brief   The default max age in seconds of a session ticket key file
+     */
+    static const time_t TICKET_KEY_MAX_AGE = 24*60*60;
+
     /**
      * @brief   Do not allow copy construction
      */
@@ -173,6 +198,7 @@ class SslContext
      */
     ~SslContext(void)
     {
+      clearSession();
       SSL_CTX_free(m_ctx);
       m_ctx = nullptr;
     }
@@ -188,6 +214,9 @@ class SslContext
     {
       if (crtfile.empty() || keyfile.empty()) return false;
 
+        // A session set up using the old certificate must not be resumed
+      clearSession();
+
         // Load certificate chain and private key files, and check consistency
       //if (SSL_CTX_use_certificate_file(
       //      m_ctx, crtfile.c_str(), SSL_FILETYPE_PEM) != 1)
@@ -235,6 +264,153 @@ class SslContext
       return m_cafile_set;
     }
 
+    /**
+     * @brief   Enable resumption of TLS sessions
+     * @param   id_ctx A string identifying the application
+     * @param   timeout The number of seconds a session can be resumed
+     *
+     * When enabled, a client side connection will save the session it get
+     * from the server so that the next connection using this context can
+     * resume it instead of doing a full handshake with certificate
+     * verification. Only the last session is saved so a context should only
+     * be used for connections to one server.
+     *
+     * On the server side, the session id context is set so that clients can
+     * resume their sessions. Use setTicketKeyFile() to be able to resume
+     * sessions after a restart.
+     *
+     * A resumed session is not verified again, so the timeout should be
+     * kept short. Within the timeout, the peer certificate of a resumed
+     * session may have expired so it should be checked by the application.
+     */
+    void enableSessionResumption(const std::string& id_ctx,
+                                 long timeout=SESSION_TIMEOUT)
+    {
+      SSL_CTX_set_session_id_context(m_ctx,
+          reinterpret_cast<const unsigned char*>(id_ctx.data()),
+          std::min(id_ctx.size(), size_t(SSL_MAX_SID_CTX_LENGTH)));
+      SSL_CTX_set_session_cache_mode(m_ctx, SSL_SESS_CACHE_BOTH);
+      SSL_CTX_set_timeout(m_ctx, timeout);
+      SSL_CTX_set_app_data(m_ctx, this);
+      SSL_CTX_sess_set_new_cb(m_ctx, newSessionCallback);
+    } /* enableSessionResumption */
+
+    /**
+     * @brief   Set the file containing the session ticket encryption keys
+     * @param   keyfile The path to the key file
+     * @param   max_age The max age of the key in seconds
+     * @return  Returns \em true on success
+     *
+     * Session tickets are encrypted by the server using a key that normally
+     * is generated when the context is created, which mean that no sessions
+     * can be resumed after a restart. Using this function the key is instead
+     * read from the given file. If the file does not exist or if it is older
+     * than max_age, a new random key is generated and written to the file.
+     * Call this function periodically to rotate the key while running.
+     * Sessions using tickets encrypted with the old key will then need a full
+     * handshake. The file must be kept secret.
+     */
+    bool setTicketKeyFile(const std::string& keyfile,
+                          time_t max_age=TICKET_KEY_MAX_AGE)
+    {
+      std::vector<unsigned char> keys(TICKET_KEY_LEN);
+      struct stat st;
+      if ((::stat(keyfile.c_str(), &st) == 0) &&
+          (std::time(NULL) - st.st_mtime < max_age))
+      {
+        std::ifstream is(keyfile, std::ios::binary);
+        if (!is.read(reinterpret_cast<char*>(keys.data()), keys.size()))
+        {
+          std::cerr << "*** ERROR: The session ticket key file '" << keyfile
+                    << "' is not valid" << std::endl;
+          return false;
+        }
+      }
+      else
+      {
+        if (RAND_bytes(keys.data(), keys.size()) != 1)
+        {
+          sslPrintErrors("RAND_bytes");
+          return false;
+        }
+          // Write the new key to a temporary file which then replace the
+          // old file so that the key file is never only partially written
+        const std::string tmpfile = keyfile + ".new";
+        int fd = ::open(tmpfile.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0600);
+        bool ok = (fd >= 0) &&
+                  (::write(fd, keys.data(), keys.size()) ==
+                   static_cast<ssize_t>(keys.size()));
+        if (fd >= 0)
+        {
+          ok = (::close(fd) == 0) && ok;
+        }
+        if (!ok || (std::rename(tmpfile.c_str(), keyfile.c_str()) != 0))
+        {
+          std::cerr << "*** ERROR: Could not write session ticket key file '"
+                    << keyfile << "'" << std::endl;
+          ::unlink(tmpfile.c_str());
+          return false;
+        }
+      }
+      if (SSL_CTX_set_tlsext_ticket_keys(m_ctx, keys.data(),
+                                         keys.size()) != 1)
+      {
+        sslPrintErrors("SSL_CTX_set_tlsext_ticket_keys");
+        return false;
+      }
+      return true;
+    } /* setTicketKeyFile */
+
+    /**
+     * @brief   Get the saved client session
+     * @return  Returns the session to resume or nullptr if there is none
+     */
+    SSL_SESSION* session(void) const { return m_session; }
+
+    /**
+     * @brief   Forget the saved client session
+     *
+     * The next connection using this context will do a full handshake.
+     */
+    void clearSession(void)
+    {
+      SSL_SESSION_free(m_session);
+      m_session = nullptr;
+    }
+
+    /**
+     * @brief   Count a finished handshake
+     * @param   resumed Set to \em true if a session was resumed
+     *
+     * This function is called by the connection when a handshake is done.
+     */
+    void handshakeDone(bool resumed)
+    {
+      if (resumed)
+      {
+        m_resumed_handshakes += 1;
+      }
+      else
+      {
+        m_full_handshakes += 1;
+      }
+    }
+
+    /**
+     * @brief   Get the number of full handshakes done using this context
+     * @return  Returns the number of full handshakes
+     */
+    unsigned long fullHandshakes(void) const { return m_full_handshakes; }
+
+    /**
+     * @brief   Get the number of resumed sessions using this context
+     * @return  Returns the number of handshakes where a session was resumed
+     */
+    unsigned long resumedHandshakes(void) const
+    {
+      return m_resumed_handshakes;
+    }
+
     /**
      * @brief   Cast to pointer to SSL_CTX
      * @return  Returns a pointer to the internal SSL_CTX
@@ -245,8 +421,28 @@ class SslContext
   protected:
 
   private:
-    SSL_CTX*  m_ctx         = nullptr;
-    bool      m_cafile_set  = false;
+    SSL_CTX*      m_ctx                 = nullptr;
+    bool          m_cafile_set          = false;
+    SSL_SESSION*  m_session             = nullptr;
+    unsigned long m_full_handshakes     = 0;
+    unsigned long m_resumed_handshakes  = 0;
+
+    static int newSessionCallback(SSL* ssl, SSL_SESSION* session)
+    {
+      if (SSL_is_server(ssl))
+      {
+        return 0;
+      }
+      auto self = reinterpret_cast<SslContext*>(
+          SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+      if ((self == nullptr) || !SSL_SESSION_is_resumable(session))
+      {
+        return 0;
+      }
+      self->clearSession();
+      self->m_session = session;
+      return 1;
+    }
 
     static void initializeGlobals(void)
     {
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -892,6 +892,16 @@ class SslX509
       return chk > 0;
     }
 
+    /**
+     * @brief   Check if this certificate may be used for the given purpose
+     * @param   purpose The purpose, e.g. X509_PURPOSE_SSL_CLIENT
+     * @return  Returns \em true if the certificate is valid for the purpose
+     */
+    bool checkPurpose(int purpose) const
+    {
+      return X509_check_purpose(m_cert, purpose, 0) == 1;
+    }
+
     /**
      * @brief   Check if the given IP address match this certificate
      * @param   ip The IP address to match against
@@ -9,7 +9,7 @@ to a remote host. See usage instructions in the class definition.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -203,6 +203,10 @@ TcpConnection& TcpConnection::operator=(TcpConnection&& other)
   m_write_buf = std::move(other.m_write_buf);
   other.m_write_buf.clear();
   other.m_write_buf.reserve(m_write_buf.capacity());
+  m_write_pos = other.m_write_pos;
+  other.m_write_pos = 0;
+  m_max_write_buf_size = other.m_max_write_buf_size;
+  other.m_max_write_buf_size = 0;
 
   m_ssl_ctx = other.m_ssl_ctx;
   other.m_ssl_ctx = nullptr;
@@ -269,6 +273,10 @@ void TcpConnection::enableSsl(bool enable)
     {
       //SSL_set_tlsext_host_name(m_ssl, "svxreflector.example.com");
       SSL_set_connect_state(m_ssl);
+      if (m_ssl_ctx->session() != nullptr)
+      {
+        SSL_set_session(m_ssl, m_ssl_ctx->session());
+      }
       auto ret = sslDoHandshake();
       assert(ret != SSLSTATUS_FAIL);
     }
@@ -303,7 +311,7 @@ void TcpConnection::freeze(void)
 void TcpConnection::unfreeze(void)
 {
   m_freezed = false;
-  m_wr_watch.setEnabled(!m_write_buf.empty());
+  m_wr_watch.setEnabled(m_write_pos < m_write_buf.size());
   processRecvBuf();
 } /* TcpConnection::unfreeze */
 
@@ -435,6 +443,7 @@ void TcpConnection::closeConnection(void)
 {
   m_recv_buf.clear();
   m_write_buf.clear();
+  m_write_pos = 0;
   m_ssl_encrypt_buf.clear();
 
   m_wr_watch.setEnabled(false);
@@ -443,6 +452,12 @@ void TcpConnection::closeConnection(void)
   if (m_ssl != nullptr)
   {
     ssl_con_map.erase(m_ssl);
+      // Mark the connection as shut down without sending anything. If not,
+      // OpenSSL will not allow the session to be resumed.
+    if (SSL_is_init_finished(m_ssl))
+    {
+      SSL_set_shutdown(m_ssl, SSL_SENT_SHUTDOWN|SSL_RECEIVED_SHUTDOWN);
+    }
     SSL_free(m_ssl);
     m_ssl = nullptr;
   }
@@ -563,31 +578,39 @@ void TcpConnection::processRecvBuf(void)
 
 void TcpConnection::addToWriteBuf(const char *buf, size_t len)
 {
+    // Sent data is removed from the front of the buffer when it make up at
+    // least half of the buffer so that each byte is moved at most once
+  if ((m_write_pos > 0) && (2 * m_write_pos >= m_write_buf.size()))
+  {
+    m_write_buf.erase(m_write_buf.begin(), m_write_buf.begin() + m_write_pos);
+    m_write_pos = 0;
+  }
   m_write_buf.insert(m_write_buf.end(), buf, buf+len);
-  m_wr_watch.setEnabled(!m_freezed && !m_write_buf.empty());
+  m_max_write_buf_size = std::max(m_max_write_buf_size, sendBufferSize());
+  m_wr_watch.setEnabled(!m_freezed && (m_write_pos < m_write_buf.size()));
 } /* TcpConnection::addToWriteBuf */
 
 
 void TcpConnection::onWriteSpaceAvailable(Async::FdWatch* w)
 {
-  ssize_t n = rawWrite(m_write_buf.data(), m_write_buf.size());
+  const size_t pending = m_write_buf.size() - m_write_pos;
+  ssize_t n = rawWrite(m_write_buf.data() + m_write_pos, pending);
   //std::cout << "### TcpConnection::onWriteSpaceAvailabe:"
   //          << "  fd=" << w->fd()
   //          << "  n=" << n
-  //          << "  bufsize=" << m_write_buf.size()
+  //          << "  bufsize=" << pending
   //          << std::endl;
-  assert(n <= static_cast<ssize_t>(m_write_buf.size()));
+  assert(n <= static_cast<ssize_t>(pending));
   if (n >= 0)
   {
-    if (n == static_cast<ssize_t>(m_write_buf.size()))
+    if (n == static_cast<ssize_t>(pending))
     {
       m_write_buf.clear();
+      m_write_pos = 0;
     }
-    else if (n > 0)
+    else
     {
-      std::rotate(m_write_buf.begin(), m_write_buf.begin() + n,
-                  m_write_buf.end());
-      m_write_buf.resize(m_write_buf.size() - n);
+      m_write_pos += n;
     }
   }
   else
@@ -599,7 +622,7 @@ void TcpConnection::onWriteSpaceAvailable(Async::FdWatch* w)
     onDisconnected(DR_SYSTEM_ERROR);
     return;
   }
-  w->setEnabled(!m_write_buf.empty());
+  w->setEnabled(m_write_pos < m_write_buf.size());
 } /* TcpConnection::onWriteSpaceAvailable */
 
 
@@ -666,6 +689,12 @@ int TcpConnection::sslRecvHandler(char* src, int count)
       if (sslDoHandshake() == SSLSTATUS_FAIL)
       {
         SslContext::sslPrintErrors("sslDoHandshake");
+          // Do not try to resume the session again if it was the reason that
+          // the handshake failed
+        if (!m_ssl_is_server)
+        {
+          m_ssl_ctx->clearSession();
+        }
         return -1;
       }
       if ((m_ssl == nullptr) || !SSL_is_init_finished(m_ssl))
@@ -748,6 +777,7 @@ enum TcpConnection::SslStatus TcpConnection::sslDoHandshake(void)
 
   if (SSL_is_init_finished(m_ssl))
   {
+    m_ssl_ctx->handshakeDone(SSL_session_reused(m_ssl));
     sslConnectionReady(this);
     sslEncrypt();
   }
@@ -758,7 +788,6 @@ enum TcpConnection::SslStatus TcpConnection::sslDoHandshake(void)
 
 int TcpConnection::sslEncrypt(void)
 {
-  char buf[DEFAULT_BUF_SIZE];
   SslStatus status;
 
   if ((m_ssl == nullptr) || !SSL_is_init_finished(m_ssl))
@@ -786,17 +815,10 @@ int TcpConnection::sslEncrypt(void)
       }
 
       /* take the output of the SSL object and queue it for socket write */
-      do {
-        n = BIO_read(m_ssl_wr_bio, buf, sizeof(buf));
-        if (n > 0)
-        {
-          addToWriteBuf(buf, n);
-        }
-        else if (!BIO_should_retry(m_ssl_wr_bio))
-        {
-          return -1;
-        }
-      } while (n > 0);
+      if (sslReadWrBio() < 0)
+      {
+        return -1;
+      }
     }
 
     if (status == SSLSTATUS_FAIL)
@@ -813,12 +835,54 @@ int TcpConnection::sslEncrypt(void)
 } /* TcpConnection::sslEncrypt */
 
 
+int TcpConnection::sslReadWrBio(void)
+{
+  char buf[DEFAULT_BUF_SIZE];
+  int n;
+  do {
+    n = BIO_read(m_ssl_wr_bio, buf, sizeof(buf));
+    if (n > 0)
+    {
+      addToWriteBuf(buf, n);
+    }
+    else if (!BIO_should_retry(m_ssl_wr_bio))
+    {
+      return -1;
+    }
+  } while (n > 0);
+  return 0;
+} /* TcpConnection::sslReadWrBio */
+
+
 int TcpConnection::sslWrite(const void* buf, int count)
 {
+  const int orig_count = count;
   const char* ptr = reinterpret_cast<const char*>(buf);
-  m_ssl_encrypt_buf.insert(m_ssl_encrypt_buf.end(), ptr, ptr+count);
-  sslEncrypt();
-  return count;
+    // Encrypt directly from the given buffer if no earlier data is waiting.
+    // The data is only copied if it cannot be encrypted right away.
+  if (m_ssl_encrypt_buf.empty() && SSL_is_init_finished(m_ssl))
+  {
+    int n = SSL_write(m_ssl, ptr, count);
+    if (n > 0)
+    {
+      ptr += n;
+      count -= n;
+      if (sslReadWrBio() < 0)
+      {
+        return -1;
+      }
+    }
+    else if (sslGetStatus(n) == SSLSTATUS_FAIL)
+    {
+      return -1;
+    }
+  }
+  if (count > 0)
+  {
+    m_ssl_encrypt_buf.insert(m_ssl_encrypt_buf.end(), ptr, ptr+count);
+    sslEncrypt();
+  }
+  return orig_count;
 } /* TcpConnection::sslWrite */
 
 
@@ -9,7 +9,7 @@ to a remote host. See usage instructions in the class definition.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -286,6 +286,24 @@ class TcpConnection : virtual public sigc::trackable
      */
     bool isIdle(void) const { return sock == -1; }
 
+    /**
+     * @brief   Get the number of bytes waiting to be sent
+     * @return  Returns the number of buffered bytes not yet sent
+     *
+     * This is the depth of the send queue for this connection. It grows if
+     * the remote end does not read data as fast as it is written.
+     */
+    size_t sendBufferSize(void) const
+    {
+      return m_write_buf.size() - m_write_pos + m_ssl_encrypt_buf.size();
+    }
+
+    /**
+     * @brief   Get the highest number of bytes waiting to be sent
+     * @return  Returns the maximum send queue depth seen
+     */
+    size_t maxSendBufferSize(void) const { return m_max_write_buf_size; }
+
     /**
      * @brief   Enable or disable TLS for this connection
      * @param   enable Set to \em true to enable
@@ -313,6 +331,15 @@ class TcpConnection : virtual public sigc::trackable
      */
     long sslVerifyResult(void) const;
 
+    /**
+     * @brief   Check if a saved TLS session was resumed for this connection
+     * @return  Returns \em true if the handshake resumed a session
+     */
+    bool sslSessionReused(void) const
+    {
+      return (m_ssl != nullptr) && (SSL_session_reused(m_ssl) == 1);
+    }
+
     /**
      * @brief   Set the OpenSSL context to use when setting up the connection
      * @param   ctx The context object to use
@@ -522,6 +549,8 @@ class TcpConnection : virtual public sigc::trackable
     std::vector<Char> m_recv_buf;
     Async::FdWatch    m_wr_watch;
     std::vector<char> m_write_buf;
+    size_t            m_write_pos         = 0;
+    size_t            m_max_write_buf_size = 0;
 
     SslContext*       m_ssl_ctx           = nullptr;
     bool              m_ssl_is_server     = false;
@@ -550,6 +579,7 @@ class TcpConnection : virtual public sigc::trackable
     int sslRecvHandler(char* src, int count);
     SslStatus sslDoHandshake(void);
     int sslEncrypt(void);
+    int sslReadWrBio(void);
     int sslWrite(const void* buf, int count);
 
 };  /* class TcpConnection */
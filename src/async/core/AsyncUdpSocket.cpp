@@ -8,7 +8,7 @@
  *
  * \verbatim
  * Async - A library for programming event driven applications
- * Copyright (C) 2003  Tobias Blomberg
+ * Copyright (C) 2003-2026 Tobias Blomberg
  *
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -45,6 +45,9 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <vector>
+#include <memory>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -54,6 +57,7 @@
  ****************************************************************************/
 
 #include <AsyncFdWatch.h>
+#include <AsyncMetrics.h>
 
 
 /****************************************************************************
@@ -109,6 +113,90 @@ class UdpPacket
 };
 
 
+  /*
+   * A pool of preallocated receive slots used with recvmmsg. The slots are
+   * as large as the largest possible datagram. The memory is not touched
+   * until the kernel write a datagram into it.
+   */
+class UdpRecvBatch
+{
+  public:
+    static const size_t SLOT_SIZE = 65536;
+
+    std::unique_ptr<char[]>             buf;
+    std::vector<struct iovec>           iovs;
+    std::vector<struct sockaddr_in>     addrs;
+#ifdef HAS_MMSG_SUPPORT
+    std::vector<struct mmsghdr>         msgs;
+#endif
+    std::vector<UdpSocket::Datagram>    dgs;
+
+    UdpRecvBatch(unsigned slots)
+      : buf(new char[slots * SLOT_SIZE]), iovs(slots), addrs(slots),
+#ifdef HAS_MMSG_SUPPORT
+        msgs(slots),
+#endif
+        dgs(slots)
+    {
+      for (unsigned i=0; i<slots; ++i)
+      {
+        iovs[i].iov_base = buf.get() + i * SLOT_SIZE;
+        iovs[i].iov_len = SLOT_SIZE;
+      }
+    }
+};
+
+
+  /*
+   * A queue of datagrams to send using sendmmsg. The slot buffers keep their
+   * capacity between batches so no allocation is done in steady state.
+   */
+class UdpSendBatch
+{
+  public:
+    static const size_t MAX_DATAGRAMS = 64;
+
+    std::vector<std::vector<char>>      bufs;
+    std::vector<struct iovec>           iovs;
+    std::vector<struct sockaddr_in>     addrs;
+#ifdef HAS_MMSG_SUPPORT
+    std::vector<struct mmsghdr>         msgs;
+#endif
+    size_t                              queued = 0;
+    bool                                blocked = false;
+
+    UdpSendBatch(void)
+      : bufs(MAX_DATAGRAMS), iovs(MAX_DATAGRAMS), addrs(MAX_DATAGRAMS)
+#ifdef HAS_MMSG_SUPPORT
+        , msgs(MAX_DATAGRAMS)
+#endif
+    {
+    }
+
+    bool isFull(void) const { return queued >= MAX_DATAGRAMS; }
+
+    void add(const IpAddress& ip, int port, const void *buf, int len)
+    {
+      auto p = static_cast<const char*>(buf);
+      bufs[queued].assign(p, p + len);
+      struct sockaddr_in& addr = addrs[queued];
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr = ip.ip4Addr();
+      ++queued;
+    }
+
+      // Remove the first cnt datagrams, keeping the slot buffers
+    void consume(size_t cnt)
+    {
+      std::rotate(bufs.begin(), bufs.begin() + cnt, bufs.begin() + queued);
+      std::rotate(addrs.begin(), addrs.begin() + cnt, addrs.begin() + queued);
+      queued -= cnt;
+    }
+};
+
+
 /****************************************************************************
  *
  * Prototypes
@@ -132,6 +220,35 @@ class UdpPacket
  *
  ****************************************************************************/
 
+namespace {
+  struct UdpMetrics
+  {
+    Metrics::Counter& rx_packets;
+    Metrics::Counter& rx_bytes;
+    Metrics::Counter& tx_packets;
+    Metrics::Counter& tx_bytes;
+    Metrics::Counter& tx_errors;
+  };
+
+  UdpMetrics& udpMetrics(void)
+  {
+    auto& m = Metrics::instance();
+    static UdpMetrics metrics {
+      m.counter("async_udp_rx_packets_total",
+                "Number of UDP datagrams received"),
+      m.counter("async_udp_rx_bytes_total",
+                "Number of bytes received in UDP datagrams"),
+      m.counter("async_udp_tx_packets_total",
+                "Number of UDP datagrams sent"),
+      m.counter("async_udp_tx_bytes_total",
+                "Number of bytes sent in UDP datagrams"),
+      m.counter("async_udp_tx_errors_total",
+                "Number of UDP datagrams that could not be sent")
+    };
+    return metrics;
+  }
+};
+
 
 
 /****************************************************************************
@@ -153,8 +270,10 @@ class UdpPacket
  * Bugs:      
  *------------------------------------------------------------------------
  */
-UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip)
-  : sock(-1), rd_watch(0), wr_watch(0), send_buf(0)
+UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip,
+                     bool reuse_port)
+  : sock(-1), rd_watch(0), wr_watch(0), send_buf(0), recv_batch(0),
+    send_batch(0), write_batch_depth(0)
 {
     // Create UDP socket
   sock = socket(AF_INET, SOCK_DGRAM, 0);
@@ -176,6 +295,15 @@ UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip)
     // Bind the socket to a local port if one was specified
   if (local_port > 0)
   {
+    int on = 1;
+    if (reuse_port &&
+        (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == -1))
+    {
+      perror("setsockopt(SO_REUSEPORT)");
+      cleanup();
+      return;
+    }
+
     struct sockaddr_in addr;
     memset(&addr, 0, sizeof(addr));
     addr.sin_family = AF_INET;
@@ -259,6 +387,26 @@ bool UdpSocket::write(const IpAddress& remote_ip, int remote_port,
   {
     return false;
   }
+
+  if (write_batch_depth > 0)
+  {
+    if (send_batch->isFull() && !send_batch->blocked && !sendBatch())
+    {
+      wr_watch->setEnabled(true);
+      sendBufferFull(true);
+    }
+    if (send_batch->isFull())
+    {
+      return false;
+    }
+    send_batch->add(remote_ip, remote_port, buf, count);
+    return true;
+  }
+
+  if ((send_batch != 0) && send_batch->blocked)
+  {
+    return false;
+  }
   
   struct sockaddr_in addr;
   addr.sin_family = AF_INET;
@@ -278,16 +426,68 @@ bool UdpSocket::write(const IpAddress& remote_ip, int remote_port,
     else
     {
       perror("sendto in UdpSocket::write");
+      udpMetrics().tx_errors.inc();
       return false;
     }
   }
   assert(ret == count);
+  udpMetrics().tx_packets.inc();
+  udpMetrics().tx_bytes.inc(count);
   
   return true;
   
 } /* UdpSocket::write */
 
 
+bool UdpSocket::setReceiveBatchSize(unsigned slots)
+{
+  delete recv_batch;
+  recv_batch = 0;
+  if (slots <= 1)
+  {
+    return true;
+  }
+#ifdef HAS_MMSG_SUPPORT
+  recv_batch = new UdpRecvBatch(slots);
+  return true;
+#else
+  return false;
+#endif
+} /* UdpSocket::setReceiveBatchSize */
+
+
+unsigned UdpSocket::receiveBatchSize(void) const
+{
+  return (recv_batch != 0) ? recv_batch->dgs.size() : 1;
+} /* UdpSocket::receiveBatchSize */
+
+
+void UdpSocket::beginWriteBatch(void)
+{
+#ifdef HAS_MMSG_SUPPORT
+  if (send_batch == 0)
+  {
+    send_batch = new UdpSendBatch;
+  }
+  ++write_batch_depth;
+#endif
+} /* UdpSocket::beginWriteBatch */
+
+
+void UdpSocket::endWriteBatch(void)
+{
+  if (write_batch_depth == 0)
+  {
+    return;
+  }
+  if ((--write_batch_depth == 0) && !send_batch->blocked && !sendBatch())
+  {
+    wr_watch->setEnabled(true);
+    sendBufferFull(true);
+  }
+} /* UdpSocket::endWriteBatch */
+
+
 
 /****************************************************************************
  *
@@ -302,6 +502,20 @@ void UdpSocket::onDataReceived(const IpAddress& ip, uint16_t port, void* buf,
 } /* UdpSocket::onDataReceived */
 
 
+void UdpSocket::onDatagramsReceived(Datagram* dgs, size_t count)
+{
+  if (!datagramsReceived.empty())
+  {
+    datagramsReceived(dgs, count);
+    return;
+  }
+  for (size_t i=0; i<count; ++i)
+  {
+    onDataReceived(dgs[i].ip, dgs[i].port, dgs[i].buf, dgs[i].count);
+  }
+} /* UdpSocket::onDatagramsReceived */
+
+
 /****************************************************************************
  *
  * Private member functions
@@ -331,6 +545,13 @@ void UdpSocket::cleanup(void)
   
   delete send_buf;
   send_buf = 0;
+
+  delete recv_batch;
+  recv_batch = 0;
+
+  delete send_batch;
+  send_batch = 0;
+  write_batch_depth = 0;
   
   if (sock != -1)
   {
@@ -345,6 +566,12 @@ void UdpSocket::cleanup(void)
 
 void UdpSocket::handleInput(FdWatch *watch)
 {
+  if (recv_batch != 0)
+  {
+    handleBatchInput();
+    return;
+  }
+
   char buf[65536];
   struct sockaddr_in addr;
   socklen_t addr_len = sizeof(addr);
@@ -356,13 +583,66 @@ void UdpSocket::handleInput(FdWatch *watch)
     perror("recvfrom in UdpSocket::handleInput");
     return;
   }
+  udpMetrics().rx_packets.inc();
+  udpMetrics().rx_bytes.inc(len);
 
   onDataReceived(IpAddress(addr.sin_addr), ntohs(addr.sin_port), buf, len);
 } /* UdpSocket::handleInput */
 
 
+void UdpSocket::handleBatchInput(void)
+{
+#ifdef HAS_MMSG_SUPPORT
+  const size_t slots = recv_batch->msgs.size();
+  for (size_t i=0; i<slots; ++i)
+  {
+    struct msghdr& hdr = recv_batch->msgs[i].msg_hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = &recv_batch->addrs[i];
+    hdr.msg_namelen = sizeof(recv_batch->addrs[i]);
+    hdr.msg_iov = &recv_batch->iovs[i];
+    hdr.msg_iovlen = 1;
+  }
+
+  int cnt = recvmmsg(sock, recv_batch->msgs.data(), slots, MSG_DONTWAIT, 0);
+  if (cnt == -1)
+  {
+    if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+    {
+      perror("recvmmsg in UdpSocket::handleBatchInput");
+    }
+    return;
+  }
+
+  size_t bytes = 0;
+  for (int i=0; i<cnt; ++i)
+  {
+    Datagram& dg = recv_batch->dgs[i];
+    dg.ip = IpAddress(recv_batch->addrs[i].sin_addr);
+    dg.port = ntohs(recv_batch->addrs[i].sin_port);
+    dg.buf = recv_batch->iovs[i].iov_base;
+    dg.count = recv_batch->msgs[i].msg_len;
+    bytes += dg.count;
+  }
+  udpMetrics().rx_packets.inc(cnt);
+  udpMetrics().rx_bytes.inc(bytes);
+  onDatagramsReceived(recv_batch->dgs.data(), cnt);
+#endif
+} /* UdpSocket::handleBatchInput */
+
+
 void UdpSocket::sendRest(FdWatch *watch)
 {
+  if ((send_batch != 0) && send_batch->blocked)
+  {
+    if (sendBatch())
+    {
+      wr_watch->setEnabled(false);
+      sendBufferFull(false);
+    }
+    return;
+  }
+
   struct sockaddr_in addr;
   addr.sin_family = AF_INET;
   addr.sin_port = htons(send_buf->port);
@@ -383,11 +663,14 @@ void UdpSocket::sendRest(FdWatch *watch)
     else
     {
       perror("sendto in UdpSocket::sendRest");
+      udpMetrics().tx_errors.inc();
     }
   }
   else
   {
     assert(ret == send_buf->len);
+    udpMetrics().tx_packets.inc();
+    udpMetrics().tx_bytes.inc(ret);
     sendBufferFull(false);
   }
   
@@ -398,6 +681,57 @@ void UdpSocket::sendRest(FdWatch *watch)
 } /* UdpSocket::sendRest */
 
 
+  /*
+   * Send all queued datagrams. Returns false if the send buffer got full. The
+   * datagrams not sent are then kept in the queue until the socket become
+   * writable again.
+   */
+bool UdpSocket::sendBatch(void)
+{
+#ifdef HAS_MMSG_SUPPORT
+  UdpSendBatch& b = *send_batch;
+  while (b.queued > 0)
+  {
+    for (size_t i=0; i<b.queued; ++i)
+    {
+      b.iovs[i].iov_base = b.bufs[i].data();
+      b.iovs[i].iov_len = b.bufs[i].size();
+      struct msghdr& hdr = b.msgs[i].msg_hdr;
+      memset(&hdr, 0, sizeof(hdr));
+      hdr.msg_name = &b.addrs[i];
+      hdr.msg_namelen = sizeof(b.addrs[i]);
+      hdr.msg_iov = &b.iovs[i];
+      hdr.msg_iovlen = 1;
+    }
+    int cnt = sendmmsg(sock, b.msgs.data(), b.queued, 0);
+    if (cnt == -1)
+    {
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+      {
+        b.blocked = true;
+        return false;
+      }
+        // Drop the failing datagram, like write does, and send the rest
+      perror("sendmmsg in UdpSocket::sendBatch");
+      udpMetrics().tx_errors.inc();
+      b.consume(1);
+      continue;
+    }
+    size_t bytes = 0;
+    for (int i=0; i<cnt; ++i)
+    {
+      bytes += b.bufs[i].size();
+    }
+    udpMetrics().tx_packets.inc(cnt);
+    udpMetrics().tx_bytes.inc(bytes);
+    b.consume(cnt);
+  }
+  b.blocked = false;
+#endif
+  return true;
+} /* UdpSocket::sendBatch */
+
+
 
 
 
@@ -8,7 +8,7 @@ This file contains a class for communication over a UDP sockets.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2023 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -43,6 +43,7 @@ An example of how to use the Async::UdpSocket class
 
 #include <sigc++/sigc++.h>
 #include <stdint.h>
+#include <cstddef>
 
 
 /****************************************************************************
@@ -69,6 +70,8 @@ An example of how to use the Async::UdpSocket class
  ****************************************************************************/
 
 class UdpPacket;
+class UdpRecvBatch;
+class UdpSendBatch;
 
 
 /****************************************************************************
@@ -120,18 +123,38 @@ class FdWatch;
 This class is used to work with UDP sockets. An example usage is shown below.
 
 \include AsyncUdpSocket_demo.cpp
+
+To reduce the number of system calls and main loop iterations when handling
+many datagrams, both receiving and sending can be done in batches where the
+platform support it (recvmmsg/sendmmsg). Batched receive is enabled using
+setReceiveBatchSize. Batched sending is done by enclosing a number of write
+calls within beginWriteBatch and endWriteBatch.
 */
 class UdpSocket : public sigc::trackable
 {
   public:
+    /**
+     * @brief   A datagram received in a batch
+     */
+    struct Datagram
+    {
+      IpAddress ip;     ///< The IP-address the data was received from
+      uint16_t  port;   ///< The remote port number
+      void*     buf;    ///< The buffer containing the datagram
+      int       count;  ///< The number of bytes in the datagram
+    };
+
     /**
      * @brief 	Constructor
      * @param 	local_port  The local port to use. If not specified, a random
      *	      	      	    local port will be used.
      * @param  	bind_ip     Bind to the interface with the given IP address.
      *	      	            If left empty, bind to all interfaces.
+     * @param   reuse_port  Set to \em true to set the SO_REUSEPORT option so
+     *                      that more sockets can be bound to the same port
      */
-    UdpSocket(uint16_t local_port=0, const IpAddress &bind_ip=IpAddress());
+    UdpSocket(uint16_t local_port=0, const IpAddress &bind_ip=IpAddress(),
+              bool reuse_port=false);
   
     /**
      * @brief 	Destructor
@@ -171,6 +194,42 @@ class UdpSocket : public sigc::trackable
     virtual bool write(const IpAddress& remote_ip, int remote_port,
         const void *buf, int count);
 
+    /**
+     * @brief   Set the number of datagrams to receive in each read
+     * @param   slots The max number of datagrams to read at once
+     * @return  Returns \em true on success or \em false if not supported
+     *
+     * Use this function to read up to the given number of datagrams using
+     * one system call each time the socket become readable. A preallocated
+     * buffer of 64 KiB per slot is used so no datagram will be truncated.
+     * Setting slots to 0 or 1 disable batched receive. When batched receive
+     * is enabled, the socket must not be deleted from a handler connected
+     * to a receive signal.
+     */
+    bool setReceiveBatchSize(unsigned slots);
+
+    /**
+     * @brief   Get the number of datagrams received in each read
+     * @return  Returns the batch size, 1 if batched receive is disabled
+     */
+    unsigned receiveBatchSize(void) const;
+
+    /**
+     * @brief   Start a batch of writes
+     *
+     * All datagrams written until endWriteBatch is called are queued and
+     * sent using as few system calls as possible. Calls may be nested. The
+     * batch is sent when the outermost batch is ended or when the queue is
+     * full. If batched sending is not supported, each datagram is sent
+     * directly as usual.
+     */
+    void beginWriteBatch(void);
+
+    /**
+     * @brief   End a batch of writes and send all queued datagrams
+     */
+    void endWriteBatch(void);
+
     /**
      * @brief   Get the file descriptor for the UDP socket
      * @return  Returns the file descriptor associated with the socket or
@@ -186,6 +245,17 @@ class UdpSocket : public sigc::trackable
      * @param 	count The number of bytes read
      */
     sigc::signal<void(const IpAddress&, uint16_t, void*, int)> dataReceived;
+
+    /**
+     * @brief   A signal that is emitted when a batch of data has been received
+     * @param   dgs   An array of received datagrams
+     * @param   count The number of datagrams in the array
+     *
+     * This signal is only emitted when batched receive is enabled. If a slot
+     * is connected to this signal, the dataReceived signal will not be
+     * emitted for batched reads.
+     */
+    sigc::signal<void(const Datagram*, size_t)> datagramsReceived;
     
     /**
      * @brief 	A signal that is emitted when the send buffer is full
@@ -197,16 +267,22 @@ class UdpSocket : public sigc::trackable
   protected:
     virtual void onDataReceived(const IpAddress& ip, uint16_t port, void* buf,
         int count);
+    virtual void onDatagramsReceived(Datagram* dgs, size_t count);
 
   private:
-    int       	sock;
-    FdWatch * 	rd_watch;
-    FdWatch * 	wr_watch;
-    UdpPacket * send_buf;
+    int       	    sock;
+    FdWatch * 	    rd_watch;
+    FdWatch * 	    wr_watch;
+    UdpPacket *     send_buf;
+    UdpRecvBatch *  recv_batch;
+    UdpSendBatch *  send_batch;
+    unsigned        write_batch_depth;
     
     void cleanup(void);
     void handleInput(FdWatch *watch);
+    void handleBatchInput(void);
     void sendRest(FdWatch *watch);
+    bool sendBatch(void);
 
 };  /* class UdpSocket */
 
@@ -9,7 +9,7 @@
  *
  * \verbatim
  * Async - A library for programming event driven applications
- * Copyright (C) 2003-2022 Tobias Blomberg
+ * Copyright (C) 2003-2026 Tobias Blomberg
  *
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -45,6 +45,7 @@
 #include <cerrno>
 #include <cassert>
 #include <algorithm>
+#include <iomanip>
 
 
 /****************************************************************************
@@ -106,6 +107,8 @@ using namespace Async;
     }                                                                         \
   } while (0)
 
+#define clock_timertosec(a) ((a)->tv_sec + (a)->tv_nsec / 1000000000.0)
+
 
 
 
@@ -162,11 +165,19 @@ int CppApplication::sighandler_pipe[2];
  *------------------------------------------------------------------------
  */
 CppApplication::CppApplication(void)
-  : do_quit(false), max_desc(0), unix_signal_recv(-1), unix_signal_recv_cnt(0)
+  : do_quit(false), max_desc(0), unix_signal_recv(-1), unix_signal_recv_cnt(0),
+    virtual_clock(false), stats_timer_cnt(0), stats_fd_cnt(0),
+    stats_timer_cpu(0.0), stats_fd_cpu(0.0)
 {
   FD_ZERO(&rd_set);
   FD_ZERO(&wr_set);
+  FD_ZERO(&pri_set);
   sighandler_pipe[0] = sighandler_pipe[1] = -1;
+  virtual_now.tv_sec = virtual_now.tv_nsec = 0;
+  virtual_start = virtual_now;
+  stats_wall_start = virtual_now;
+  stats_cpu_start = virtual_now;
+  timerclear(&virtual_tod_start);
 } /* CppApplication::CppApplication */
 
 
@@ -207,19 +218,28 @@ void CppApplication::exec(void)
   {
     struct timespec *timeout_ptr = 0;
     struct timespec timeout;
+    bool timer_due = false;
     TimerMap::iterator titer = timer_map.begin();
     while (titer != timer_map.end())
     {
       if (titer->second != 0)
       {
 	struct timespec ts;
-	clock_gettime(CLOCK_MONOTONIC, &ts);
+	currentTime(ts);
 	clock_timersub(&titer->first, &ts, &timeout);
 	if (timeout.tv_sec < 0)
 	{
 	  timeout.tv_sec = 0;
 	  timeout.tv_nsec = 0;
 	}
+	timer_due = (timeout.tv_sec == 0) && (timeout.tv_nsec == 0);
+	if (virtual_clock)
+	{
+	    // Just poll the file descriptors. If nothing is pending, the
+	    // clock is advanced to the timer expiration time below.
+	  timeout.tv_sec = 0;
+	  timeout.tv_nsec = 0;
+	}
 	timeout_ptr = &timeout;
 	break;
       }
@@ -232,8 +252,9 @@ void CppApplication::exec(void)
     
     fd_set local_rd_set = rd_set;
     fd_set local_wr_set = wr_set;
-    int dcnt = pselect(max_desc, &local_rd_set, &local_wr_set, NULL,
-	timeout_ptr, NULL);
+    fd_set local_pri_set = pri_set;
+    int dcnt = pselect(max_desc, &local_rd_set, &local_wr_set,
+	&local_pri_set, timeout_ptr, NULL);
     if (dcnt == -1)
     {
       if ((errno == EINTR) || (errno == EAGAIN))
@@ -247,12 +268,17 @@ void CppApplication::exec(void)
       }
     }
     
-    if ((timeout_ptr != 0)
-        && ((dcnt == 0)
-            || ((timeout_ptr->tv_sec == 0) && (timeout_ptr->tv_nsec == 0))
-           )
-       )
+    if ((timeout_ptr != 0) && ((dcnt == 0) || timer_due))
     {
+      struct timespec cpu_start;
+      if (virtual_clock)
+      {
+        if (!timer_due)
+        {
+          virtual_now = titer->first;
+        }
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_start);
+      }
       titer->second->expired(titer->second);
       if ((titer->second != 0) &&
 	  (titer->second->type() == Timer::TYPE_PERIODIC))
@@ -260,8 +286,24 @@ void CppApplication::exec(void)
 	addTimerP(titer->second, titer->first);
       }
       timer_map.erase(titer);
+      if (virtual_clock)
+      {
+        struct timespec cpu_stop, cpu_diff;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_stop);
+        clock_timersub(&cpu_stop, &cpu_start, &cpu_diff);
+        stats_timer_cpu += clock_timertosec(&cpu_diff);
+        ++stats_timer_cnt;
+      }
     }
     
+    const bool measure_fd_cpu = virtual_clock && (dcnt > 0);
+    struct timespec fd_cpu_start;
+    if (measure_fd_cpu)
+    {
+      clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &fd_cpu_start);
+      stats_fd_cnt += dcnt;
+    }
+
     WatchMap::iterator witer, next_witer;
     
       /* Check for activity on the read watch file descriptors */
@@ -305,6 +347,36 @@ void CppApplication::exec(void)
       }
       witer = next_witer;
     }
+
+      /* Check for exceptional conditions on the priority watch file
+       * descriptors */
+    witer=pri_watch_map.begin();
+    while ((dcnt > 0) && (witer != pri_watch_map.end()))
+    {
+      next_witer = witer;
+      ++next_witer;
+      if (FD_ISSET(witer->first, &local_pri_set))
+      {
+	if (witer->second != 0)
+	{
+	  witer->second->activity(witer->second);
+	}
+	else
+	{
+	  pri_watch_map.erase(witer);
+	}
+	--dcnt;
+      }
+      witer = next_witer;
+    }
+
+    if (measure_fd_cpu)
+    {
+      struct timespec cpu_stop, cpu_diff;
+      clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_stop);
+      clock_timersub(&cpu_stop, &fd_cpu_start, &cpu_diff);
+      stats_fd_cpu += clock_timertosec(&cpu_diff);
+    }
     
     assert(dcnt == 0);
   }
@@ -332,6 +404,93 @@ void CppApplication::quit(void)
 } /* CppApplication::quit */
 
 
+bool CppApplication::setVirtualClock(bool enable)
+{
+  if (sighandler_pipe[0] != -1)
+  {
+    return enable == virtual_clock;
+  }
+
+  if (enable && !virtual_clock)
+  {
+    clock_gettime(CLOCK_MONOTONIC, &virtual_now);
+    virtual_start = virtual_now;
+    gettimeofday(&virtual_tod_start, NULL);
+    stats_wall_start = virtual_now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stats_cpu_start);
+    stats_timer_cnt = stats_fd_cnt = 0;
+    stats_timer_cpu = stats_fd_cpu = 0.0;
+  }
+  virtual_clock = enable;
+  return true;
+} /* CppApplication::setVirtualClock */
+
+
+void CppApplication::getTimeOfDay(struct timeval *tv) const
+{
+  if (!virtual_clock)
+  {
+    gettimeofday(tv, NULL);
+    return;
+  }
+
+  struct timespec elapsed;
+  clock_timersub(&virtual_now, &virtual_start, &elapsed);
+  struct timeval elapsed_tv;
+  elapsed_tv.tv_sec = elapsed.tv_sec;
+  elapsed_tv.tv_usec = elapsed.tv_nsec / 1000;
+  timeradd(&virtual_tod_start, &elapsed_tv, tv);
+} /* CppApplication::getTimeOfDay */
+
+
+void CppApplication::getMonotonicTime(struct timespec *ts) const
+{
+  currentTime(*ts);
+} /* CppApplication::getMonotonicTime */
+
+
+void CppApplication::printLoopStats(std::ostream& os) const
+{
+  if (!virtual_clock)
+  {
+    return;
+  }
+
+  struct timespec now, sim_time, wall_time, cpu_time;
+  clock_timersub(&virtual_now, &virtual_start, &sim_time);
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  clock_timersub(&now, &stats_wall_start, &wall_time);
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+  clock_timersub(&now, &stats_cpu_start, &cpu_time);
+
+  const double sim_sec = clock_timertosec(&sim_time);
+  const double wall_sec = clock_timertosec(&wall_time);
+  std::ios_base::fmtflags flags(os.flags());
+  os << std::fixed << std::setprecision(3);
+  os << "--- Main loop statistics (virtual clock)\n";
+  os << "  Simulated time : " << sim_sec << "s\n";
+  os << "  Wall clock time: " << wall_sec << "s";
+  if (wall_sec > 0.0)
+  {
+    os << " (" << std::setprecision(1) << (sim_sec / wall_sec)
+       << "x real time)" << std::setprecision(3);
+  }
+  os << "\n";
+  os << "  Process CPU    : " << clock_timertosec(&cpu_time) << "s\n";
+  os << "  Timer callbacks: " << stats_timer_cnt << " ("
+     << stats_timer_cpu << "s CPU)\n";
+  os << "  Fd callbacks   : " << stats_fd_cnt << " ("
+     << stats_fd_cpu << "s CPU)" << std::endl;
+  os.flags(flags);
+} /* CppApplication::printLoopStats */
+
+
+void CppApplication::printDnsStats(std::ostream& os) const
+{
+  CppDnsLookupWorker::printStats(os);
+} /* CppApplication::printDnsStats */
+
+
 void CppApplication::catchUnixSignal(int signum)
 {
   UnixSignalMap::iterator it = unix_signals.find(signum);
@@ -434,6 +593,11 @@ void CppApplication::addFdWatch(FdWatch *fd_watch)
       FD_SET(fd, &wr_set);
       watch_map = &wr_watch_map;
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      FD_SET(fd, &pri_set);
+      watch_map = &pri_watch_map;
+      break;
   }
   assert(watch_map != 0);
 
@@ -465,6 +629,11 @@ void CppApplication::delFdWatch(FdWatch *fd_watch)
       FD_CLR(fd, &wr_set);
       watch_map = &wr_watch_map;
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      FD_CLR(fd, &pri_set);
+      watch_map = &pri_watch_map;
+      break;
   }
   assert(watch_map != 0);
   
@@ -494,6 +663,16 @@ void CppApplication::delFdWatch(FdWatch *fd_watch)
         break;
       }
     }
+
+    for (riter = pri_watch_map.rbegin(); riter != pri_watch_map.rend();
+         ++riter)
+    {
+      if ((riter->second != 0) && (riter->first > max_desc))
+      {
+        max_desc = riter->first;
+        break;
+      }
+    }
     
     ++max_desc;
   }
@@ -503,7 +682,7 @@ void CppApplication::delFdWatch(FdWatch *fd_watch)
 void CppApplication::addTimer(Timer *timer)
 {
   struct timespec current;
-  clock_gettime(CLOCK_MONOTONIC, &current);
+  currentTime(current);
   addTimerP(timer, current);
 } /* CppApplication::addTimer */
 
@@ -560,6 +739,19 @@ void CppApplication::handleUnixSignal(void)
 } /* CppApplication::handleUnixSignal */
 
 
+void CppApplication::currentTime(struct timespec& ts) const
+{
+  if (virtual_clock)
+  {
+    ts = virtual_now;
+  }
+  else
+  {
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+  }
+} /* CppApplication::currentTime */
+
+
 
 /*
  * This file has not been truncated
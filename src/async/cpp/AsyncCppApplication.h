@@ -9,7 +9,7 @@
  *
  * \verbatim
  * Async - A library for programming event driven applications
- * Copyright (C) 2003-2022 Tobias Blomberg
+ * Copyright (C) 2003-2026 Tobias Blomberg
  *
  * This program is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -46,6 +46,7 @@
 
 #include <map>
 #include <utility>
+#include <ostream>
 
 
 /****************************************************************************
@@ -174,6 +175,59 @@ class CppApplication : public Application
      */
     void quit(void);
 
+    /**
+     * @brief   Enable or disable the virtual clock
+     * @param   enable Set to \em true to enable the virtual clock
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * When the virtual clock is enabled, timers are driven by simulated
+     * time. As soon as there is no file descriptor activity pending, the
+     * clock is advanced to the expiration time of the next timer without
+     * waiting. Statistics about the time spent in callbacks are also
+     * collected in this mode (see printLoopStats).
+     * The virtual clock can only be changed before the exec function has
+     * been called.
+     */
+    bool setVirtualClock(bool enable);
+
+    /**
+     * @brief   Check if the virtual clock is enabled
+     * @return  Returns \em true if the virtual clock is enabled
+     */
+    bool virtualClockEnabled(void) const { return virtual_clock; }
+
+    /**
+     * @brief   Get the current time of day as seen by the application
+     * @param   tv Will be filled in with the current time
+     */
+    void getTimeOfDay(struct timeval *tv) const;
+
+    /**
+     * @brief   Get the current monotonic time as seen by the application
+     * @param   ts Will be filled in with the current time
+     */
+    void getMonotonicTime(struct timespec *ts) const;
+
+    /**
+     * @brief   Print main loop statistics
+     * @param   os The stream to print the statistics to
+     *
+     * Print a report of simulated time, wall clock time and the CPU time
+     * spent in timer and file descriptor callbacks. The statistics are
+     * only collected when the virtual clock is enabled.
+     */
+    void printLoopStats(std::ostream& os) const;
+
+    /**
+     * @brief   Print DNS lookup statistics
+     * @param   os The stream to print the statistics to
+     *
+     * Print the number of DNS lookup requests, how many of them that were
+     * answered from the cache or merged with an identical pending query and
+     * the latency for the queries sent to the resolver.
+     */
+    void printDnsStats(std::ostream& os) const;
+
     /**
      * @brief   A signal that is emitted when a monitored UNIX signal is caught
      * @param   signum The signal number that was caught
@@ -206,12 +260,24 @@ class CppApplication : public Application
     int       	      	max_desc;
     fd_set    	      	rd_set;
     fd_set    	      	wr_set;
+    fd_set    	      	pri_set;
     WatchMap  	      	rd_watch_map;
     WatchMap  	      	wr_watch_map;
+    WatchMap  	      	pri_watch_map;
     TimerMap  	      	timer_map;
     UnixSignalMap       unix_signals;
     int                 unix_signal_recv;
     size_t              unix_signal_recv_cnt;
+    bool                virtual_clock;
+    struct timespec     virtual_now;
+    struct timespec     virtual_start;
+    struct timeval      virtual_tod_start;
+    struct timespec     stats_wall_start;
+    struct timespec     stats_cpu_start;
+    unsigned long long  stats_timer_cnt;
+    unsigned long long  stats_fd_cnt;
+    double              stats_timer_cpu;
+    double              stats_fd_cpu;
     
     static void unixSignalHandler(int signum);
 
@@ -222,6 +288,7 @@ class CppApplication : public Application
     void delTimer(Timer *timer);    
     DnsLookupWorker *newDnsLookupWorker(const DnsLookup& lookup);
     void handleUnixSignal(void);
+    void currentTime(struct timespec& ts) const;
     
 };  /* class CppApplication */
 
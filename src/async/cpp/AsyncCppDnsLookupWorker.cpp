@@ -10,7 +10,7 @@ used by Async::CppApplication to execute DNS queries.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2025 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -44,7 +44,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <cassert>
 #include <cstring>
+#include <cstdlib>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <iomanip>
+#include <limits>
 
 
 /****************************************************************************
@@ -103,7 +111,12 @@ namespace {
 #if __RES >= 19991006
       int init(void)
       {
-        return res_ninit(&m_state);
+        int rc = res_ninit(&m_state);
+        if (rc != -1)
+        {
+          overrideNameserver(m_state);
+        }
+        return rc;
       }
       int search(const char *dname, int dclass, int type,
                  unsigned char* answer, int anslen)
@@ -125,6 +138,10 @@ namespace {
         const std::lock_guard<std::mutex> lock(res_mutex);
         int rc = res_init();
         memcpy(&m_state, &_res, sizeof(m_state));
+        if (rc != -1)
+        {
+          overrideNameserver(m_state);
+        }
         return rc;
       }
       int search(const char *dname, int dclass, int type,
@@ -142,7 +159,333 @@ namespace {
 #endif
     private:
       struct __res_state m_state;
+
+        // The ASYNC_DNS_NAMESERVER environment variable can be set to
+        // "ip[:port]" to send all queries to a specific name server, e.g. a
+        // local stub resolver when testing.
+      static void overrideNameserver(struct __res_state& state)
+      {
+        const char *ns = getenv("ASYNC_DNS_NAMESERVER");
+        if ((ns == nullptr) || (*ns == '\0'))
+        {
+          return;
+        }
+        std::string ns_str(ns);
+        unsigned port = NS_DEFAULTPORT;
+        auto colon = ns_str.find(':');
+        if (colon != std::string::npos)
+        {
+          port = atoi(ns_str.c_str() + colon + 1);
+          ns_str.erase(colon);
+        }
+        struct in_addr addr;
+        if (inet_aton(ns_str.c_str(), &addr) == 0)
+        {
+          return;
+        }
+        state.nscount = 1;
+        state.nsaddr_list[0].sin_family = AF_INET;
+        state.nsaddr_list[0].sin_addr = addr;
+        state.nsaddr_list[0].sin_port = htons(port);
+      }
   };
+
+  unsigned envValue(const char *name, unsigned default_value)
+  {
+    const char *value = getenv(name);
+    if ((value == nullptr) || (*value == '\0'))
+    {
+      return default_value;
+    }
+    return atoi(value);
+  }
+};
+
+
+/*
+ * A fixed size pool of resolver threads shared by all lookup workers. Queries
+ * for the same label and type that are pending at the same time are only sent
+ * once. Answers are cached for as long as their TTL allow. Results from
+ * getaddrinfo and getnameinfo do not have a TTL so they are cached for a
+ * fixed time, set by the ASYNC_DNS_ADDRINFO_TTL environment variable. The
+ * number of threads is set by the ASYNC_DNS_THREADS environment variable.
+ * The cache is only accessed from the main thread.
+ */
+class CppDnsLookupWorker::ResolverPool
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using ContextPtr = std::shared_ptr<CppDnsLookupWorker::ThreadContext>;
+
+    static ResolverPool& instance(void)
+    {
+      static ResolverPool pool;
+      return pool;
+    }
+
+    ~ResolverPool(void)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+      }
+      m_cond.notify_all();
+      for (auto& thread : m_threads)
+      {
+        thread.join();
+      }
+      for (auto& entry : m_cache)
+      {
+        for (auto& rr : entry.second.rrs)
+        {
+          delete rr;
+        }
+      }
+    }
+
+    ContextPtr lookup(const std::string& label, DnsLookup::Type type,
+                      int notifier_wr)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const Key key(static_cast<int>(type), label);
+      auto it = m_in_flight.find(key);
+      if (it != m_in_flight.end())
+      {
+        m_coalesced += 1;
+        it->second->notifier_wrs.push_back(notifier_wr);
+        return it->second;
+      }
+
+      if (m_threads.empty())
+      {
+        unsigned thread_cnt = std::max(1U, envValue("ASYNC_DNS_THREADS", 4));
+        for (unsigned i=0; i<thread_cnt; ++i)
+        {
+          m_threads.emplace_back(&ResolverPool::threadFunc, this);
+        }
+      }
+
+      ContextPtr ctx = std::make_shared<CppDnsLookupWorker::ThreadContext>();
+      ctx->label = label;
+      ctx->type = type;
+      ctx->notifier_wrs.push_back(notifier_wr);
+      ctx->queued = Clock::now();
+      m_in_flight[key] = ctx;
+      m_queue.push_back(ctx);
+      m_cond.notify_one();
+      return ctx;
+    }
+
+    bool cancel(const ContextPtr& ctx, int notifier_wr)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto& fds = ctx->notifier_wrs;
+      auto it = std::find(fds.begin(), fds.end(), notifier_wr);
+      if (it == fds.end())
+      {
+        return false;
+      }
+      fds.erase(it);
+      return true;
+    }
+
+    bool cacheLookup(const std::string& label, DnsLookup::Type type,
+                     std::vector<DnsResourceRecord*>& rrs)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_requests += 1;
+      auto it = m_cache.find(Key(static_cast<int>(type), label));
+      if (it == m_cache.end())
+      {
+        return false;
+      }
+      const auto now = Clock::now();
+      CacheEntry& entry = it->second;
+      if (now >= entry.expires)
+      {
+        for (auto& rr : entry.rrs)
+        {
+          delete rr;
+        }
+        m_cache.erase(it);
+        return false;
+      }
+      auto age = std::chrono::duration_cast<std::chrono::seconds>(
+          now - entry.stored).count();
+      for (const auto& rr : entry.rrs)
+      {
+        DnsResourceRecord* cloned_rr = rr->clone();
+        if (cloned_rr->ttl() > age)
+        {
+          cloned_rr->setTtl(cloned_rr->ttl() - age);
+        }
+        else
+        {
+          cloned_rr->setTtl(0);
+        }
+        rrs.push_back(cloned_rr);
+      }
+      m_cache_hits += 1;
+      return true;
+    }
+
+    void cacheStore(const std::string& label, DnsLookup::Type type,
+                    const std::vector<DnsResourceRecord*>& rrs)
+    {
+      auto min_ttl = std::numeric_limits<DnsResourceRecord::Ttl>::max();
+      for (const auto& rr : rrs)
+      {
+        min_ttl = std::min(min_ttl, rr->ttl());
+      }
+      if ((type == DnsLookup::Type::A) || (type == DnsLookup::Type::PTR))
+      {
+        min_ttl = envValue("ASYNC_DNS_ADDRINFO_TTL", 30);
+      }
+      if (rrs.empty() || (min_ttl == 0))
+      {
+        return;
+      }
+
+      const auto now = Clock::now();
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_cache.size() >= MAX_CACHE_ENTRIES)
+      {
+        pruneCache(now);
+      }
+      CacheEntry& entry = m_cache[Key(static_cast<int>(type), label)];
+      for (auto& rr : entry.rrs)
+      {
+        delete rr;
+      }
+      entry.rrs.clear();
+      for (const auto& rr : rrs)
+      {
+        entry.rrs.push_back(rr->clone());
+      }
+      entry.stored = now;
+      entry.expires = now + std::chrono::seconds(min_ttl);
+    }
+
+    void printStats(std::ostream& os)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::ios_base::fmtflags flags(os.flags());
+      os << std::fixed << std::setprecision(1);
+      os << "--- DNS lookup statistics\n";
+      os << "  Requests         : " << m_requests << "\n";
+      os << "  Cache hits       : " << m_cache_hits;
+      if (m_requests > 0)
+      {
+        os << " (" << (100.0 * m_cache_hits / m_requests) << "%)";
+      }
+      os << "\n";
+      os << "  Coalesced        : " << m_coalesced << "\n";
+      os << "  Resolver queries : " << m_queries << "\n";
+      if (m_queries > 0)
+      {
+        os << "  Latency avg/max  : "
+           << (1000.0 * m_latency_sum / m_queries) << "ms / "
+           << (1000.0 * m_max_latency) << "ms\n";
+      }
+      os << "  Cache entries    : " << m_cache.size() << "\n";
+      os << "  Resolver threads : " << m_threads.size() << std::endl;
+      os.flags(flags);
+    }
+
+  private:
+    using Key = std::pair<int, std::string>;
+    struct CacheEntry
+    {
+      std::vector<DnsResourceRecord*> rrs;
+      Clock::time_point               stored;
+      Clock::time_point               expires;
+    };
+    static const size_t MAX_CACHE_ENTRIES = 1024;
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_cond;
+    std::vector<std::thread>    m_threads;
+    std::deque<ContextPtr>      m_queue;
+    std::map<Key, ContextPtr>   m_in_flight;
+    std::map<Key, CacheEntry>   m_cache;
+    bool                        m_quit          = false;
+    uint64_t                    m_requests      = 0;
+    uint64_t                    m_cache_hits    = 0;
+    uint64_t                    m_coalesced     = 0;
+    uint64_t                    m_queries       = 0;
+    double                      m_latency_sum   = 0.0;
+    double                      m_max_latency   = 0.0;
+
+    ResolverPool(void) {}
+    ResolverPool(const ResolverPool&) = delete;
+    ResolverPool& operator=(const ResolverPool&) = delete;
+
+    void threadFunc(void)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      for (;;)
+      {
+        m_cond.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+        if (m_quit)
+        {
+          break;
+        }
+        ContextPtr ctx = m_queue.front();
+        m_queue.pop_front();
+        const Key key(static_cast<int>(ctx->type), ctx->label);
+
+          // Skip the query if all lookups waiting for it have been aborted
+        if (!ctx->notifier_wrs.empty())
+        {
+          lock.unlock();
+          CppDnsLookupWorker::workerFunc(*ctx);
+          double latency = std::chrono::duration<double>(
+              Clock::now() - ctx->queued).count();
+          lock.lock();
+          m_queries += 1;
+          m_latency_sum += latency;
+          m_max_latency = std::max(m_max_latency, latency);
+        }
+
+        m_in_flight.erase(key);
+        for (int fd : ctx->notifier_wrs)
+        {
+          close(fd);
+        }
+        ctx->notifier_wrs.clear();
+      }
+    }
+
+    void pruneCache(Clock::time_point now)
+    {
+      auto oldest = m_cache.end();
+      for (auto it = m_cache.begin(); it != m_cache.end(); )
+      {
+        if (now >= it->second.expires)
+        {
+          for (auto& rr : it->second.rrs)
+          {
+            delete rr;
+          }
+          it = m_cache.erase(it);
+          continue;
+        }
+        if ((oldest == m_cache.end()) ||
+            (it->second.expires < oldest->second.expires))
+        {
+          oldest = it;
+        }
+        ++it;
+      }
+      if ((m_cache.size() >= MAX_CACHE_ENTRIES) && (oldest != m_cache.end()))
+      {
+        for (auto& rr : oldest->second.rrs)
+        {
+          delete rr;
+        }
+        m_cache.erase(oldest);
+      }
+    }
 };
 
 
@@ -199,8 +542,10 @@ DnsLookupWorker& CppDnsLookupWorker::operator=(DnsLookupWorker&& other_base)
 
   abortLookup();
 
-  m_result = std::move(other.m_result);
-  assert(!other.m_result.valid());
+  m_ctx = std::move(other.m_ctx);
+  m_cached_rrs.swap(other.m_cached_rrs);
+  m_notifier_wr = other.m_notifier_wr;
+  other.m_notifier_wr = -1;
 
   m_notifier_watch = std::move(other.m_notifier_watch);
 
@@ -208,6 +553,12 @@ DnsLookupWorker& CppDnsLookupWorker::operator=(DnsLookupWorker&& other_base)
 } /* CppDnsLookupWorker::operator=(DnsLookupWorker&&) */
 
 
+void CppDnsLookupWorker::printStats(std::ostream& os)
+{
+  ResolverPool::instance().printStats(os);
+} /* CppDnsLookupWorker::printStats */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -217,7 +568,7 @@ DnsLookupWorker& CppDnsLookupWorker::operator=(DnsLookupWorker&& other_base)
 bool CppDnsLookupWorker::doLookup(void)
 {
     // A lookup is already running
-  if (m_result.valid())
+  if (m_notifier_watch.fd() >= 0)
   {
     return true;
   }
@@ -234,13 +585,18 @@ bool CppDnsLookupWorker::doLookup(void)
   m_notifier_watch.setFd(fd[0], FdWatch::FD_WATCH_RD);
   m_notifier_watch.setEnabled(true);
 
-  m_ctx = std::unique_ptr<ThreadContext>(new ThreadContext);
-  m_ctx->label = dns().label();
-  m_ctx->type = dns().type();
-  m_ctx->notifier_wr = fd[1];
-  m_ctx->anslen = 0;
-  m_ctx->thread_cerr.clear();
-  m_result = std::async(std::launch::async, workerFunc, std::ref(*m_ctx));
+    // A cached answer is delivered through the notification pipe too, so
+    // that the result is always reported from the main loop and never from
+    // within the call to lookup.
+  auto& pool = ResolverPool::instance();
+  if (pool.cacheLookup(dns().label(), dns().type(), m_cached_rrs))
+  {
+    close(fd[1]);
+    return true;
+  }
+
+  m_notifier_wr = fd[1];
+  m_ctx = pool.lookup(dns().label(), dns().type(), m_notifier_wr);
 
   return true;
 
@@ -249,10 +605,20 @@ bool CppDnsLookupWorker::doLookup(void)
 
 void CppDnsLookupWorker::abortLookup(void)
 {
-  if (m_result.valid())
+    // The shared query is left to complete in the background. It is only
+    // the notification for this worker that is removed.
+  if ((m_ctx != nullptr) && (m_notifier_wr >= 0) &&
+      ResolverPool::instance().cancel(m_ctx, m_notifier_wr))
+  {
+    close(m_notifier_wr);
+  }
+  m_notifier_wr = -1;
+
+  for (auto& rr : m_cached_rrs)
   {
-    m_result.get();
+    delete rr;
   }
+  m_cached_rrs.clear();
 
   int fd = m_notifier_watch.fd();
   if (fd >= 0)
@@ -275,12 +641,11 @@ void CppDnsLookupWorker::abortLookup(void)
  *----------------------------------------------------------------------------
  * Method:    CppDnsLookupWorker::workerFunc
  * Purpose:   This is the function that do the actual DNS lookup. It is
- *    	      started as a separate thread since res_nsearch is a
- *    	      blocking function.
+ *    	      run in one of the resolver pool threads since res_nsearch is
+ *    	      a blocking function.
  * Input:     ctx - A context containing query and result parameters
  * Output:    The answer and anslen variables in the ThreadContext will be
- *            filled in with the lookup result. The context will be returned
- *            from this function.
+ *            filled in with the lookup result.
  * Author:    Tobias Blomberg
  * Created:   2021-07-14
  * Remarks:   
@@ -379,9 +744,6 @@ void CppDnsLookupWorker::workerFunc(CppDnsLookupWorker::ThreadContext& ctx)
               << hstrerror(h_errno) << std::endl;
     }
   }
-
-  close(ctx.notifier_wr);
-  ctx.notifier_wr = -1;
 } /* CppDnsLookupWorker::workerFunc */
 
 
@@ -406,13 +768,63 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
   assert(cnt == 0);
   close(w->fd());
   w->setFd(-1, FdWatch::FD_WATCH_RD);
+  m_notifier_wr = -1;
+
+  if (m_ctx == nullptr)
+  {
+      // The answer was found in the cache
+    for (auto& rr : m_cached_rrs)
+    {
+      addResourceRecord(rr);
+    }
+    m_cached_rrs.clear();
+    workerDone();
+    return;
+  }
+
+  std::vector<DnsResourceRecord*> rrs;
+  parseAnswer(rrs);
+
+    // The query may be shared by many workers. The first one to get here
+    // store the answer in the cache.
+  if (!lookupFailed() && !m_ctx->cached)
+  {
+    ResolverPool::instance().cacheStore(m_ctx->label, m_ctx->type, rrs);
+    m_ctx->cached = true;
+  }
+  m_ctx.reset();
+
+  for (auto& rr : rrs)
+  {
+    addResourceRecord(rr);
+  }
+  workerDone();
+} /* CppDnsLookupWorker::notificationReceived */
 
-  m_result.get();
 
+/*
+ *----------------------------------------------------------------------------
+ * Method:    CppDnsLookupWorker::parseAnswer
+ * Purpose:   Parse the result of a finished query into resource records.
+ * Input:     rrs - The vector to add the resource records to
+ * Output:    None
+ * Author:    Tobias Blomberg
+ * Created:   2026-10-18
+ * Remarks:   The answer may be shared with other workers so it must not be
+ *            modified.
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void CppDnsLookupWorker::parseAnswer(std::vector<DnsResourceRecord*>& rrs)
+{
   const std::string& thread_errstr = m_ctx->thread_cerr.str();
   if (!thread_errstr.empty())
   {
-    std::cerr << thread_errstr;
+    if (!m_ctx->errors_printed)
+    {
+      std::cerr << thread_errstr;
+      m_ctx->errors_printed = true;
+    }
     setLookupFailed();
   }
 
@@ -434,18 +846,17 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
             the_addresses.end())
         {
           the_addresses.push_back(ip_addr);
-          addResourceRecord(
+          rrs.push_back(
               new DnsResourceRecordA(m_ctx->label, 0, ip_addr));
         }
       }
-      m_ctx.reset();
     }
   }
   else if (m_ctx->type == DnsResourceRecord::Type::PTR)
   {
     if (m_ctx->host[0] != '\0')
     {
-      addResourceRecord(
+      rrs.push_back(
           new DnsResourceRecordPTR(m_ctx->label, 0, m_ctx->host));
     }
   }
@@ -453,7 +864,6 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
   {
     if (m_ctx->anslen == -1)
     {
-      workerDone();
       return;
     }
 
@@ -465,7 +875,6 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
       ss << "WARNING: ns_initparse failed (anslen=" << m_ctx->anslen << ")";
       printErrno(ss.str());
       setLookupFailed();
-      workerDone();
       return;
     }
 
@@ -503,7 +912,7 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
           struct in_addr in_addr;
           uint32_t ip = ns_get32(cp);
           in_addr.s_addr = ntohl(ip);
-          addResourceRecord(
+          rrs.push_back(
               new DnsResourceRecordA(name, ttl, IpAddress(in_addr)));
           break;
         }
@@ -522,7 +931,7 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
           size_t exp_dn_len = strlen(exp_dn);
           exp_dn[exp_dn_len] = '.';
           exp_dn[exp_dn_len+1] = 0;
-          addResourceRecord(new DnsResourceRecordPTR(name, ttl, exp_dn));
+          rrs.push_back(new DnsResourceRecordPTR(name, ttl, exp_dn));
           break;
         }
 
@@ -540,7 +949,7 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
           size_t exp_dn_len = strlen(exp_dn);
           exp_dn[exp_dn_len] = '.';
           exp_dn[exp_dn_len+1] = 0;
-          addResourceRecord(new DnsResourceRecordCNAME(name, ttl, exp_dn));
+          rrs.push_back(new DnsResourceRecordCNAME(name, ttl, exp_dn));
           break;
         }
 
@@ -564,7 +973,7 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
           size_t exp_dn_len = strlen(exp_dn);
           exp_dn[exp_dn_len] = '.';
           exp_dn[exp_dn_len+1] = 0;
-          addResourceRecord(
+          rrs.push_back(
               new DnsResourceRecordSRV(name, ttl, prio, weight, port, exp_dn));
           break;
         }
@@ -577,8 +986,7 @@ void CppDnsLookupWorker::notificationReceived(FdWatch *w)
       }
     }
   }
-  workerDone();
-} /* CppDnsLookupWorker::notificationReceived */
+} /* CppDnsLookupWorker::parseAnswer */
 
 
 void CppDnsLookupWorker::printErrno(const std::string& msg)
@@ -10,7 +10,7 @@ used by Async::CppApplication to execute DNS queries.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2023 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -45,7 +45,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <string>
 #include <sstream>
-#include <future>
+#include <memory>
+#include <vector>
+#include <chrono>
 #include <netdb.h>
 
 
@@ -145,6 +147,12 @@ class CppDnsLookupWorker : public DnsLookupWorker, public sigc::trackable
      */
     virtual DnsLookupWorker& operator=(DnsLookupWorker&& other_base);
 
+    /**
+     * @brief   Print statistics for the shared resolver pool and cache
+     * @param   os The stream to print the statistics to
+     */
+    static void printStats(std::ostream& os);
+
   protected:
     /**
      * @brief   Called by the DnsLookupWorker class to start the lookup
@@ -159,16 +167,23 @@ class CppDnsLookupWorker : public DnsLookupWorker, public sigc::trackable
     virtual void abortLookup(void);
 
   private:
+    class ResolverPool;
+
+      // A query that is shared by all lookups for the same label and type
+      // that are pending at the same time
     struct ThreadContext
     {
       std::string         label;
       DnsLookup::Type     type                = DnsLookup::Type::A;
-      int                 notifier_wr         = -1;
+      std::vector<int>    notifier_wrs;
+      std::chrono::steady_clock::time_point queued;
       unsigned char       answer[NS_MAXMSG];
       int                 anslen              = 0;
       struct addrinfo*    addrinfo            = nullptr;
       char                host[NI_MAXHOST]    = {0};
       std::ostringstream  thread_cerr;
+      bool                errors_printed      = false;
+      bool                cached              = false;
 
       ~ThreadContext(void)
       {
@@ -181,11 +196,13 @@ class CppDnsLookupWorker : public DnsLookupWorker, public sigc::trackable
     };
 
     Async::FdWatch                  m_notifier_watch;
-    std::future<void>               m_result;
-    std::unique_ptr<ThreadContext>  m_ctx;
+    int                             m_notifier_wr = -1;
+    std::shared_ptr<ThreadContext>  m_ctx;
+    std::vector<DnsResourceRecord*> m_cached_rrs;
 
     static void workerFunc(ThreadContext& ctx);
     void notificationReceived(FdWatch *w);
+    void parseAnswer(std::vector<DnsResourceRecord*>& rrs);
     void printErrno(const std::string& msg);
 
 };  /* class CppDnsLookupWorker */
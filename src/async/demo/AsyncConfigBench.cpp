@@ -0,0 +1,163 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <unistd.h>
+
+#include <AsyncConfig.h>
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark for reading configuration variables.
+ *
+ * Usage: AsyncConfigBench [sections] [variables per section] [lookups]
+ *
+ * A configuration file with the given number of sections and variables is
+ * written to a temporary file, like a large svxlink.conf with many logics
+ * and modules. The time to load the file is measured. Then the time to read
+ * integer variables is measured, first using Config::getValue, which look up
+ * and parse the value each time, and then using handles from
+ * Config::variable. Finally it's checked that the handles follow changes
+ * made using Config::setValue.
+ */
+
+namespace {
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+std::string sectionName(unsigned sec)
+{
+  return "Section" + std::to_string(sec);
+}
+
+std::string tagName(unsigned tag)
+{
+  return "VARIABLE_" + std::to_string(tag);
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned sections = 100;
+  unsigned tags = 50;
+  unsigned lookups = 1000000;
+  if (argc > 1)
+  {
+    sections = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    tags = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    lookups = atoi(argv[3]);
+  }
+  if ((sections < 1) || (tags < 1) || (lookups < 1))
+  {
+    cerr << "Usage: AsyncConfigBench [sections] [variables per section] "
+            "[lookups]\n";
+    exit(1);
+  }
+
+  char cfgfile[] = "/tmp/AsyncConfigBench.XXXXXX";
+  int fd = mkstemp(cfgfile);
+  if (fd == -1)
+  {
+    perror("mkstemp");
+    exit(1);
+  }
+  close(fd);
+  std::ofstream os(cfgfile);
+  for (unsigned sec=0; sec<sections; ++sec)
+  {
+    os << "[" << sectionName(sec) << "]\n";
+    for (unsigned tag=0; tag<tags; ++tag)
+    {
+      os << tagName(tag) << "=" << (sec * tags + tag) << "\n";
+    }
+    os << "\n";
+  }
+  os.close();
+
+  double t0 = wallTime();
+  Config cfg;
+  bool open_ok = cfg.open(cfgfile);
+  double open_time = wallTime() - t0;
+  unlink(cfgfile);
+  if (!open_ok)
+  {
+    cerr << "*** ERROR: Could not open config file " << cfgfile << endl;
+    exit(1);
+  }
+  printf("Loaded %u sections with %u variables each in %7.3f ms\n",
+         sections, tags, 1.0e3 * open_time);
+
+    // Pick the variables to read up front so that only the config lookup
+    // is measured
+  const unsigned vars = 64;
+  std::vector<std::string> sec_names;
+  std::vector<std::string> tag_names;
+  std::vector<Config::Variable<unsigned>> handles;
+  for (unsigned i=0; i<vars; ++i)
+  {
+    unsigned sec = (i * 7919) % sections;
+    unsigned tag = (i * 104729) % tags;
+    sec_names.push_back(sectionName(sec));
+    tag_names.push_back(tagName(tag));
+    handles.push_back(cfg.variable<unsigned>(sec_names[i], tag_names[i]));
+  }
+
+  unsigned long long sum_get = 0;
+  t0 = wallTime();
+  for (unsigned i=0; i<lookups; ++i)
+  {
+    unsigned val = 0;
+    cfg.getValue(sec_names[i % vars], tag_names[i % vars], val);
+    sum_get += val;
+  }
+  double get_time = wallTime() - t0;
+  printf("getValue  %u lookups in %7.3f s (%6.1f ns/lookup)\n",
+         lookups, get_time, 1.0e9 * get_time / lookups);
+
+  unsigned long long sum_var = 0;
+  t0 = wallTime();
+  for (unsigned i=0; i<lookups; ++i)
+  {
+    sum_var += handles[i % vars].value();
+  }
+  double var_time = wallTime() - t0;
+  printf("variable  %u lookups in %7.3f s (%6.1f ns/lookup)\n",
+         lookups, var_time, 1.0e9 * var_time / lookups);
+
+  bool ok = (sum_get == sum_var);
+
+    // Check that handles follow updates and variables added later
+  cfg.setValue(sec_names[0], tag_names[0], 4711u);
+  ok &= (handles[0].value() == 4711);
+  cfg.setValue(sec_names[0], tag_names[0], "not a number");
+  ok &= handles[0].isSet() && !handles[0].isValid();
+  ok &= (handles[0].value() == 0);
+  auto added = cfg.variable<unsigned>("AddedLater", "VALUE", 17u);
+  ok &= !added.isSet() && (added.value() == 17);
+  cfg.setValue("AddedLater", "VALUE", 42u);
+  ok &= added.isValid() && (added.value() == 42);
+  auto str = cfg.variable<std::string>("AddedLater", "STR");
+  cfg.setValue("AddedLater", "STR", "a string with spaces");
+  ok &= (str.value() == "a string with spaces");
+
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+} /* main */
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include <AsyncCppApplication.h>
+#include <AsyncDnsLookup.h>
+#include <AsyncUdpSocket.h>
+#include <AsyncIpAddress.h>
+#include <AsyncTimer.h>
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Demonstrate the DNS lookup cache and the coalescing of identical queries.
+ *
+ * A minimal DNS server that answer all SRV queries is started on localhost
+ * and the resolver is pointed to it using the ASYNC_DNS_NAMESERVER
+ * environment variable. A number of identical lookups are started at the
+ * same time. They should all be answered by one single query to the server.
+ * When the first round is done, a second round of lookups are made that
+ * should all be answered from the cache without any query being sent.
+ */
+
+namespace {
+const int     LOOKUPS   = 20;
+const int     DNS_PORT  = 15353;
+const char*   SRV_LABEL = "_svxreflector._tcp.test.example.org";
+};
+
+class StubDnsServer : public sigc::trackable
+{
+  public:
+    unsigned queries = 0;
+
+    StubDnsServer(void) : sock(DNS_PORT, IpAddress("127.0.0.1"))
+    {
+      sock.dataReceived.connect(mem_fun(*this, &StubDnsServer::onQuery));
+    }
+
+  private:
+    UdpSocket sock;
+
+    void onQuery(const IpAddress& addr, uint16_t port, void *buf, int count)
+    {
+      const unsigned char *q = static_cast<const unsigned char*>(buf);
+      if (count < 12)
+      {
+        return;
+      }
+      size_t qend = 12;
+      while ((qend < size_t(count)) && (q[qend] != 0))
+      {
+        qend += q[qend] + 1;
+      }
+      qend += 5; // Terminating zero, QTYPE and QCLASS
+      if (qend > size_t(count))
+      {
+        return;
+      }
+      ++queries;
+
+      std::vector<unsigned char> a(q, q + qend);
+      a[2] = 0x81; a[3] = 0x80;     // Response, RD, RA, NOERROR
+      a[6] = 0x00; a[7] = 0x01;     // ANCOUNT = 1
+      a[8] = a[9] = a[10] = a[11] = 0x00;
+      const unsigned char rr[] = {
+        0xc0, 0x0c,                 // Name pointer to the question
+        0x00, 0x21, 0x00, 0x01,     // SRV, IN
+        0x00, 0x00, 0x0e, 0x10,     // TTL 3600
+        0x00, 0x19,                 // RDLENGTH
+        0x00, 0x0a, 0x00, 0x05,     // Priority 10, weight 5
+        0x14, 0xb8,                 // Port 5304
+        0x09, 'l', 'o', 'c', 'a', 'l', 'h', 'o', 's', 't',
+        0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0x00
+      };
+      a.insert(a.end(), rr, rr + sizeof(rr));
+      sock.write(addr, port, &a[0], a.size());
+    }
+};
+
+class MyClass : public sigc::trackable
+{
+  public:
+    MyClass(StubDnsServer& server) : server(server)
+    {
+      startRound();
+    }
+
+    ~MyClass(void)
+    {
+      clearLookups();
+    }
+
+  private:
+    StubDnsServer&      server;
+    vector<DnsLookup*>  lookups;
+    int                 round = 0;
+    int                 pending = 0;
+    int                 failed = 0;
+
+    void clearLookups(void)
+    {
+      for (auto& dns : lookups)
+      {
+        delete dns;
+      }
+      lookups.clear();
+    }
+
+    void startRound(void)
+    {
+      clearLookups();
+      ++round;
+      pending = LOOKUPS;
+      failed = 0;
+      for (int i=0; i<LOOKUPS; ++i)
+      {
+        DnsLookup *dns = new DnsLookup(SRV_LABEL, DnsLookup::Type::SRV);
+        dns->resultsReady.connect(mem_fun(*this, &MyClass::onResultsReady));
+        lookups.push_back(dns);
+      }
+    }
+
+    void onResultsReady(DnsLookup& dns)
+    {
+      DnsResourceRecordSRV::List srv_rrs;
+      dns.resourceRecords(srv_rrs);
+      if (dns.lookupFailed() || srv_rrs.empty())
+      {
+        ++failed;
+      }
+      if (--pending > 0)
+      {
+        return;
+      }
+
+      cout << "Round " << round << ": " << LOOKUPS << " lookups, "
+           << failed << " failed, " << server.queries
+           << " queries received by the server" << endl;
+      if (failed > 0)
+      {
+        cout << "*** ERROR: Lookup failed" << endl;
+        exit(1);
+      }
+      if (round < 2)
+      {
+          // Do not delete the lookup objects from within their own signal
+        Application::app().runTask(mem_fun(*this, &MyClass::startRound));
+        return;
+      }
+
+      cout << endl;
+      static_cast<CppApplication&>(Application::app()).printDnsStats(cout);
+      if (server.queries != 1)
+      {
+        cout << "*** ERROR: Expected exactly one query to the server" << endl;
+        exit(1);
+      }
+      Application::app().quit();
+    }
+};
+
+int main(int argc, char **argv)
+{
+  CppApplication app;
+  StubDnsServer server;
+  std::string ns = std::string("127.0.0.1:") + std::to_string(DNS_PORT);
+  setenv("ASYNC_DNS_NAMESERVER", ns.c_str(), 1);
+  MyClass my_class(server);
+  Timer timeout_timer(10000);
+  timeout_timer.expired.connect([](Timer*)
+      {
+        cout << "*** ERROR: Timeout waiting for lookups" << endl;
+        exit(1);
+      });
+  app.exec();
+}
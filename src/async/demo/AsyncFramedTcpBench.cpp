@@ -0,0 +1,241 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTcpServer.h>
+#include <AsyncTcpClient.h>
+#include <AsyncFramedTcpConnection.h>
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark for broadcasting frames over many framed TCP connections.
+ *
+ * Usage: AsyncFramedTcpBench [clients] [frames] [frame size]
+ *
+ * A server and a number of clients are set up on localhost. The server send
+ * each frame to all clients, like the reflector do with control messages.
+ * This is first done by writing the frame buffer to each connection and then
+ * by creating one shared frame that is written to all connections. The time
+ * spent in the write calls and the time until all frames have been received
+ * is measured. The clients check that all frames arrive intact and in order.
+ */
+
+namespace {
+const uint16_t  PORT = 15420;
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+class Client
+{
+  public:
+    unsigned  rx_frames = 0;
+    bool      rx_ok     = true;
+    std::function<void()> rxDone;
+
+    Client(size_t frame_size) : frame_size(frame_size), cli("127.0.0.1", PORT)
+    {
+      cli.frameReceived.connect(
+          [this](FramedTcpConnection*, std::vector<uint8_t>& frame)
+          {
+            onFrameReceived(frame);
+          });
+    }
+
+    void connect(void) { cli.connect(); }
+    void expect(unsigned frames)
+    {
+      rx_frames = 0;
+      expected = frames;
+    }
+
+  private:
+    size_t                            frame_size;
+    TcpClient<FramedTcpConnection>    cli;
+    unsigned                          expected  = 0;
+
+    void onFrameReceived(std::vector<uint8_t>& frame)
+    {
+      uint32_t seq = 0;
+      if (frame.size() == frame_size)
+      {
+        memcpy(&seq, frame.data(), sizeof(seq));
+      }
+      rx_ok &= (frame.size() == frame_size) && (seq == rx_frames);
+      if (++rx_frames == expected)
+      {
+        rxDone();
+      }
+    }
+};
+
+class Server
+{
+  public:
+    std::vector<FramedTcpConnection*> cons;
+    std::function<void()> clientAccepted;
+
+    Server(void) : srv(std::to_string(PORT))
+    {
+      srv.clientConnected.connect([this](FramedTcpConnection* con)
+      {
+        cons.push_back(con);
+        clientAccepted();
+      });
+    }
+
+    size_t maxSendBufferSize(void) const
+    {
+      size_t max_size = 0;
+      for (const auto& con : cons)
+      {
+        max_size = std::max(max_size, con->maxSendBufferSize());
+      }
+      return max_size;
+    }
+
+  private:
+    TcpServer<FramedTcpConnection>    srv;
+};
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned clients = 200;
+  unsigned frames = 1000;
+  size_t frame_size = 64;
+  if (argc > 1)
+  {
+    clients = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    frames = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    frame_size = atoi(argv[3]);
+  }
+  if ((clients < 1) || (frames < 1) || (frame_size < sizeof(uint32_t)))
+  {
+    cerr << "Usage: AsyncFramedTcpBench [clients] [frames] [frame size]\n";
+    exit(1);
+  }
+
+  CppApplication app;
+
+  Server srv;
+  std::vector<Client*> cli;
+  for (unsigned i=0; i<clients; ++i)
+  {
+    cli.push_back(new Client(frame_size));
+  }
+
+  std::vector<std::function<void()>> modes;
+  size_t mode = 0;
+  unsigned rx_done = 0;
+  double t0 = 0.0;
+  double write_time = 0.0;
+  const char* mode_name = "";
+  auto start_mode = [&]()
+  {
+    if (mode >= modes.size())
+    {
+      app.quit();
+      return;
+    }
+    rx_done = 0;
+    for (auto& c : cli)
+    {
+      c->expect(frames);
+    }
+    t0 = wallTime();
+    modes[mode++]();
+    write_time = wallTime() - t0;
+  };
+  for (auto& c : cli)
+  {
+    c->rxDone = [&]()
+    {
+      if (++rx_done < clients)
+      {
+        return;
+      }
+      double total_time = wallTime() - t0;
+      printf("%-7s %u frames of %zu bytes to %u clients: "
+             "write %7.3f s (%6.0f ns/frame), delivered in %7.3f s\n",
+             mode_name, frames, frame_size, clients, write_time,
+             1.0e9 * write_time / frames / clients, total_time);
+      Application::app().runTask(start_mode);
+    };
+  }
+
+  std::vector<uint8_t> buf(frame_size, 0xa5);
+  modes.push_back([&]()
+  {
+    mode_name = "Copy";
+    for (uint32_t seq=0; seq<frames; ++seq)
+    {
+      memcpy(buf.data(), &seq, sizeof(seq));
+      for (auto& con : srv.cons)
+      {
+        con->write(buf.data(), buf.size());
+      }
+    }
+  });
+  modes.push_back([&]()
+  {
+    mode_name = "Shared";
+    for (uint32_t seq=0; seq<frames; ++seq)
+    {
+      memcpy(buf.data(), &seq, sizeof(seq));
+      auto frame = FramedTcpConnection::makeFrame(buf.data(), buf.size());
+      for (auto& con : srv.cons)
+      {
+        con->write(frame);
+      }
+    }
+  });
+
+    // The clients are connected one at a time since the listen backlog of
+    // the server is small
+  srv.clientAccepted = [&]()
+  {
+    if (srv.cons.size() < clients)
+    {
+      cli[srv.cons.size()]->connect();
+    }
+    else
+    {
+      start_mode();
+    }
+  };
+  cli.front()->connect();
+
+  app.exec();
+
+  bool ok = true;
+  for (auto& c : cli)
+  {
+    ok &= c->rx_ok;
+    delete c;
+  }
+  printf("Max send queue %zu bytes\n", srv.maxSendBufferSize());
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+} /* main */
@@ -0,0 +1,296 @@
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+
+#include <unistd.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTcpServer.h>
+#include <AsyncTcpClient.h>
+#include <AsyncSslContext.h>
+#include <AsyncSslKeypair.h>
+#include <AsyncSslX509.h>
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark TLS session resumption on localhost.
+ *
+ * Usage: AsyncSslSessionBench [clients] [window]
+ *
+ * A number of clients connect to a TLS server, do the handshake, receive one
+ * byte from the server and then disconnect. At most "window" clients are
+ * connecting at the same time. Both sides use certificates signed by a
+ * test CA, like the reflector and its nodes do. This is first done with
+ * full handshakes. Then the server is restarted using the same session
+ * ticket key file and the clients reconnect, this time resuming a saved
+ * session. The server and the clients run in the same thread so the rate
+ * include the work done on both sides.
+ */
+
+namespace {
+const uint16_t  PORT = 15410;
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+bool createCert(const std::string& dir, const std::string& name,
+                SslX509& ca_cert, SslKeypair& ca_pkey, long serial)
+{
+  SslKeypair pkey;
+  if (!pkey.generate(2048))
+  {
+    return false;
+  }
+  time_t t = time(nullptr);
+  SslX509 cert;
+  cert.setSerialNumber(serial);
+  cert.setVersion(SslX509::VERSION_3);
+  cert.setIssuerName(ca_cert.subjectName());
+  cert.addSubjectName("CN", name);
+  SslX509Extensions exts;
+  exts.addBasicConstraints("critical, CA:FALSE");
+  exts.addKeyUsage("critical, digitalSignature, keyEncipherment");
+  exts.addSubjectAltNames("IP:127.0.0.1");
+  cert.addExtensions(exts);
+  cert.setNotBefore(t);
+  cert.setNotAfter(t + 3600);
+  cert.setPublicKey(pkey);
+  cert.sign(ca_pkey);
+  return pkey.writePrivateKeyFile(dir + "/" + name + ".key") &&
+         cert.writePemFile(dir + "/" + name + ".crt");
+}
+
+bool createCerts(const std::string& dir)
+{
+  SslKeypair ca_pkey;
+  if (!ca_pkey.generate(2048))
+  {
+    return false;
+  }
+  time_t t = time(nullptr);
+  SslX509 ca_cert;
+  ca_cert.setSerialNumber(1);
+  ca_cert.setVersion(SslX509::VERSION_3);
+  ca_cert.addIssuerName("CN", "Bench CA");
+  ca_cert.setSubjectName(ca_cert.issuerName());
+  SslX509Extensions ca_exts;
+  ca_exts.addBasicConstraints("critical, CA:TRUE");
+  ca_exts.addKeyUsage("critical, cRLSign, digitalSignature, keyCertSign");
+  ca_cert.addExtensions(ca_exts);
+  ca_cert.setNotBefore(t);
+  ca_cert.setNotAfter(t + 3600);
+  ca_cert.setPublicKey(ca_pkey);
+  ca_cert.sign(ca_pkey);
+  return ca_cert.writePemFile(dir + "/ca.crt") &&
+         createCert(dir, "server", ca_cert, ca_pkey, 2) &&
+         createCert(dir, "client", ca_cert, ca_pkey, 3);
+}
+
+class Server
+{
+  public:
+    SslContext ctx;
+
+    Server(const std::string& dir) : srv(std::to_string(PORT))
+    {
+      if (!ctx.setCertificateFiles(dir + "/server.key", dir + "/server.crt") ||
+          !ctx.setCaCertificateFile(dir + "/ca.crt"))
+      {
+        exit(1);
+      }
+      ctx.enableSessionResumption("AsyncSslSessionBench");
+      if (!ctx.setTicketKeyFile(dir + "/ticket.key"))
+      {
+        exit(1);
+      }
+      srv.setSslContext(ctx);
+      srv.clientConnected.connect([](TcpConnection* con)
+      {
+        con->sslConnectionReady.connect([](TcpConnection* con)
+        {
+          con->write("K", 1);
+        });
+        con->enableSsl(true);
+      });
+    }
+
+  private:
+    TcpServer<TcpConnection> srv;
+};
+
+class Clients
+{
+  public:
+    std::function<void()> done;
+
+    Clients(SslContext& ctx, unsigned total, unsigned window)
+      : ctx(ctx), total(total), window(window)
+    {
+    }
+
+    void start(void)
+    {
+      started = 0;
+      finished = 0;
+      t0 = wallTime();
+      while ((started < total) && (started - finished < window))
+      {
+        startClient();
+      }
+    }
+
+    double elapsed(void) const { return t1 - t0; }
+
+  private:
+    SslContext& ctx;
+    unsigned    total;
+    unsigned    window;
+    unsigned    started   = 0;
+    unsigned    finished  = 0;
+    double      t0        = 0.0;
+    double      t1        = 0.0;
+
+    void startClient(void)
+    {
+      ++started;
+      auto cli = new TcpClient<TcpConnection>("127.0.0.1", PORT);
+      cli->setSslContext(ctx);
+      cli->connected.connect([cli]() { cli->enableSsl(true); });
+      cli->dataReceived.connect([this, cli](TcpConnection*, void*, int len)
+      {
+        clientDone(cli);
+        return len;
+      });
+      cli->disconnected.connect(
+          [this, cli](TcpConnection*, TcpConnection::DisconnectReason reason)
+          {
+            cerr << "*** ERROR: Client disconnected: "
+                 << TcpConnection::disconnectReasonStr(reason) << endl;
+            clientDone(cli);
+          });
+      cli->connect();
+    }
+
+    void clientDone(TcpClient<TcpConnection>* cli)
+    {
+      cli->disconnect();
+      Application::app().runTask([cli]() { delete cli; });
+      if (++finished == total)
+      {
+        t1 = wallTime();
+        done();
+      }
+      else if (started < total)
+      {
+        startClient();
+      }
+    }
+};
+
+void report(const char* name, const Clients& clients, const SslContext& ctx,
+            unsigned total)
+{
+  printf("%-8s %6u connections in %7.3f s (%8.1f handshakes/s), "
+         "full=%lu resumed=%lu\n",
+         name, total, clients.elapsed(), total / clients.elapsed(),
+         ctx.fullHandshakes(), ctx.resumedHandshakes());
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned total = 1000;
+  unsigned window = 4;
+  if (argc > 1)
+  {
+    total = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    window = atoi(argv[2]);
+  }
+  if ((total < 1) || (window < 1))
+  {
+    cerr << "Usage: AsyncSslSessionBench [clients] [window]\n";
+    exit(1);
+  }
+
+  char dir_template[] = "/tmp/AsyncSslSessionBench.XXXXXX";
+  std::string dir(mkdtemp(dir_template));
+  if (!createCerts(dir))
+  {
+    cerr << "*** ERROR: Failed to create the certificates in " << dir << endl;
+    exit(1);
+  }
+
+  CppApplication app;
+
+  SslContext full_ctx;
+  SslContext resume_ctx;
+  for (auto ctx : {&full_ctx, &resume_ctx})
+  {
+    if (!ctx->setCertificateFiles(dir + "/client.key", dir + "/client.crt") ||
+        !ctx->setCaCertificateFile(dir + "/ca.crt"))
+    {
+      exit(1);
+    }
+  }
+  resume_ctx.enableSessionResumption("AsyncSslSessionBench");
+
+  Server* srv = new Server(dir);
+  Clients full(full_ctx, total, window);
+  Clients prime(resume_ctx, 1, 1);
+  Clients resumed(resume_ctx, total, window);
+
+    // Full handshakes, then get a session to resume, then restart the
+    // server and let all clients resume that session
+  full.done = [&]()
+  {
+    report("Full", full, srv->ctx, total);
+    prime.start();
+  };
+  prime.done = [&]()
+  {
+    if (resume_ctx.session() == nullptr)
+    {
+      cerr << "*** ERROR: No session received from the server" << endl;
+      app.quit();
+      return;
+    }
+    Application::app().runTask([&]()
+    {
+      delete srv;
+      srv = new Server(dir);
+      resumed.start();
+    });
+  };
+  resumed.done = [&]()
+  {
+    report("Resumed", resumed, srv->ctx, total);
+    Application::app().runTask([&]() { app.quit(); });
+  };
+  full.start();
+
+  app.exec();
+
+  delete srv;
+  for (const char* f : {"ca.crt", "server.key", "server.crt", "client.key",
+                        "client.crt", "ticket.key"})
+  {
+    unlink((dir + "/" + f).c_str());
+  }
+  rmdir(dir.c_str());
+
+  return 0;
+} /* main */
@@ -0,0 +1,207 @@
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+
+#include <AsyncCppApplication.h>
+#include <AsyncUdpSocket.h>
+#include <AsyncIpAddress.h>
+#include <AsyncTimer.h>
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark the packet rate of Async::UdpSocket on localhost.
+ *
+ * Usage: AsyncUdpSocketBench [datagrams] [burst]
+ *
+ * A sender socket write bursts of datagrams to a receiver socket. A new
+ * burst is started in the next main loop iteration when all datagrams in
+ * the previous burst have been received. This is run with one system call
+ * per datagram, as it has always been done, and with batched receive and
+ * send. The datagram size is about the size of a reflector audio packet.
+ */
+
+namespace {
+const int       RX_PORT       = 15400;
+const int       DATAGRAM_SIZE = 180;
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+class Bench : public sigc::trackable
+{
+  public:
+    Bench(bool batch, unsigned total, unsigned burst)
+      : rx(RX_PORT, IpAddress("127.0.0.1")), batch(batch), total(total),
+        burst(burst), payload(DATAGRAM_SIZE, 0x55), stall_timer(2000)
+    {
+      rx.dataReceived.connect(mem_fun(*this, &Bench::onDataReceived));
+      if (batch)
+      {
+        if (!rx.setReceiveBatchSize(burst))
+        {
+          cout << "*** WARNING: Batched receive not supported" << endl;
+        }
+        rx.datagramsReceived.connect(
+            mem_fun(*this, &Bench::onDatagramsReceived));
+      }
+      stall_timer.expired.connect(mem_fun(*this, &Bench::onStall));
+    }
+
+    sigc::signal<void()> done;
+
+    void start(void)
+    {
+      start_time = wallTime();
+      sendBurst();
+    }
+
+    double elapsed(void) const { return end_time - start_time; }
+    unsigned received(void) const { return rcvd; }
+    unsigned wakeups(void) const { return rx_wakeups; }
+    bool stalled(void) const { return is_stalled; }
+
+  private:
+    UdpSocket       rx;
+    UdpSocket       tx;
+    bool            batch;
+    unsigned        total;
+    unsigned        burst;
+    vector<char>    payload;
+    Timer           stall_timer;
+    double          start_time = 0.0;
+    double          end_time = 0.0;
+    unsigned        sent = 0;
+    unsigned        rcvd = 0;
+    unsigned        rx_wakeups = 0;
+    bool            is_stalled = false;
+
+    void sendBurst(void)
+    {
+      if (batch)
+      {
+        tx.beginWriteBatch();
+      }
+      for (unsigned i=0; (i<burst) && (sent<total); ++i, ++sent)
+      {
+        tx.write(IpAddress("127.0.0.1"), RX_PORT, &payload[0], payload.size());
+      }
+      if (batch)
+      {
+        tx.endWriteBatch();
+      }
+    }
+
+    void onDataReceived(const IpAddress&, uint16_t, void*, int count)
+    {
+      ++rx_wakeups;
+      handleDatagram(count);
+    }
+
+    void onDatagramsReceived(const UdpSocket::Datagram* dgs, size_t count)
+    {
+      ++rx_wakeups;
+      for (size_t i=0; i<count; ++i)
+      {
+        handleDatagram(dgs[i].count);
+      }
+    }
+
+    void handleDatagram(int count)
+    {
+      if (count != DATAGRAM_SIZE)
+      {
+        cerr << "*** ERROR: Wrong datagram size " << count << endl;
+        exit(1);
+      }
+      ++rcvd;
+      stall_timer.reset();
+      if (rcvd == total)
+      {
+        stall_timer.setEnable(false);
+        end_time = wallTime();
+        done();
+      }
+      else if (rcvd == sent)
+      {
+        Application::app().runTask(mem_fun(*this, &Bench::sendBurst));
+      }
+    }
+
+    void onStall(Timer*)
+    {
+      is_stalled = true;
+      end_time = wallTime();
+      done();
+    }
+};
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned total = 200000;
+  unsigned burst = 32;
+  if (argc > 1)
+  {
+    total = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    burst = atoi(argv[2]);
+  }
+  if ((total == 0) || (burst == 0))
+  {
+    cerr << "Usage: AsyncUdpSocketBench [datagrams] [burst]\n";
+    exit(1);
+  }
+
+  CppApplication app;
+  int ret = 0;
+  printf("%-9s %10s %12s %10s %12s\n", "Mode", "Datagrams", "Datagrams/s",
+         "Wakeups", "Dgrams/wake");
+
+    // Run the single and then the batch benchmark. A benchmark object is
+    // not deleted from within its own signal handler.
+  bool batch = false;
+  Bench *bench = 0;
+  std::function<void()> next = [&]()
+  {
+    if (bench != 0)
+    {
+      if (bench->stalled())
+      {
+        cerr << "*** ERROR: Datagrams lost, only " << bench->received()
+             << " of " << total << " received" << endl;
+        ret = 1;
+      }
+      printf("%-9s %10u %12.0f %10u %12.1f\n", batch ? "batch" : "single",
+             bench->received(), bench->received() / bench->elapsed(),
+             bench->wakeups(), double(bench->received()) / bench->wakeups());
+      delete bench;
+      bench = 0;
+      if (batch)
+      {
+        app.quit();
+        return;
+      }
+      batch = true;
+    }
+    bench = new Bench(batch, total, burst);
+    bench->done.connect([&]() { app.runTask([&]() { next(); }); });
+    bench->start();
+  };
+  app.runTask([&]() { next(); });
+  app.exec();
+
+  return ret;
+} /* main */
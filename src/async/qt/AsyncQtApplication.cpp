@@ -9,7 +9,7 @@ application that use the Async classes in a Qt application.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2022 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -229,6 +229,14 @@ void QtApplication::addFdWatch(FdWatch *fd_watch)
       QObject::connect(notifier, SIGNAL(activated(int)),
                        this, SLOT(wrFdActivity(int)));
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      notifier = new QSocketNotifier(fd_watch->fd(),
+                                     QSocketNotifier::Exception);
+      pri_watch_map[fd_watch->fd()] = FdWatchMapItem(fd_watch, notifier);
+      QObject::connect(notifier, SIGNAL(activated(int)),
+                       this, SLOT(priFdActivity(int)));
+      break;
   }  
 } /* QtApplication::addFdWatch */
 
@@ -252,6 +260,13 @@ void QtApplication::delFdWatch(FdWatch *fd_watch)
       delete iter->second.second;
       wr_watch_map.erase(fd_watch->fd());
       break;
+
+    case FdWatch::FD_WATCH_PRI:
+      iter = pri_watch_map.find(fd_watch->fd());
+      assert(iter != pri_watch_map.end());
+      delete iter->second.second;
+      pri_watch_map.erase(fd_watch->fd());
+      break;
   }
   
 
@@ -276,6 +291,15 @@ void QtApplication::wrFdActivity(int socket)
 } /* QtApplication::wrFdActivity */
 
 
+void QtApplication::priFdActivity(int socket)
+{
+  FdWatchMap::iterator iter;
+  iter = pri_watch_map.find(socket);
+  assert(iter != pri_watch_map.end());
+  iter->second.first->activity(iter->second.first);
+} /* QtApplication::priFdActivity */
+
+
 void QtApplication::addTimer(Timer *timer)
 {
   AsyncQtTimer *t = new AsyncQtTimer(timer);
@@ -9,7 +9,7 @@ application that use the Async classes in a Qt application.
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2003-2022 Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -200,6 +200,7 @@ class QtApplication : public QApplication, public Application
     
     FdWatchMap  rd_watch_map;
     FdWatchMap  wr_watch_map;
+    FdWatchMap  pri_watch_map;
     TimerMap  	timer_map;
     
     void addFdWatch(FdWatch *fd_watch);
@@ -211,6 +212,7 @@ class QtApplication : public QApplication, public Application
   private slots:
     void rdFdActivity(int socket);
     void wrFdActivity(int socket);
+    void priFdActivity(int socket);
     
 };  /* class QtApplication */
 
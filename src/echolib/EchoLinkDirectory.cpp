@@ -10,7 +10,7 @@ EchoLink::Directory.
 
 \verbatim
 EchoLib - A library for EchoLink communication
-Copyright (C) 2003-2013 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -85,6 +85,12 @@ using namespace EchoLink;
  *
  ****************************************************************************/
 
+  // The station categories in the order they are presented
+enum
+{
+  CAT_LINK, CAT_REPEATER, CAT_CONFERENCE, CAT_STATION
+};
+
 
 
 /****************************************************************************
@@ -110,6 +116,8 @@ struct Cmd
  *
  ****************************************************************************/
 
+static int stationCategory(const string& callsign);
+
 
 
 /****************************************************************************
@@ -140,7 +148,8 @@ Directory::Directory(const vector<string>& servers, const string& callsign,
     const IpAddress &bind_ip)
   : com_state(CS_IDLE),       	      	      the_servers(servers),
     the_password(password),   	      	      the_description(""),
-    error_str(""),    	      	      	      get_call_cnt(0),
+    error_str(""),    	      	      	      refresh_cnt(0),
+    get_call_cnt(0),
     ctrl_con(0),
     the_status(StationData::STAT_OFFLINE),    reg_refresh_timer(0),
     current_status(StationData::STAT_OFFLINE),server_changed(false),
@@ -207,10 +216,7 @@ void Directory::getCalls(void)
   }
   else
   {
-    the_links.clear();
-    the_repeaters.clear();
-    the_conferences.clear();
-    the_stations.clear();
+    clearStationLists();
     error("Trying to update the directory list while not registered with the "
       	  "directory server");
     //stationListUpdated();
@@ -249,142 +255,109 @@ void Directory::setDescription(const string& description)
 } /* Directory::setDescription */
 
 
-const StationData *Directory::findCall(const string& call)
+bool Directory::loadCallList(const char *buf, int len)
 {
-  list<StationData> calls;
-  list<StationData>::const_iterator iter;
-  
-  for (iter=the_links.begin(); iter!=the_links.end(); ++iter)
+  if (com_state != CS_IDLE)
   {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
+    return false;
   }
-  
-  for (iter=the_repeaters.begin(); iter!=the_repeaters.end(); ++iter)
+
+    // The parser modify the buffer so we need a copy of it
+  vector<char> data(buf, buf + len);
+  char *ptr = data.data();
+  error_str = "";
+  com_state = CS_WAITING_FOR_START;
+  bool end_found = false;
+  int read_len = 0;
+  do
   {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_conferences.begin(); iter!=the_conferences.end(); ++iter)
+    end_found = (com_state == CS_WAITING_FOR_END);
+    read_len = handleCallList(ptr, len);
+    ptr += read_len;
+    len -= read_len;
+  } while ((com_state != CS_IDLE) && (read_len > 0));
+
+  if (com_state != CS_IDLE)
   {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
+    com_state = CS_IDLE;
+    get_call_list.clear();
+    return false;
   }
-  
-  for (iter=the_stations.begin(); iter!=the_stations.end(); ++iter)
+  if (!end_found || (read_len == 0) || !error_str.empty())
   {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
+    return false;
   }
-  
-  return 0;
-  
-} /* Directory::findCall */
 
+  stationListUpdated();
+  return true;
+} /* Directory::loadCallList */
 
-const StationData *Directory::findStation(int id)
+
+const StationData *Directory::findCall(const string& call)
 {
-  list<StationData> calls;
-  list<StationData>::const_iterator iter;
-  
-  for (iter=the_links.begin(); iter!=the_links.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_repeaters.begin(); iter!=the_repeaters.end(); ++iter)
+  CallIndex::const_iterator it = call_idx.find(call);
+  if (it != call_idx.end())
   {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
+    return &(*it->second.stn);
   }
-  
-  for (iter=the_conferences.begin(); iter!=the_conferences.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_stations.begin(); iter!=the_stations.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
   return 0;
-  
-} /* Directory::findStation */
+} /* Directory::findCall */
 
 
-bool Directory::stationCodeEq(const StationData& stn, string code, bool exact)
+const StationData *Directory::findStation(int id)
 {
-  if (exact)
+  IdIndex::const_iterator it = id_idx.find(id);
+  if (it != id_idx.end())
   {
-    return (stn.code() == code);
+    return it->second;
   }
-  else
-  {
-    return (stn.code().find(code) == 0);
-  }
-} /* Directory::stationCodeEq  */
+  return 0;
+} /* Directory::findStation */
 
 
 void Directory::findStationsByCode(vector<StationData> &stns,
 		const string& code, bool exact)
 {
-  list<StationData>::const_iterator iter;
-  
   stns.clear();
 
-  for (iter=the_links.begin(); iter!=the_links.end(); ++iter)
-  {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
-  }
-  
-  for (iter=the_repeaters.begin(); iter!=the_repeaters.end(); ++iter)
+  CodeNode *node = findCodeNode(code, false);
+  if (node == 0)
   {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
+    return;
   }
-  
-  for (iter=the_conferences.begin(); iter!=the_conferences.end(); ++iter)
+
+  vector<const StationData*> found(node->stns);
+  if (!exact)
   {
-    if (stationCodeEq(*iter, code, exact))
+      // Collect all stations in the subtree below the node
+    vector<unsigned> pending(node->next, node->next + 10);
+    while (!pending.empty())
     {
-      stns.push_back(*iter);
+      unsigned idx = pending.back();
+      pending.pop_back();
+      if (idx != 0)
+      {
+        const CodeNode& child = code_trie[idx];
+        found.insert(found.end(), child.stns.begin(), child.stns.end());
+        pending.insert(pending.end(), child.next, child.next + 10);
+      }
     }
   }
-  
-  for (iter=the_stations.begin(); iter!=the_stations.end(); ++iter)
+
+  sort(found.begin(), found.end(),
+      [](const StationData *a, const StationData *b)
+      {
+        int cat_a = stationCategory(a->callsign());
+        int cat_b = stationCategory(b->callsign());
+        return (cat_a < cat_b) ||
+               ((cat_a == cat_b) && (a->callsign() < b->callsign()));
+      });
+
+  stns.reserve(found.size());
+  for (const StationData *stn : found)
   {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
+    stns.push_back(*stn);
   }
-
 } /* Directory::findStationsByCode  */
 
 
@@ -498,6 +471,7 @@ int Directory::handleCallList(char *buf, int len)
 	if (get_call_cnt > 0)
 	{
 	  get_call_list.clear();
+	  get_call_list.reserve(get_call_cnt);
 	  the_message = "";
 	  com_state = CS_WAITING_FOR_CALL;
 	}
@@ -607,31 +581,7 @@ int Directory::handleCallList(char *buf, int len)
 	if (memcmp(buf, "+++", 3) == 0)
 	{
 	  //printf("End received!\n");
-	  the_links.clear();
-	  the_repeaters.clear();
-	  the_conferences.clear();
-	  the_stations.clear();
-	  list<StationData>::const_iterator it;
-	  for (it = get_call_list.begin(); it != get_call_list.end(); ++it)
-	  {
-	    const string &callsign = it->callsign();
-	    if (callsign.rfind("-L") == callsign.size()-2)
-	    {
-	      the_links.push_back(*it);
-	    }
-	    else if (callsign.rfind("-R") == callsign.size()-2)
-	    {
-	      the_repeaters.push_back(*it);
-	    }
-	    else if (callsign.find("*") == 0)
-	    {
-	      the_conferences.push_back(*it);
-	    }
-	    else
-	    {
-	      the_stations.push_back(*it);
-	    }
-	  }
+	  updateStationLists();
 	  get_call_list.clear();
 	  com_state = CS_IDLE;
 	  read_len = 3;
@@ -665,6 +615,183 @@ int Directory::handleCallList(char *buf, int len)
 } /* Directory::handleCallList */
 
 
+/*
+ *----------------------------------------------------------------------------
+ * Method:    Directory::updateStationLists
+ * Purpose:   Update the station lists and indexes from a newly received
+ *    	      station list. Stations that already exist are updated in place
+ *    	      and moved to their new position in the list so that only
+ *    	      new, changed and removed stations cost more than a lookup.
+ * Input:     None
+ * Output:    None
+ * Author:    Tobias Blomberg
+ * Created:   2026-10-18
+ * Remarks:   The category of a station is given by its callsign so an
+ *    	      existing station will never move between the lists.
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void Directory::updateStationLists(void)
+{
+  list<StationData> links;
+  list<StationData> repeaters;
+  list<StationData> conferences;
+  list<StationData> stations;
+  list<StationData> *new_lists[] = {
+    &links, &repeaters, &conferences, &stations
+  };
+
+  ++refresh_cnt;
+  for (const StationData& new_stn : get_call_list)
+  {
+    const string& callsign = new_stn.callsign();
+    list<StationData>& new_list = *new_lists[stationCategory(callsign)];
+    CallIndex::iterator idx_it = call_idx.find(callsign);
+    if (idx_it == call_idx.end())
+    {
+      addToIndex(new_list.insert(new_list.end(), new_stn));
+      continue;
+    }
+
+      // Only the first entry is used if the server send duplicates
+    CallIndexEntry& entry = idx_it->second;
+    if (entry.refresh == refresh_cnt)
+    {
+      continue;
+    }
+    entry.refresh = refresh_cnt;
+
+    StationIter it = entry.stn;
+    if (*it != new_stn)
+    {
+      if (it->id() != new_stn.id())
+      {
+        IdIndex::iterator id_it = id_idx.find(it->id());
+        if ((id_it != id_idx.end()) && (id_it->second == &(*it)))
+        {
+          id_idx.erase(id_it);
+        }
+        id_idx[new_stn.id()] = &(*it);
+      }
+      *it = new_stn;
+    }
+    new_list.splice(new_list.end(), stationList(callsign), it);
+  }
+
+    // What is left in the old lists have disappeared from the directory
+  the_links.swap(links);
+  the_repeaters.swap(repeaters);
+  the_conferences.swap(conferences);
+  the_stations.swap(stations);
+  for (list<StationData> *old_list : new_lists)
+  {
+    for (StationIter it = old_list->begin(); it != old_list->end(); ++it)
+    {
+      removeFromIndex(it);
+    }
+  }
+} /* Directory::updateStationLists */
+
+
+void Directory::clearStationLists(void)
+{
+  the_links.clear();
+  the_repeaters.clear();
+  the_conferences.clear();
+  the_stations.clear();
+  call_idx.clear();
+  id_idx.clear();
+  code_trie.clear();
+} /* Directory::clearStationLists */
+
+
+list<StationData>& Directory::stationList(const string& callsign)
+{
+  switch (stationCategory(callsign))
+  {
+    case CAT_LINK:
+      return the_links;
+    case CAT_REPEATER:
+      return the_repeaters;
+    case CAT_CONFERENCE:
+      return the_conferences;
+    default:
+      return the_stations;
+  }
+} /* Directory::stationList */
+
+
+void Directory::addToIndex(StationIter it)
+{
+  CallIndexEntry& entry = call_idx[it->callsign()];
+  entry.stn = it;
+  entry.refresh = refresh_cnt;
+  id_idx[it->id()] = &(*it);
+  findCodeNode(it->code(), true)->stns.push_back(&(*it));
+} /* Directory::addToIndex */
+
+
+void Directory::removeFromIndex(StationIter it)
+{
+  CallIndex::iterator call_it = call_idx.find(it->callsign());
+  if ((call_it != call_idx.end()) && (call_it->second.stn == it))
+  {
+    call_idx.erase(call_it);
+  }
+  IdIndex::iterator id_it = id_idx.find(it->id());
+  if ((id_it != id_idx.end()) && (id_it->second == &(*it)))
+  {
+    id_idx.erase(id_it);
+  }
+  CodeNode *node = findCodeNode(it->code(), false);
+  if (node != 0)
+  {
+    vector<const StationData*>::iterator stn_it =
+      find(node->stns.begin(), node->stns.end(), &(*it));
+    if (stn_it != node->stns.end())
+    {
+      node->stns.erase(stn_it);
+    }
+  }
+} /* Directory::removeFromIndex */
+
+
+Directory::CodeNode *Directory::findCodeNode(const string& code, bool create)
+{
+  if (code_trie.empty())
+  {
+    if (!create)
+    {
+      return 0;
+    }
+    code_trie.push_back(CodeNode());
+  }
+
+  unsigned idx = 0;
+  for (string::const_iterator it = code.begin(); it != code.end(); ++it)
+  {
+    if (!isdigit(*it))
+    {
+      return 0;
+    }
+    unsigned next = code_trie[idx].next[*it - '0'];
+    if (next == 0)
+    {
+      if (!create)
+      {
+        return 0;
+      }
+      next = code_trie.size();
+      code_trie[idx].next[*it - '0'] = next;
+      code_trie.push_back(CodeNode());
+    }
+    idx = next;
+  }
+
+  return &code_trie[idx];
+} /* Directory::findCodeNode */
+
+
 void Directory::ctrlSockReady(bool is_ready)
 {
   if (is_ready)
@@ -1008,6 +1135,24 @@ void Directory::onCmdTimeout(Timer *timer)
 } /* Directory::onCmdTimeout */
 
 
+static int stationCategory(const string& callsign)
+{
+  if (callsign.rfind("-L") == callsign.size()-2)
+  {
+    return CAT_LINK;
+  }
+  else if (callsign.rfind("-R") == callsign.size()-2)
+  {
+    return CAT_REPEATER;
+  }
+  else if (callsign.find("*") == 0)
+  {
+    return CAT_CONFERENCE;
+  }
+  return CAT_STATION;
+} /* stationCategory */
+
+
 
 /*
  * This file has not been truncated
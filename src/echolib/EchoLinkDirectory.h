@@ -10,7 +10,7 @@ EchoLink::Directory.
 
 \verbatim
 EchoLib - A library for EchoLink communication
-Copyright (C) 2003  Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -48,6 +48,7 @@ An example of how to use the EchoLink::Directory class
 #include <string>
 #include <list>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 
 
@@ -312,12 +313,32 @@ class Directory : public sigc::trackable
      * call is made again.
      */
     const std::string& message(void) const { return the_message; }
-    
+
+    /**
+     * @brief   Load a station list captured from a directory server
+     * @param   buf The complete reply to a station list request
+     * @param   len The length of the reply
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * The station list is normally fetched from the directory server using
+     * the \em getCalls function. This function can be used to load a reply
+     * that has been captured earlier, starting with "@@@" and ending with
+     * "+++". The station lists are updated in the same way as when fetching
+     * the list from the directory server and the stationListUpdated signal
+     * is emitted on success. Loading will fail if a station list request is
+     * in progress.
+     */
+    bool loadCallList(const char *buf, int len);
+
     /**
      * @brief 	Find a callsign in the station list
      * @param 	call  The callsign to find
      * @return	Returns a pointer to a StationData object if the callsign was
      *	      	found. Otherwise a NULL-pointer is returned.
+     *
+     * The returned pointer is valid until the station disappear from the
+     * station list. Stations that are still present after a station list
+     * refresh are updated in place.
      */
     const StationData *findCall(const std::string& call);
     
@@ -338,6 +359,8 @@ class Directory : public sigc::trackable
      *
      * Find stations matching the given code. For a description of how the
      * callsign to code mapping is done see @see EchoLink::StationData::code.
+     * The stations are returned sorted on callsign, with links first, then
+     * repeaters, conferences and last "normal" stations.
      */
     void findStationsByCode(std::vector<StationData> &stns,
 		    const std::string& code, bool exact=true);
@@ -368,7 +391,25 @@ class Directory : public sigc::trackable
       CS_WAITING_FOR_DATA,  CS_WAITING_FOR_ID,    CS_WAITING_FOR_IP,
       CS_WAITING_FOR_END,   CS_IDLE,  	      	  CS_WAITING_FOR_OK
     } ComState;
-    
+
+    typedef std::list<StationData>::iterator  StationIter;
+    struct CallIndexEntry
+    {
+      StationIter stn;
+      unsigned    refresh;
+    };
+    typedef std::unordered_map<std::string, CallIndexEntry> CallIndex;
+    typedef std::unordered_map<int, const StationData*> IdIndex;
+
+      // A node in the callsign code trie. The code consist of digits only
+      // so there are ten possible children. A child index of zero means
+      // that there is no child since the root node cannot be a child.
+    struct CodeNode
+    {
+      unsigned                        next[10] = {0};
+      std::vector<const StationData*> stns;
+    };
+
     static const int DIRECTORY_SERVER_PORT    	= 5200;
     static const int REGISTRATION_REFRESH_TIME  = 5 * 60 * 1000; // 5 minutes
     static const int CMD_TIMEOUT                = 120 * 1000; // 2 minutes
@@ -385,9 +426,14 @@ class Directory : public sigc::trackable
     std::string       	      the_message;
     std::string       	      error_str;
     
+    CallIndex                 call_idx;
+    IdIndex                   id_idx;
+    std::vector<CodeNode>     code_trie;
+    unsigned                  refresh_cnt;
+
     int       	      	      get_call_cnt;
     StationData       	      get_call_entry;
-    std::list<StationData>    get_call_list;
+    std::vector<StationData>  get_call_list;
     
     DirectoryCon *            ctrl_con;
     std::list<Cmd>    	      cmd_queue;
@@ -403,6 +449,12 @@ class Directory : public sigc::trackable
     
     void printBuf(const unsigned char *buf, int len);
     int handleCallList(char *buf, int len);
+    void updateStationLists(void);
+    void clearStationLists(void);
+    std::list<StationData>& stationList(const std::string& callsign);
+    void addToIndex(StationIter it);
+    void removeFromIndex(StationIter it);
+    CodeNode *findCodeNode(const std::string& code, bool create);
     
     void ctrlSockReady(bool is_ready);
     void ctrlSockConnected(void);
@@ -414,7 +466,6 @@ class Directory : public sigc::trackable
     void createClientObject(void);
     void onRefreshRegistration(Async::Timer *timer);
     void onCmdTimeout(Async::Timer *timer);
-    bool stationCodeEq(const StationData& stn, std::string code, bool exact);
 
 };  /* class Directory */
 
@@ -0,0 +1,313 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#include <AsyncCppApplication.h>
+#include <EchoLinkDirectory.h>
+
+using namespace std;
+using namespace Async;
+using namespace EchoLink;
+
+
+/*
+ * Benchmark the EchoLink directory station list handling.
+ *
+ * Usage: EchoLinkDirectoryBench [directory dump file]
+ *
+ * The dump file should contain a complete directory server reply to a
+ * station list request, from "@@@" to "+++". If no file is given, a
+ * synthetic directory with 30000 stations is generated. The time to load the
+ * list into an empty directory, to refresh it with an unchanged list and to
+ * refresh it with a list where a few percent of the stations have changed is
+ * measured. The indexed lookup functions are then compared to a linear scan
+ * of the station lists.
+ */
+
+namespace {
+const unsigned  SYNTHETIC_STATIONS  = 30000;
+const unsigned  LOOKUPS             = 10000;
+
+struct Entry
+{
+  string  call;
+  string  data;
+  int     id;
+  string  ip;
+};
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+string mkDump(const vector<Entry>& entries)
+{
+  ostringstream os;
+  os << "@@@\n" << entries.size() << "\n";
+  for (const auto& entry : entries)
+  {
+    os << entry.call << "\n" << entry.data << "\n" << entry.id << "\n"
+       << entry.ip << "\n";
+  }
+  os << "+++";
+  return os.str();
+}
+
+bool parseDump(const string& dump, vector<Entry>& entries)
+{
+  istringstream is(dump);
+  string line;
+  if (!getline(is, line) || (line != "@@@") || !getline(is, line))
+  {
+    return false;
+  }
+  Entry entry;
+  while (getline(is, entry.call) && (entry.call != "+++"))
+  {
+    string id;
+    if (!getline(is, entry.data) || !getline(is, id) ||
+        !getline(is, entry.ip))
+    {
+      return false;
+    }
+    entry.id = atoi(id.c_str());
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+string mkCall(mt19937& gen)
+{
+  static const char *suffixes[] = { "", "", "", "-L", "-R" };
+  uniform_int_distribution<int> letter(0, 25);
+  uniform_int_distribution<int> digit(0, 9);
+  uniform_int_distribution<int> suffix(0, 4);
+  string call;
+  call += 'A' + letter(gen);
+  call += 'A' + letter(gen);
+  call += '0' + digit(gen);
+  call += 'A' + letter(gen);
+  call += 'A' + letter(gen);
+  call += 'A' + letter(gen);
+  return call + suffixes[suffix(gen)];
+}
+
+Entry mkEntry(mt19937& gen, int id)
+{
+  Entry entry;
+  entry.call = mkCall(gen);
+  if (id % 500 == 0)
+  {
+    entry.call = "*" + entry.call + "*";
+  }
+  entry.data = "Somewhere far away      [ON 12:34]";
+  entry.id = id;
+  entry.ip = "10." + to_string((id >> 16) & 0xff) + "." +
+             to_string((id >> 8) & 0xff) + "." + to_string(id & 0xff);
+  return entry;
+}
+
+double load(Directory& dir, const string& dump)
+{
+  double start = cpuTime();
+  if (!dir.loadCallList(dump.c_str(), dump.size()))
+  {
+    cerr << "*** ERROR: Could not load the station list\n";
+    exit(1);
+  }
+  return cpuTime() - start;
+}
+
+const StationData *scanCall(Directory& dir, const string& call)
+{
+  for (const auto *stns : { &dir.links(), &dir.repeaters(),
+                            &dir.conferences(), &dir.stations() })
+  {
+    for (const auto& stn : *stns)
+    {
+      if (stn.callsign() == call)
+      {
+        return &stn;
+      }
+    }
+  }
+  return 0;
+}
+
+size_t scanCode(Directory& dir, const string& code)
+{
+  size_t cnt = 0;
+  for (const auto *stns : { &dir.links(), &dir.repeaters(),
+                            &dir.conferences(), &dir.stations() })
+  {
+    for (const auto& stn : *stns)
+    {
+      if (stn.code().find(code) == 0)
+      {
+        ++cnt;
+      }
+    }
+  }
+  return cnt;
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  mt19937 gen(4711);
+  vector<Entry> entries;
+  if (argc > 1)
+  {
+    ifstream is(argv[1]);
+    stringstream ss;
+    ss << is.rdbuf();
+    if (!is || !parseDump(ss.str(), entries) || entries.empty())
+    {
+      cerr << "*** ERROR: Could not read directory dump from \""
+           << argv[1] << "\"\n";
+      exit(1);
+    }
+  }
+  else
+  {
+    for (unsigned i=0; i<SYNTHETIC_STATIONS; ++i)
+    {
+      entries.push_back(mkEntry(gen, 100000 + i));
+    }
+  }
+
+    // Change the status of 5%, remove 1% and add 1% of the stations
+  vector<Entry> changed_entries;
+  uniform_int_distribution<int> percent(0, 99);
+  int next_id = 900000;
+  for (const auto& entry : entries)
+  {
+    int rnd = percent(gen);
+    if (rnd == 0)
+    {
+      continue;
+    }
+    changed_entries.push_back(entry);
+    if (rnd <= 5)
+    {
+      changed_entries.back().data = "Somewhere else           [BUSY 23:45]";
+    }
+    else if (rnd == 6)
+    {
+      changed_entries.push_back(mkEntry(gen, next_id++));
+    }
+  }
+
+  const string dump = mkDump(entries);
+  const string changed_dump = mkDump(changed_entries);
+
+  CppApplication app;
+  Directory dir(vector<string>(), "N0CALL", "", "");
+  double initial_time = load(dir, dump);
+  double unchanged_time = load(dir, dump);
+  double changed_time = load(dir, changed_dump);
+
+  vector<string> calls;
+  vector<int> ids;
+  uniform_int_distribution<size_t> pick(0, changed_entries.size() - 1);
+  for (unsigned i=0; i<LOOKUPS; ++i)
+  {
+    const Entry& entry = changed_entries[pick(gen)];
+    calls.push_back(entry.call);
+    ids.push_back(entry.id);
+  }
+
+  int ret = 0;
+  double start = cpuTime();
+  size_t scan_found = 0;
+  for (const auto& call : calls)
+  {
+    scan_found += (scanCall(dir, call) != 0) ? 1 : 0;
+  }
+  double scan_call_time = cpuTime() - start;
+
+  start = cpuTime();
+  size_t idx_found = 0;
+  for (const auto& call : calls)
+  {
+    idx_found += (dir.findCall(call) != 0) ? 1 : 0;
+  }
+  double idx_call_time = cpuTime() - start;
+  if (scan_found != idx_found)
+  {
+    cerr << "*** ERROR: findCall mismatch: scan=" << scan_found
+         << " index=" << idx_found << endl;
+    ret = 1;
+  }
+
+  start = cpuTime();
+  idx_found = 0;
+  for (int id : ids)
+  {
+    idx_found += (dir.findStation(id) != 0) ? 1 : 0;
+  }
+  double idx_id_time = cpuTime() - start;
+  if (idx_found != ids.size())
+  {
+    cerr << "*** ERROR: findStation only found " << idx_found << " of "
+         << ids.size() << " stations\n";
+    ret = 1;
+  }
+
+    // Use the first four digits of the code, like a typical DTMF search
+  vector<string> codes;
+  for (const auto& call : calls)
+  {
+    codes.push_back(dir.findCall(call)->code().substr(0, 4));
+  }
+  const unsigned code_lookups = codes.size() / 10;
+  start = cpuTime();
+  scan_found = 0;
+  for (unsigned i=0; i<code_lookups; ++i)
+  {
+    scan_found += scanCode(dir, codes[i]);
+  }
+  double scan_code_time = cpuTime() - start;
+
+  start = cpuTime();
+  idx_found = 0;
+  vector<StationData> stns;
+  for (unsigned i=0; i<code_lookups; ++i)
+  {
+    dir.findStationsByCode(stns, codes[i], false);
+    idx_found += stns.size();
+  }
+  double idx_code_time = cpuTime() - start;
+  if (scan_found != idx_found)
+  {
+    cerr << "*** ERROR: findStationsByCode mismatch: scan=" << scan_found
+         << " index=" << idx_found << endl;
+    ret = 1;
+  }
+
+  printf("Stations                   : %zu\n", entries.size());
+  printf("Initial load               : %.2fms\n", 1.0e3 * initial_time);
+  printf("Unchanged refresh          : %.2fms\n", 1.0e3 * unchanged_time);
+  printf("Changed refresh            : %.2fms\n", 1.0e3 * changed_time);
+  printf("findCall scan/index        : %.2fus / %.2fus\n",
+         1.0e6 * scan_call_time / calls.size(),
+         1.0e6 * idx_call_time / calls.size());
+  printf("findStation index          : %.2fus\n",
+         1.0e6 * idx_id_time / ids.size());
+  printf("findStationsByCode scan/idx: %.2fus / %.2fus\n",
+         1.0e6 * scan_code_time / code_lookups,
+         1.0e6 * idx_code_time / code_lookups);
+
+  return ret;
+} /* main */
@@ -9,7 +9,7 @@ information, see the documentation for class EchoLink::Qso.
 
 \verbatim
 EchoLib - A library for EchoLink communication
-Copyright (C) 2003-2014 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -103,6 +103,7 @@ struct Qso::Private
   } Codec;
 
   Codec     remote_codec;
+  bool      is_writing_samples;
 #ifdef SPEEX_MAJOR
   SpeexBits enc_bits;
   SpeexBits dec_bits;
@@ -111,7 +112,7 @@ struct Qso::Private
 #endif
 
   Private(void)
-    : remote_codec(CODEC_GSM)
+    : remote_codec(CODEC_GSM), is_writing_samples(false)
 #if SPEEX_MAJOR
       , enc_bits(), dec_bits(), enc_state(0), dec_state(0)
 #endif
@@ -397,6 +398,13 @@ bool Qso::sendAudioRaw(RawPacket *raw_packet)
   {
     return false;
   }
+
+    // Only one audio source at a time. Samples written to this connection
+    // have precedence until they have been flushed.
+  if (p->is_writing_samples)
+  {
+    return false;
+  }
   
 #ifdef SPEEX_MAJOR
   if ((raw_packet->voice_packet->header.pt == 0x96) &&
@@ -444,6 +452,26 @@ bool Qso::sendAudioRaw(RawPacket *raw_packet)
 } /* Qso::sendAudioRaw */
 
 
+bool Qso::sendEncodedAudio(RawPacket *gsm_packet, RawPacket *speex_packet)
+{
+  if (remoteUsesSpeex() && (speex_packet != 0))
+  {
+    return sendAudioRaw(speex_packet);
+  }
+  return sendAudioRaw(gsm_packet);
+} /* Qso::sendEncodedAudio */
+
+
+bool Qso::remoteUsesSpeex(void) const
+{
+#ifdef SPEEX_MAJOR
+  return p->remote_codec == Private::CODEC_SPEEX;
+#else
+  return false;
+#endif
+} /* Qso::remoteUsesSpeex */
+
+
 void Qso::setRemoteParams(const string& priv)
 {
 #ifdef SPEEX_MAJOR  
@@ -453,6 +481,7 @@ void Qso::setRemoteParams(const string& priv)
   {
     cerr << "Switching to SPEEX audio codec for EchoLink Qso." << endl;
     p->remote_codec = Private::CODEC_SPEEX;
+    remoteCodecChanged();
   }
 #endif
 } /* Qso::setRemoteParams */
@@ -462,6 +491,8 @@ int Qso::writeSamples(const float *samples, int count)
 {
   int samples_read = 0;
   
+  p->is_writing_samples = true;
+
   if (state != STATE_CONNECTED)
   {
     return count;
@@ -519,6 +550,7 @@ void Qso::flushSamples(void)
     }
   }
   
+  p->is_writing_samples = false;
   sourceAllSamplesFlushed();
   
 } /* Qso::flushSamples */
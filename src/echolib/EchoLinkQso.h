@@ -9,7 +9,7 @@ the documentation for class EchoLink::Qso.
 
 \verbatim
 EchoLib - A library for EchoLink communication
-Copyright (C) 2003  Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -312,9 +312,31 @@ class Qso
      * audioReceivedRaw signal. The raw_packet contains both the network
      * packet and the decoded samples, which is beneficial when the audio
      * frame has to be transcoded (SPEEX -> GSM) prior re-transmission.
+     * Samples written to this object using writeSamples have precedence.
+     * No packet is sent until those samples have been flushed so that two
+     * audio streams are never interleaved.
      */
     bool sendAudioRaw(RawPacket *raw_packet);
 
+    /**
+     * @brief 	Send audio encoded by an EchoLink::SharedEncoder
+     * @param 	gsm_packet The GSM encoded packet
+     * @param 	speex_packet The SPEEX encoded packet or 0 if not available
+     * @return	Returns \em true on success or \em false on failure
+     *
+     * This function is used to send audio that has been encoded once for
+     * many connections. The packet matching the codec used for this
+     * connection is selected and sent, with only the sequence number
+     * changed.
+     */
+    bool sendEncodedAudio(RawPacket *gsm_packet, RawPacket *speex_packet);
+
+    /**
+     * @brief 	Find out if the remote station should be sent SPEEX audio
+     * @return	Returns \em true if the SPEEX codec is used for this connection
+     */
+    bool remoteUsesSpeex(void) const;
+
     /**
       * @brief Set parameters of the remote station connection
       * @param priv A private string for passing connection parameters
@@ -387,6 +409,15 @@ class Qso
      */
     sigc::signal<void(State)> stateChange;
 
+    /**
+     * @brief A signal that is emitted when the remote station change codec
+     *
+     * The remote station may tell us that it prefer the SPEEX codec after
+     * the connection has been established. Use remoteUsesSpeex to find out
+     * which codec is used.
+     */
+    sigc::signal<void()> remoteCodecChanged;
+
     /**
      * @brief A signal that is emitted when the audio receive state changes
      * @param is_receiving  Is \em true when audio is being received and
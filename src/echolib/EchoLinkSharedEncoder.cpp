@@ -0,0 +1,308 @@
+/**
+@file	 EchoLinkSharedEncoder.cpp
+@brief   Encode audio once for many EchoLink connections
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+This file contains a class that encode audio to EchoLink voice packets once
+and hand the packets over to any number of EchoLink::Qso objects.
+
+\verbatim
+EchoLib - A library for EchoLink communication
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef SPEEX_MAJOR
+#include <speex/speex.h>
+#endif
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "EchoLinkSharedEncoder.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+using namespace EchoLink;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+struct SharedEncoder::Private
+{
+#ifdef SPEEX_MAJOR
+  SpeexBits enc_bits;
+  void *    enc_state;
+
+  Private(void) : enc_bits(), enc_state(0) {}
+#endif
+};
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+SharedEncoder::SharedEncoder(void)
+  : gsmh(gsm_create()), send_buffer_cnt(0), enabled(true),
+    speex_enabled(false), p(new Private)
+{
+} /* SharedEncoder::SharedEncoder */
+
+
+SharedEncoder::~SharedEncoder(void)
+{
+  setSpeexEnabled(false);
+  gsm_destroy(gsmh);
+  gsmh = 0;
+  delete p;
+  p = 0;
+} /* SharedEncoder::~SharedEncoder */
+
+
+void SharedEncoder::setEnabled(bool enable)
+{
+  enabled = enable;
+  if (!enabled)
+  {
+    send_buffer_cnt = 0;
+  }
+} /* SharedEncoder::setEnabled */
+
+
+void SharedEncoder::setSpeexEnabled(bool enable)
+{
+#ifdef SPEEX_MAJOR
+  if (enable == speex_enabled)
+  {
+    return;
+  }
+  speex_enabled = enable;
+
+  if (enable)
+  {
+      // Same settings as in the Qso class
+    speex_bits_init(&p->enc_bits);
+    p->enc_state = speex_encoder_init(&speex_nb_mode);
+    int val = 25000;
+    speex_encoder_ctl(p->enc_state, SPEEX_SET_BITRATE, &val);
+    val = 8;
+    speex_encoder_ctl(p->enc_state, SPEEX_SET_QUALITY, &val);
+    val = 4;
+    speex_encoder_ctl(p->enc_state, SPEEX_SET_COMPLEXITY, &val);
+  }
+  else
+  {
+    speex_bits_destroy(&p->enc_bits);
+    speex_encoder_destroy(p->enc_state);
+    p->enc_state = 0;
+  }
+#endif
+} /* SharedEncoder::setSpeexEnabled */
+
+
+int SharedEncoder::writeSamples(const float *samples, int count)
+{
+  if (!enabled)
+  {
+    return count;
+  }
+
+  int samples_read = 0;
+  while (samples_read < count)
+  {
+    int read_cnt = min(BUFFER_SIZE - send_buffer_cnt, count-samples_read);
+    for (int i=0; i<read_cnt; ++i)
+    {
+      float sample = samples[samples_read++];
+      if (sample > 1)
+      {
+        send_buffer[send_buffer_cnt++] = 32767;
+      }
+      else if (sample < -1)
+      {
+        send_buffer[send_buffer_cnt++] = -32767;
+      }
+      else
+      {
+        send_buffer[send_buffer_cnt++] = static_cast<int16_t>(32767.0 * sample);
+      }
+    }
+
+    if (send_buffer_cnt == BUFFER_SIZE)
+    {
+      encodePacket();
+      send_buffer_cnt = 0;
+    }
+  }
+
+  return samples_read;
+} /* SharedEncoder::writeSamples */
+
+
+void SharedEncoder::flushSamples(void)
+{
+  if (send_buffer_cnt > 0)
+  {
+    memset(send_buffer + send_buffer_cnt, 0,
+        sizeof(send_buffer) - sizeof(*send_buffer) * send_buffer_cnt);
+    send_buffer_cnt = BUFFER_SIZE;
+    encodePacket();
+    send_buffer_cnt = 0;
+  }
+
+  sourceAllSamplesFlushed();
+} /* SharedEncoder::flushSamples */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void SharedEncoder::encodePacket(void)
+{
+  Qso::VoicePacket gsm_packet;
+  gsm_packet.header.version = 0xc0;
+  gsm_packet.header.pt = 0x03;
+  gsm_packet.header.seqNum = 0;
+  gsm_packet.header.time = htonl(0);
+  gsm_packet.header.ssrc = htonl(0);
+  for (int i=0; i<FRAME_COUNT; i++)
+  {
+    gsm_encode(gsmh, send_buffer + i*160, gsm_packet.data + i*33);
+  }
+  Qso::RawPacket gsm_raw = {
+    &gsm_packet,
+    static_cast<int>(sizeof(gsm_packet.header)) + FRAME_COUNT*33,
+    send_buffer
+  };
+
+  Qso::RawPacket *speex_raw_ptr = 0;
+#ifdef SPEEX_MAJOR
+  Qso::VoicePacket speex_packet;
+  Qso::RawPacket speex_raw = { &speex_packet, 0, send_buffer };
+  if (speex_enabled)
+  {
+    for (int i=0; i<BUFFER_SIZE; i += 160)
+    {
+      speex_encode_int(p->enc_state, send_buffer + i, &p->enc_bits);
+    }
+    speex_bits_insert_terminator(&p->enc_bits);
+    size_t nsize = speex_bits_nbytes(&p->enc_bits);
+    if (nsize < sizeof(speex_packet.data))
+    {
+      speex_packet.header = gsm_packet.header;
+      speex_packet.header.pt = 0x96;
+      int nbytes = speex_bits_write(&p->enc_bits, (char*)speex_packet.data,
+                                    nsize);
+      speex_raw.length = sizeof(speex_packet.header) + nbytes;
+      speex_raw_ptr = &speex_raw;
+    }
+    speex_bits_reset(&p->enc_bits);
+  }
+#endif
+
+  audioEncoded(&gsm_raw, speex_raw_ptr);
+} /* SharedEncoder::encodePacket */
+
+
+
+/*
+ * This file has not been truncated
+ */
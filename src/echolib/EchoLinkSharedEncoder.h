@@ -0,0 +1,228 @@
+/**
+@file	 EchoLinkSharedEncoder.h
+@brief   Encode audio once for many EchoLink connections
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+This file contains a class that encode audio to EchoLink voice packets once
+and hand the packets over to any number of EchoLink::Qso objects.
+
+\verbatim
+EchoLib - A library for EchoLink communication
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef ECHOLINK_SHARED_ENCODER_INCLUDED
+#define ECHOLINK_SHARED_ENCODER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+extern "C" {
+#include <gsm.h>
+}
+#include <AsyncAudioSink.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "EchoLinkQso.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace EchoLink
+{
+
+/****************************************************************************
+ *
+ * Forward declarations inside the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Encode audio once for many EchoLink connections
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+When the same audio is to be sent to many EchoLink stations, e.g. in a
+conference, it is a waste of CPU to run one encoder per connection. This
+class is an audio sink that encode the audio into EchoLink voice packets
+once. Each packet is emitted through the audioEncoded signal and should then
+be sent to each connection using EchoLink::Qso::sendEncodedAudio. Only the
+sequence number differ between the packets sent to different connections.
+
+The audio is always encoded using GSM, which all EchoLink stations can
+decode. If Speex support is enabled using setSpeexEnabled, each packet is
+encoded using Speex as well, for the connections that prefer that.
+
+The sample rate of the incoming audio must be 8000 Hz.
+*/
+class SharedEncoder : public Async::AudioSink
+{
+  public:
+    /**
+     * @brief 	Default constuctor
+     */
+    SharedEncoder(void);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~SharedEncoder(void);
+
+    /**
+     * @brief   Enable or disable the encoder
+     * @param   enable Set to \em false to throw away all incoming audio
+     *
+     * Disable the encoder when there are no connected stations to save CPU.
+     * The encoder is enabled by default.
+     */
+    void setEnabled(bool enable);
+
+    /**
+     * @brief   Check if the encoder is enabled
+     * @return  Returns \em true if the encoder is enabled
+     */
+    bool isEnabled(void) const { return enabled; }
+
+    /**
+     * @brief   Enable or disable Speex encoding
+     * @param   enable Set to \em true to encode packets using Speex too
+     *
+     * Enable Speex encoding when there is at least one connected station
+     * that use Speex (see EchoLink::Qso::remoteUsesSpeex). If echolib was
+     * built without Speex support, this function does nothing.
+     */
+    void setSpeexEnabled(bool enable);
+
+    /**
+     * @brief   Check if Speex encoding is enabled
+     * @return  Returns \em true if packets are encoded using Speex too
+     */
+    bool speexEnabled(void) const { return speex_enabled; }
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     *
+     * A partially filled packet is padded with silence and emitted.
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief A signal that is emitted when a voice packet has been encoded
+     * @param gsm_packet The GSM encoded packet
+     * @param speex_packet The Speex encoded packet or 0 if Speex is disabled
+     *
+     * The packets are only valid during the signal emission.
+     */
+    sigc::signal<void(Qso::RawPacket*, Qso::RawPacket*)> audioEncoded;
+
+  protected:
+
+  private:
+    struct Private;
+
+    static const int    FRAME_COUNT   = 4;
+    static const int    BUFFER_SIZE   = FRAME_COUNT*160;
+
+    gsm                 gsmh;
+    short               send_buffer[BUFFER_SIZE];
+    int                 send_buffer_cnt;
+    bool                enabled;
+    bool                speex_enabled;
+    Private             *p;
+
+    SharedEncoder(const SharedEncoder&);
+    SharedEncoder& operator=(const SharedEncoder&);
+    void encodePacket(void);
+
+};  /* class SharedEncoder */
+
+
+} /* namespace */
+
+#endif /* ECHOLINK_SHARED_ENCODER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,183 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+#include <EchoLinkDispatcher.h>
+#include <EchoLinkQso.h>
+#include <EchoLinkSharedEncoder.h>
+
+using namespace std;
+using namespace Async;
+using namespace EchoLink;
+
+
+/*
+ * Test of sending audio from an EchoLink::SharedEncoder.
+ *
+ * A connection to 127.0.0.1 is set up so that all packets sent on the
+ * connection are received by the same connection. The shared encoder is
+ * reconfigured in the same way as the EchoLink module do it, when the
+ * connection state or the remote codec change.
+ *
+ * - When the connection receive its own SDES packet, the remote station
+ *   will switch to the SPEEX codec if echolib was built with Speex support.
+ *   The shared encoder must then send SPEEX packets.
+ * - While samples are written to the connection, like when a message is
+ *   played to the remote station, no packets from the shared encoder may be
+ *   sent so that the two audio streams are not interleaved.
+ */
+
+namespace {
+const int       PORT_BASE   = 47198;
+const int       PACKET_SIZE = 4*160;
+
+int failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+  printf("%-4s %s\n", ok ? "ok" : "FAIL", what.c_str());
+  if (!ok)
+  {
+    ++failures;
+  }
+}
+
+void writePackets(AudioSink *sink, int packet_cnt)
+{
+  std::vector<float> block(PACKET_SIZE);
+  for (int i=0; i<PACKET_SIZE; ++i)
+  {
+    block[i] = 0.5f * sinf(2.0f * M_PI * 440.0f * i / 8000.0f);
+  }
+  for (int i=0; i<packet_cnt; ++i)
+  {
+    sink->writeSamples(block.data(), block.size());
+  }
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  CppApplication app;
+
+  Dispatcher::setPortBase(PORT_BASE);
+  if (Dispatcher::instance() == 0)
+  {
+    cerr << "*** ERROR: Could not create EchoLink listener (Dispatcher)\n";
+    exit(1);
+  }
+
+  Qso qso(IpAddress("127.0.0.1"), "TEST", "Test", "Test");
+  if (!qso.initOk())
+  {
+    cerr << "*** ERROR: Could not set up the EchoLink connection\n";
+    exit(1);
+  }
+
+  SharedEncoder enc;
+  enc.setEnabled(false);
+  enc.audioEncoded.connect(
+      [&](Qso::RawPacket *gsm_packet, Qso::RawPacket *speex_packet)
+      {
+        qso.sendEncodedAudio(gsm_packet, speex_packet);
+      });
+
+  bool codec_changed = false;
+  auto update_encoder = [&]()
+  {
+    bool is_connected = (qso.currentState() == Qso::STATE_CONNECTED);
+    enc.setEnabled(is_connected);
+    enc.setSpeexEnabled(is_connected && qso.remoteUsesSpeex());
+  };
+  qso.stateChange.connect([&](Qso::State) { update_encoder(); });
+  qso.remoteCodecChanged.connect(
+      [&](void)
+      {
+        codec_changed = true;
+        update_encoder();
+      });
+
+  unsigned rx_cnt = 0;
+  unsigned rx_speex_cnt = 0;
+  qso.audioReceivedRaw.connect(
+      [&](Qso::RawPacket *packet)
+      {
+        ++rx_cnt;
+        if (packet->voice_packet->header.pt == 0x96)
+        {
+          ++rx_speex_cnt;
+        }
+      });
+
+#ifdef SPEEX_MAJOR
+  const bool use_speex = true;
+#else
+  const bool use_speex = false;
+#endif
+
+    // Each step is run when the packets sent in the previous step have
+    // been received
+  std::vector<std::function<void()>> steps;
+  steps.push_back([&]()
+  {
+    check(qso.accept(), "Connection accepted");
+  });
+  steps.push_back([&]()
+  {
+    check(qso.currentState() == Qso::STATE_CONNECTED, "Connected");
+    check(codec_changed == use_speex, "Codec change signalled");
+    check(enc.speexEnabled() == use_speex,
+          "Shared encoder reconfigured after codec change");
+    writePackets(&enc, 1);
+  });
+  steps.push_back([&]()
+  {
+    check(rx_cnt == 1, "Shared packet received");
+    check((rx_speex_cnt == 1) == use_speex,
+          "Shared packet encoded using the remote codec");
+    rx_cnt = 0;
+    for (int i=0; i<2; ++i)
+    {
+      writePackets(&qso, 1);
+      writePackets(&enc, 2);
+    }
+  });
+  steps.push_back([&]()
+  {
+    check(rx_cnt == 2,
+          "No shared packets sent while samples are written");
+    rx_cnt = 0;
+    qso.flushSamples();
+    writePackets(&enc, 1);
+  });
+  steps.push_back([&]()
+  {
+    check(rx_cnt == 1, "Shared packets sent after samples are flushed");
+    qso.disconnect();
+  });
+
+  size_t step = 0;
+  Timer step_timer(200, Timer::TYPE_PERIODIC);
+  step_timer.expired.connect([&](Timer*)
+  {
+    if (step < steps.size())
+    {
+      steps[step++]();
+    }
+    else
+    {
+      app.quit();
+    }
+  });
+  app.exec();
+
+  printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+} /* main */
@@ -8,7 +8,7 @@ This file contains a class that is used to represent the data for a station.
 
 \verbatim
 EchoLib - A library for EchoLink communication
-Copyright (C) 2003  Tobias Blomberg
+Copyright (C) 2003-2026 Tobias Blomberg
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -270,6 +270,25 @@ class StationData
       return m_callsign < rhs.m_callsign;
     }
 
+    /**
+     * @brief   Equality operator
+     * @param   rhs Right Hand Side expression
+     * @return  Returns \em true if all station data are equal
+     */
+    bool operator==(const StationData &rhs) const
+    {
+      return (m_callsign == rhs.m_callsign) && (m_status == rhs.m_status) &&
+             (m_time == rhs.m_time) && (m_description == rhs.m_description) &&
+             (m_id == rhs.m_id) && (m_ip == rhs.m_ip);
+    }
+
+    /**
+     * @brief   Inequality operator
+     * @param   rhs Right Hand Side expression
+     * @return  Returns \em true if any of the station data differ
+     */
+    bool operator!=(const StationData &rhs) const { return !(*this == rhs); }
+
     /**
      * @brief Output stream operator
      * @param os The stream to output data to
@@ -10,7 +10,7 @@ Try the "--help" switch for more info.
 
 \verbatim
 EchoLib - A library for EchoLink communication
-Copyright (C) 2003  Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -48,7 +48,10 @@ An example of how to use the Template class
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
+#include <ctime>
 #include <iostream>
+#include <vector>
 
 
 /****************************************************************************
@@ -70,6 +73,7 @@ An example of how to use the Template class
 #include "EchoLinkDirectory.h"
 #include "EchoLinkDispatcher.h"
 #include "EchoLinkQsoTest.h"
+#include "EchoLinkSharedEncoder.h"
 
 
 /****************************************************************************
@@ -115,6 +119,7 @@ static void echolink_qso_done(EchoLinkQsoTest *con);
 static void on_station_list_updated(void);
 static void print_call_list(const list<StationData>& calls);
 static void parse_arguments(int argc, const char **argv);
+static int run_benchmark(int station_cnt);
 
 
 /****************************************************************************
@@ -148,6 +153,7 @@ int portbase = -1;
 const char *proxy_host = 0;
 int proxy_port = 8100;
 const char *proxy_password = "";
+int bench_stations = 0;
 
 Directory *dir = 0;
 ProcessingStage processing_stage = PS_START;
@@ -184,6 +190,13 @@ int main( int argc, const char **argv )
 {
   openlog(PROGRAM_NAME, LOG_PID, LOG_USER);
   parse_arguments(argc, argv);
+
+  if (bench_stations > 0)
+  {
+    int ret = run_benchmark(bench_stations);
+    closelog();
+    return ret;
+  }
   
   const char *home = getenv("HOME");
   if (home == 0)
@@ -562,6 +575,117 @@ static void print_call_list(const list<StationData>& calls)
 } /* print_call_list */
 
 
+static double cpu_time(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+} /* cpu_time */
+
+
+/*
+ *----------------------------------------------------------------------------
+ * Function:  run_benchmark
+ * Purpose:   Measure the CPU time needed to send the same audio to many
+ *    	      connected stations. First each Qso object encode the audio
+ *    	      itself, as when feeding the audio through a splitter. Then the
+ *    	      audio is encoded once by a SharedEncoder and the packets are
+ *    	      handed to all Qso objects. The stations are simulated using
+ *    	      loopback addresses so no real stations are needed.
+ * Input:     station_cnt - The number of simulated stations
+ * Output:    Returns 0 on success, else non-zero.
+ * Author:    Tobias Blomberg / SM0SVX
+ * Created:   2026-10-18
+ * Remarks:   
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+static int run_benchmark(int station_cnt)
+{
+  const int seconds = 60;
+  const int block_size = 160;
+
+  CppApplication app;
+
+  if (portbase != -1)
+  {
+    Dispatcher::setPortBase(portbase);
+  }
+  if (Dispatcher::instance() == 0)
+  {
+    cerr << "*** ERROR: Could not create EchoLink listener (Dispatcher)\n";
+    return 1;
+  }
+
+  vector<Qso*> qsos;
+  for (int i=0; i<station_cnt; ++i)
+  {
+      // Use 127.0.0.2 and upwards
+    IpAddress ip("127.0." + to_string((i + 2) / 256) + "." +
+                 to_string((i + 2) % 256));
+    Qso *qso = new Qso(ip, "BENCH", "Bench", "Benchmark");
+    if (!qso->initOk() || !qso->accept())
+    {
+      cerr << "*** ERROR: Could not set up Qso to " << ip << endl;
+      return 1;
+    }
+    qsos.push_back(qso);
+  }
+
+  vector<float> audio(seconds * 8000);
+  for (size_t i=0; i<audio.size(); ++i)
+  {
+    audio[i] = 0.5f * sin(2.0 * M_PI * 440.0 * i / 8000.0) +
+               0.2f * sin(2.0 * M_PI * 1230.0 * i / 8000.0);
+  }
+
+  double start = cpu_time();
+  for (size_t pos=0; pos<audio.size(); pos+=block_size)
+  {
+    for (vector<Qso*>::iterator it=qsos.begin(); it!=qsos.end(); ++it)
+    {
+      (*it)->writeSamples(&audio[pos], block_size);
+    }
+  }
+  double per_qso_time = cpu_time() - start;
+
+  SharedEncoder enc;
+  unsigned packet_cnt = 0;
+  enc.audioEncoded.connect(
+      [&](Qso::RawPacket *gsm_packet, Qso::RawPacket *speex_packet)
+      {
+        for (vector<Qso*>::iterator it=qsos.begin(); it!=qsos.end(); ++it)
+        {
+          (*it)->sendEncodedAudio(gsm_packet, speex_packet);
+        }
+        ++packet_cnt;
+      });
+  start = cpu_time();
+  for (size_t pos=0; pos<audio.size(); pos+=block_size)
+  {
+    enc.writeSamples(&audio[pos], block_size);
+  }
+  double shared_time = cpu_time() - start;
+
+  printf("Stations                   : %d\n", station_cnt);
+  printf("Audio length               : %ds\n", seconds);
+  printf("Packets per station        : %u\n", packet_cnt);
+  printf("Per Qso encoder CPU/audio s: %.1fus\n",
+         1.0e6 * per_qso_time / seconds);
+  printf("Shared encoder CPU/audio s : %.1fus\n",
+         1.0e6 * shared_time / seconds);
+  printf("Speedup                    : %.2f\n", per_qso_time / shared_time);
+
+  for (vector<Qso*>::iterator it=qsos.begin(); it!=qsos.end(); ++it)
+  {
+    delete *it;
+  }
+  Dispatcher::deleteInstance();
+
+  return 0;
+} /* run_benchmark */
+
+
 /*
  *----------------------------------------------------------------------------
  * Function:  parse_arguments
@@ -615,6 +739,9 @@ static void parse_arguments( int argc, const char **argv )
 	    "Use EchoLink proxy TCP port (default 8100)", "<port>"},
     {"proxypasswd", 'p', POPT_ARG_STRING, &proxy_password, 0,
             "Use EchoLink Proxy server password", "<password>"},
+    {"bench", 0, POPT_ARG_INT, &bench_stations, 0,
+	    "Benchmark audio encoding for the given number of connected "
+	    "stations", "<stations>"},
     {NULL, 0, 0, NULL, 0}
   };
   int err;
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -211,6 +211,7 @@ void AprsTcpClient::updateQsoStatus(int action, const std::string& call,
   }
 
   num_connected = calls.size();
+  formatStaticParts();
 
   char msg[80];
   switch(action)
@@ -228,14 +229,7 @@ void AprsTcpClient::updateQsoStatus(int action, const std::string& call,
 
     // Object message for Echolink
     // ;EL-242660*111111z4900.05NE00823.29E0QSO status message
-  std::ostringstream objmsg;
-  objmsg << addrStr(loc_cfg.sourcecall)
-         << ";" << addresseeStr(loc_cfg.objectname) << "*"
-         << "111111z"
-         << posStr("E0")
-         << msg
-         ;
-  sendMsg(objmsg.str());
+  sendMsg(obj_prefix + posStr("E0") + msg);
 
     // Status message for Echolink, connected calls
   std::string status;
@@ -424,39 +418,46 @@ std::string AprsTcpClient::prependSpaceIfNotEmpty(const std::string& str) const
 } /* AprsTcpClient::prependSpaceIfNotEmpty */
 
 
+void AprsTcpClient::formatStaticParts(void)
+{
+    // The configuration is not changed after startup so the parts of the
+    // packets that do not depend on the current state are only built once.
+    // This cannot be done in the constructor since some of the configuration
+    // is read after the clients have been created.
+  if (!src_addr.empty())
+  {
+    return;
+  }
+
+  src_addr = addrStr(loc_cfg.sourcecall);
+
+    // MYCALL>APSVXn,path:;OBJECTNAM*111111z
+  obj_prefix = src_addr + ";" + addresseeStr(loc_cfg.objectname) + "*" +
+               "111111z";
+
+    // PHGphgd/438.875MHz T136 -060 R10k Comment
+  std::ostringstream info;
+  info << phgStr()
+       << frequencyStr()
+       << " " << toneStr()
+       << prependSpaceIfNotEmpty(txOffsetStr())
+       << " " << rangeStr()
+       << prependSpaceIfNotEmpty(loc_cfg.comment);
+  beacon_info = info.str();
+} /* AprsTcpClient::formatStaticParts */
+
+
 void AprsTcpClient::sendAprsBeacon(Timer *t)
 {
-  const std::string tx_offset_str = prependSpaceIfNotEmpty(txOffsetStr());
-  const std::string comment_str = prependSpaceIfNotEmpty(loc_cfg.comment);
+  formatStaticParts();
 
     // Position report for main object
-  std::ostringstream posmsg;
-  posmsg << addrStr(loc_cfg.sourcecall)
-         << ";" << addresseeStr(loc_cfg.objectname) << "*"
-         << "111111z"
-         << posStr(loc_cfg.symbol)
-         << phgStr()
-         << frequencyStr()
-         << " " << toneStr()
-         << tx_offset_str
-         << " " << rangeStr()
-         << comment_str;
-  sendMsg(posmsg.str());
+  sendMsg(obj_prefix + posStr(loc_cfg.symbol) + beacon_info);
 
   if (loc_cfg.objectname != loc_cfg.statscall)
   {
       // Position for source callsign
-    std::ostringstream posmsg;
-    posmsg << addrStr(loc_cfg.sourcecall)
-           << "="
-           << posStr(loc_cfg.symbol)
-           << phgStr()
-           << frequencyStr()
-           << " " << toneStr()
-           << tx_offset_str
-           << " " << rangeStr()
-           << comment_str;
-    sendMsg(posmsg.str());
+    sendMsg(src_addr + "=" + posStr(loc_cfg.symbol) + beacon_info);
     //std::ostringstream objmsg;
     //objmsg << addrStr(loc_cfg.sourcecall)
     //       << ";" << addresseeStr(loc_cfg.sourcecall) << "*"
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -143,6 +143,9 @@ class AprsTcpClient : public AprsClient, public sigc::trackable
 
     std::string         recv_buf;
     std::string         current_status;
+    std::string         src_addr;
+    std::string         obj_prefix;
+    std::string         beacon_info;
 
     void  sendMsg(std::string aprsmsg);
     std::string addrStr(const std::string& source) const;
@@ -155,6 +158,7 @@ class AprsTcpClient : public AprsClient, public sigc::trackable
     std::string rangeStr(void) const;
     std::string addresseeStr(const std::string& call) const;
     std::string prependSpaceIfNotEmpty(const std::string& str) const;
+    void  formatStaticParts(void);
     void  sendAprsBeacon(Async::Timer *t);
     void  sendAprsStatus(const std::string& src, const std::string& status);
 
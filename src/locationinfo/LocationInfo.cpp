@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <limits>
 #include <string>
 #include <regex>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -136,11 +137,15 @@ LocationInfo::LocationInfo(void)
 {
   aprs_stats_timer.expired.connect(sigc::hide(
       sigc::mem_fun(*this, &LocationInfo::sendAprsStatistics)));
+  update_timer.expired.connect(sigc::hide(
+      sigc::mem_fun(*this, &LocationInfo::flushUpdates)));
 } /* LocationInfo::LocationInfo */
 
 
 LocationInfo::~LocationInfo(void)
 {
+  flushUpdates();
+
   for (const auto client : clients)
   {
     delete client;
@@ -284,6 +289,9 @@ bool LocationInfo::initialize(Async::Config& cfg, const std::string& cfg_name)
 
   cfg.getValue(cfg_name, "FILTER", loc_cfg.filter);
 
+  cfg.getValue(cfg_name, "UPDATE_WINDOW", 0U, 60000U,
+      _instance->update_window, true);
+
   _instance->initExtPty(cfg.getValue(cfg_name, "PTY_PATH"));
 
   if(!init_ok)
@@ -297,10 +305,14 @@ bool LocationInfo::initialize(Async::Config& cfg, const std::string& cfg_name)
 
 void LocationInfo::updateDirectoryStatus(StationData::Status status)
 {
-  for (const auto client : clients)
-  {
-    client->updateDirectoryStatus(status);
-  }
+  queueUpdate("directory", std::to_string(status),
+      [this, status]()
+      {
+        for (const auto client : clients)
+        {
+          client->updateDirectoryStatus(status);
+        }
+      });
 } /* LocationInfo::updateDirectoryStatus */
 
 
@@ -308,20 +320,34 @@ void LocationInfo::updateQsoStatus(int action, const std::string& call,
                                    const std::string& info,
                                    const std::list<std::string>& calls)
 {
-  for (const auto client : clients)
+  std::ostringstream state;
+  state << action << " " << call << " " << info << ":";
+  for (const auto& c : calls)
   {
-    client->updateQsoStatus(action, call, info, calls);
+    state << " " << c;
   }
+  queueUpdate("qso", state.str(),
+      [this, action, call, info, calls]()
+      {
+        for (const auto client : clients)
+        {
+          client->updateQsoStatus(action, call, info, calls);
+        }
+      });
 } /* LocationInfo::updateQsoStatus */
 
 
 void LocationInfo::update3rdState(const std::string& call,
                                   const std::string& info)
 {
-  for (const auto client : clients)
-  {
-    client->update3rdState(call, info);
-  }
+  queueUpdate("3rd " + call, info,
+      [this, call, info]()
+      {
+        for (const auto client : clients)
+        {
+          client->update3rdState(call, info);
+        }
+      });
 } /* LocationInfo::update3rdState */
 
 
@@ -384,6 +410,17 @@ void LocationInfo::setReceiving(const std::string& name,
 } /* LocationInfo::setReceiving */
 
 
+LocationInfo::UpdateStats LocationInfo::updateStats(void) const
+{
+  UpdateStats stats = update_stats;
+  if (stats.sent > 0)
+  {
+    stats.avg_latency = update_latency_sum / stats.sent;
+  }
+  return stats;
+} /* LocationInfo::updateStats */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -748,6 +785,18 @@ void LocationInfo::sendAprsStatistics(void)
   addressee << ":" << std::left << std::setw(9) << loc_cfg.statscall << ":";
 
   const auto now = Clock::now();
+
+  if (loc_cfg.debug)
+  {
+    const UpdateStats ustats = updateStats();
+    std::cout << "APRS: Status updates sent=" << ustats.sent
+              << " suppressed=" << ustats.suppressed
+              << " latency avg/max="
+              << std::lrint(1000.0 * ustats.avg_latency) << "/"
+              << std::lrint(1000.0 * ustats.max_latency) << "ms"
+              << std::endl;
+  }
+
   bool send_metadata = (now - last_tlm_metadata > std::chrono::minutes(59));
   if (send_metadata)
   {
@@ -912,6 +961,72 @@ LocationInfo::aprsStats(const std::string& logic_name)
 } /* LocationInfo::aprsStats */
 
 
+void LocationInfo::queueUpdate(const std::string& object,
+                               const std::string& state,
+                               std::function<void()> send)
+{
+  auto it = pending_updates.find(object);
+  if (it != pending_updates.end())
+  {
+      // Replace the update that is already waiting for the same object. The
+      // time when the first update was queued is kept.
+    it->second.state = state;
+    it->second.send = std::move(send);
+    update_stats.suppressed += 1;
+    return;
+  }
+
+  const auto now = Clock::now();
+  PendingUpdate update{state, now, std::move(send)};
+  if (update_window == 0)
+  {
+    sendUpdate(object, update, now);
+    return;
+  }
+
+  pending_updates.emplace(object, std::move(update));
+  if (!update_timer.isEnabled())
+  {
+    update_timer.setTimeout(update_window);
+    update_timer.setEnable(true);
+  }
+} /* LocationInfo::queueUpdate */
+
+
+void LocationInfo::sendUpdate(const std::string& object,
+                              PendingUpdate& update, Timepoint now)
+{
+  auto sent_it = sent_updates.find(object);
+  if ((sent_it != sent_updates.end()) && (sent_it->second == update.state))
+  {
+    update_stats.suppressed += 1;
+    return;
+  }
+  sent_updates[object] = update.state;
+
+  update.send();
+
+  const double latency = Duration(now - update.queued).count();
+  update_stats.sent += 1;
+  update_latency_sum += latency;
+  update_stats.max_latency = std::max(update_stats.max_latency, latency);
+} /* LocationInfo::sendUpdate */
+
+
+void LocationInfo::flushUpdates(void)
+{
+  update_timer.setEnable(false);
+
+  PendingUpdateMap updates;
+  updates.swap(pending_updates);
+  const auto now = Clock::now();
+  for (auto& entry : updates)
+  {
+    sendUpdate(entry.first, entry.second, now);
+  }
+} /* LocationInfo::flushUpdates */
+
+
 /****************************************************************************
  *
  * Private local functions
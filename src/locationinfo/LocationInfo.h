@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -38,6 +38,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <list>
 #include <chrono>
+#include <map>
+#include <functional>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -154,6 +157,14 @@ class LocationInfo
       bool        narrow        {false};
     };
 
+    struct UpdateStats
+    {
+      uint64_t    sent          {0};    // Status updates sent to clients
+      uint64_t    suppressed    {0};    // Updates merged or not changed
+      double      avg_latency   {0.0};  // Avg time held back (seconds)
+      double      max_latency   {0.0};  // Max time held back (seconds)
+    };
+
     static LocationInfo* instance(void)
     {
       return _instance;
@@ -187,6 +198,7 @@ class LocationInfo
                          Timepoint tp=Clock::now());
     void setReceiving(const std::string& name, bool is_receiving,
                       const Timepoint& tp=Clock::now());
+    UpdateStats updateStats(void) const;
 
   private:
     static LocationInfo* _instance;
@@ -213,6 +225,14 @@ class LocationInfo
       }
     };
     using AprsStatsMap = std::map<std::string, AprsStatistics>;
+    struct PendingUpdate
+    {
+      std::string           state;
+      Timepoint             queued;
+      std::function<void()> send;
+    };
+    using PendingUpdateMap = std::map<std::string, PendingUpdate>;
+    using SentUpdateMap = std::map<std::string, std::string>;
 
     Cfg           loc_cfg; // weshalb?
     ClientList    clients;
@@ -223,6 +243,12 @@ class LocationInfo
     Timepoint     last_tlm_metadata {-std::chrono::hours(1)};
     AprsStatsMap  aprs_stats;
     Async::Pty*   aprspty           {nullptr};
+    unsigned      update_window     {2000}; // Milliseconds
+    Async::Timer  update_timer      {-1};
+    PendingUpdateMap pending_updates;
+    SentUpdateMap sent_updates;
+    UpdateStats   update_stats;
+    double        update_latency_sum {0.0};
 
     bool parsePosition(const Async::Config &cfg, const std::string &name);
     bool parseLatitude(Coordinate &pos, const std::string &value);
@@ -239,6 +265,11 @@ class LocationInfo
     void initExtPty(std::string ptydevice);
     void mesReceived(const void* buf, size_t len);
     AprsStatistics& aprsStats(const std::string& logic_name);
+    void queueUpdate(const std::string& object, const std::string& state,
+                     std::function<void()> send);
+    void sendUpdate(const std::string& object, PendingUpdate& update,
+                    Timepoint now);
+    void flushUpdates(void);
 
 };  /* class LocationInfo */
 
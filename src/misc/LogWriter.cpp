@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -31,14 +31,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <sys/time.h>
 #include <syslog.h>
 
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -72,6 +74,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+  // How long to wait for the rest of a row written to stdout or stderr
+  // before writing what we have got to the log
+#define PARTIAL_LINE_TIMEOUT  100
+
+  // Write an incomplete row to the log when it has grown this big
+#define PARTIAL_LINE_MAX      4096
 
 
 /****************************************************************************
@@ -80,6 +88,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+std::atomic<LogWriter*> LogWriter::active_writer {nullptr};
+
 
 
 /****************************************************************************
@@ -88,6 +98,17 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+struct LogWriter::LogRow
+{
+  static const size_t MAX_LEN = 256 - sizeof(std::atomic<uint64_t>) -
+                                sizeof(uint32_t);
+
+  std::atomic<uint64_t> seq;
+  uint32_t              len;
+  char                  buf[MAX_LEN];
+};
+
+
 class LogWriter::LogWriterWorker
 {
   public:
@@ -96,8 +117,8 @@ class LogWriter::LogWriterWorker
     virtual bool logOpen(void) { return true; }
     virtual void logClose(void) {}
     virtual void logReopen(std::string reason) {}
-    virtual bool logWriteTimestamp(void) { return true; }
-    virtual void logWrite(const char *buf) = 0;
+    virtual void logWrite(const char *buf, size_t len) = 0;
+    virtual void logFlush(void) {}
 };
 
 
@@ -110,13 +131,23 @@ class LogWriter::LogWriterWorkerFile : public LogWriter::LogWriterWorker
     virtual bool logOpen(void) override;
     virtual void logClose(void) override;
     virtual void logReopen(std::string reason) override;
-    virtual bool logWriteTimestamp(void) override;
-    virtual void logWrite(const char *buf) override;
+    virtual void logWrite(const char *buf, size_t len) override;
+    virtual void logFlush(void) override;
 
   private:
     std::string       m_logfile_name;
     int               m_logfd           {-1};
-    std::string       m_tstamp_format   {"%c"};
+    std::string       m_tstamp_pre;
+    std::string       m_tstamp_post;
+    bool              m_tstamp_frac     {false};
+    time_t            m_tstamp_sec      {-1};
+    std::string       m_tstamp;
+    size_t            m_tstamp_frac_pos {0};
+    bool              m_print_timestamp {true};
+    std::string       m_out;
+
+    void addTimestamp(const struct timeval& tv);
+    bool writeOut(void);
 };
 
 
@@ -124,7 +155,7 @@ class LogWriter::LogWriterWorkerSyslog : public LogWriter::LogWriterWorker
 {
   public:
     virtual ~LogWriterWorkerSyslog(void) {}
-    virtual void logWrite(const char *buf) override;
+    virtual void logWrite(const char *buf, size_t len) override;
   private:
     std::string   m_buf;
 };
@@ -158,12 +189,37 @@ LogWriter::LogWriter(void)
     perror("pipe");
     exit(1);
   }
+
+    // Create a pipe used to wake the logger thread up when a row have been
+    // put into the ring buffer
+  if (pipe(m_wakefd) == -1)
+  {
+    perror("pipe");
+    exit(1);
+  }
+  fcntl(m_wakefd[0], F_SETFL, O_NONBLOCK);
+  fcntl(m_wakefd[1], F_SETFL, O_NONBLOCK);
+
+  m_ring = new LogRow[RING_SIZE];
+  for (size_t i=0; i<RING_SIZE; ++i)
+  {
+    m_ring[i].seq = i;
+  }
 } /* LogWriter::LogWriter */
 
 
 LogWriter::~LogWriter(void)
 {
   stop();
+  for (auto& fd : m_wakefd)
+  {
+    if (fd != -1)
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+  delete [] m_ring;
 } /* LogWriter::~LogWriter */
 
 
@@ -171,10 +227,7 @@ void LogWriter::setTimestampFormat(const std::string& fmt)
 {
   const std::lock_guard<std::mutex> lock(m_mutex);
   m_tstamp_format = fmt;
-  if (m_worker != nullptr)
-  {
-    m_worker->setTimestampFormat(fmt);
-  }
+  m_tstamp_changed = true;
 } /* LogWriter::setTimestampFormat */
 
 
@@ -187,11 +240,15 @@ void LogWriter::setDestinationName(const std::string& name)
 void LogWriter::start(void)
 {
   m_logthread = std::thread(&LogWriter::writerThread, this);
+  active_writer = this;
 } /* LogWriter::start */
 
 
 void LogWriter::stop(void)
 {
+  LogWriter* self = this;
+  active_writer.compare_exchange_strong(self, nullptr);
+
   logFlush();
 
   if (m_pipefd[1] != -1)
@@ -251,6 +308,35 @@ void LogWriter::redirectStderr(void)
 } /* LogWriter::redirectStderr */
 
 
+bool LogWriter::log(const char* fmt, ...)
+{
+  va_list ap;
+  va_start(ap, fmt);
+  bool ret = true;
+  LogWriter* writer = active_writer;
+  if (writer != nullptr)
+  {
+    ret = writer->ringPush(fmt, ap);
+  }
+  else
+  {
+    char buf[LogRow::MAX_LEN];
+    int len = vsnprintf(buf, sizeof(buf), fmt, ap);
+    if (len >= 0)
+    {
+      fputs(buf, stdout);
+      if ((len == 0) || (len >= static_cast<int>(sizeof(buf))) ||
+          (buf[len-1] != '\n'))
+      {
+        fputc('\n', stdout);
+      }
+    }
+  }
+  va_end(ap);
+  return ret;
+} /* LogWriter::log */
+
+
 
 /****************************************************************************
  *
@@ -281,23 +367,100 @@ void LogWriter::writerThread(void)
     }
 
     m_worker->setTimestampFormat(m_tstamp_format);
+    m_tstamp_changed = false;
     if (!m_worker->logOpen())
     {
       abort();
     }
   }
 
-  for (;;)
+  bool done = false;
+  while (!done)
   {
-    char buf[256];
-    auto len = read(m_pipefd[0], buf, sizeof(buf)-1);
-    if ((len <= 0) || (buf[len-1] == '\0'))
+      // Only sleep if the ring buffer is empty. The flag tell producers that
+      // they need to wake us up.
+    m_ring_waiting = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    struct pollfd fds[2];
+    fds[0].fd = m_pipefd[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakefd[0];
+    fds[1].events = POLLIN;
+    int timeout = -1;
+    if (!ringEmpty())
+    {
+      timeout = 0;
+    }
+    else if (!m_partial_line.empty())
+    {
+      auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - m_partial_line_start).count();
+      timeout = std::max(0, PARTIAL_LINE_TIMEOUT - static_cast<int>(age));
+    }
+    int ret = poll(fds, 2, timeout);
+    if ((ret == -1) && (errno != EINTR))
     {
       break;
     }
-    buf[len] = 0;
-    const std::lock_guard<std::mutex> lock(m_mutex);
-    m_worker->logWrite(buf);
+    m_ring_waiting = false;
+
+    if (fds[1].revents != 0)
+    {
+      char tmp[64];
+      while (read(m_wakefd[0], tmp, sizeof(tmp)) > 0) {}
+    }
+
+    if (m_tstamp_changed)
+    {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+      m_worker->setTimestampFormat(m_tstamp_format);
+      m_tstamp_changed = false;
+    }
+
+    if (fds[0].revents != 0)
+    {
+      char buf[4096];
+      auto len = read(m_pipefd[0], buf, sizeof(buf));
+      if ((len <= 0) || (buf[len-1] == '\0'))
+      {
+        done = true;
+        len = (len > 0) ? len-1 : 0;
+      }
+      writeStream(buf, len);
+    }
+
+      // Rows from the ring buffer are not written in the middle of a row
+      // from stdout or stderr unless the rest of that row is late. The age
+      // is checked on every round since a steady flow of rows to the ring
+      // buffer would otherwise keep the poll from ever timing out.
+    bool partial_line_late = !m_partial_line.empty() &&
+        (std::chrono::steady_clock::now() - m_partial_line_start >=
+         std::chrono::milliseconds(PARTIAL_LINE_TIMEOUT));
+    if (!m_partial_line.empty() &&
+        (done || partial_line_late ||
+         (m_partial_line.size() >= PARTIAL_LINE_MAX)))
+    {
+      m_worker->logWrite(m_partial_line.data(), m_partial_line.size());
+      m_partial_line.clear();
+      m_mid_line = true;
+    }
+
+    ringDrain();
+
+    uint64_t dropped = m_dropped;
+    if (dropped != m_dropped_reported)
+    {
+      char msg[128];
+      int len = snprintf(msg, sizeof(msg),
+          "*** WARNING: %llu log rows dropped since the log ring was full\n",
+          static_cast<unsigned long long>(dropped - m_dropped_reported));
+      m_worker->logWrite(msg, len);
+      m_dropped_reported = dropped;
+    }
+
+      // Everything read in this round is written to the log in one go
+    m_worker->logFlush();
+
     if (m_reopen_log)
     {
       m_worker->logReopen("Reopen requested");
@@ -306,7 +469,6 @@ void LogWriter::writerThread(void)
   }
 
   const std::lock_guard<std::mutex> lock(m_mutex);
-  //m_worker->logWrite("### logwriter exited\n");
   delete m_worker;
   m_worker = nullptr;
 } /* LogWriter::writerThread */
@@ -319,6 +481,122 @@ void LogWriter::logFlush(void)
 } /* LogWriter::logFlush */
 
 
+bool LogWriter::ringPush(const char* fmt, va_list ap)
+{
+    // This is a bounded multi producer queue. Each slot have a sequence
+    // number that tell if the slot is free for the producer that claim
+    // position pos (seq == pos) or if it hold a row for the consumer
+    // (seq == pos + 1).
+  uint64_t pos = m_ring_head.load(std::memory_order_relaxed);
+  LogRow* row;
+  for (;;)
+  {
+    row = &m_ring[pos % RING_SIZE];
+    uint64_t seq = row->seq.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(seq - pos);
+    if (diff == 0)
+    {
+      if (m_ring_head.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    else
+    {
+      pos = m_ring_head.load(std::memory_order_relaxed);
+    }
+  }
+
+  int len = vsnprintf(row->buf, sizeof(row->buf), fmt, ap);
+  if (len < 0)
+  {
+    len = 0;
+  }
+  else if (len >= static_cast<int>(sizeof(row->buf)))
+  {
+    len = sizeof(row->buf) - 1;
+  }
+  if ((len == 0) || (row->buf[len-1] != '\n'))
+  {
+    if (len == sizeof(row->buf) - 1)
+    {
+      len -= 1;
+    }
+    row->buf[len++] = '\n';
+  }
+  row->len = len;
+  row->seq.store(pos + 1, std::memory_order_release);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_ring_waiting.load(std::memory_order_relaxed) &&
+      m_ring_waiting.exchange(false))
+  {
+    char ch = 0;
+    if ((write(m_wakefd[1], &ch, 1) == -1) && (errno != EAGAIN))
+    {
+      perror("write in LogWriter::ringPush");
+    }
+  }
+  return true;
+} /* LogWriter::ringPush */
+
+
+bool LogWriter::ringEmpty(void) const
+{
+  const LogRow& row = m_ring[m_ring_tail % RING_SIZE];
+  return row.seq.load(std::memory_order_acquire) != m_ring_tail + 1;
+} /* LogWriter::ringEmpty */
+
+
+void LogWriter::ringDrain(void)
+{
+  while (!ringEmpty())
+  {
+    if (m_mid_line)
+    {
+      m_worker->logWrite("\n", 1);
+      m_mid_line = false;
+    }
+    LogRow& row = m_ring[m_ring_tail % RING_SIZE];
+    m_worker->logWrite(row.buf, row.len);
+    row.seq.store(m_ring_tail + RING_SIZE, std::memory_order_release);
+    m_ring_tail += 1;
+  }
+} /* LogWriter::ringDrain */
+
+
+void LogWriter::writeStream(const char* buf, size_t len)
+{
+  const char* end = buf + len;
+  const char* last_nl = end;
+  while ((last_nl > buf) && (*(last_nl-1) != '\n'))
+  {
+    --last_nl;
+  }
+  if (last_nl > buf)
+  {
+    if (!m_partial_line.empty())
+    {
+      m_worker->logWrite(m_partial_line.data(), m_partial_line.size());
+      m_partial_line.clear();
+    }
+    m_worker->logWrite(buf, last_nl - buf);
+    m_mid_line = false;
+  }
+  if (m_partial_line.empty() && (last_nl < end))
+  {
+    m_partial_line_start = std::chrono::steady_clock::now();
+  }
+  m_partial_line.append(last_nl, end - last_nl);
+} /* LogWriter::writeStream */
+
+
 
 LogWriter::LogWriterWorkerFile::LogWriterWorkerFile(const std::string& filename)
   : m_logfile_name(filename)
@@ -328,7 +606,14 @@ LogWriter::LogWriterWorkerFile::LogWriterWorkerFile(const std::string& filename)
 
 void LogWriter::LogWriterWorkerFile::setTimestampFormat(const std::string& fmt)
 {
-  m_tstamp_format = fmt;
+    // The timestamp is only formatted once every second. The milliseconds,
+    // if requested using %f, are filled in for each row.
+  const std::string frac_code("%f");
+  size_t pos = fmt.find(frac_code);
+  m_tstamp_frac = (pos != std::string::npos);
+  m_tstamp_pre = fmt.substr(0, pos);
+  m_tstamp_post = m_tstamp_frac ? fmt.substr(pos + frac_code.length()) : "";
+  m_tstamp_sec = -1;
 } /* LogWriter::LogWriterWorkerFile::setTimestampFormat */
 
 
@@ -364,10 +649,14 @@ void LogWriter::LogWriterWorkerFile::logReopen(std::string reason)
     reason += ". ";
   }
 
-  logWriteTimestamp();
-  std::string msg(reason);
-  msg += "Reopening logfile...\n";
-  if (write(m_logfd, msg.c_str(), msg.size()) == -1)
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  m_out.clear();
+  m_print_timestamp = true;
+  addTimestamp(tv);
+  m_out += reason;
+  m_out += "Reopening logfile...\n";
+  if (!writeOut())
   {
     abort();
   }
@@ -377,98 +666,122 @@ void LogWriter::LogWriterWorkerFile::logReopen(std::string reason)
     abort();
   }
 
-  logWriteTimestamp();
-  msg = reason;
-  msg += "Logfile reopened.\n";
-  if (write(m_logfd, msg.c_str(), msg.size()) == -1)
+  addTimestamp(tv);
+  m_out += reason;
+  m_out += "Logfile reopened.\n";
+  if (!writeOut())
   {
     abort();
   }
 } /* LogWriter::LogWriterWorkerFile::logReopen */
 
 
-bool LogWriter::LogWriterWorkerFile::logWriteTimestamp(void)
+void LogWriter::LogWriterWorkerFile::logWrite(const char *buf, size_t len)
 {
-  if (!m_tstamp_format.empty())
-  {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    std::string fmt(m_tstamp_format);
-    const std::string frac_code("%f");
-    size_t pos = fmt.find(frac_code);
-    if (pos != std::string::npos)
-    {
-      std::stringstream ss;
-      ss << std::setfill('0') << std::setw(3) << (tv.tv_usec / 1000);
-      fmt.replace(pos, frac_code.length(), ss.str());
-    }
-    struct tm tm;
-    char tstr[256];
-    size_t tlen = strftime(tstr, sizeof(tstr), fmt.c_str(),
-                           localtime_r(&tv.tv_sec, &tm));
-    ssize_t ret = write(m_logfd, tstr, tlen);
-    if (ret != static_cast<ssize_t>(tlen))
+  if (m_logfd == -1)
+  {
+    return;
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+
+  const char *ptr = buf;
+  const char *end = buf + len;
+  while (ptr < end)
+  {
+    if (m_print_timestamp)
     {
-      return false;
+      addTimestamp(tv);
+      m_print_timestamp = false;
     }
-    ret = write(m_logfd, ": ", 2);
-    if (ret != 2)
+
+    const char *nl = static_cast<const char*>(memchr(ptr, '\n', end-ptr));
+    const char *next = end;
+    if (nl != nullptr)
     {
-      return false;
+      next = nl + 1;
+      m_print_timestamp = true;
     }
+    m_out.append(ptr, next-ptr);
+    ptr = next;
   }
-  return true;
-} /* LogWriter::LogWriterWorkerFile::logWriteTimestamp */
+} /* LogWriter::LogWriterWorkerFile::logWrite */
 
 
-void LogWriter::LogWriterWorkerFile::logWrite(const char *buf)
+void LogWriter::LogWriterWorkerFile::logFlush(void)
 {
-  if (m_logfd == -1)
+  if (!writeOut())
   {
-    return;
+    logReopen("Write error");
   }
+} /* LogWriter::LogWriterWorkerFile::logFlush */
 
-  const char *ptr = buf;
-  while (*ptr != 0)
+
+void LogWriter::LogWriterWorkerFile::addTimestamp(const struct timeval& tv)
+{
+  if (m_tstamp_pre.empty() && !m_tstamp_frac)
   {
-    static bool print_timestamp = true;
-    ssize_t ret;
+    return;
+  }
 
-    if (print_timestamp)
+  if (tv.tv_sec != m_tstamp_sec)
+  {
+    struct tm tm;
+    localtime_r(&tv.tv_sec, &tm);
+    char tstr[256];
+    size_t tlen = strftime(tstr, sizeof(tstr), m_tstamp_pre.c_str(), &tm);
+    m_tstamp.assign(tstr, tlen);
+    m_tstamp_frac_pos = m_tstamp.size();
+    if (m_tstamp_frac)
     {
-      if (!logWriteTimestamp())
-      {
-        logReopen("Write error");
-        return;
-      }
-      print_timestamp = false;
+      m_tstamp += "000";
+      tlen = strftime(tstr, sizeof(tstr), m_tstamp_post.c_str(), &tm);
+      m_tstamp.append(tstr, tlen);
     }
+    m_tstamp += ": ";
+    m_tstamp_sec = tv.tv_sec;
+  }
 
-    size_t write_len = 0;
-    const char *nl = strchr(ptr, '\n');
-    if (nl != 0)
-    {
-      write_len = nl-ptr+1;
-      print_timestamp = true;
-    }
-    else
-    {
-      write_len = strlen(ptr);
-    }
-    ret = write(m_logfd, ptr, write_len);
-    if (ret != static_cast<ssize_t>(write_len))
+  size_t pos = m_out.size();
+  m_out += m_tstamp;
+  if (m_tstamp_frac)
+  {
+    unsigned msec = tv.tv_usec / 1000;
+    m_out[pos + m_tstamp_frac_pos] = '0' + msec / 100;
+    m_out[pos + m_tstamp_frac_pos + 1] = '0' + (msec / 10) % 10;
+    m_out[pos + m_tstamp_frac_pos + 2] = '0' + msec % 10;
+  }
+} /* LogWriter::LogWriterWorkerFile::addTimestamp */
+
+
+bool LogWriter::LogWriterWorkerFile::writeOut(void)
+{
+  const char *ptr = m_out.data();
+  size_t left = m_out.size();
+  while (left > 0)
+  {
+    ssize_t ret = write(m_logfd, ptr, left);
+    if (ret == -1)
     {
-      logReopen("Write error");
-      return;
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      m_out.clear();
+      return false;
     }
-    ptr += write_len;
+    ptr += ret;
+    left -= ret;
   }
-} /* LogWriter::LogWriterWorkerFile::logWrite */
+  m_out.clear();
+  return true;
+} /* LogWriter::LogWriterWorkerFile::writeOut */
 
 
-void LogWriter::LogWriterWorkerSyslog::logWrite(const char* buf)
+void LogWriter::LogWriterWorkerSyslog::logWrite(const char* buf, size_t len)
 {
-  m_buf.append(buf);
+  m_buf.append(buf, len);
 
   std::string::size_type pos;
   while ((pos = m_buf.find ('\n')) != std::string::npos)
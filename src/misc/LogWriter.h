@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -38,6 +38,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdarg>
 
 
 /****************************************************************************
@@ -113,6 +117,14 @@ to syslog.
 When writing to a file, each row will be prefixed with a timestamp.
 
 When writing to syslog, the timestamp format in SvxLink is ignored.
+
+Apart from stdout and stderr, log rows can be written using the static
+function LogWriter::log. That function format the row using printf style
+formatting directly into a lock free ring buffer that is emptied by the logger
+thread, so it is cheap enough to use in places that are called often and it
+can be used from any thread. If the ring buffer is full, the row is dropped
+and counted. A warning about dropped rows is written to the log the next time
+the logger thread run.
 */
 class LogWriter
 {
@@ -174,21 +186,59 @@ class LogWriter
      */
     void redirectStderr(void);
 
+    /**
+     * @brief   Get the number of log rows dropped since the ring was full
+     * @return  Returns the total number of dropped rows
+     */
+    uint64_t droppedRows(void) const { return m_dropped; }
+
+    /**
+     * @brief   Write a log row without going through stdout
+     * @param   fmt A printf style format string
+     * @return  Returns \em false if the row was dropped
+     *
+     * The row is queued to the logger thread that have been started most
+     * recently. A newline is added if the row does not end with one. Rows
+     * longer than about 250 characters are truncated. If no logger thread
+     * is running, the row is written to stdout.
+     */
+    static bool log(const char* fmt, ...)
+      __attribute__ ((format (printf, 1, 2)));
+
   private:
     class LogWriterWorker;
     class LogWriterWorkerFile;
     class LogWriterWorkerSyslog;
-
-    std::string       m_dest_name;
-    std::string       m_tstamp_format {"%c"};
-    std::atomic_bool  m_reopen_log;
-    int               m_pipefd[2]     {-1, -1};
-    std::thread       m_logthread;
-    std::mutex        m_mutex;
-    LogWriterWorker*  m_worker        {nullptr};
+    struct LogRow;
+
+    static const size_t RING_SIZE = 1024;
+    static std::atomic<LogWriter*> active_writer;
+
+    std::string           m_dest_name;
+    std::string           m_tstamp_format     {"%c"};
+    std::atomic_bool      m_tstamp_changed    {false};
+    std::atomic_bool      m_reopen_log        {false};
+    int                   m_pipefd[2]         {-1, -1};
+    int                   m_wakefd[2]         {-1, -1};
+    std::thread           m_logthread;
+    std::mutex            m_mutex;
+    LogWriterWorker*      m_worker            {nullptr};
+    LogRow*               m_ring              {nullptr};
+    std::atomic<uint64_t> m_ring_head         {0};
+    uint64_t              m_ring_tail         {0};
+    std::atomic_bool      m_ring_waiting      {false};
+    std::atomic<uint64_t> m_dropped           {0};
+    uint64_t              m_dropped_reported  {0};
+    std::string           m_partial_line;
+    std::chrono::steady_clock::time_point m_partial_line_start;
+    bool                  m_mid_line          {false};
 
     void writerThread(void);
     void logFlush(void);
+    bool ringPush(const char* fmt, va_list ap);
+    bool ringEmpty(void) const;
+    void ringDrain(void);
+    void writeStream(const char* buf, size_t len);
 
 }; /* class LogWriter */
 
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <unistd.h>
+
+#include "LogWriter.h"
+
+using namespace std;
+
+
+/*
+ * Benchmark for the LogWriter class.
+ *
+ * Usage: LogWriterBench [threads] [rows per thread]
+ *
+ * Stdout is redirected to a LogWriter that write to a temporary logfile. A
+ * number of threads first write rows to the log using std::cout and then the
+ * same number of rows using LogWriter::log. The time spent in the threads
+ * writing the rows is measured, as well as the time until all rows have been
+ * written to the logfile. The logfile is then checked so that each row
+ * written using LogWriter::log is either in the file or counted as dropped.
+ * The results are printed on stderr.
+ */
+
+namespace {
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+double runThreads(unsigned threads, void (*func)(unsigned, unsigned),
+                  unsigned rows)
+{
+  double t0 = wallTime();
+  std::vector<std::thread> thrs;
+  for (unsigned t=0; t<threads; ++t)
+  {
+    thrs.emplace_back(func, t, rows);
+  }
+  for (auto& thr : thrs)
+  {
+    thr.join();
+  }
+  return wallTime() - t0;
+}
+
+void coutRows(unsigned thread, unsigned rows)
+{
+  for (unsigned i=0; i<rows; ++i)
+  {
+    std::cout << "cout row " << thread << ":" << i << " "
+              << 1.0 * i / rows << std::endl;
+  }
+}
+
+void logRows(unsigned thread, unsigned rows)
+{
+  for (unsigned i=0; i<rows; ++i)
+  {
+    LogWriter::log("ring row %u:%u %g", thread, i, 1.0 * i / rows);
+  }
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned threads = 4;
+  unsigned rows = 100000;
+  if (argc > 1)
+  {
+    threads = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    rows = atoi(argv[2]);
+  }
+  if ((threads < 1) || (rows < 1))
+  {
+    cerr << "Usage: LogWriterBench [threads] [rows per thread]\n";
+    exit(1);
+  }
+
+  char logfile[] = "/tmp/LogWriterBench.XXXXXX";
+  int fd = mkstemp(logfile);
+  if (fd == -1)
+  {
+    perror("mkstemp");
+    exit(1);
+  }
+  close(fd);
+
+  LogWriter logwriter;
+  logwriter.setDestinationName(logfile);
+  logwriter.setTimestampFormat("%Y-%m-%d %H:%M:%S.%f");
+  logwriter.redirectStdout();
+  logwriter.start();
+
+  const unsigned total = threads * rows;
+  double cout_time = runThreads(threads, coutRows, rows);
+  double log_time = runThreads(threads, logRows, rows);
+  double t0 = wallTime();
+  logwriter.stop();
+  double drain_time = wallTime() - t0;
+
+  unsigned cout_found = 0;
+  unsigned log_found = 0;
+  std::ifstream is(logfile);
+  std::string line;
+  while (std::getline(is, line))
+  {
+    if (line.find(": cout row ") != std::string::npos)
+    {
+      cout_found += 1;
+    }
+    else if (line.find(": ring row ") != std::string::npos)
+    {
+      log_found += 1;
+    }
+  }
+  is.close();
+  unlink(logfile);
+
+  fprintf(stderr, "std::cout      %u rows in %7.3f s (%6.0f ns/row), "
+                  "%u rows in logfile\n",
+          total, cout_time, 1.0e9 * cout_time / total, cout_found);
+  fprintf(stderr, "LogWriter::log %u rows in %7.3f s (%6.0f ns/row), "
+                  "%u rows in logfile, %llu dropped\n",
+          total, log_time, 1.0e9 * log_time / total, log_found,
+          static_cast<unsigned long long>(logwriter.droppedRows()));
+  fprintf(stderr, "Logfile written %.3f s after the last row\n", drain_time);
+
+  bool ok = (log_found + logwriter.droppedRows() == total);
+  fprintf(stderr, "%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+} /* main */
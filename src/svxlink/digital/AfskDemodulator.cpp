@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iomanip>
 #include <sstream>
 #include <deque>
+#include <vector>
+#include <algorithm>
 
 
 /****************************************************************************
@@ -88,7 +90,7 @@ namespace {
     public:
       Correlator(float f0, float f1, unsigned baudrate,
           unsigned sample_rate=INTERNAL_SAMPLE_RATE)
-        : delay(0), head(0)
+        : delay(0)
       {
           // Calculate the optimum value for the delay
         unsigned samples_per_symbol = sample_rate / baudrate;
@@ -105,30 +107,32 @@ namespace {
         }
         cout << "### Delay: " << delay << endl;
 
-        buf = new float[delay];
-        memset(buf, 0, sizeof(float) * delay);
+        hist.assign(delay, 0.0f);
       }
 
-      ~Correlator(void)
-      {
-        delete [] buf;
-      }
+      ~Correlator(void) {}
 
     protected:
       void processSamples(float *out, const float *in, int len)
       {
+          // The history buffer hold the last "delay" input samples followed
+          // by the new block so the multiplication can be done in one
+          // straight loop without any index wrapping, which the compiler
+          // can vectorize.
+        hist.resize(delay + len);
+        copy(in, in + len, hist.begin() + delay);
+        const float *delayed = hist.data();
+        const float *current = hist.data() + delay;
         for (int i=0; i<len; ++i)
         {
-          out[i] = in[i] * buf[head];
-          buf[head] = in[i];
-          head = (head+1) % delay;
+          out[i] = current[i] * delayed[i];
         }
+        copy(hist.end() - delay, hist.end(), hist.begin());
       }
 
     private:
-      unsigned  delay;
-      float *   buf;
-      unsigned  head;
+      unsigned            delay;
+      std::vector<float>  hist;
   };
 
 #if 0
@@ -165,7 +169,7 @@ namespace {
   {
     public:
       DcBlocker(size_t order)
-        : order(order), delay(order, 0.0f), prev(0.0f)
+        : order(order), hist(order, 0.0f), prev(0.0f)
       {
       }
 
@@ -183,22 +187,25 @@ namespace {
        */
       virtual void processSamples(float *dest, const float *src, int count)
       {
+          // Same layout as in the correlator. The last "order" input samples
+          // are followed by the new block.
+        hist.resize(order + count);
+        copy(src, src + count, hist.begin() + order);
+        const float *old = hist.data();
+        const float *in = hist.data() + order;
         for (int i=0; i<count; ++i)
         {
-          float in = src[i];
-          float out = (in - delay.back()) / order + prev;
-          //dest[i] = delay[order/2]-out;
-          dest[i] = in-out;
+          float out = (in[i] - old[i]) / order + prev;
+          dest[i] = in[i] - out;
           prev = out;
-          delay.pop_back();
-          delay.push_front(in);
         }
+        copy(hist.end() - order, hist.end(), hist.begin());
       }
 
     private:
-      const size_t  order;
-      deque<float>  delay;
-      float         prev;
+      const size_t        order;
+      std::vector<float>  hist;
+      float               prev;
 
   }; /* class DcBlocker */
 }; /* Anonymous namespace */
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -64,8 +64,6 @@ using namespace std;
  *
  ****************************************************************************/
 
-#define PPPINITFCS      0xffff	/* Initial FCS value */
-#define PPPGOODFCS      0xf0b8	/* Good final FCS value */
 
 
 /****************************************************************************
@@ -82,9 +80,6 @@ using namespace std;
  *
  ****************************************************************************/
 
-namespace {
-  uint16_t pppfcs(uint16_t fcs, const uint8_t *cp, size_t len);
-};
 
 
 /****************************************************************************
@@ -151,45 +146,35 @@ namespace {
  *
  ****************************************************************************/
 
-uint16_t fcsCalc(const std::vector<uint8_t> buf)
+uint16_t fcsCalc(const std::vector<uint8_t>& buf)
 {
-  uint16_t fcs = PPPINITFCS;
-  fcs = pppfcs(fcs, buf.data(), buf.size());
+  uint16_t fcs = fcsUpdate(FCS_INIT, buf.data(), buf.size());
   fcs ^= 0xffff;
   return fcs;
 } /* fcsCalc */
 
 
-bool fcsOk(const std::vector<uint8_t> buf)
+bool fcsOk(const std::vector<uint8_t>& buf)
 {
-  uint16_t fcs = PPPINITFCS;
-  fcs = pppfcs(fcs, buf.data(), buf.size());
-  return (fcs == PPPGOODFCS);
+  return (fcsUpdate(FCS_INIT, buf.data(), buf.size()) == FCS_GOOD);
 } /* fcsOk */
 
 
-/****************************************************************************
- *
- * Private functions
- *
- ****************************************************************************/
-
-namespace {
-
-/*
- * Calculate a new fcs given the current fcs and the new data.
- */
-uint16_t pppfcs(uint16_t fcs, const uint8_t *cp, size_t len)
+uint16_t fcsUpdate(uint16_t fcs, const uint8_t *cp, size_t len)
 {
   while (len--)
   {
     fcs = (fcs >> 8) ^ fcstab[(fcs ^ *cp++) & 0xff];
   }
+  return fcs;
+} /* fcsUpdate */
 
-  return (fcs);
-}
 
-}; /* namespace */
+/****************************************************************************
+ *
+ * Private functions
+ *
+ ****************************************************************************/
 
 /*
  * This file has not been truncated
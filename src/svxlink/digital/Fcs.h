@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stddef.h>
 #include <vector>
 
 
@@ -86,6 +87,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+  /// The initial FCS value to use when calculating the FCS incrementally
+static const uint16_t FCS_INIT = 0xffff;
+
+  /// The FCS value obtained after running a valid frame, including its FCS
+static const uint16_t FCS_GOOD = 0xf0b8;
 
 
 /****************************************************************************
@@ -107,14 +113,27 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  * @param   buf The buffer containing the data bytes
  * @return  Return the 16 bit frame check sequence
  */
-uint16_t fcsCalc(const std::vector<uint8_t> buf);
+uint16_t fcsCalc(const std::vector<uint8_t>& buf);
 
 /**
  * @brief   Check if the buffer contain a valid data stream
  * @param   buf The buffer containing the data bytes and the transmitted FCS
  * @return  Returns \em true on success or \em false on failure
  * */
-bool fcsOk(const std::vector<uint8_t> buf);
+bool fcsOk(const std::vector<uint8_t>& buf);
+
+/**
+ * @brief   Update a running frame check sequence with more data
+ * @param   fcs The current FCS value, FCS_INIT for the first call
+ * @param   buf The buffer containing the data bytes
+ * @param   len The number of bytes in the buffer
+ * @return  Returns the updated FCS value
+ *
+ * This function can be used to calculate the FCS while a frame is being
+ * received. When all data, including the transmitted FCS, have been run
+ * through this function the result will be FCS_GOOD for a valid frame.
+ */
+uint16_t fcsUpdate(uint16_t fcs, const uint8_t *buf, size_t len);
 
 
 //} /* namespace */
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -99,6 +99,11 @@ using namespace std;
  *
  ****************************************************************************/
 
+namespace {
+    // Max size of a received frame, including the FCS
+  const size_t MAX_FRAME_SIZE = 330;
+};
+
 
 
 /****************************************************************************
@@ -108,8 +113,10 @@ using namespace std;
  ****************************************************************************/
 
 HdlcDeframer::HdlcDeframer(void)
-  : state(STATE_SYNCHRONIZING), next_byte(0), bit_cnt(0), ones(0)
+  : state(STATE_SYNCHRONIZING), next_byte(0), bit_cnt(0), ones(0),
+    fcs(FCS_INIT)
 {
+  frame.reserve(MAX_FRAME_SIZE);
 } /* HdlcDeframer::HdlcDeframer */
 
 
@@ -118,15 +125,16 @@ HdlcDeframer::~HdlcDeframer(void)
 } /* HdlcDeframer::~HdlcDeframer */
 
 
-void HdlcDeframer::bitsReceived(vector<bool> &bits)
+void HdlcDeframer::bitsReceived(const uint8_t *bits, size_t count)
 {
-  for (size_t i=0; i<bits.size(); ++i)
+  for (size_t i=0; i<count; ++i)
   {
     bool flag_detected = false;
+    uint8_t bit = (bits[i / 8] >> (i % 8)) & 1;
 
       // Undo bitstuffing. If we receive a zero and the previous five bits
       // have been ones, the zero should be thrown away.
-    if (bits[i])
+    if (bit)
     {
       ones += 1;
     }
@@ -145,7 +153,7 @@ void HdlcDeframer::bitsReceived(vector<bool> &bits)
     }
 
     next_byte >>= 1;
-    next_byte |= (bits[i] << 7);
+    next_byte |= (bit << 7);
     switch (state)
     {
       case STATE_SYNCHRONIZING:
@@ -164,6 +172,7 @@ void HdlcDeframer::bitsReceived(vector<bool> &bits)
             state = STATE_RECEIVING;
             frame.clear();
             frame.push_back(next_byte);
+            fcs = fcsUpdate(FCS_INIT, &next_byte, 1);
           }
           //frame.push_back(next_byte);
           bit_cnt = 0;
@@ -197,7 +206,9 @@ void HdlcDeframer::bitsReceived(vector<bool> &bits)
             }
             cout << endl << endl;
             */
-            if ((frame.size() > 2) && fcsOk(frame))
+              // The FCS is calculated as the bytes arrive. Running the
+              // transmitted FCS through the calculation give a constant.
+            if ((frame.size() > 2) && (fcs == FCS_GOOD))
             {
                 // Remove CRC from frame
               frame.pop_back();
@@ -207,9 +218,10 @@ void HdlcDeframer::bitsReceived(vector<bool> &bits)
           }
           else
           {
-            if(frame.size() < 330)
+            if(frame.size() < MAX_FRAME_SIZE)
             {
               frame.push_back(next_byte);
+              fcs = fcsUpdate(fcs, &next_byte, 1);
               next_byte = 0;
             }
             else
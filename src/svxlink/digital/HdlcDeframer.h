@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -128,9 +128,13 @@ class HdlcDeframer : public sigc::trackable
 
     /**
      * @brief 	Process bitstream
-     * @param 	bits The bitstream to process
+     * @param 	bits The bitstream to process, packed LSB first
+     * @param   count The number of bits in the bitstream
+     *
+     * Bit n is found in byte n / 8 at bit position n % 8, which is the
+     * format emitted by the Synchronizer::bitsReceived signal.
      */
-    void bitsReceived(std::vector<bool> &bits);
+    void bitsReceived(const uint8_t *bits, size_t count);
 
     /**
      * @brief 	Signal that is emitted when a complete frame have been received
@@ -148,6 +152,7 @@ class HdlcDeframer : public sigc::trackable
     uint8_t               bit_cnt;
     std::vector<uint8_t>  frame;
     unsigned              ones;
+    uint16_t              fcs;
 
     HdlcDeframer(const HdlcDeframer&);
     HdlcDeframer& operator=(const HdlcDeframer&);
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -107,7 +107,7 @@ using namespace std;
 
 Synchronizer::Synchronizer(unsigned baudrate, unsigned sample_rate)
   : baudrate(baudrate), sample_rate(sample_rate),
-    shift_pos(sample_rate / 2), pos(0), was_mark(false),
+    shift_pos(sample_rate / 2), pos(0), bit_cnt(0), was_mark(false),
     last_stored_was_mark(false)
 {
 } /* Synchronizer::Synchronizer */
@@ -121,6 +121,9 @@ Synchronizer::~Synchronizer(void)
 int Synchronizer::writeSamples(const float *samples, int len)
 {
   //cout << pos << endl;
+    // At most one bit can be extracted per sample
+  bitbuf.assign(len / 8 + 1, 0);
+  bit_cnt = 0;
   for (int i=0; i<len; ++i)
   {
     pos += baudrate;
@@ -144,25 +147,21 @@ int Synchronizer::writeSamples(const float *samples, int len)
       // Extract bit if pos >= sample_rate
     if (pos >= sample_rate)
     {
-      bitbuf.push_back(is_mark == last_stored_was_mark);
-      last_stored_was_mark = is_mark;
-      if (bitbuf.size() >= 8)
+      if (is_mark == last_stored_was_mark)
       {
-        /*
-        for (size_t i=0; i<bitbuf.size(); ++i)
-        {
-          cout << (bitbuf[i] ? '1' : '0');
-        }
-        float err_percent = 100.0 * static_cast<float>(err) / sample_rate;
-        cout << "  " << err << " " << err_percent << "%" << endl;
-        */
-        bitsReceived(bitbuf);
-        bitbuf.clear();
+        bitbuf[bit_cnt / 8] |= 1 << (bit_cnt % 8);
       }
+      ++bit_cnt;
+      last_stored_was_mark = is_mark;
       pos -= sample_rate;
     }
   }
 
+  if (bit_cnt > 0)
+  {
+    bitsReceived(bitbuf.data(), bit_cnt);
+  }
+
   return len;
 } /* Synchronizer::writeSamples */
 
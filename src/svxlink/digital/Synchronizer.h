@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2018 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <vector>
+#include <stdint.h>
 #include <sigc++/sigc++.h>
 
 
@@ -152,16 +153,21 @@ class Synchronizer : public Async::AudioSink, public sigc::trackable
 
     /**
      * @brief   A signal emitted when new bits have been received
-     * @param   A vector of received bits
+     * @param   bits The received bits packed LSB first, eight per byte
+     * @param   bit_cnt The number of bits received
+     *
+     * All bits extracted from one block of incoming samples are emitted in
+     * one go. Bit n is found in byte n / 8 at bit position n % 8.
      */
-    sigc::signal<void(std::vector<bool>&)> bitsReceived;
+    sigc::signal<void(const uint8_t*, size_t)> bitsReceived;
 
   private:
     const unsigned    baudrate;
     const unsigned    sample_rate;
     const unsigned    shift_pos;
     unsigned          pos;
-    std::vector<bool> bitbuf;
+    std::vector<uint8_t> bitbuf;
+    size_t            bit_cnt;
     bool              was_mark;
     bool              last_stored_was_mark;
     int               err;
@@ -4,6 +4,13 @@
  * sox TNC_Test_Ver-1.1-01.wav -t raw -esigned-integer -c1 -r 16000 - | \
  * valgrind --leak-check=full svxlink/digital/afsk_test
  *
+ * Measure the receiver throughput with:
+ * svxlink/digital/afsk_test -b [frame count]
+ *
+ * In benchmark mode a number of random frames are modulated into memory and
+ * then run through the demodulator, synchronizer and deframer as fast as
+ * possible. No configuration file or audio input is needed.
+ *
  ******************************************************************************/
 
 #include <iostream>
@@ -12,6 +19,10 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <algorithm>
 #include <unistd.h>
 
 #include <AsyncCppApplication.h>
@@ -329,6 +340,113 @@ class StdInSourceDev : public StdInSource
 };
 
 
+class BufferSink : public Async::AudioSink
+{
+  public:
+    vector<float> samples;
+
+    virtual int writeSamples(const float *buf, int count)
+    {
+      samples.insert(samples.end(), buf, buf + count);
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      sourceAllSamplesFlushed();
+    }
+}; /* class BufferSink */
+
+
+class FrameCounter : public sigc::trackable
+{
+  public:
+    FrameCounter(const vector<vector<uint8_t> > &sent)
+      : sent(sent), next(0), received(0), correct(0) {}
+
+    void frameReceived(vector<uint8_t> &frame)
+    {
+        // Lost frames are skipped so that one lost frame does not make all
+        // following frames count as incorrect
+      auto it = find(sent.begin() + next, sent.end(), frame);
+      if (it != sent.end())
+      {
+        next = it - sent.begin() + 1;
+        ++correct;
+      }
+      ++received;
+    }
+
+    const vector<vector<uint8_t> > &sent;
+    size_t next;
+    size_t received;
+    size_t correct;
+}; /* class FrameCounter */
+
+
+static double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+
+static int runBenchmark(unsigned f0, unsigned f1, unsigned baudrate,
+                        unsigned sample_rate, unsigned frame_cnt)
+{
+  mt19937 gen(4711);
+  uniform_int_distribution<int> byte(0, 255);
+  vector<vector<uint8_t> > frames(frame_cnt);
+  for (auto& frame : frames)
+  {
+    frame.resize(100);
+    for (auto& b : frame)
+    {
+      b = byte(gen);
+    }
+  }
+
+  HdlcFramer framer;
+  AfskModulator fsk_mod(f0, f1, baudrate, -6, sample_rate);
+  framer.sendBits.connect(mem_fun(fsk_mod, &AfskModulator::sendBits));
+  BufferSink audio;
+  fsk_mod.registerSink(&audio);
+  for (const auto& frame : frames)
+  {
+    framer.sendBytes(frame);
+  }
+
+  AfskDemodulator fsk_demod(f0, f1, baudrate, sample_rate);
+  Synchronizer sync(baudrate, sample_rate);
+  fsk_demod.registerSink(&sync);
+  HdlcDeframer deframer;
+  sync.bitsReceived.connect(mem_fun(deframer, &HdlcDeframer::bitsReceived));
+  FrameCounter counter(frames);
+  deframer.frameReceived.connect(
+      mem_fun(counter, &FrameCounter::frameReceived));
+
+  const size_t block_size = 256;
+  const size_t len = audio.samples.size();
+  double start = cpuTime();
+  for (size_t pos=0; pos<len; pos+=block_size)
+  {
+    fsk_demod.writeSamples(&audio.samples[pos], min(block_size, len - pos));
+  }
+  double cpu = cpuTime() - start;
+
+  double audio_time = static_cast<double>(len) / sample_rate;
+  printf("Frames sent/received/correct : %zu/%zu/%zu\n",
+         frames.size(), counter.received, counter.correct);
+  printf("Audio length                 : %.1fs\n", audio_time);
+  printf("CPU time                     : %.3fs\n", cpu);
+  printf("Throughput                   : %.0f samples/s (%.0fx realtime)\n",
+         len / cpu, audio_time / cpu);
+
+  return (counter.correct == counter.received) ? 0 : 1;
+} /* runBenchmark */
+
+
 int main(int argc, const char **argv)
 {
   // 1200Bd AMPR
@@ -396,6 +514,12 @@ int main(int argc, const char **argv)
 
   unsigned sample_rate = 16000;
 
+  if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+  {
+    unsigned frame_cnt = (argc > 2) ? atoi(argv[2]) : 1000;
+    return runBenchmark(f0, f1, baudrate, sample_rate, frame_cnt);
+  }
+
   CppApplication app;
 
   AudioIO::setSampleRate(sample_rate);
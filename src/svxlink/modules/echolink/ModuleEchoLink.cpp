@@ -6,7 +6,7 @@
 
 \verbatim
 A module (plugin) for the multi purpose tranciever frontend system.
-Copyright (C) 2004-2014 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -49,12 +49,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <AsyncTimer.h>
 #include <AsyncConfig.h>
-#include <AsyncAudioSplitter.h>
 #include <AsyncAudioValve.h>
 #include <AsyncAudioSelector.h>
+#include <AsyncAudioDecimator.h>
 #include <EchoLinkDirectory.h>
 #include <EchoLinkDispatcher.h>
 #include <EchoLinkProxy.h>
+#include <EchoLinkSharedEncoder.h>
 #include <LocationInfo.h>
 #include <common.h>
 
@@ -71,6 +72,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "version/MODULE_ECHO_LINK.h"
 #include "ModuleEchoLink.h"
 #include "QsoImpl.h"
+#include "multirate_filter_coeff.h"
 
 
 /****************************************************************************
@@ -165,7 +167,7 @@ ModuleEchoLink::ModuleEchoLink(void *dl_handle, Logic *logic,
     max_connections(1), max_qsos(1), talker(0), squelch_is_open(false),
     state(STATE_NORMAL), cbc_timer(0), dbc_timer(0), drop_incoming_regex(0),
     reject_incoming_regex(0), accept_incoming_regex(0),
-    reject_outgoing_regex(0), accept_outgoing_regex(0), splitter(0),
+    reject_outgoing_regex(0), accept_outgoing_regex(0), shared_encoder(0),
     listen_only_valve(0), selector(0), num_con_max(0), num_con_ttl(5*60),
     num_con_block_time(120*60), num_con_update_timer(0), reject_conf(false),
     autocon_echolink_id(0), autocon_time(DEFAULT_AUTOCON_TIME),
@@ -369,12 +371,24 @@ bool ModuleEchoLink::initialize(void)
   }
 
     // Create audio pipe chain for audio transmitted to the remote EchoLink
-    // stations: <from core> -> Valve -> Splitter (-> QsoImpl ...)
+    // stations: <from core> -> Valve -> Decimator -> SharedEncoder
+    // (-> QsoImpl ...). The audio is encoded once for all stations.
   listen_only_valve = new AudioValve;
   AudioSink::setHandler(listen_only_valve);
-  
-  splitter = new AudioSplitter;
-  listen_only_valve->registerSink(splitter);
+  AudioSource *prev_src = listen_only_valve;
+
+#if INTERNAL_SAMPLE_RATE == 16000
+  AudioDecimator *down_sampler = new AudioDecimator(
+          2, coeff_16_8, coeff_16_8_taps);
+  prev_src->registerSink(down_sampler, true);
+  prev_src = down_sampler;
+#endif
+
+  shared_encoder = new SharedEncoder;
+  shared_encoder->audioEncoded.connect(
+      mem_fun(*this, &ModuleEchoLink::audioFromLogicEncoded));
+  prev_src->registerSink(shared_encoder);
+  prev_src = 0;
 
     // Create audio pipe chain for audio received from the remove EchoLink
     // stations: (QsoImpl -> ) Selector -> Fifo -> <to core>
@@ -589,8 +603,8 @@ void ModuleEchoLink::moduleCleanup(void)
   autocon_timer = 0;
   
   AudioSink::clearHandler();
-  delete splitter;
-  splitter = 0;
+  delete shared_encoder;
+  shared_encoder = 0;
   delete listen_only_valve;
   listen_only_valve = 0;
   
@@ -1045,11 +1059,12 @@ void ModuleEchoLink::onIncomingConnection(const IpAddress& ip,
   qso->infoMsgReceived.connect(
           mem_fun(*this, &ModuleEchoLink::onInfoMsgReceived));
   qso->isReceiving.connect(mem_fun(*this, &ModuleEchoLink::onIsReceiving));
+  qso->remoteCodecChanged.connect(
+          mem_fun(*this, &ModuleEchoLink::onRemoteCodecChanged));
   qso->audioReceivedRaw.connect(
       	  mem_fun(*this, &ModuleEchoLink::audioFromRemoteRaw));
   qso->destroyMe.connect(mem_fun(*this, &ModuleEchoLink::destroyQsoObject));
 
-  splitter->addSink(qso);
   selector->addSource(qso);
   selector->enableAutoSelect(qso, 0);
 
@@ -1151,12 +1166,14 @@ void ModuleEchoLink::onStateChange(QsoImpl *qso, Qso::State qso_state)
 
       broadcastTalkerStatus();
       updateDescription();
+      updateSharedEncoder();
       clientListChanged();
       break;
     }
     
     case Qso::STATE_CONNECTED:
       updateEventVariables();
+      updateSharedEncoder();
       clientListChanged();
       break;
 
@@ -1297,17 +1314,36 @@ void ModuleEchoLink::onIsReceiving(bool is_receiving, QsoImpl *qso)
 } /* onIsReceiving */
 
 
+/*
+ *----------------------------------------------------------------------------
+ * Method:    onRemoteCodecChanged
+ * Purpose:   Called by the EchoLink::Qso object when the remote station
+ *    	      change codec after the connection has been established.
+ * Input:     qso     	    - The QSO object
+ * Output:    None
+ * Author:    Tobias Blomberg / SM0SVX
+ * Created:   2026-10-18
+ * Remarks:   The shared encoder must encode using the new codec too.
+ * Bugs:      
+ *----------------------------------------------------------------------------
+ */
+void ModuleEchoLink::onRemoteCodecChanged(QsoImpl *qso)
+{
+  updateSharedEncoder();
+} /* onRemoteCodecChanged */
+
+
 void ModuleEchoLink::destroyQsoObject(QsoImpl *qso)
 {
   //cout << qso->remoteCallsign() << ": Destroying QSO object" << endl;
   string callsign = qso->remoteCallsign();
 
-  splitter->removeSink(qso);
   selector->removeSource(qso);
       
   vector<QsoImpl*>::iterator it = find(qsos.begin(), qsos.end(), qso);
   assert (it != qsos.end());
   qsos.erase(it);
+  updateSharedEncoder();
 
   updateEventVariables();
   delete qso;
@@ -1450,11 +1486,12 @@ void ModuleEchoLink::createOutgoingConnection(const StationData &station)
     qso->infoMsgReceived.connect(
         mem_fun(*this, &ModuleEchoLink::onInfoMsgReceived));
     qso->isReceiving.connect(mem_fun(*this, &ModuleEchoLink::onIsReceiving));
+    qso->remoteCodecChanged.connect(
+        mem_fun(*this, &ModuleEchoLink::onRemoteCodecChanged));
     qso->audioReceivedRaw.connect(
       	    mem_fun(*this, &ModuleEchoLink::audioFromRemoteRaw));
     qso->destroyMe.connect(mem_fun(*this, &ModuleEchoLink::destroyQsoObject));
 
-    splitter->addSink(qso);
     selector->addSource(qso);
     selector->enableAutoSelect(qso, 0);
   }
@@ -1503,6 +1540,40 @@ void ModuleEchoLink::audioFromRemoteRaw(Qso::RawPacket *packet,
 } /* ModuleEchoLink::audioFromRemoteRaw */
 
 
+void ModuleEchoLink::audioFromLogicEncoded(Qso::RawPacket *gsm_packet,
+                                           Qso::RawPacket *speex_packet)
+{
+  vector<QsoImpl*>::iterator it;
+  for (it=qsos.begin(); it!=qsos.end(); ++it)
+  {
+    (*it)->sendEncodedAudio(gsm_packet, speex_packet);
+  }
+} /* ModuleEchoLink::audioFromLogicEncoded */
+
+
+void ModuleEchoLink::updateSharedEncoder(void)
+{
+  if (shared_encoder == 0)
+  {
+    return;
+  }
+
+  bool is_connected = false;
+  bool use_speex = false;
+  vector<QsoImpl*>::iterator it;
+  for (it=qsos.begin(); it!=qsos.end(); ++it)
+  {
+    if ((*it)->currentState() == Qso::STATE_CONNECTED)
+    {
+      is_connected = true;
+      use_speex = use_speex || (*it)->remoteUsesSpeex();
+    }
+  }
+  shared_encoder->setEnabled(is_connected);
+  shared_encoder->setSpeexEnabled(use_speex);
+} /* ModuleEchoLink::updateSharedEncoder */
+
+
 QsoImpl *ModuleEchoLink::findFirstTalker(void) const
 {
   vector<QsoImpl*>::const_iterator it;
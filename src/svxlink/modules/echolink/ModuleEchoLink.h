@@ -6,7 +6,7 @@
 
 \verbatim
 A module (plugin) for the multi purpose tranciever frontend system.
-Copyright (C) 2004-2014 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -72,7 +72,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace Async
 {
   class Timer;
-  class AudioSplitter;
   class AudioValve;
   class AudioSelector;
   class Pty;
@@ -82,6 +81,7 @@ namespace EchoLink
   class Directory;
   class StationData;
   class Proxy;
+  class SharedEncoder;
 };
 
 
@@ -198,7 +198,7 @@ class ModuleEchoLink : public Module
     regex_t   	      	  *reject_outgoing_regex;
     regex_t   	      	  *accept_outgoing_regex;
     EchoLink::StationData last_disc_stn;
-    Async::AudioSplitter  *splitter;
+    EchoLink::SharedEncoder *shared_encoder;
     Async::AudioValve 	  *listen_only_valve;
     Async::AudioSelector  *selector;
     unsigned              num_con_max;
@@ -237,6 +237,7 @@ class ModuleEchoLink : public Module
     void onChatMsgReceived(QsoImpl *qso, const std::string& msg);
     void onInfoMsgReceived(QsoImpl *qso, const std::string& msg);
     void onIsReceiving(bool is_receiving, QsoImpl *qso);
+    void onRemoteCodecChanged(QsoImpl *qso);
     void destroyQsoObject(QsoImpl *qso);
 
     void getDirectoryList(Async::Timer *timer=0);
@@ -245,6 +246,9 @@ class ModuleEchoLink : public Module
     int audioFromRemote(float *samples, int count, QsoImpl *qso);
     void audioFromRemoteRaw(EchoLink::Qso::RawPacket *packet,
       	      	      	    QsoImpl *qso);
+    void audioFromLogicEncoded(EchoLink::Qso::RawPacket *gsm_packet,
+                               EchoLink::Qso::RawPacket *speex_packet);
+    void updateSharedEncoder(void);
     QsoImpl *findFirstTalker(void) const;
     void broadcastTalkerStatus(void);
     void updateDescription(void);
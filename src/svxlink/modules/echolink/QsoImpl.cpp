@@ -9,7 +9,7 @@ EchoLink Qso.
 
 \verbatim
 A module (plugin) for the multi purpose tranciever frontend system.
-Copyright (C) 2004-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -266,6 +266,8 @@ QsoImpl::QsoImpl(const StationData &station, ModuleEchoLink *module)
   m_qso.chatMsgReceived.connect(mem_fun(*this, &QsoImpl::onChatMsgReceived));
   m_qso.stateChange.connect(mem_fun(*this, &QsoImpl::onStateChange));
   m_qso.isReceiving.connect(sigc::bind(isReceiving.make_slot(), this));
+  m_qso.remoteCodecChanged.connect(
+      sigc::bind(remoteCodecChanged.make_slot(), this));
   m_qso.audioReceivedRaw.connect(
       sigc::bind(audioReceivedRaw.make_slot(), this));
   
@@ -335,6 +337,19 @@ bool QsoImpl::sendAudioRaw(Qso::RawPacket *packet)
 } /* QsoImpl::sendAudioRaw */
 
 
+bool QsoImpl::sendEncodedAudio(Qso::RawPacket *gsm_packet,
+                               Qso::RawPacket *speex_packet)
+{
+  if (!msg_handler->isWritingMessage())
+  {
+    return m_qso.sendEncodedAudio(gsm_packet, speex_packet);
+  }
+
+  return true;
+
+} /* QsoImpl::sendEncodedAudio */
+
+
 bool QsoImpl::connect(void)
 {
   if (destroy_timer != 0)
@@ -9,7 +9,7 @@ EchoLink Qso.
 
 \verbatim
 A module (plugin) for the multi purpose tranciever frontend system.
-Copyright (C) 2004-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -167,6 +167,23 @@ class QsoImpl
      * audioReceivedRaw signal.
      */
     bool sendAudioRaw(EchoLink::Qso::RawPacket *packet);
+
+    /**
+     * @brief 	Send audio encoded by an EchoLink::SharedEncoder
+     * @param 	gsm_packet The GSM encoded packet
+     * @param 	speex_packet The SPEEX encoded packet or 0 if not available
+     *
+     * The packet is not sent while a message is being played to the remote
+     * station. The station only get audio from one source at a time.
+     */
+    bool sendEncodedAudio(EchoLink::Qso::RawPacket *gsm_packet,
+                          EchoLink::Qso::RawPacket *speex_packet);
+
+    /**
+     * @brief 	Find out if the remote station should be sent SPEEX audio
+     * @return	Returns \em true if the SPEEX codec is used
+     */
+    bool remoteUsesSpeex(void) const { return m_qso.remoteUsesSpeex(); }
     
     /**
      * @brief 	Initiate a connection to the remote station
@@ -300,6 +317,12 @@ class QsoImpl
      */
     sigc::signal<void(bool, QsoImpl*)> isReceiving;
 
+    /**
+     * @brief A signal that is emitted when the remote station change codec
+     * @param qso The QSO object
+     */
+    sigc::signal<void(QsoImpl*)> remoteCodecChanged;
+
     /**
      * @brief A signal that is emitted when an audio datagram has been received
      * @param packet A pointer to the buffer that contains the raw GSM audio
@@ -0,0 +1,225 @@
+/**
+@file    FrnGsmCodec.cpp
+@brief   GSM WAV49 codec for whole FRN voice packets
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+\verbatim
+A module (plugin) for the multi purpose tranciever frontend system.
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <cstring>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "FrnGsmCodec.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+FrnGsmCodec::FrnGsmCodec(void)
+  : handle(0), label("")
+{
+} /* FrnGsmCodec::FrnGsmCodec */
+
+
+FrnGsmCodec::~FrnGsmCodec(void)
+{
+  if (handle != 0)
+  {
+    gsm_destroy(handle);
+  }
+} /* FrnGsmCodec::~FrnGsmCodec */
+
+
+bool FrnGsmCodec::reset(const char *label)
+{
+  this->label = label;
+
+  if (handle != 0)
+  {
+    gsm_destroy(handle);
+    handle = 0;
+  }
+
+  handle = gsm_create();
+  if (handle == 0)
+  {
+    cerr << "*** ERROR: Failed to create FRN " << label
+         << " GSM codec" << endl;
+    return false;
+  }
+
+  int gsm_one = 1;
+  if (gsm_option(handle, GSM_OPT_WAV49, &gsm_one) == -1)
+  {
+    cerr << "*** ERROR: Failed to enable WAV49 mode on FRN "
+         << label << " GSM codec" << endl;
+    gsm_destroy(handle);
+    handle = 0;
+    return false;
+  }
+
+  return true;
+} /* FrnGsmCodec::reset */
+
+
+void FrnGsmCodec::encodePacket(short *pcm, unsigned char *gsm_data)
+{
+  for (int frameno = 0; frameno < FRAME_COUNT; frameno++)
+  {
+    short *src = pcm + frameno * PCM_FRAME_SIZE;
+    unsigned char *dst = gsm_data + frameno * GSM_FRAME_SIZE;
+
+      // GSM WAV49 packs two 160-sample frames into 65 bytes. The second
+      // encode starts at +32 because the pair shares the boundary byte.
+    gsm_encode(handle, src, dst);
+    gsm_encode(handle, src + PCM_FRAME_SIZE / 2, dst + 32);
+  }
+} /* FrnGsmCodec::encodePacket */
+
+
+int FrnGsmCodec::decodePacket(unsigned char *gsm_data, float *samples)
+{
+  int failed_frames = 0;
+  for (int frameno = 0; frameno < FRAME_COUNT; frameno++)
+  {
+    unsigned char *src = gsm_data + frameno * GSM_FRAME_SIZE;
+    short *dst = pcm_buffer + frameno * PCM_FRAME_SIZE;
+
+      // GSM WAV49 consumes the same 65-byte pair produced above:
+      // first half at +0, second half at +33.
+    bool is_decode_success = (handle != 0) &&
+      (gsm_decode(handle, src, dst) != -1) &&
+      (gsm_decode(handle, src + 33, dst + PCM_FRAME_SIZE / 2) != -1);
+    if (!is_decode_success)
+    {
+      ++failed_frames;
+      memset(dst, 0, sizeof(*dst) * PCM_FRAME_SIZE);
+      reset(label);
+    }
+  }
+
+  for (int i = 0; i < PCM_PACKET_SIZE; i++)
+  {
+    samples[i] = static_cast<float>(pcm_buffer[i]) / 32768.0f;
+  }
+
+  return failed_frames;
+} /* FrnGsmCodec::decodePacket */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,195 @@
+/**
+@file    FrnGsmCodec.h
+@brief   GSM WAV49 codec for whole FRN voice packets
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+\verbatim
+A module (plugin) for the multi purpose tranciever frontend system.
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef FRN_GSM_CODEC_INCLUDED
+#define FRN_GSM_CODEC_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+extern "C" {
+#include <gsm.h>
+}
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  GSM WAV49 codec for whole FRN voice packets
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+An FRN voice packet consist of FRAME_COUNT GSM WAV49 frames. Each WAV49 frame
+is 65 bytes and holds two 160 sample GSM frames. This class encode and decode
+a whole voice packet in one call using only preallocated buffers so that no
+memory is allocated in the audio path.
+*/
+class FrnGsmCodec
+{
+  public:
+      /// Number of WAV49 frames in one voice packet
+    static const int FRAME_COUNT      = 5;
+      /// Number of samples in one WAV49 frame
+    static const int PCM_FRAME_SIZE   = 160*2;
+      /// Number of bytes in one WAV49 frame
+    static const int GSM_FRAME_SIZE   = 65;
+      /// Number of samples in one voice packet
+    static const int PCM_PACKET_SIZE  = FRAME_COUNT*PCM_FRAME_SIZE;
+      /// Number of bytes in one voice packet
+    static const int GSM_PACKET_SIZE  = FRAME_COUNT*GSM_FRAME_SIZE;
+
+    /**
+     * @brief   Default constructor
+     */
+    FrnGsmCodec(void);
+
+    /**
+     * @brief   Destructor
+     */
+    ~FrnGsmCodec(void);
+
+    /**
+     * @brief   Reset the codec state
+     * @param   label A label used in error messages, e.g. "TX" or "RX"
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * This function must be called, and succeed, before the codec can be
+     * used. It should also be called at the start of each new transmission.
+     */
+    bool reset(const char *label);
+
+    /**
+     * @brief   Check if the codec is ready to use
+     * @return  Returns \em true if the codec is ready to use
+     */
+    bool isReady(void) const { return handle != 0; }
+
+    /**
+     * @brief   Encode one voice packet
+     * @param   pcm PCM_PACKET_SIZE samples to encode
+     * @param   gsm_data Buffer of GSM_PACKET_SIZE bytes for the result
+     *
+     * The GSM encoder use the input buffer as scratch space so the samples
+     * are destroyed after the call.
+     */
+    void encodePacket(short *pcm, unsigned char *gsm_data);
+
+    /**
+     * @brief   Decode one voice packet
+     * @param   gsm_data GSM_PACKET_SIZE bytes to decode
+     * @param   samples Buffer of PCM_PACKET_SIZE samples for the result
+     * @return  Returns the number of frames that could not be decoded
+     *
+     * Frames that cannot be decoded are replaced by silence and the decoder
+     * is reset.
+     */
+    int decodePacket(unsigned char *gsm_data, float *samples);
+
+  private:
+    gsm         handle;
+    const char  *label;
+    short       pcm_buffer[PCM_PACKET_SIZE];
+
+    FrnGsmCodec(const FrnGsmCodec&);
+    FrnGsmCodec& operator=(const FrnGsmCodec&);
+
+};  /* class FrnGsmCodec */
+
+
+//} /* namespace */
+
+#endif /* FRN_GSM_CODEC_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,200 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "FrnGsmCodec.h"
+
+using namespace std;
+
+
+/*
+ * Benchmark the FRN voice packet pipeline.
+ *
+ * Usage: FrnVoiceBench [packets]
+ *
+ * Voice packets are encoded, written to a loopback FRN server stand-in,
+ * echoed back as an FRN voice buffer and decoded, the same way QsoFrn handle
+ * them. The stand-in server runs in its own thread on the other end of a
+ * local socket pair. The CPU time used to encode and decode a voice packet
+ * and the round trip latency through the stand-in server are printed.
+ */
+
+namespace {
+const int SAMPLE_RATE       = 8000;
+const int TX1_REQUEST_SIZE  = 5;
+const int CLIENT_INDEX_SIZE = 2;
+const unsigned char DT_VOICE_BUFFER = 2;
+
+double threadCpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+bool readAll(int fd, unsigned char *buf, size_t len)
+{
+  while (len > 0)
+  {
+    ssize_t n = read(fd, buf, len);
+    if (n <= 0)
+    {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+bool writeAll(int fd, const unsigned char *buf, size_t len)
+{
+  while (len > 0)
+  {
+    ssize_t n = write(fd, buf, len);
+    if (n <= 0)
+    {
+      return false;
+    }
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+
+  // Echo each TX1 voice packet back as a voice buffer from client 1
+void runServer(int fd)
+{
+  unsigned char req[TX1_REQUEST_SIZE + FrnGsmCodec::GSM_PACKET_SIZE];
+  unsigned char rsp[1 + CLIENT_INDEX_SIZE + FrnGsmCodec::GSM_PACKET_SIZE];
+  rsp[0] = DT_VOICE_BUFFER;
+  rsp[1] = 0;
+  rsp[2] = 1;
+  while (readAll(fd, req, sizeof(req)))
+  {
+    if (memcmp(req, "TX1\r\n", TX1_REQUEST_SIZE) != 0)
+    {
+      cerr << "*** ERROR: Stand-in server got an unexpected request\n";
+      break;
+    }
+    memcpy(rsp + 1 + CLIENT_INDEX_SIZE, req + TX1_REQUEST_SIZE,
+           FrnGsmCodec::GSM_PACKET_SIZE);
+    if (!writeAll(fd, rsp, sizeof(rsp)))
+    {
+      break;
+    }
+  }
+  close(fd);
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  int packets = 1000;
+  if (argc > 1)
+  {
+    packets = atoi(argv[1]);
+  }
+  if (packets < 1)
+  {
+    cerr << "Usage: FrnVoiceBench [packets]\n";
+    exit(1);
+  }
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+  {
+    perror("socketpair");
+    exit(1);
+  }
+  thread server(runServer, fds[1]);
+
+  FrnGsmCodec tx_codec;
+  FrnGsmCodec rx_codec;
+  if (!tx_codec.reset("TX") || !rx_codec.reset("RX"))
+  {
+    exit(1);
+  }
+
+  vector<float> audio(FrnGsmCodec::PCM_PACKET_SIZE * packets);
+  for (size_t i=0; i<audio.size(); ++i)
+  {
+    audio[i] = 0.3f * sin(2.0 * M_PI * 440.0 * i / SAMPLE_RATE) +
+               0.2f * sin(2.0 * M_PI * 1270.0 * i / SAMPLE_RATE);
+  }
+
+  short pcm[FrnGsmCodec::PCM_PACKET_SIZE];
+  unsigned char tx_packet[TX1_REQUEST_SIZE + FrnGsmCodec::GSM_PACKET_SIZE];
+  memcpy(tx_packet, "TX1\r\n", TX1_REQUEST_SIZE);
+  unsigned char rx_packet[1 + CLIENT_INDEX_SIZE +
+                          FrnGsmCodec::GSM_PACKET_SIZE];
+  float samples[FrnGsmCodec::PCM_PACKET_SIZE];
+
+  double encode_time = 0.0;
+  double decode_time = 0.0;
+  double tot_latency = 0.0;
+  double max_latency = 0.0;
+  int failed_frames = 0;
+  for (int p=0; p<packets; ++p)
+  {
+    double start_wall = wallTime();
+    double start_cpu = threadCpuTime();
+    const float *src = &audio[p * FrnGsmCodec::PCM_PACKET_SIZE];
+    for (int i=0; i<FrnGsmCodec::PCM_PACKET_SIZE; ++i)
+    {
+      float sample = max(-1.0f, min(1.0f, src[i]));
+      pcm[i] = static_cast<short>(32767.0f * sample);
+    }
+    tx_codec.encodePacket(pcm, tx_packet + TX1_REQUEST_SIZE);
+    encode_time += threadCpuTime() - start_cpu;
+
+    if (!writeAll(fds[0], tx_packet, sizeof(tx_packet)) ||
+        !readAll(fds[0], rx_packet, sizeof(rx_packet)))
+    {
+      cerr << "*** ERROR: Stand-in server connection failed\n";
+      exit(1);
+    }
+
+    start_cpu = threadCpuTime();
+    failed_frames += rx_codec.decodePacket(
+        rx_packet + 1 + CLIENT_INDEX_SIZE, samples);
+    decode_time += threadCpuTime() - start_cpu;
+
+    double latency = wallTime() - start_wall;
+    tot_latency += latency;
+    max_latency = max(max_latency, latency);
+  }
+
+  shutdown(fds[0], SHUT_RDWR);
+  close(fds[0]);
+  server.join();
+
+  printf("Voice packets              : %d (%dms audio each)\n", packets,
+         1000 * FrnGsmCodec::PCM_PACKET_SIZE / SAMPLE_RATE);
+  printf("Encode CPU/packet          : %.1fus\n",
+         1.0e6 * encode_time / packets);
+  printf("Decode CPU/packet          : %.1fus\n",
+         1.0e6 * decode_time / packets);
+  printf("Round trip latency avg/max : %.1fus / %.1fus\n",
+         1.0e6 * tot_latency / packets, 1.0e6 * max_latency);
+  printf("Failed frames              : %d\n", failed_frames);
+
+  return (failed_frames == 0) ? 0 : 1;
+} /* main */
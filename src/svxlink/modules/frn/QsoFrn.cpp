@@ -9,7 +9,7 @@ EchoLink Qso.
 
 \verbatim
 A module (plugin) for the multi purpose tranciever frontend system.
-Copyright (C) 2004-2014 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -80,34 +80,6 @@ using namespace Async;
 
 namespace
 {
-  bool initGsmWav49(gsm& handle, const char* label)
-  {
-    if (handle != 0)
-    {
-      gsm_destroy(handle);
-      handle = 0;
-    }
-
-    handle = gsm_create();
-    if (handle == 0)
-    {
-      cerr << "*** ERROR: Failed to create FRN " << label
-           << " GSM codec" << endl;
-      return false;
-    }
-
-    int gsm_one = 1;
-    if (gsm_option(handle, GSM_OPT_WAV49, &gsm_one) == -1)
-    {
-      cerr << "*** ERROR: Failed to enable WAV49 mode on FRN "
-           << label << " GSM codec" << endl;
-      gsm_destroy(handle);
-      handle = 0;
-      return false;
-    }
-    return true;
-  }
-
   bool extractTagValue(const std::string& s, const std::string& tag,
                        std::string& out)
   {
@@ -200,8 +172,6 @@ QsoFrn::QsoFrn(ModuleFrn *module)
   , state(STATE_DISCONNECTED)
   , connect_retry_cnt(0)
   , send_buffer_cnt(0)
-  , gsmh_tx(0)
-  , gsmh_rx(0)
   , lines_to_read(-1)
   , last_list_response(DT_IDLE)
   , is_receiving_voice(false)
@@ -315,11 +285,11 @@ QsoFrn::QsoFrn(ModuleFrn *module)
     return;
   }
 
-  if (!initGsmWav49(gsmh_tx, "TX") ||
-      !initGsmWav49(gsmh_rx, "RX"))
+  if (!tx_codec.reset("TX") || !rx_codec.reset("RX"))
   {
     return;
   }
+  memcpy(tx_voice_packet, "TX1\r\n", TX1_REQUEST_SIZE);
 
   tcp_client->connected.connect(
       mem_fun(*this, &QsoFrn::onConnected));
@@ -384,17 +354,6 @@ QsoFrn::~QsoFrn(void)
 
   delete tm_out_timer;
   tm_out_timer = 0;
-
-  if (gsmh_tx != 0)
-  {
-    gsm_destroy(gsmh_tx);
-    gsmh_tx = 0;
-  }
-  if (gsmh_rx != 0)
-  {
-    gsm_destroy(gsmh_rx);
-    gsmh_rx = 0;
-  }
 }
 
 
@@ -490,7 +449,7 @@ int QsoFrn::writeSamples(const float *samples, int count)
 
   if (state == STATE_IDLE)
   {
-    if (!initGsmWav49(gsmh_tx, "TX"))
+    if (!tx_codec.reset("TX"))
     {
       return 0;
     }
@@ -637,10 +596,9 @@ void QsoFrn::sendVoiceData(short *data, int len)
 {
   assert(len == BUFFER_SIZE);
 
-  size_t nbytes = 0;
-  unsigned char gsm_data[FRN_AUDIO_PACKET_SIZE];
+  const size_t nbytes = FRN_AUDIO_PACKET_SIZE;
 
-  if (gsmh_tx == 0 && !initGsmWav49(gsmh_tx, "TX"))
+  if (!tx_codec.isReady() && !tx_codec.reset("TX"))
   {
     ++tx_voice_drops;
     cerr << "FRN TX: GSM encoder unavailable; voice frame dropped"
@@ -648,19 +606,11 @@ void QsoFrn::sendVoiceData(short *data, int len)
     return;
   }
 
-  for (int nframe = 0; nframe < FRAME_COUNT; nframe++)
-  {
-    short * src = data + nframe * PCM_FRAME_SIZE;
-    unsigned char * dst = gsm_data + nframe * GSM_FRAME_SIZE;
-
-    // GSM WAV49 packs two 160-sample frames into 65 bytes. The second
-    // encode starts at +32 because the pair shares the boundary byte.
-    gsm_encode(gsmh_tx, src, dst);
-    gsm_encode(gsmh_tx, src + PCM_FRAME_SIZE / 2, dst + 32);
+  tx_codec.encodePacket(data, tx_voice_packet + TX1_REQUEST_SIZE);
 
-    nbytes += GSM_FRAME_SIZE;
-  }
-  if (!sendRequest(RQ_TX1))
+  if (opt_frn_debug)
+    cout << "req:   TX1" << endl;
+  if (!tcp_client->isConnected())
   {
     if (opt_frn_debug)
       cerr << "FRN TX: TX1 request failed; voice frame dropped" << endl;
@@ -674,8 +624,9 @@ void QsoFrn::sendVoiceData(short *data, int len)
          << " bytes=" << nbytes << " state=" << stateToString(state) << endl;
   }
 
-  std::string frame(reinterpret_cast<const char*>(gsm_data), nbytes);
-  if (!writeAll(frame))
+    // The TX1 request and the voice data is written in one go
+  if (!writeAll(reinterpret_cast<const char*>(tx_voice_packet),
+                sizeof(tx_voice_packet)))
   {
     ++tx_voice_drops;
     cerr << "FRN TX: voice frame write failed (drops=" << tx_voice_drops
@@ -760,15 +711,19 @@ bool QsoFrn::writeFrame(const char* tag, const std::string& frame)
 }
 
 bool QsoFrn::writeAll(const std::string& out)
+{
+  return writeAll(out.c_str(), out.size());
+}
+
+bool QsoFrn::writeAll(const char *buf, size_t len)
 {
   if (!tcp_client->isConnected())
     return false;
 
   size_t off = 0;
-  const size_t len = out.size();
   while (off < len)
   {
-    int n = tcp_client->write(out.c_str() + off, len - off);
+    int n = tcp_client->write(buf + off, len - off);
     if (n <= 0)
       return false;
     off += static_cast<size_t>(n);
@@ -869,32 +824,33 @@ bool QsoFrn::sendTextMessage(const std::string& to_id, const std::string& msg)
 
 bool QsoFrn::sendRequest(Request rq)
 {
-  std::stringstream s;
+  const char *rq_s;
 
   switch(rq)
   {
     case RQ_RX0:
-      s << "RX0";
+      rq_s = "RX0\r\n";
       break;
 
     case RQ_TX0:
-      s << "TX0";
+      rq_s = "TX0\r\n";
       break;
 
     case RQ_TX1:
-      s << "TX1";
+      rq_s = "TX1\r\n";
       break;
 
     case RQ_P:
-      s << "P";
+      rq_s = "P\r\n";
       break;
 
     default:
       cerr << "unknown request " << rq << endl;
       return false;
   }
+  const size_t rq_len = strlen(rq_s);
   if (opt_frn_debug)
-    if (opt_frn_debug) cout << "req:   " << s.str() << endl;
+    cout << "req:   " << string(rq_s, rq_len - 2) << endl;
 
   if (!tcp_client->isConnected())
   {
@@ -905,9 +861,7 @@ bool QsoFrn::sendRequest(Request rq)
     return false;
   }
 
-  s << "\r\n";
-  std::string rq_s = s.str();
-  if (!writeAll(rq_s))
+  if (!writeAll(rq_s, rq_len))
   {
     cerr << "request " << rq_s << " was not written to FRN" << endl;
     return false;
@@ -919,8 +873,6 @@ bool QsoFrn::sendRequest(Request rq)
 int QsoFrn::handleAudioData(unsigned char *data, int len)
 {
   unsigned char *gsm_data = data + CLIENT_INDEX_SIZE;
-  short *pcm_buffer = receive_buffer;
-  float pcm_samples[PCM_FRAME_SIZE];
 
   if (len < FRN_AUDIO_PACKET_SIZE + CLIENT_INDEX_SIZE)
     return 0;
@@ -931,7 +883,7 @@ int QsoFrn::handleAudioData(unsigned char *data, int len)
   {
     unsigned short client_index = data[1] | data[0] << 8;
     is_receiving_voice = true;
-    initGsmWav49(gsmh_rx, "RX");
+    rx_codec.reset("RX");
     if (client_index > 0 && client_index <= client_list.size())
       rxVoiceStarted(client_list[client_index - 1]);
   }
@@ -956,71 +908,35 @@ int QsoFrn::handleAudioData(unsigned char *data, int len)
       cout << endl;
     }
 
-    for (int frameno = 0; frameno < FRAME_COUNT; frameno++)
+      // Decode all frames in the packet before handing the samples over to
+      // the audio sink in one go
+    int failed_frames = rx_codec.decodePacket(gsm_data, receive_buffer);
+    if (failed_frames > 0)
     {
-      unsigned char *src = gsm_data + frameno * GSM_FRAME_SIZE;
-      short *dst = pcm_buffer;
-      memset(dst, 0, sizeof(*dst) * PCM_FRAME_SIZE);
-
-      int decode_rc0 = -1;
-      int decode_rc1 = -1;
-      if (gsmh_rx != 0)
-      {
-        // GSM WAV49 consumes the same 65-byte pair produced above:
-        // first half at +0, second half at +33.
-        decode_rc0 = gsm_decode(gsmh_rx, src, dst);
-        if (decode_rc0 != -1)
-        {
-          decode_rc1 = gsm_decode(gsmh_rx, src + 33,
-                                  dst + PCM_FRAME_SIZE / 2);
-        }
-      }
-      bool is_gsm_decode_success = (decode_rc0 != -1 && decode_rc1 != -1);
-
-      if (opt_frn_debug && rx_voice_packets <= 3)
-      {
-        cout << "FRN RX frame=" << frameno << " rc0=" << decode_rc0
-             << " rc1=" << decode_rc1 << " first8=";
-        for (int i = 0; i < 8; ++i)
-        {
-          cout << hex << static_cast<int>(src[i]) << dec << (i == 7 ? "" : " ");
-        }
-        cout << endl;
-      }
+      rx_voice_drops += failed_frames;
+      if (opt_frn_debug || rx_voice_drops <= 5)
+        cerr << "FRN RX: gsm decoder failed for " << failed_frames
+             << " frame(s); inserting silence"
+             << " (drops=" << rx_voice_drops << ")" << endl;
+    }
 
-      if (!is_gsm_decode_success)
+    int all_written = 0;
+    while (all_written < BUFFER_SIZE)
+    {
+      int written = sinkWriteSamples(receive_buffer + all_written,
+          BUFFER_SIZE - all_written);
+      if (written == 0)
       {
         ++rx_voice_drops;
-        memset(dst, 0, sizeof(*dst) * PCM_FRAME_SIZE);
         if (opt_frn_debug || rx_voice_drops <= 5)
-          cerr << "FRN RX: gsm decoder failed for frame " << frameno
-               << "; inserting silence"
-               << " (drops=" << rx_voice_drops << ")" << endl;
-        initGsmWav49(gsmh_rx, "RX");
-      }
-
-      for (int i = 0; i < PCM_FRAME_SIZE; i++)
-         pcm_samples[i] = static_cast<float>(pcm_buffer[i]) / 32768.0;
-
-      int all_written = 0;
-      while (all_written < PCM_FRAME_SIZE)
-      {
-        int written = sinkWriteSamples(pcm_samples + all_written,
-            PCM_FRAME_SIZE - all_written);
-        if (written == 0)
         {
-          ++rx_voice_drops;
-          if (opt_frn_debug || rx_voice_drops <= 5)
-          {
-            cerr << "FRN RX: sink write stalled, dropping sample "
-                 << (PCM_FRAME_SIZE - all_written)
-                 << " (drops=" << rx_voice_drops << ")" << endl;
-          }
-          break;
+          cerr << "FRN RX: sink write stalled, dropping sample "
+               << (BUFFER_SIZE - all_written)
+               << " (drops=" << rx_voice_drops << ")" << endl;
         }
-        all_written += written;
+        break;
       }
-      pcm_buffer += PCM_FRAME_SIZE;
+      all_written += written;
     }
   }
   setState(STATE_IDLE);
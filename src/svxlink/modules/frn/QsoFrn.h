@@ -9,7 +9,7 @@ Frn Qso.
 
 \verbatim
 A module (plugin) for the multi purpose tranciever frontend system.
-Copyright (C) 2004-2014 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -47,10 +47,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  * Project Includes
  *
  ****************************************************************************/
-extern "C" {
-#include <gsm.h>
-}
-
 #include <AsyncAudioSink.h>
 #include <AsyncAudioSource.h>
 #include <AsyncTcpClient.h>
@@ -62,7 +58,7 @@ extern "C" {
  * Local Includes
  *
  ****************************************************************************/
-
+#include "FrnGsmCodec.h"
 
 
 /****************************************************************************
@@ -418,6 +414,10 @@ public:
      *
      * @param Pcm buffer with samples
      * @param Size of buffer
+     *
+     * The samples are encoded straight into a preallocated packet that
+     * already hold the TX1 request so the whole voice packet is written to
+     * the server in one go. The samples are destroyed by the encoder.
      */
     void sendVoiceData(short *data, int len);
 
@@ -562,11 +562,9 @@ public:
   private:
     static const int        CLIENT_INDEX_SIZE       = 2;
     static const int        TCP_BUFFER_SIZE         = 65536;
-    static const int        FRAME_COUNT             = 5;
-    static const int        PCM_FRAME_SIZE          = 160*2;  // WAV49 has 2x
-    static const int        GSM_FRAME_SIZE          = 65;     // WAV49 has 65
-    static const int        BUFFER_SIZE             = FRAME_COUNT*PCM_FRAME_SIZE;
-    static const int        FRN_AUDIO_PACKET_SIZE   = FRAME_COUNT*GSM_FRAME_SIZE;
+    static const int        BUFFER_SIZE             = FrnGsmCodec::PCM_PACKET_SIZE;
+    static const int        FRN_AUDIO_PACKET_SIZE   = FrnGsmCodec::GSM_PACKET_SIZE;
+    static const int        TX1_REQUEST_SIZE        = 5;      // "TX1\r\n"
 
     static const int        CON_TIMEOUT_TIME        = 30000;
     static const int        RX_TIMEOUT_TIME         = 1000;
@@ -595,6 +593,7 @@ public:
     void tmOutKick();
     void tmOutSendNext(Async::Timer* t);
     bool writeAll(const std::string& out);
+    bool writeAll(const char *buf, size_t len);
 
     bool writeFrame(const char* tag, const std::string& frame);
     static std::string headPreview(const std::string& s, size_t n = 40);
@@ -602,11 +601,13 @@ public:
     Async::Timer *      reconnect_timer;
     State               state;
     int                 connect_retry_cnt;
-    short               receive_buffer[BUFFER_SIZE];
+    float               receive_buffer[BUFFER_SIZE];
     short               send_buffer[BUFFER_SIZE];
     int                 send_buffer_cnt;
-    gsm                 gsmh_tx;
-    gsm                 gsmh_rx;
+    unsigned char       tx_voice_packet[TX1_REQUEST_SIZE +
+                                        FRN_AUDIO_PACKET_SIZE];
+    FrnGsmCodec         tx_codec;
+    FrnGsmCodec         rx_codec;
     int                 lines_to_read;
     Response            last_list_response;
     FrnList             cur_item_list;
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <unistd.h>
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <iterator>
 #include <regex>
 
@@ -51,6 +52,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncEncryptedUdpSocket.h>
 #include <AsyncApplication.h>
 #include <AsyncPty.h>
+#include <AsyncMetrics.h>
+#include <AsyncMetricsHttpServer.h>
 
 #include <common.h>
 #include <config.h>
@@ -65,6 +68,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Reflector.h"
 #include "ReflectorClient.h"
 #include "TGHandler.h"
+#include "ReflectorUdpShards.h"
 
 
 /****************************************************************************
@@ -86,6 +90,9 @@ using namespace Async;
 
 #define RENEW_AFTER 2/3
 
+  // The max number of UDP datagrams read in one system call
+#define UDP_RECV_BATCH_SIZE 32
+
 
 /****************************************************************************
  *
@@ -93,6 +100,96 @@ using namespace Async;
  *
  ****************************************************************************/
 
+/*
+ * The state needed by the CA operations that are run in the CA worker
+ * thread. A snapshot is taken from the main thread and is then only used by
+ * the worker thread.
+ */
+struct Reflector::CaContext
+{
+  std::string         certs_dir;
+  std::string         csrs_dir;
+  std::string         pending_csrs_dir;
+  Async::SslX509      issue_ca_cert;
+  Async::SslKeypair   issue_ca_pkey;
+
+  Async::SslCertSigningReq loadCsr(const std::string& dir,
+                                   const std::string& callsign)
+  {
+    Async::SslCertSigningReq csr;
+    (void)csr.readPemFile(dir + "/" + callsign + ".csr");
+    return csr;
+  }
+
+  Async::SslX509 loadClientCertificate(const std::string& callsign)
+  {
+    Async::SslX509 cert;
+    if (!cert.readPemFile(certs_dir + "/" + callsign + ".crt") ||
+        cert.isNull() ||
+        //!cert.verify(issue_ca_pkey) ||
+        !cert.timeIsWithinRange())
+    {
+      return nullptr;
+    }
+    return cert;
+  }
+
+    // Return the certificate file content to send to a client or an empty
+    // string if the certificate does not match a pending CSR
+  std::string clientCertPem(const Async::SslX509& cert)
+  {
+    if (cert.isNull())
+    {
+      return std::string();
+    }
+    const auto callsign = cert.commonName();
+    const auto pending_csr = loadCsr(pending_csrs_dir, callsign);
+    if (!pending_csr.isNull() &&
+        (cert.publicKey() != pending_csr.publicKey()))
+    {
+      return std::string();
+    }
+    std::ifstream ifs(certs_dir + "/" + callsign + ".crt");
+    if (!ifs.good())
+    {
+      return std::string();
+    }
+    return std::string(std::istreambuf_iterator<char>{ifs}, {});
+  }
+
+    // Sign the certificate and write it to file. The environment for the CA
+    // hook is returned in env if the certificate file was written.
+  bool signClientCert(Async::SslX509& cert, const std::string& ca_op,
+                      Async::Exec::Environment& env)
+  {
+    cert.setSerialNumber();
+    cert.setIssuerName(issue_ca_cert.subjectName());
+    cert.setValidityTime(CERT_VALIDITY_DAYS, CERT_VALIDITY_OFFSET_DAYS);
+    auto cn = cert.commonName();
+    if (!cert.sign(issue_ca_pkey))
+    {
+      std::cerr << "*** ERROR: Certificate signing failed for client "
+                << cn << std::endl;
+      return false;
+    }
+    auto crtfile = certs_dir + "/" + cn + ".crt";
+    if (cert.writePemFile(crtfile) && issue_ca_cert.appendPemFile(crtfile))
+    {
+      env = {
+          { "CA_OP",      ca_op },
+          { "CA_CRT_PEM", cert.pem() }
+        };
+    }
+    else
+    {
+      std::cerr << "*** WARNING: Failed to write client certificate file '"
+                << crtfile << "'" << std::endl;
+    }
+    return true;
+  }
+}; /* Reflector::CaContext */
+
+
 
 
 /****************************************************************************
@@ -172,6 +269,24 @@ namespace {
     timer.setExpireOffset(10000);
     timer.start();
   } /* startCertRenewTimer */
+
+
+    // Sending a message to a client may fail. The client is then
+    // disconnected and deleted right away and other clients may follow, e.g.
+    // if sending the node left message to them fail. Loops that send
+    // messages therefore work on a snapshot of the client IDs and look up
+    // each client again before it is used.
+  std::vector<ReflectorClient::ClientId> clientIds(
+      const TGHandler::ClientList& clients)
+  {
+    std::vector<ReflectorClient::ClientId> ids;
+    ids.reserve(clients.size());
+    for (const auto& client : clients)
+    {
+      ids.push_back(client->clientId());
+    }
+    return ids;
+  } /* clientIds */
 };
 
 
@@ -196,6 +311,34 @@ namespace {
   //    ProtoVer(2, 0), ProtoVer(2, 999));
   ReflectorClient::ProtoVerLargerOrEqualFilter ge_v2_client_filter(
       ProtoVer(2, 0));
+
+  struct ReflectorMetrics
+  {
+    Metrics::Counter& audio_frames;
+    Metrics::Counter& udp_lost_frames;
+    Metrics::Counter& udp_out_of_seq;
+    Metrics::Gauge&   clients;
+    Metrics::Gauge&   ca_jobs_queued;
+  };
+
+  ReflectorMetrics& reflectorMetrics(void)
+  {
+    auto& m = Metrics::instance();
+    static ReflectorMetrics metrics {
+      m.counter("svxreflector_audio_frames_total",
+                "Number of audio frames received from talkers"),
+      m.counter("svxreflector_udp_lost_frames_total",
+                "Number of UDP frames from clients that never arrived"),
+      m.counter("svxreflector_udp_out_of_sequence_total",
+                "Number of UDP frames from clients dropped since they "
+                "arrived out of sequence"),
+      m.gauge("svxreflector_clients", "Number of connected clients"),
+      m.gauge("svxreflector_ca_jobs_queued",
+              "Number of CA operations waiting for or running in the "
+              "worker thread")
+    };
+    return metrics;
+  }
 };
 
 
@@ -227,15 +370,25 @@ time_t Reflector::timeToRenewCert(const Async::SslX509& cert)
  ****************************************************************************/
 
 Reflector::Reflector(void)
-  : m_srv(0), m_udp_sock(0), m_tg_for_v1_clients(1), m_random_qsy_lo(0),
+  : m_srv(0), m_udp_sock(0), m_udp_shards(0), m_tg_for_v1_clients(1),
+    m_random_qsy_lo(0),
     m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0), m_cmd_pty(0),
     m_keys_dir("private/"), m_pending_csrs_dir("pending_csrs/"),
-    m_csrs_dir("csrs/"), m_certs_dir("certs/"), m_pki_dir("pki/")
+    m_csrs_dir("csrs/"), m_certs_dir("certs/"), m_pki_dir("pki/"),
+    m_ticket_key_timer(60*60*1000, Async::Timer::TYPE_PERIODIC, false)
 {
   TGHandler::instance()->talkerUpdated.connect(
       mem_fun(*this, &Reflector::onTalkerUpdated));
   TGHandler::instance()->requestAutoQsy.connect(
       mem_fun(*this, &Reflector::onRequestAutoQsy));
+  TGHandler::instance()->tgUsageChanged.connect(
+      mem_fun(m_trunk_handler, &TrunkHandler::setLocalTGUsed));
+  m_trunk_handler.remoteTalkerUpdated.connect(
+      mem_fun(*this, &Reflector::onTrunkTalkerUpdated));
+  m_trunk_handler.remoteAudioReceived.connect(
+      mem_fun(*this, &Reflector::onTrunkAudioReceived));
+  m_trunk_handler.localTalkerPreempted.connect(
+      mem_fun(*this, &Reflector::onTrunkTalkerPreempted));
   m_renew_cert_timer.expired.connect(
       [&](Async::AtTimer*)
       {
@@ -254,6 +407,16 @@ Reflector::Reflector(void)
                     << std::endl;
         }
       });
+  m_ticket_key_timer.expired.connect(
+      [&](Async::Timer*)
+      {
+          // The key is only replaced when it has reached its max age
+        if (!m_ssl_ctx.setTicketKeyFile(m_ticket_key_file))
+        {
+          std::cerr << "*** WARNING: Failed to rotate the TLS session ticket "
+                       "key" << std::endl;
+        }
+      });
   m_status["nodes"] = Json::Value(Json::objectValue);
 } /* Reflector::Reflector */
 
@@ -270,6 +433,8 @@ Reflector::~Reflector(void)
   m_cmd_pty = 0;
   m_client_con_map.clear();
   ReflectorClient::cleanup();
+  delete m_udp_shards;
+  m_udp_shards = 0;
   delete TGHandler::instance();
 } /* Reflector::~Reflector */
 
@@ -295,9 +460,24 @@ bool Reflector::initialize(Async::Config &cfg)
 
   m_srv->setSslContext(m_ssl_ctx);
 
+  if (!m_ca_jobs.initialize())
+  {
+    std::cerr << "*** ERROR: Could not start the CA worker thread"
+              << std::endl;
+    return false;
+  }
+
   uint16_t udp_listen_port = 5300;
   cfg.getValue("GLOBAL", "LISTEN_PORT", udp_listen_port);
-  m_udp_sock = new Async::EncryptedUdpSocket(udp_listen_port);
+  unsigned udp_shards = 1;
+  if (!cfg.getValue("GLOBAL", "UDP_SHARDS", 1U, 64U, udp_shards, true))
+  {
+    std::cerr << "*** ERROR: Illegal value for GLOBAL/UDP_SHARDS. "
+                 "Valid range is 1 to 64." << std::endl;
+    return false;
+  }
+  m_udp_sock = new Async::EncryptedUdpSocket(udp_listen_port,
+      Async::IpAddress(), udp_shards > 1);
   const char* err = "unknown reason";
   if ((err="bad allocation",          (m_udp_sock == 0)) ||
       (err="initialization failure",  !m_udp_sock->initOk()) ||
@@ -313,6 +493,23 @@ bool Reflector::initialize(Async::Config &cfg)
       mem_fun(*this, &Reflector::udpCipherDataReceived));
   m_udp_sock->dataReceived.connect(
       mem_fun(*this, &Reflector::udpDatagramReceived));
+  m_udp_sock->setReceiveBatchSize(UDP_RECV_BATCH_SIZE);
+
+    // The main thread socket is the first shard. The rest of the shards
+    // are worker threads with their own socket on the same port.
+  if (udp_shards > 1)
+  {
+    m_udp_shards = new ReflectorUdpShards;
+    if (!m_udp_shards->initialize(udp_listen_port, udp_shards - 1))
+    {
+      std::cerr << "*** ERROR: Could not start the UDP shard threads"
+                << std::endl;
+      return false;
+    }
+    m_udp_shards->datagramReceived.connect(
+        mem_fun(*this, &Reflector::udpShardDatagramReceived));
+    std::cout << "Using " << udp_shards << " UDP shards" << std::endl;
+  }
 
   unsigned sql_timeout = 0;
   cfg.getValue("GLOBAL", "SQL_TIMEOUT", sql_timeout);
@@ -324,6 +521,16 @@ bool Reflector::initialize(Async::Config &cfg)
 
   m_cfg->getValue("GLOBAL", "TG_FOR_V1_CLIENTS", m_tg_for_v1_clients);
 
+  m_accept_callsign.var =
+    m_cfg->variable<std::string>("GLOBAL", "ACCEPT_CALLSIGN");
+  m_reject_callsign.var =
+    m_cfg->variable<std::string>("GLOBAL", "REJECT_CALLSIGN");
+
+  if (!m_trunk_handler.initialize(cfg, m_ssl_ctx))
+  {
+    return false;
+  }
+
   SvxLink::SepPair<uint32_t, uint32_t> random_qsy_range;
   if (m_cfg->getValue("GLOBAL", "RANDOM_QSY_RANGE", random_qsy_range))
   {
@@ -347,6 +554,8 @@ bool Reflector::initialize(Async::Config &cfg)
     m_http_server->clientDisconnected.connect(
         sigc::mem_fun(*this, &Reflector::httpClientDisconnected));
   }
+  Metrics::instance().collect.connect(
+      sigc::mem_fun(*this, &Reflector::collectMetrics));
 
     // Path for command PTY
   string pty_path;
@@ -391,13 +600,26 @@ void Reflector::nodeList(std::vector<std::string>& nodes) const
 void Reflector::broadcastMsg(const ReflectorMsg& msg,
                              const ReflectorClient::Filter& filter)
 {
+    // The message is packed once, when the first receiver is found, and the
+    // same frame is then written to all receivers
+  Async::FramedTcpConnection::Frame frame;
+  std::vector<ReflectorClient::ClientId> ids;
+  ids.reserve(m_client_con_map.size());
   for (const auto& item : m_client_con_map)
   {
-    ReflectorClient *client = item.second;
-    if (filter(client) &&
+    ids.push_back(item.second->clientId());
+  }
+  for (const auto& id : ids)
+  {
+    ReflectorClient *client = ReflectorClient::lookup(id);
+    if ((client != nullptr) && filter(client) &&
         (client->conState() == ReflectorClient::STATE_CONNECTED))
     {
-      client->sendMsg(msg);
+      if (frame == nullptr)
+      {
+        frame = ReflectorClient::packMsg(msg);
+      }
+      client->sendFrame(frame, msg.type());
     }
   }
 } /* Reflector::broadcastMsg */
@@ -408,14 +630,14 @@ bool Reflector::sendUdpDatagram(ReflectorClient *client,
 {
   auto udp_addr = client->remoteUdpHost();
   auto udp_port = client->remoteUdpPort();
+  const unsigned shard = udpShardForClient(client);
   if (client->protoVer() >= ProtoVer(3, 0))
   {
     ReflectorUdpMsg header(msg.type());
     ostringstream ss;
     assert(header.pack(ss) && msg.pack(ss));
 
-    m_udp_sock->setCipherIV(client->udpCipherIV());
-    m_udp_sock->setCipherKey(client->udpCipherKey());
+    std::vector<uint8_t> iv = client->udpCipherIV();
     UdpCipher::AAD aad{client->udpCipherIVCntrNext()};
     std::stringstream aadss;
     if (!aad.pack(aadss))
@@ -424,6 +646,14 @@ bool Reflector::sendUdpDatagram(ReflectorClient *client,
                    "datagram to " << udp_addr << ":" << udp_port << std::endl;
       return false;
     }
+    if (shard > 0)
+    {
+      m_udp_shards->send(shard - 1, udp_addr, udp_port, std::move(iv),
+                         client->udpCipherKey(), aadss.str(), ss.str());
+      return true;
+    }
+    m_udp_sock->setCipherIV(iv);
+    m_udp_sock->setCipherKey(client->udpCipherKey());
     return m_udp_sock->write(udp_addr, udp_port,
                              aadss.str().data(), aadss.str().size(),
                              ss.str().data(), ss.str().size());
@@ -434,6 +664,12 @@ bool Reflector::sendUdpDatagram(ReflectorClient *client,
         client->udpCipherIVCntrNext() & 0xffff);
     ostringstream ss;
     assert(header.pack(ss) && msg.pack(ss));
+    if (shard > 0)
+    {
+      m_udp_shards->send(shard - 1, udp_addr, udp_port, {}, {}, "",
+                         ss.str());
+      return true;
+    }
     return m_udp_sock->UdpSocket::write(
         udp_addr, udp_port,
         ss.str().data(), ss.str().size());
@@ -444,6 +680,7 @@ bool Reflector::sendUdpDatagram(ReflectorClient *client,
 void Reflector::broadcastUdpMsg(const ReflectorUdpMsg& msg,
                                 const ReflectorClient::Filter& filter)
 {
+  m_udp_sock->beginWriteBatch();
   for (const auto& item : m_client_con_map)
   {
     ReflectorClient *client = item.second;
@@ -453,9 +690,87 @@ void Reflector::broadcastUdpMsg(const ReflectorUdpMsg& msg,
       client->sendUdpMsg(msg);
     }
   }
+  m_udp_sock->endWriteBatch();
 } /* Reflector::broadcastUdpMsg */
 
 
+void Reflector::broadcastMsgToTG(const ReflectorMsg& msg, uint32_t tg,
+                                 const ReflectorClient::Filter& filter)
+{
+  TGHandler *tg_handler = TGHandler::instance();
+  Async::FramedTcpConnection::Frame frame;
+  auto send = [&](ReflectorClient *client)
+  {
+    if (frame == nullptr)
+    {
+      frame = ReflectorClient::packMsg(msg);
+    }
+    client->sendFrame(frame, msg.type());
+  };
+  for (const auto& id : clientIds(tg_handler->clientsForTG(tg)))
+  {
+    ReflectorClient *client = ReflectorClient::lookup(id);
+    if ((client != nullptr) && filter(client) &&
+        (client->conState() == ReflectorClient::STATE_CONNECTED))
+    {
+      send(client);
+    }
+  }
+  for (const auto& id : clientIds(tg_handler->monitorsForTG(tg)))
+  {
+    ReflectorClient *client = ReflectorClient::lookup(id);
+    if ((client != nullptr) && (tg_handler->TGForClient(client) != tg) &&
+        filter(client) &&
+        (client->conState() == ReflectorClient::STATE_CONNECTED))
+    {
+      send(client);
+    }
+  }
+} /* Reflector::broadcastMsgToTG */
+
+
+void Reflector::broadcastUdpMsgToTG(const ReflectorUdpMsg& msg, uint32_t tg,
+                                    const ReflectorClient* except)
+{
+  m_udp_sock->beginWriteBatch();
+  for (const auto& id : clientIds(TGHandler::instance()->clientsForTG(tg)))
+  {
+    ReflectorClient *client = ReflectorClient::lookup(id);
+    if ((client != nullptr) && (client != except) &&
+        (client->conState() == ReflectorClient::STATE_CONNECTED))
+    {
+      client->sendUdpMsg(msg);
+    }
+  }
+  m_udp_sock->endWriteBatch();
+} /* Reflector::broadcastUdpMsgToTG */
+
+
+void Reflector::updateUdpShardClient(ReflectorClient* client)
+{
+  if (m_udp_shards == 0)
+  {
+    return;
+  }
+  m_udp_shards->setClientCipher(client->clientId(),
+      client->udpCipherIVRand(), client->udpCipherKey());
+  if (client->remoteUdpPort() != 0)
+  {
+    m_udp_shards->setClientSource(client->clientId(),
+        client->remoteUdpHost(), client->remoteUdpPort());
+  }
+} /* Reflector::updateUdpShardClient */
+
+
+void Reflector::removeUdpShardClient(ReflectorClient* client)
+{
+  if (m_udp_shards != 0)
+  {
+    m_udp_shards->removeClient(client->clientId());
+  }
+} /* Reflector::removeUdpShardClient */
+
+
 void Reflector::requestQsy(ReflectorClient *client, uint32_t tg)
 {
   uint32_t current_tg = TGHandler::instance()->TGForClient(client);
@@ -482,154 +797,136 @@ void Reflector::requestQsy(ReflectorClient *client, uint32_t tg)
 } /* Reflector::requestQsy */
 
 
-Async::SslCertSigningReq
-Reflector::loadClientPendingCsr(const std::string& callsign)
-{
-  Async::SslCertSigningReq csr;
-  (void)csr.readPemFile(m_pending_csrs_dir + "/" + callsign + ".csr");
-  return csr;
-} /* Reflector::loadClientPendingCsr */
-
-
-Async::SslCertSigningReq
-Reflector::loadClientCsr(const std::string& callsign)
-{
-  Async::SslCertSigningReq csr;
-  (void)csr.readPemFile(m_csrs_dir + "/" + callsign + ".csr");
-  return csr;
-} /* Reflector::loadClientPendingCsr */
-
-
-bool Reflector::renewedClientCert(Async::SslX509& cert)
+void Reflector::renewClientCert(const Async::SslX509& cert, CertDone done)
 {
   if (cert.isNull())
   {
-    return false;
+    done(std::string());
+    return;
   }
 
-  std::string callsign(cert.commonName());
-  Async::SslX509 new_cert = loadClientCertificate(callsign);
-  if (!new_cert.isNull() &&
-      ((new_cert.publicKey() != cert.publicKey()) ||
-       (timeToRenewCert(new_cert) <= std::time(NULL))))
+  struct Result
   {
-    return signClientCert(cert, "CRT_RENEWED");
-  }
-  cert = std::move(new_cert);
-  return !cert.isNull();
-} /* Reflector::renewedClientCert */
-
-
-bool Reflector::signClientCert(Async::SslX509& cert, const std::string& ca_op)
-{
-  //std::cout << "### Reflector::signClientCert" << std::endl;
-
-  cert.setSerialNumber();
-  cert.setIssuerName(m_issue_ca_cert.subjectName());
-  cert.setValidityTime(CERT_VALIDITY_DAYS, CERT_VALIDITY_OFFSET_DAYS);
-  auto cn = cert.commonName();
-  if (!cert.sign(m_issue_ca_pkey))
-  {
-    std::cerr << "*** ERROR: Certificate signing failed for client "
-              << cn << std::endl;
-    return false;
-  }
-  auto crtfile = m_certs_dir + "/" + cn + ".crt";
-  if (cert.writePemFile(crtfile) && m_issue_ca_cert.appendPemFile(crtfile))
-  {
-    runCAHook({
-        { "CA_OP",      ca_op },
-        { "CA_CRT_PEM", cert.pem() }
+    std::string               cert_pem;
+    Async::Exec::Environment  env;
+  };
+  auto ca = caContext();
+  auto res = std::make_shared<Result>();
+  const std::string cert_pem = cert.pem();
+  m_ca_jobs.post("renew_cert",
+      [ca, res, cert_pem](void)
+      {
+        Async::SslX509 cert;
+        if (!cert.readPem(cert_pem) || cert.isNull())
+        {
+          return;
+        }
+        Async::SslX509 new_cert =
+          ca->loadClientCertificate(cert.commonName());
+        if (!new_cert.isNull() &&
+            ((new_cert.publicKey() != cert.publicKey()) ||
+             (timeToRenewCert(new_cert) <= std::time(NULL))))
+        {
+          if (!ca->signClientCert(cert, "CRT_RENEWED", res->env))
+          {
+            return;
+          }
+          new_cert = std::move(cert);
+        }
+        res->cert_pem = ca->clientCertPem(new_cert);
+      },
+      [this, res, done](void)
+      {
+        if (!res->env.empty())
+        {
+          runCAHook(res->env);
+        }
+        done(res->cert_pem);
       });
-  }
-  else
-  {
-    std::cerr << "*** WARNING: Failed to write client certificate file '"
-              << crtfile << "'" << std::endl;
-  }
-  return true;
-} /* Reflector::signClientCert */
+} /* Reflector::renewClientCert */
 
 
-Async::SslX509 Reflector::signClientCsr(const std::string& cn)
+void Reflector::signClientCsr(const std::string& cn,
+                              std::function<void(bool)> done)
 {
   //std::cout << "### Reflector::signClientCsr" << std::endl;
 
-  Async::SslX509 cert(nullptr);
-
-  auto req = loadClientPendingCsr(cn);
-  if (req.isNull())
+  struct Result
   {
-    std::cerr << "*** ERROR: Cannot find CSR to sign '" << req.filePath()
-              << "'" << std::endl;
-    return cert;
-  }
-
-  cert.clear();
-  cert.setVersion(Async::SslX509::VERSION_3);
-  cert.setSubjectName(req.subjectName());
-  const Async::SslX509Extensions exts(req.extensions());
-  Async::SslX509Extensions cert_exts;
-  cert_exts.addBasicConstraints("critical, CA:FALSE");
-  cert_exts.addKeyUsage(
-      "critical, digitalSignature, keyEncipherment, keyAgreement");
-  cert_exts.addExtKeyUsage("clientAuth");
-  Async::SslX509ExtSubjectAltName san(exts.subjectAltName());
-  cert_exts.addExtension(san);
-  cert.addExtensions(cert_exts);
-  Async::SslKeypair csr_pkey(req.publicKey());
-  cert.setPublicKey(csr_pkey);
-
-  if (!signClientCert(cert, "CSR_SIGNED"))
-  {
-    cert.set(nullptr);
-  }
-
-  std::string csr_path = m_csrs_dir + "/" + cn + ".csr";
-  if (rename(req.filePath().c_str(), csr_path.c_str()) != 0)
-  {
-    auto errstr = SvxLink::strError(errno);
-    std::cerr << "*** WARNING: Failed to move signed CSR from '"
-              << req.filePath() << "' to '" << csr_path << "': "
-              << errstr << std::endl;
-  }
+    std::string               cert_pem;
+    std::string               send_pem;
+    Async::Exec::Environment  env;
+  };
+  auto ca = caContext();
+  auto res = std::make_shared<Result>();
+  m_ca_jobs.post("sign_csr",
+      [ca, res, cn](void)
+      {
+        auto req = ca->loadCsr(ca->pending_csrs_dir, cn);
+        if (req.isNull())
+        {
+          std::cerr << "*** ERROR: Cannot find CSR to sign '"
+                    << req.filePath() << "'" << std::endl;
+          return;
+        }
 
-  auto client = ReflectorClient::lookup(cn);
-  if ((client != nullptr) && !cert.isNull())
-  {
-    client->certificateUpdated(cert);
-  }
+        Async::SslX509 cert;
+        cert.setVersion(Async::SslX509::VERSION_3);
+        cert.setSubjectName(req.subjectName());
+        const Async::SslX509Extensions exts(req.extensions());
+        Async::SslX509Extensions cert_exts;
+        cert_exts.addBasicConstraints("critical, CA:FALSE");
+        cert_exts.addKeyUsage(
+            "critical, digitalSignature, keyEncipherment, keyAgreement");
+        cert_exts.addExtKeyUsage("clientAuth");
+        Async::SslX509ExtSubjectAltName san(exts.subjectAltName());
+        cert_exts.addExtension(san);
+        cert.addExtensions(cert_exts);
+        Async::SslKeypair csr_pkey(req.publicKey());
+        cert.setPublicKey(csr_pkey);
+
+        bool signed_ok = ca->signClientCert(cert, "CSR_SIGNED", res->env);
+
+        std::string csr_path = ca->csrs_dir + "/" + cn + ".csr";
+        if (rename(req.filePath().c_str(), csr_path.c_str()) != 0)
+        {
+          auto errstr = SvxLink::strError(errno);
+          std::cerr << "*** WARNING: Failed to move signed CSR from '"
+                    << req.filePath() << "' to '" << csr_path << "': "
+                    << errstr << std::endl;
+        }
 
-  return cert;
+        if (signed_ok)
+        {
+          res->cert_pem = cert.pem();
+          res->send_pem = ca->clientCertPem(cert);
+        }
+      },
+      [this, res, cn, done](void)
+      {
+        if (!res->env.empty())
+        {
+          runCAHook(res->env);
+        }
+        Async::SslX509 cert(nullptr);
+        if (!res->cert_pem.empty() && cert.readPem(res->cert_pem))
+        {
+          std::cout << "---------- Signed Client Certificate ----------"
+                    << std::endl;
+          cert.print(" ");
+          std::cout << "-----------------------------------------------"
+                    << std::endl;
+          auto client = ReflectorClient::lookup(cn);
+          if (client != nullptr)
+          {
+            client->certificateUpdated(res->send_pem);
+          }
+        }
+        done(!cert.isNull());
+      });
 } /* Reflector::signClientCsr */
 
 
-Async::SslX509 Reflector::loadClientCertificate(const std::string& callsign)
-{
-  Async::SslX509 cert;
-  if (!cert.readPemFile(m_certs_dir + "/" + callsign + ".crt") ||
-      cert.isNull() ||
-      //!cert.verify(m_issue_ca_pkey) ||
-      !cert.timeIsWithinRange())
-  {
-    return nullptr;
-  }
-  return cert;
-} /* Reflector::loadClientCertificate */
-
-
-std::string Reflector::clientCertPem(const std::string& callsign) const
-{
-  std::string crtfile(m_certs_dir + "/" + callsign + ".crt");
-  std::ifstream ifs(crtfile);
-  if (!ifs.good())
-  {
-    return std::string();
-  }
-  return std::string(std::istreambuf_iterator<char>{ifs}, {});
-} /* Reflector::clientCertPem */
-
-
 std::string Reflector::caBundlePem(void) const
 {
   std::ifstream ifs(m_ca_bundle_file);
@@ -657,14 +954,8 @@ bool Reflector::callsignOk(const std::string& callsign) const
   }
 
     // Accept check
-  std::string accept_cs_re_str;
-  if (!m_cfg->getValue("GLOBAL", "ACCEPT_CALLSIGN", accept_cs_re_str) ||
-      accept_cs_re_str.empty())
-  {
-    accept_cs_re_str =
-      "[A-Z0-9][A-Z]{0,2}\\d[A-Z0-9]{0,3}[A-Z](?:-[A-Z0-9]{1,3})?";
-  }
-  const std::regex accept_callsign_re(accept_cs_re_str);
+  const std::regex& accept_callsign_re = m_accept_callsign.regex(
+      "[A-Z0-9][A-Z]{0,2}\\d[A-Z0-9]{0,3}[A-Z](?:-[A-Z0-9]{1,3})?");
   if (!std::regex_match(callsign, accept_callsign_re))
   {
     std::cerr << "*** WARNING: The callsign '" << callsign
@@ -674,11 +965,9 @@ bool Reflector::callsignOk(const std::string& callsign) const
   }
 
     // Reject check
-  std::string reject_cs_re_str;
-  m_cfg->getValue("GLOBAL", "REJECT_CALLSIGN", reject_cs_re_str);
-  if (!reject_cs_re_str.empty())
+  const std::regex& reject_callsign_re = m_reject_callsign.regex("");
+  if (!m_reject_callsign.str.empty())
   {
-    const std::regex reject_callsign_re(reject_cs_re_str);
     if (std::regex_match(callsign, reject_callsign_re))
     {
       std::cerr << "*** WARNING: The callsign '" << callsign
@@ -746,11 +1035,13 @@ std::string Reflector::checkCsr(const Async::SslCertSigningReq& req)
 } /* Reflector::checkCsr */
 
 
-Async::SslX509 Reflector::csrReceived(Async::SslCertSigningReq& req)
+void Reflector::csrReceived(const Async::SslCertSigningReq& req,
+                            CsrDone done)
 {
   if (req.isNull())
   {
-    return nullptr;
+    done(std::string(), false);
+    return;
   }
 
   std::string callsign(req.commonName());
@@ -758,66 +1049,89 @@ Async::SslX509 Reflector::csrReceived(Async::SslCertSigningReq& req)
   {
     std::cerr << "*** WARNING: The CSR CN (callsign) check failed"
               << std::endl;
-    return nullptr;
+    done(std::string(), false);
+    return;
   }
 
-  std::string csr_path(m_csrs_dir + "/" + callsign + ".csr");
-  Async::SslCertSigningReq csr;
-  if (!csr.readPemFile(csr_path))
+  struct Result
   {
-    csr.set(nullptr);
-  }
+    std::string               cert_pem;
+    bool                      csr_is_current = false;
+    Async::Exec::Environment  env;
+  };
+  auto ca = caContext();
+  auto res = std::make_shared<Result>();
+  const std::string req_pem = req.pem();
+  m_ca_jobs.post("csr_received",
+      [ca, res, callsign, req_pem](void)
+      {
+        Async::SslCertSigningReq req;
+        if (!req.readPem(req_pem) || req.isNull())
+        {
+          return;
+        }
 
-  if (!csr.isNull() && (req.publicKey() != csr.publicKey()))
-  {
-    std::cerr << "*** WARNING: The received CSR with callsign '"
-              << callsign << "' has a different public key "
-                 "than the current CSR. That may be a sign of someone "
-                 "trying to hijack a callsign or the owner of the "
-                 "callsign has generated a new private/public key pair."
-              << std::endl;
-    return nullptr;
-  }
+        Async::SslCertSigningReq csr = ca->loadCsr(ca->csrs_dir, callsign);
+        if (!csr.isNull() && (req.publicKey() != csr.publicKey()))
+        {
+          std::cerr << "*** WARNING: The received CSR with callsign '"
+                    << callsign << "' has a different public key "
+                       "than the current CSR. That may be a sign of someone "
+                       "trying to hijack a callsign or the owner of the "
+                       "callsign has generated a new private/public key "
+                       "pair." << std::endl;
+          return;
+        }
+        res->csr_is_current = !csr.isNull() &&
+                              (req.digest() == csr.digest());
 
-  Async::SslX509 cert = loadClientCertificate(callsign);
-  if (!cert.isNull() &&
-      ((cert.publicKey() != req.publicKey()) ||
-       (timeToRenewCert(cert) <= std::time(NULL))))
-  {
-    cert.set(nullptr);
-  }
+        Async::SslX509 cert = ca->loadClientCertificate(callsign);
+        if (!cert.isNull() &&
+            ((cert.publicKey() != req.publicKey()) ||
+             (timeToRenewCert(cert) <= std::time(NULL))))
+        {
+          cert.set(nullptr);
+        }
 
-  const std::string pending_csr_path(
-      m_pending_csrs_dir + "/" + callsign + ".csr");
-  Async::SslCertSigningReq pending_csr;
-  if ((
-        csr.isNull() ||
-        (req.digest() != csr.digest()) ||
-        cert.isNull()
-      ) && (
-        !pending_csr.readPemFile(pending_csr_path) ||
-        (req.digest() != pending_csr.digest())
-      ))
-  {
-    std::cout << callsign << ": Add pending CSR '" << pending_csr_path
-              << "' to CA" << std::endl;
-    if (req.writePemFile(pending_csr_path))
-    {
-      const auto ca_op =
-        pending_csr.isNull() ? "PENDING_CSR_CREATE" : "PENDING_CSR_UPDATE";
-      runCAHook({
-          { "CA_OP",      ca_op },
-          { "CA_CSR_PEM", req.pem() }
-        });
-    }
-    else
-    {
-      std::cerr << "*** WARNING: Could not write CSR file '"
-                << pending_csr_path << "'" << std::endl;
-    }
-  }
+        const std::string pending_csr_path(
+            ca->pending_csrs_dir + "/" + callsign + ".csr");
+        Async::SslCertSigningReq pending_csr;
+        if ((
+              !res->csr_is_current ||
+              cert.isNull()
+            ) && (
+              !pending_csr.readPemFile(pending_csr_path) ||
+              (req.digest() != pending_csr.digest())
+            ))
+        {
+          std::cout << callsign << ": Add pending CSR '" << pending_csr_path
+                    << "' to CA" << std::endl;
+          if (req.writePemFile(pending_csr_path))
+          {
+            const auto ca_op = pending_csr.isNull()
+              ? "PENDING_CSR_CREATE" : "PENDING_CSR_UPDATE";
+            res->env = {
+                { "CA_OP",      ca_op },
+                { "CA_CSR_PEM", req.pem() }
+              };
+          }
+          else
+          {
+            std::cerr << "*** WARNING: Could not write CSR file '"
+                      << pending_csr_path << "'" << std::endl;
+          }
+        }
 
-  return cert;
+        res->cert_pem = ca->clientCertPem(cert);
+      },
+      [this, res, done](void)
+      {
+        if (!res->env.empty())
+        {
+          runCAHook(res->env);
+        }
+        done(res->cert_pem, res->csr_is_current);
+      });
 } /* Reflector::csrReceived */
 
 
@@ -845,6 +1159,21 @@ Json::Value& Reflector::clientStatus(const std::string& callsign)
  *
  ****************************************************************************/
 
+const std::regex& Reflector::CfgRegex::regex(const std::string& def)
+{
+    // The regular expression is only compiled again if the configuration
+    // variable has been changed
+  const std::string& cfg_str = var.value();
+  const std::string& new_str = cfg_str.empty() ? def : cfg_str;
+  if (new_str != str)
+  {
+    str = new_str;
+    re = std::regex(str);
+  }
+  return re;
+} /* Reflector::CfgRegex::regex */
+
+
 void Reflector::clientConnected(Async::FramedTcpConnection *con)
 {
   std::cout << con->remoteHost() << ":" << con->remotePort()
@@ -965,6 +1294,36 @@ bool Reflector::udpCipherDataReceived(const IpAddress& addr, uint16_t port,
 } /* Reflector::udpCipherDataReceived */
 
 
+void Reflector::udpShardDatagramReceived(const IpAddress& addr,
+                                         uint16_t port, void* aad, int aadlen,
+                                         void *buf, int count)
+{
+    // The datagram have already been decrypted by the shard thread. Only
+    // the length of the associated data need to be set up.
+  if (aad != nullptr)
+  {
+    m_udp_sock->setCipherAADLength(aadlen);
+  }
+  udpDatagramReceived(addr, port, aad, buf, count);
+} /* Reflector::udpShardDatagramReceived */
+
+
+  /*
+   * Select the shard that datagrams to a client are sent from. Shard zero is
+   * the socket owned by the main thread. Received datagrams are spread over
+   * the sockets by the kernel, using a hash of the address and port of both
+   * ends, so they may be received by any shard.
+   */
+unsigned Reflector::udpShardForClient(const ReflectorClient* client) const
+{
+  if (m_udp_shards == 0)
+  {
+    return 0;
+  }
+  return client->clientId() % (m_udp_shards->size() + 1);
+} /* Reflector::udpShardForClient */
+
+
 void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
                                     void* aadptr, void *buf, int count)
 {
@@ -1103,6 +1462,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
   {
     if (aad.iv_cntr < client->nextUdpRxSeq()) // Frame out of sequence (ignore)
     {
+      reflectorMetrics().udp_out_of_seq.inc();
       std::cout << client->callsign()
                 << ": Dropping out of sequence UDP frame with seq="
                 << aad.iv_cntr << std::endl;
@@ -1110,6 +1470,8 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
     }
     else if (aad.iv_cntr > client->nextUdpRxSeq()) // Frame lost
     {
+      reflectorMetrics().udp_lost_frames.inc(
+          aad.iv_cntr - client->nextUdpRxSeq());
       std::cout << client->callsign() << ": UDP frame(s) lost. Expected seq="
                 << client->nextUdpRxSeq()
                 << " but received " << aad.iv_cntr
@@ -1124,6 +1486,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
     uint16_t udp_rx_seq_diff = header_v2.sequenceNum() - next_udp_rx_seq;
     if (udp_rx_seq_diff > 0x7fff) // Frame out of sequence (ignore)
     {
+      reflectorMetrics().udp_out_of_seq.inc();
       std::cout << client->callsign()
                 << ": Dropping out of sequence frame with seq="
                 << header_v2.sequenceNum() << ". Expected seq="
@@ -1132,6 +1495,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
     }
     else if (udp_rx_seq_diff > 0) // Frame(s) lost
     {
+      reflectorMetrics().udp_lost_frames.inc(udp_rx_seq_diff);
       cout << client->callsign()
            << ": UDP frame(s) lost. Expected seq=" << next_udp_rx_seq
            << ". Received seq=" << header_v2.sequenceNum() << endl;
@@ -1163,7 +1527,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
         if (!msg.audioData().empty() && (tg > 0))
         {
           ReflectorClient* talker = TGHandler::instance()->talkerForTG(tg);
-          if (talker == 0)
+          if ((talker == 0) && !hasTrunkTalker(tg))
           {
             TGHandler::instance()->setTalkerForTG(tg, client);
             talker = TGHandler::instance()->talkerForTG(tg);
@@ -1171,10 +1535,9 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
           if (talker == client)
           {
             TGHandler::instance()->setTalkerForTG(tg, client);
-            broadcastUdpMsg(msg,
-                ReflectorClient::mkAndFilter(
-                  ReflectorClient::ExceptFilter(client),
-                  ReflectorClient::TgFilter(tg)));
+            reflectorMetrics().audio_frames.inc();
+            broadcastUdpMsgToTG(msg, tg, client);
+            m_trunk_handler.localAudio(tg, msg.audioData());
             //broadcastUdpMsgExcept(tg, client, msg,
             //    ProtoVerRange(ProtoVer(0, 6),
             //                  ProtoVer(1, ProtoVer::max().minor())));
@@ -1293,31 +1656,22 @@ void Reflector::onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
   {
     cout << old_talker->callsign() << ": Talker stop on TG #" << tg << endl;
     old_talker->updateIsTalker();
-    broadcastMsg(MsgTalkerStop(tg, old_talker->callsign()),
-        ReflectorClient::mkAndFilter(
-          ge_v2_client_filter,
-          ReflectorClient::mkOrFilter(
-            ReflectorClient::TgFilter(tg),
-            ReflectorClient::TgMonitorFilter(tg))));
+    broadcastMsgToTG(MsgTalkerStop(tg, old_talker->callsign()), tg,
+                     ge_v2_client_filter);
     if (tg == tgForV1Clients())
     {
       broadcastMsg(MsgTalkerStopV1(old_talker->callsign()), v1_client_filter);
     }
-    broadcastUdpMsg(MsgUdpFlushSamples(),
-          ReflectorClient::mkAndFilter(
-            ReflectorClient::TgFilter(tg),
-            ReflectorClient::ExceptFilter(old_talker)));
+    broadcastUdpMsgToTG(MsgUdpFlushSamples(), tg, old_talker);
+    m_trunk_handler.localTalkerStop(tg, old_talker->callsign());
   }
   if (new_talker != 0)
   {
     cout << new_talker->callsign() << ": Talker start on TG #" << tg << endl;
+    m_trunk_handler.localTalkerStart(tg, new_talker->callsign());
     new_talker->updateIsTalker();
-    broadcastMsg(MsgTalkerStart(tg, new_talker->callsign()),
-        ReflectorClient::mkAndFilter(
-          ge_v2_client_filter,
-          ReflectorClient::mkOrFilter(
-            ReflectorClient::TgFilter(tg),
-            ReflectorClient::TgMonitorFilter(tg))));
+    broadcastMsgToTG(MsgTalkerStart(tg, new_talker->callsign()), tg,
+                     ge_v2_client_filter);
     if (tg == tgForV1Clients())
     {
       broadcastMsg(MsgTalkerStartV1(new_talker->callsign()), v1_client_filter);
@@ -1326,6 +1680,47 @@ void Reflector::onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
 } /* Reflector::onTalkerUpdated */
 
 
+void Reflector::onTrunkTalkerUpdated(uint32_t tg,
+                                     const std::string& old_callsign,
+                                     const std::string& new_callsign)
+{
+  if (!old_callsign.empty())
+  {
+    cout << old_callsign << ": Trunk talker stop on TG #" << tg << endl;
+    broadcastMsgToTG(MsgTalkerStop(tg, old_callsign), tg,
+                     ge_v2_client_filter);
+    if (tg == tgForV1Clients())
+    {
+      broadcastMsg(MsgTalkerStopV1(old_callsign), v1_client_filter);
+    }
+    broadcastUdpMsgToTG(MsgUdpFlushSamples(), tg);
+  }
+  if (!new_callsign.empty())
+  {
+    cout << new_callsign << ": Trunk talker start on TG #" << tg << endl;
+    broadcastMsgToTG(MsgTalkerStart(tg, new_callsign), tg,
+                     ge_v2_client_filter);
+    if (tg == tgForV1Clients())
+    {
+      broadcastMsg(MsgTalkerStartV1(new_callsign), v1_client_filter);
+    }
+  }
+} /* Reflector::onTrunkTalkerUpdated */
+
+
+void Reflector::onTrunkAudioReceived(uint32_t tg,
+                                     const std::vector<uint8_t>& audio)
+{
+  broadcastUdpMsgToTG(MsgUdpAudio(audio), tg);
+} /* Reflector::onTrunkAudioReceived */
+
+
+void Reflector::onTrunkTalkerPreempted(uint32_t tg)
+{
+  TGHandler::instance()->setTalkerForTG(tg, 0);
+} /* Reflector::onTrunkTalkerPreempted */
+
+
 void Reflector::httpRequestReceived(Async::HttpServerConnection *con,
                                     Async::HttpServerConnection::Request& req)
 {
@@ -1341,6 +1736,12 @@ void Reflector::httpRequestReceived(Async::HttpServerConnection *con,
     return;
   }
 
+  if (req.target == "/metrics")
+  {
+    Async::MetricsHttpServer::handleRequest(con, req);
+    return;
+  }
+
   if (req.target != "/status")
   {
     res.setCode(404);
@@ -1350,6 +1751,37 @@ void Reflector::httpRequestReceived(Async::HttpServerConnection *con,
     return;
   }
 
+  m_status["tls_handshakes"]["full"] =
+    static_cast<Json::UInt64>(m_ssl_ctx.fullHandshakes());
+  m_status["tls_handshakes"]["resumed"] =
+    static_cast<Json::UInt64>(m_ssl_ctx.resumedHandshakes());
+  Json::Value& ca_jobs = m_status["ca_jobs"];
+  ca_jobs["queued"] = m_ca_jobs.queued();
+  ca_jobs["max_queued"] = m_ca_jobs.maxQueued();
+  for (const auto& op : m_ca_jobs.opStats())
+  {
+    const auto& stats = op.second;
+    Json::Value& op_status = ca_jobs["ops"][op.first];
+    op_status["count"] = static_cast<Json::UInt64>(stats.count);
+    op_status["avg_ms"] = (stats.count > 0)
+      ? stats.total.count() / 1000.0 / stats.count : 0.0;
+    op_status["max_ms"] = stats.max.count() / 1000.0;
+    op_status["max_wait_ms"] = stats.max_wait.count() / 1000.0;
+  }
+  for (const auto& item : m_client_con_map)
+  {
+    const auto con = item.first;
+    const ReflectorClient *client = item.second;
+    if (client->conState() == ReflectorClient::STATE_CONNECTED)
+    {
+      Json::Value& tx = clientStatus(client->callsign())["tcp_tx"];
+      tx["frames"] = static_cast<Json::UInt64>(con->txFrames());
+      tx["queued_bytes"] = static_cast<Json::UInt64>(con->sendBufferSize());
+      tx["max_queued_bytes"] =
+        static_cast<Json::UInt64>(con->maxSendBufferSize());
+    }
+  }
+
   std::ostringstream os;
   Json::StreamWriterBuilder builder;
   builder["commentStyle"] = "None";
@@ -1383,6 +1815,21 @@ void Reflector::httpClientDisconnected(Async::HttpServerConnection *con,
 } /* Reflector::httpClientDisconnected */
 
 
+void Reflector::collectMetrics(void)
+{
+  unsigned clients = 0;
+  for (const auto& item : m_client_con_map)
+  {
+    if (item.second->conState() == ReflectorClient::STATE_CONNECTED)
+    {
+      clients += 1;
+    }
+  }
+  reflectorMetrics().clients.set(clients);
+  reflectorMetrics().ca_jobs_queued.set(m_ca_jobs.queued());
+} /* Reflector::collectMetrics */
+
+
 void Reflector::onRequestAutoQsy(uint32_t from_tg)
 {
   uint32_t tg = nextRandomQsyTg();
@@ -1530,19 +1977,20 @@ void Reflector::ctrlPtyDataReceived(const void *buf, size_t count)
                  "Usage: CA SIGN <callsign>";
         goto write_status;
       }
-      auto cert = signClientCsr(cn);
-      if (!cert.isNull())
-      {
-        std::cout << "---------- Signed Client Certificate ----------"
-                  << std::endl;
-        cert.print(" ");
-        std::cout << "-----------------------------------------------"
-                  << std::endl;
-      }
-      else
-      {
-        errss << "Certificate signing failed";
-      }
+        // The status is written when the signing job has finished
+      signClientCsr(cn,
+          [this](bool ok)
+          {
+            if (!ok)
+            {
+              std::cerr << "*** ERROR: Certificate signing failed"
+                        << std::endl;
+              m_cmd_pty->write("ERR:Certificate signing failed\n");
+              return;
+            }
+            m_cmd_pty->write("OK\n");
+          });
+      return;
     }
     else if (subcmd == "RM")
     {
@@ -1675,6 +2123,23 @@ bool Reflector::loadCertificateFiles(void)
     return false;
   }
 
+    // Let reconnecting clients resume their TLS sessions, also after a
+    // restart of the reflector, to avoid a full handshake for each client
+  m_ssl_ctx.enableSessionResumption("SvxReflector");
+  m_ticket_key_file = "svxreflector_ticket.key";
+  if (buildPath("GLOBAL", "CERT_TICKET_KEY_FILE", m_keys_dir,
+                m_ticket_key_file) &&
+      m_ssl_ctx.setTicketKeyFile(m_ticket_key_file))
+  {
+    m_ticket_key_timer.setEnable(true);
+  }
+  else
+  {
+    std::cerr << "*** WARNING: Failed to set up the TLS session ticket key "
+                 "file '" << m_ticket_key_file << "'. Sessions will not be "
+                 "resumable after a restart." << std::endl;
+  }
+
   struct stat st;
   if (stat(m_ca_bundle_file.c_str(), &st) != 0)
   {
@@ -1768,6 +2233,16 @@ bool Reflector::loadServerCertificateFiles(void)
         cert.clear();
         generate_cert = true;
       }
+      else if (!cert.checkPurpose(X509_PURPOSE_SSL_CLIENT))
+      {
+          // The server certificate is also used as client certificate when
+          // connecting trunks to other reflectors
+        std::cerr << "The server certificate '" << m_crtfile << "' is not "
+                     "valid for client authentication. Generating new "
+                     "certificate." << std::endl;
+        cert.clear();
+        generate_cert = true;
+      }
     }
   }
   if (generate_cert)
@@ -1791,7 +2266,7 @@ bool Reflector::loadServerCertificateFiles(void)
     req_exts.addBasicConstraints("critical, CA:FALSE");
     req_exts.addKeyUsage(
         "critical, digitalSignature, keyEncipherment, keyAgreement");
-    req_exts.addExtKeyUsage("serverAuth");
+    req_exts.addExtKeyUsage("serverAuth, clientAuth");
     std::stringstream csr_san_ss;
     csr_san_ss << "DNS:" << cert_cn;
     std::string cert_san_str;
@@ -2002,6 +2477,9 @@ bool Reflector::loadRootCAFiles(void)
 
 bool Reflector::loadSigningCAFiles(void)
 {
+    // Jobs already queued keep using the old issuing CA
+  m_ca_ctx.reset();
+
     // Read issuing CA private key or generate a new one if it does not exist
   std::string ca_keyfile;
   if (!m_cfg->getValue("ISSUING_CA", "KEYFILE", ca_keyfile))
@@ -2218,6 +2696,30 @@ bool Reflector::removeClientCert(const std::string& cn)
 } /* Reflector::removeClientCert */
 
 
+std::shared_ptr<Reflector::CaContext> Reflector::caContext(void)
+{
+  if (m_ca_ctx == nullptr)
+  {
+    auto ca = std::make_shared<CaContext>();
+    ca->certs_dir = m_certs_dir;
+    ca->csrs_dir = m_csrs_dir;
+    ca->pending_csrs_dir = m_pending_csrs_dir;
+      // Deep copies so that the worker thread never share OpenSSL objects
+      // with the main thread
+    if (!m_issue_ca_cert.isNull())
+    {
+      ca->issue_ca_cert.readPem(m_issue_ca_cert.pem());
+    }
+    if (!m_issue_ca_pkey.isNull())
+    {
+      ca->issue_ca_pkey.privateKeyFromPem(m_issue_ca_pkey.privateKeyPem());
+    }
+    m_ca_ctx = ca;
+  }
+  return m_ca_ctx;
+} /* Reflector::caContext */
+
+
 void Reflector::runCAHook(const Async::Exec::Environment& env)
 {
   auto ca_hook_cmd = m_cfg->getValue("GLOBAL", "CERT_CA_HOOK");
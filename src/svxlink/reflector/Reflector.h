@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2024 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -38,6 +38,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/time.h>
 #include <vector>
 #include <string>
+#include <memory>
+#include <functional>
+#include <regex>
 #include <json/json.h>
 
 
@@ -47,6 +50,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncConfig.h>
 #include <AsyncTcpServer.h>
 #include <AsyncFramedTcpConnection.h>
 #include <AsyncTimer.h>
@@ -63,6 +67,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "ProtoVer.h"
 #include "ReflectorClient.h"
+#include "TrunkHandler.h"
+#include "ReflectorJobQueue.h"
 
 
 /****************************************************************************
@@ -74,12 +80,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace Async
 {
   class EncryptedUdpSocket;
-  class Config;
   class Pty;
 };
 
 class ReflectorMsg;
 class ReflectorUdpMsg;
+class ReflectorUdpShards;
 
 
 /****************************************************************************
@@ -175,6 +181,31 @@ class Reflector : public sigc::trackable
     void broadcastUdpMsg(const ReflectorUdpMsg& msg,
         const ReflectorClient::Filter& filter=ReflectorClient::NoFilter());
 
+    /**
+     * @brief   Send a TCP message to clients on, or monitoring, a talk group
+     * @param   msg The message to send
+     * @param   tg The talk group
+     * @param   filter The client filter to apply
+     *
+     * The clients are found using the talk group index kept by the TGHandler
+     * so only clients that have selected or are monitoring the talk group
+     * are looked at. Each client receive the message at most once.
+     */
+    void broadcastMsgToTG(const ReflectorMsg& msg, uint32_t tg,
+        const ReflectorClient::Filter& filter=ReflectorClient::NoFilter());
+
+    /**
+     * @brief   Send a UDP message to all clients on a talk group
+     * @param   msg The message to send
+     * @param   tg The talk group
+     * @param   except A client that should not receive the message
+     *
+     * This is the audio routing fast path. Only the clients that have
+     * selected the talk group are looked at, not all connected clients.
+     */
+    void broadcastUdpMsgToTG(const ReflectorUdpMsg& msg, uint32_t tg,
+                             const ReflectorClient* except=0);
+
     /**
      * @brief   Get the TG for protocol V1 clients
      * @return  Returns the TG used for protocol V1 clients
@@ -187,29 +218,86 @@ class Reflector : public sigc::trackable
      */
     void requestQsy(ReflectorClient *client, uint32_t tg);
 
+    /**
+     * @brief   Check if someone on another reflector is talking on a TG
+     * @param   tg The talk group
+     * @return  Returns \em true if there is a talker on a trunk peer
+     */
+    bool hasTrunkTalker(uint32_t tg) const
+    {
+      return !m_trunk_handler.remoteTalkerForTG(tg).empty();
+    }
+
     Async::EncryptedUdpSocket* udpSocket(void) const { return m_udp_sock; }
 
+    /**
+     * @brief   Update the UDP shards with the cipher and source of a client
+     * @param   client The client that have changed
+     *
+     * This function must be called when the UDP cipher parameters or the
+     * UDP source of a client have been set so that the UDP shard threads
+     * can decrypt datagrams from the client. It does nothing if sharding is
+     * not enabled.
+     */
+    void updateUdpShardClient(ReflectorClient* client);
+
+    /**
+     * @brief   Remove a client from the UDP shards
+     * @param   client The client to remove
+     */
+    void removeUdpShardClient(ReflectorClient* client);
+
     uint32_t randomQsyLo(void) const { return m_random_qsy_lo; }
     uint32_t randomQsyHi(void) const { return m_random_qsy_hi; }
 
-    Async::SslCertSigningReq loadClientPendingCsr(const std::string& callsign);
-    Async::SslCertSigningReq loadClientCsr(const std::string& callsign);
-    bool renewedClientCert(Async::SslX509& cert);
-    bool signClientCert(Async::SslX509& cert, const std::string& ca_op);
-    Async::SslX509 signClientCsr(const std::string& cn);
-    Async::SslX509 loadClientCertificate(const std::string& callsign);
+    using CertDone = std::function<void(const std::string&)>;
+    using CsrDone = std::function<void(const std::string&, bool)>;
+
+    /**
+     * @brief   Renew the certificate for a client
+     * @param   cert The current client certificate
+     * @param   done Called with the certificate PEM to send to the client
+     *
+     * The certificate is signed and written to file in the CA worker
+     * thread. The done function is called from the main thread with an
+     * empty string if there is no valid certificate to send.
+     */
+    void renewClientCert(const Async::SslX509& cert, CertDone done);
+
+    /**
+     * @brief   Sign a pending certificate signing request
+     * @param   cn The common name (callsign) of the pending CSR
+     * @param   done Called with the result when the signing is done
+     *
+     * The certificate is signed and written to file in the CA worker
+     * thread. When finished, a connected client with the given callsign is
+     * sent the new certificate.
+     */
+    void signClientCsr(const std::string& cn, std::function<void(bool)> done);
 
     size_t caSize(void) const { return m_ca_size; }
     const std::vector<uint8_t>& caDigest(void) const { return m_ca_md; }
     const std::vector<uint8_t>& caSignature(void) const { return m_ca_sig; }
-    std::string clientCertPem(const std::string& callsign) const;
     std::string caBundlePem(void) const;
     std::string issuingCertPem(void) const;
     bool callsignOk(const std::string& callsign) const;
     bool reqEmailOk(const Async::SslCertSigningReq& req) const;
     bool emailOk(const std::string& email) const;
     std::string checkCsr(const Async::SslCertSigningReq& req);
-    Async::SslX509 csrReceived(Async::SslCertSigningReq& req);
+
+    /**
+     * @brief   Handle a certificate signing request received from a client
+     * @param   req The received CSR
+     * @param   done Called with the result when the CSR has been handled
+     *
+     * The CSR is checked against the stored CSR and certificate, and saved
+     * as a pending CSR if needed, in the CA worker thread. The done
+     * function is called from the main thread with the certificate PEM to
+     * send to the client, or an empty string if there is no valid
+     * certificate, and a flag telling if the CSR is the same as the last
+     * one signed.
+     */
+    void csrReceived(const Async::SslCertSigningReq& req, CsrDone done);
 
     Json::Value& clientStatus(const std::string& callsign);
 
@@ -226,8 +314,19 @@ class Reflector : public sigc::trackable
     static constexpr unsigned CERT_VALIDITY_DAYS        = 90;
     static constexpr int      CERT_VALIDITY_OFFSET_DAYS = -1;
 
+    struct CaContext;
+    struct CfgRegex
+    {
+      Async::Config::Variable<std::string>  var;
+      std::string                           str;
+      std::regex                            re;
+      const std::regex& regex(const std::string& def);
+    };
+
     FramedTcpServer*            m_srv;
     Async::EncryptedUdpSocket*  m_udp_sock;
+    ReflectorUdpShards*         m_udp_shards;
+    TrunkHandler                m_trunk_handler;
     ReflectorClientConMap       m_client_con_map;
     Async::Config*              m_cfg;
     uint32_t                    m_tg_for_v1_clients;
@@ -251,10 +350,16 @@ class Reflector : public sigc::trackable
     std::string                 m_crtfile;
     Async::AtTimer              m_renew_cert_timer;
     Async::AtTimer              m_renew_issue_ca_cert_timer;
+    std::string                 m_ticket_key_file;
+    Async::Timer                m_ticket_key_timer;
     size_t                      m_ca_size = 0;
     std::vector<uint8_t>        m_ca_md;
     std::vector<uint8_t>        m_ca_sig;
     std::string                 m_accept_cert_email;
+    mutable CfgRegex            m_accept_callsign;
+    mutable CfgRegex            m_reject_callsign;
+    ReflectorJobQueue           m_ca_jobs;
+    std::shared_ptr<CaContext>  m_ca_ctx;
     Json::Value                 m_status;
 
     Reflector(const Reflector&);
@@ -266,13 +371,22 @@ class Reflector : public sigc::trackable
                                void *buf, int count);
     void udpDatagramReceived(const Async::IpAddress& addr, uint16_t port,
                              void* aad, void *buf, int count);
+    void udpShardDatagramReceived(const Async::IpAddress& addr,
+                                  uint16_t port, void* aad, int aadlen,
+                                  void *buf, int count);
+    unsigned udpShardForClient(const ReflectorClient* client) const;
     void onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
                          ReflectorClient *new_talker);
+    void onTrunkTalkerUpdated(uint32_t tg, const std::string& old_callsign,
+                              const std::string& new_callsign);
+    void onTrunkAudioReceived(uint32_t tg, const std::vector<uint8_t>& audio);
+    void onTrunkTalkerPreempted(uint32_t tg);
     void httpRequestReceived(Async::HttpServerConnection *con,
                              Async::HttpServerConnection::Request& req);
     void httpClientConnected(Async::HttpServerConnection *con);
     void httpClientDisconnected(Async::HttpServerConnection *con,
         Async::HttpServerConnection::DisconnectReason reason);
+    void collectMetrics(void);
     void onRequestAutoQsy(uint32_t from_tg);
     uint32_t nextRandomQsyTg(void);
     void ctrlPtyDataReceived(const void *buf, size_t count);
@@ -287,6 +401,7 @@ class Reflector : public sigc::trackable
     bool buildPath(const std::string& sec, const std::string& tag,
                    const std::string& defdir, std::string& defpath);
     bool removeClientCert(const std::string& cn);
+    std::shared_ptr<CaContext> caContext(void);
     void runCAHook(const Async::Exec::Environment& env);
 
 };  /* class Reflector */
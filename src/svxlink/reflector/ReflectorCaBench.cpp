@@ -0,0 +1,272 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <unistd.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+#include <AsyncUdpSocket.h>
+#include <AsyncSslKeypair.h>
+#include <AsyncSslX509.h>
+
+#include "ReflectorJobQueue.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Test of the reflector CA worker thread.
+ *
+ * Usage: ReflectorCaBench [certificates] [burst]
+ *
+ * A flood of client certificates are signed and written to disk, "burst"
+ * certificates every 20 ms, the same way that the reflector do when it
+ * receive certificate signing requests. At the same time a UDP datagram is
+ * sent over localhost every 5 ms and the time until it has been received by
+ * the main loop is measured. That is the extra latency that audio forwarded
+ * by the reflector would see. This is first done with the signing done
+ * directly in the main thread and then with the signing done in the CA
+ * worker thread.
+ */
+
+namespace {
+const uint16_t  PORT = 15600;
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+struct Ca
+{
+  std::string dir;
+  SslX509     ca_cert;
+  SslKeypair  ca_pkey;
+  SslKeypair  client_pkey;
+
+  bool sign(unsigned serial)
+  {
+    std::string cn = "SM" + std::to_string(serial) + "X";
+    SslX509 cert;
+    cert.setVersion(SslX509::VERSION_3);
+    cert.addSubjectName("CN", cn);
+    SslX509Extensions exts;
+    exts.addBasicConstraints("critical, CA:FALSE");
+    exts.addKeyUsage(
+        "critical, digitalSignature, keyEncipherment, keyAgreement");
+    exts.addExtKeyUsage("clientAuth");
+    cert.addExtensions(exts);
+    cert.setPublicKey(client_pkey);
+    cert.setSerialNumber();
+    cert.setIssuerName(ca_cert.subjectName());
+    cert.setValidityTime(90, -1);
+    std::string crtfile = dir + "/" + cn + ".crt";
+    return cert.sign(ca_pkey) && cert.writePemFile(crtfile) &&
+           ca_cert.appendPemFile(crtfile);
+  }
+};
+
+std::shared_ptr<Ca> createCa(const std::string& dir)
+{
+  auto ca = std::make_shared<Ca>();
+  ca->dir = dir;
+  if (!ca->ca_pkey.generate(2048) || !ca->client_pkey.generate(2048))
+  {
+    return nullptr;
+  }
+  ca->ca_cert.setSerialNumber(1);
+  ca->ca_cert.setVersion(SslX509::VERSION_3);
+  ca->ca_cert.addIssuerName("CN", "Bench CA");
+  ca->ca_cert.setSubjectName(ca->ca_cert.issuerName());
+  SslX509Extensions ca_exts;
+  ca_exts.addBasicConstraints("critical, CA:TRUE");
+  ca_exts.addKeyUsage("critical, cRLSign, digitalSignature, keyCertSign");
+  ca->ca_cert.addExtensions(ca_exts);
+  ca->ca_cert.setValidityTime(1);
+  ca->ca_cert.setPublicKey(ca->ca_pkey);
+  ca->ca_cert.sign(ca->ca_pkey);
+  return ca;
+}
+
+class Flood
+{
+  public:
+    std::function<void()> done;
+    ReflectorJobQueue      jobs;
+    unsigned               signed_ok  = 0;
+    double                 elapsed    = 0.0;
+    unsigned               pings      = 0;
+    double                 lat_sum    = 0.0;
+    double                 lat_max    = 0.0;
+
+    Flood(const std::shared_ptr<Ca>& ca, unsigned total, unsigned burst)
+      : ca(ca), total(total), burst(burst),
+        ping_timer(5, Timer::TYPE_PERIODIC, false),
+        flood_timer(20, Timer::TYPE_PERIODIC, false)
+    {
+      ping_timer.expired.connect([this](Timer*) { ping(); });
+      flood_timer.expired.connect([this](Timer*) { flood(); });
+    }
+
+    void start(void)
+    {
+      sock = new UdpSocket(PORT, IpAddress("127.0.0.1"));
+      sock->dataReceived.connect(
+          [this](const IpAddress&, uint16_t, void* buf, int count)
+          {
+            pong(buf, count);
+          });
+      t0 = wallTime();
+      ping_timer.setEnable(true);
+      flood_timer.setEnable(true);
+    }
+
+    void report(const char* name) const
+    {
+      const auto& stats = jobs.opStats().at("sign_cert");
+      printf("%-8s %5u/%u certs in %6.3f s (sign avg %5.2f ms "
+             "max %6.2f ms, max queued %u), "
+             "UDP latency avg %6.2f ms max %7.2f ms\n",
+             name, signed_ok, total, elapsed,
+             stats.total.count() / 1000.0 / stats.count,
+             stats.max.count() / 1000.0, jobs.maxQueued(),
+             1000.0 * lat_sum / std::max(pings, 1U), 1000.0 * lat_max);
+    }
+
+  private:
+    std::shared_ptr<Ca> ca;
+    unsigned            total;
+    unsigned            burst;
+    Timer               ping_timer;
+    Timer               flood_timer;
+    UdpSocket*          sock      = nullptr;
+    unsigned            posted    = 0;
+    unsigned            finished  = 0;
+    double              t0        = 0.0;
+
+    void ping(void)
+    {
+      double now = wallTime();
+      sock->write(IpAddress("127.0.0.1"), PORT, &now, sizeof(now));
+    }
+
+    void pong(void* buf, int count)
+    {
+      double sent;
+      if (count != sizeof(sent))
+      {
+        return;
+      }
+      memcpy(&sent, buf, sizeof(sent));
+      double lat = wallTime() - sent;
+      pings += 1;
+      lat_sum += lat;
+      lat_max = std::max(lat_max, lat);
+    }
+
+    void flood(void)
+    {
+      for (unsigned i=0; (i<burst) && (posted<total); ++i)
+      {
+        auto ok = std::make_shared<bool>(false);
+        unsigned serial = ++posted;
+        auto ca = this->ca;
+        jobs.post("sign_cert",
+            [ca, ok, serial](void) { *ok = ca->sign(serial); },
+            [this, ok](void) { jobDone(*ok); });
+      }
+    }
+
+    void jobDone(bool ok)
+    {
+      signed_ok += ok ? 1 : 0;
+      if (++finished < total)
+      {
+        return;
+      }
+      elapsed = wallTime() - t0;
+      ping_timer.setEnable(false);
+      flood_timer.setEnable(false);
+      for (unsigned i=1; i<=total; ++i)
+      {
+        unlink((ca->dir + "/SM" + std::to_string(i) + "X.crt").c_str());
+      }
+      Application::app().runTask([this]()
+      {
+        delete sock;
+        sock = nullptr;
+        done();
+      });
+    }
+};
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned total = 500;
+  unsigned burst = 50;
+  if (argc > 1)
+  {
+    total = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    burst = atoi(argv[2]);
+  }
+  if ((total < 1) || (burst < 1))
+  {
+    cerr << "Usage: ReflectorCaBench [certificates] [burst]\n";
+    exit(1);
+  }
+
+  char dir_template[] = "/tmp/ReflectorCaBench.XXXXXX";
+  std::string dir(mkdtemp(dir_template));
+  auto ca = createCa(dir);
+  if (ca == nullptr)
+  {
+    cerr << "*** ERROR: Failed to create the CA" << endl;
+    exit(1);
+  }
+
+  CppApplication app;
+
+    // First sign in the main thread, then in the worker thread
+  Flood inline_flood(ca, total, burst);
+  Flood worker_flood(ca, total, burst);
+  if (!worker_flood.jobs.initialize())
+  {
+    exit(1);
+  }
+  inline_flood.done = [&]()
+  {
+    inline_flood.report("Inline");
+    worker_flood.start();
+  };
+  worker_flood.done = [&]()
+  {
+    worker_flood.report("Worker");
+    app.quit();
+  };
+  inline_flood.start();
+
+  app.exec();
+
+  rmdir(dir.c_str());
+
+  bool ok = (inline_flood.signed_ok == total) &&
+            (worker_flood.signed_ok == total);
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+} /* main */
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -252,6 +252,7 @@ ReflectorClient::~ReflectorClient(void)
     client_callsign_map.erase(m_callsign);
   }
   TGHandler::instance()->removeClient(this);
+  m_reflector->removeUdpShardClient(this);
 } /* ReflectorClient::~ReflectorClient */
 
 
@@ -263,36 +264,51 @@ void ReflectorClient::setRemoteUdpSource(const ReflectorClient::ClientSrc& src)
   {
     m_client_src = src;
     client_src_map[src] = this;
+    m_reflector->updateUdpShardClient(this);
   }
 } /* ReflectorClient::setRemoteUdpSource */
 
 
 int ReflectorClient::sendMsg(const ReflectorMsg& msg)
+{
+  return sendFrame(packMsg(msg), msg.type());
+} /* ReflectorClient::sendMsg */
+
+
+Async::FramedTcpConnection::Frame ReflectorClient::packMsg(
+    const ReflectorMsg& msg)
+{
+  ostringstream ss;
+  ReflectorMsg header(msg.type());
+  if (!header.pack(ss) || !msg.pack(ss))
+  {
+    cerr << "*** ERROR: Failed to pack TCP message\n";
+    return nullptr;
+  }
+  const std::string data(ss.str());
+  return Async::FramedTcpConnection::makeFrame(data.data(), data.size());
+} /* ReflectorClient::packMsg */
+
+
+int ReflectorClient::sendFrame(const Async::FramedTcpConnection::Frame& frame,
+                               unsigned type)
 {
   errno = 0;
 
-  if (((m_con_state != STATE_CONNECTED) && (msg.type() >= 100)) ||
+  if (((m_con_state != STATE_CONNECTED) && (type >= 100)) ||
       !m_con->isConnected())
   {
     errno = ENOTCONN;
   }
-
-  ostringstream ss;
-  if (errno == 0)
+  else if (frame == nullptr)
   {
-    m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
-
-    ReflectorMsg header(msg.type());
-    if (!header.pack(ss) || !msg.pack(ss))
-    {
-      cerr << "*** ERROR: Failed to pack TCP message\n";
-      errno = EBADMSG;
-    }
+    errno = EBADMSG;
   }
 
   if (errno == 0)
   {
-    auto ret = m_con->write(ss.str().data(), ss.str().size());
+    m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
+    auto ret = m_con->write(frame);
     if (ret >= 0)
     {
       return ret;
@@ -300,11 +316,11 @@ int ReflectorClient::sendMsg(const ReflectorMsg& msg)
   }
   std::cerr << "*** ERROR[" << m_con->remoteHost() << ":"
             << m_con->remotePort() << "]: Write to client failed due to '"
-            << strerror(errno) << "'. Message type=" << msg.type() << "."
+            << strerror(errno) << "'. Message type=" << type << "."
             << std::endl;
   disconnect();
   return -1;
-} /* ReflectorClient::sendMsg */
+} /* ReflectorClient::sendFrame */
 
 
 void ReflectorClient::udpMsgReceived(const ReflectorUdpMsg &header)
@@ -366,12 +382,11 @@ std::vector<uint8_t> ReflectorClient::udpCipherIV(void) const
 } /* ReflectorClient::udpCipherIV */
 
 
-void ReflectorClient::certificateUpdated(Async::SslX509& cert)
+void ReflectorClient::certificateUpdated(const std::string& cert_pem)
 {
   if (m_con_state == STATE_CONNECTED)
   {
-    //sendMsg(MsgClientCert(cert.pem()));
-    sendClientCert(cert);
+    sendClientCert(cert_pem);
   }
 } /* ReflectorClient::certificateUpdated */
 
@@ -446,6 +461,18 @@ void ReflectorClient::onSslConnectionReady(TcpConnection *con)
   peer_cert.print();
   std::cout << "-----------------------------------------------" << std::endl;
 
+    // The certificate is not verified when a session is resumed so it may
+    // have expired since the session was set up
+  if (con->sslSessionReused() && !peer_cert.timeIsWithinRange())
+  {
+    std::cout << "*** WARNING[" << m_con->remoteHost() << ":"
+              << m_con->remotePort()
+              << "]: client certificate of resumed session is not valid"
+              << std::endl;
+    disconnect();
+    return;
+  }
+
   std::string callsign = peer_cert.commonName();
   if (!m_reflector->callsignOk(callsign))
   {
@@ -828,25 +855,30 @@ void ReflectorClient::handleMsgClientCsr(std::istream& is)
     return;
   }
 
-  auto cert = m_reflector->csrReceived(req);
-  auto current_req = m_reflector->loadClientCsr(req.commonName());
-  if ((
-        (m_con_state == STATE_EXPECT_CSR) ||
-        (!current_req.isNull() && (req.digest() == current_req.digest()))
-      ) &&
-      sendClientCert(cert))
-  {
-    std::cout << idss.str() << ": Sent certificate to peer" << std::endl;
-    //cert.print();
-    m_con_state = STATE_EXPECT_DISCONNECT;
-  }
-  else if (m_con_state == STATE_EXPECT_CSR)
-  {
-    std::cout << idss.str() << ": No valid certificate found matching CSR. "
-                 "Sending authentication challenge." << std::endl;
-    sendAuthChallenge();
-    m_con_state = STATE_EXPECT_AUTH_RESPONSE;
-  }
+    // The client may be gone when the CA worker thread is done
+  const auto id = m_client_id;
+  const std::string idstr = idss.str();
+  m_reflector->csrReceived(req,
+      [this, id, idstr](const std::string& cert_pem, bool csr_is_current)
+      {
+        if (lookup(id) != this)
+        {
+          return;
+        }
+        if (((m_con_state == STATE_EXPECT_CSR) || csr_is_current) &&
+            sendClientCert(cert_pem))
+        {
+          std::cout << idstr << ": Sent certificate to peer" << std::endl;
+          m_con_state = STATE_EXPECT_DISCONNECT;
+        }
+        else if (m_con_state == STATE_EXPECT_CSR)
+        {
+          std::cout << idstr << ": No valid certificate found matching CSR. "
+                       "Sending authentication challenge." << std::endl;
+          sendAuthChallenge();
+          m_con_state = STATE_EXPECT_AUTH_RESPONSE;
+        }
+      });
 } /* ReflectorClient::handleMsgClientCsr */
 
 
@@ -865,12 +897,10 @@ void ReflectorClient::handleSelectTG(std::istream& is)
     auto talker = TGHandler::instance()->talkerForTG(m_current_tg);
     if (talker == this)
     {
-      m_reflector->broadcastUdpMsg(MsgUdpFlushSamples(),
-          mkAndFilter(
-            TgFilter(m_current_tg),
-            ExceptFilter(this)));
+      m_reflector->broadcastUdpMsgToTG(MsgUdpFlushSamples(), m_current_tg,
+                                       this);
     }
-    else if (talker != 0)
+    else if ((talker != 0) || m_reflector->hasTrunkTalker(m_current_tg))
     {
       sendUdpMsg(MsgUdpFlushSamples());
     }
@@ -930,6 +960,7 @@ void ReflectorClient::handleNodeInfo(std::istream& is)
     //setRemoteUdpSource(msg.udpSrcPort());
     setUdpCipherIVRand(msg.ivRand());
     setUdpCipherKey(msg.udpCipherKey());
+    m_reflector->updateUdpShardClient(this);
     jsonstr = msg.json();
 
     sendMsg(MsgStartUdpEncryption());
@@ -1352,23 +1383,13 @@ void ReflectorClient::connectionAuthenticated(const std::string& callsign)
 } /* ReflectorClient::connectionAuthenticated */
 
 
-bool ReflectorClient::sendClientCert(const Async::SslX509& cert)
+bool ReflectorClient::sendClientCert(const std::string& cert_pem)
 {
-  if (cert.isNull())
+  if (cert_pem.empty())
   {
     return false;
   }
-
-  const auto callsign = cert.commonName();
-  const auto pending_csr = m_reflector->loadClientPendingCsr(callsign);
-  if (!pending_csr.isNull() && (cert.publicKey() != pending_csr.publicKey()))
-  {
-    //std::cout << "### ReflectorClient::sendClientCert: Cert public key "
-    //             "differs compared to pending CSR public key" << std::endl;
-    //sendMsg(MsgClientCert());
-    return false;
-  }
-  return sendMsg(MsgClientCert(m_reflector->clientCertPem(callsign)));
+  return sendMsg(MsgClientCert(cert_pem));
 } /* ReflectorClient::sendClientCert */
 
 
@@ -1390,20 +1411,37 @@ void ReflectorClient::sendAuthChallenge(void)
 void ReflectorClient::renewClientCertificate(void)
 {
   auto cert = m_con->sslPeerCertificate();
-  if (cert.isNull() || !m_reflector->renewedClientCert(cert))
+  if (cert.isNull())
   {
     std::cerr << "*** WARNING: Certificate renewal for '"
               << m_callsign << "' failed" << std::endl;
     return;
   }
-  std::cout << m_callsign << ": Send renewed client certificate" << std::endl;
-  sendClientCert(cert);
-  m_con_state = STATE_EXPECT_DISCONNECT;
+  const auto id = m_client_id;
+  m_reflector->renewClientCert(cert,
+      [this, id](const std::string& cert_pem)
+      {
+        if (lookup(id) != this)
+        {
+          return;
+        }
+        if (cert_pem.empty())
+        {
+          std::cerr << "*** WARNING: Certificate renewal for '"
+                    << m_callsign << "' failed" << std::endl;
+          return;
+        }
+        std::cout << m_callsign << ": Send renewed client certificate"
+                  << std::endl;
+        sendClientCert(cert_pem);
+        m_con_state = STATE_EXPECT_DISCONNECT;
+      });
 } /* ReflectorClient::renewClientCertificate */
 
 
 void ReflectorClient::setMonitoredTGs(const std::set<uint32_t>& tgs)
 {
+  TGHandler::instance()->setMonitoredTGs(this, tgs);
   m_monitored_tgs = tgs;
 
   if (m_status != nullptr)
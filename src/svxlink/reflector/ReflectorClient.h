@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -395,6 +395,25 @@ class ReflectorClient : public sigc::trackable
      */
     int sendMsg(const ReflectorMsg& msg);
 
+    /**
+     * @brief   Pack a TCP message into a frame that can be shared
+     * @param   msg The message to pack
+     * @return  Returns the frame or an empty pointer on failure
+     *
+     * Use this function together with sendFrame to send the same message to
+     * many clients without packing it for each client.
+     */
+    static Async::FramedTcpConnection::Frame packMsg(const ReflectorMsg& msg);
+
+    /**
+     * @brief   Send a packed TCP message to the remote end
+     * @param   frame The packed message, created using packMsg
+     * @param   type The message type
+     * @return  On success 0 is returned or else -1
+     */
+    int sendFrame(const Async::FramedTcpConnection::Frame& frame,
+                  unsigned type);
+
     /**
      * @brief   Handle a received UDP message
      * @param   The received UDP message
@@ -496,7 +515,7 @@ class ReflectorClient : public sigc::trackable
     }
     std::vector<uint8_t> udpCipherKey(void) const { return m_udp_cipher_key; }
 
-    void certificateUpdated(Async::SslX509& cert);
+    void certificateUpdated(const std::string& cert_pem);
 
   private:
     using ClientIdRandomDist  = std::uniform_int_distribution<ClientId>;
@@ -579,7 +598,7 @@ class ReflectorClient : public sigc::trackable
     void handleHeartbeat(Async::Timer *t);
     std::string lookupUserKey(const std::string& callsign);
     void connectionAuthenticated(const std::string& callsign);
-    bool sendClientCert(const Async::SslX509& cert);
+    bool sendClientCert(const std::string& cert_pem);
     void sendAuthChallenge(void);
     void renewClientCertificate(void);
     void setMonitoredTGs(const std::set<uint32_t>& tgs);
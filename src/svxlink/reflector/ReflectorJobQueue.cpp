@@ -0,0 +1,285 @@
+/**
+@file   ReflectorJobQueue.cpp
+@brief  Run slow jobs in a worker thread
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReflectorJobQueue.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ReflectorJobQueue::ReflectorJobQueue(void)
+  : m_stop(false), m_done_notify_wr(-1), m_queued(0), m_max_queued(0)
+{
+} /* ReflectorJobQueue::ReflectorJobQueue */
+
+
+ReflectorJobQueue::~ReflectorJobQueue(void)
+{
+  if (m_thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mu);
+      m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+  }
+  int done_notify_rd = m_done_watch.fd();
+  m_done_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+  if (done_notify_rd >= 0)
+  {
+    ::close(done_notify_rd);
+  }
+  if (m_done_notify_wr >= 0)
+  {
+    ::close(m_done_notify_wr);
+  }
+} /* ReflectorJobQueue::~ReflectorJobQueue */
+
+
+bool ReflectorJobQueue::initialize(void)
+{
+  int fds[2];
+  if (pipe(fds) < 0)
+  {
+    perror("pipe in ReflectorJobQueue::initialize");
+    return false;
+  }
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  m_done_notify_wr = fds[1];
+  m_done_watch.setFd(fds[0], FdWatch::FD_WATCH_RD);
+  m_done_watch.setEnabled(true);
+  m_done_watch.activity.connect(
+      sigc::mem_fun(*this, &ReflectorJobQueue::handleDone));
+
+  m_thread = std::thread(&ReflectorJobQueue::workerLoop, this);
+  return true;
+} /* ReflectorJobQueue::initialize */
+
+
+void ReflectorJobQueue::post(const std::string& op, Job job, Done done)
+{
+  Entry entry;
+  entry.op = op;
+  entry.job = std::move(job);
+  entry.done = std::move(done);
+  entry.posted = Clock::now();
+  entry.wait = Clock::duration::zero();
+  entry.run = Clock::duration::zero();
+
+  m_max_queued = std::max(m_max_queued, ++m_queued);
+  if (!m_thread.joinable())
+  {
+    entry.job();
+    entry.run = Clock::now() - entry.posted;
+    finish(entry);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_mu);
+    m_jobs.push_back(std::move(entry));
+  }
+  m_cond.notify_one();
+} /* ReflectorJobQueue::post */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void ReflectorJobQueue::workerLoop(void)
+{
+  std::unique_lock<std::mutex> lk(m_mu);
+  for (;;)
+  {
+    m_cond.wait(lk, [this]() { return m_stop || !m_jobs.empty(); });
+    if (m_jobs.empty())
+    {
+      break;
+    }
+    Entry entry = std::move(m_jobs.front());
+    m_jobs.pop_front();
+    lk.unlock();
+
+    auto start = Clock::now();
+    entry.wait = start - entry.posted;
+    entry.job();
+    entry.run = Clock::now() - start;
+
+    lk.lock();
+    bool was_empty = m_done.empty();
+    m_done.push_back(std::move(entry));
+      // The main thread empty the whole queue on each notification so it
+      // only need to be notified when the first job is finished
+    if (was_empty)
+    {
+      char ch = 0;
+      if ((::write(m_done_notify_wr, &ch, 1) < 0) && (errno != EAGAIN))
+      {
+        perror("write in ReflectorJobQueue::workerLoop");
+      }
+    }
+  }
+} /* ReflectorJobQueue::workerLoop */
+
+
+void ReflectorJobQueue::handleDone(FdWatch *w)
+{
+  char tmp[64];
+  while (::read(w->fd(), tmp, sizeof(tmp)) > 0) {}
+
+  std::deque<Entry> done;
+  {
+    std::lock_guard<std::mutex> lk(m_mu);
+    done.swap(m_done);
+  }
+  for (auto& entry : done)
+  {
+    finish(entry);
+  }
+} /* ReflectorJobQueue::handleDone */
+
+
+void ReflectorJobQueue::finish(Entry& entry)
+{
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  m_queued -= 1;
+  OpStats& stats = m_op_stats[entry.op];
+  auto run = duration_cast<microseconds>(entry.run);
+  stats.count += 1;
+  stats.total += run;
+  stats.max = std::max(stats.max, run);
+  stats.max_wait = std::max(stats.max_wait,
+                            duration_cast<microseconds>(entry.wait));
+  if (entry.done)
+  {
+    entry.done();
+  }
+} /* ReflectorJobQueue::finish */
+
+
+
+/*
+ * This file has not been truncated
+ */
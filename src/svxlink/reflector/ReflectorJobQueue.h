@@ -0,0 +1,237 @@
+/**
+@file   ReflectorJobQueue.h
+@brief  Run slow jobs in a worker thread
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef REFLECTOR_JOB_QUEUE_INCLUDED
+#define REFLECTOR_JOB_QUEUE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+#include <map>
+#include <deque>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Run slow jobs in a worker thread
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class is used to move slow operations, like signing certificates and
+writing them to disk, away from the main thread so that they do not delay
+the audio handling. A job is run in a worker thread and when it is done, its
+completion function is called from the main thread. Jobs are run one at a
+time in the order they were posted so the completions are also called in
+that order.
+
+A job must not touch any state that is also used by the main thread. All
+data needed by the job should be copied into it and the result should be
+handed over to the completion function.
+*/
+class ReflectorJobQueue : public sigc::trackable
+{
+  public:
+    using Job   = std::function<void(void)>;
+    using Done  = std::function<void(void)>;
+
+    /**
+     * @brief   Statistics for one type of operation
+     */
+    struct OpStats
+    {
+      unsigned long             count = 0;  ///< Number of finished jobs
+      std::chrono::microseconds total{0};   ///< Total run time
+      std::chrono::microseconds max{0};     ///< Longest run time
+      std::chrono::microseconds max_wait{0};///< Longest time in queue
+    };
+    using OpStatsMap = std::map<std::string, OpStats>;
+
+    /**
+     * @brief   Default constructor
+     */
+    ReflectorJobQueue(void);
+
+    /**
+     * @brief   Destructor
+     *
+     * Jobs that are already queued are run to completion but their
+     * completion functions are not called.
+     */
+    ~ReflectorJobQueue(void);
+
+    /**
+     * @brief   Start the worker thread
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * If the queue has not been initialized, jobs are run directly when
+     * posted.
+     */
+    bool initialize(void);
+
+    /**
+     * @brief   Post a job to the worker thread
+     * @param   op The name of the operation, used for the statistics
+     * @param   job The function to run in the worker thread
+     * @param   done The function to run in the main thread when finished
+     */
+    void post(const std::string& op, Job job, Done done);
+
+    /**
+     * @brief   Get the number of jobs that have not finished yet
+     * @return  Returns the number of queued or running jobs
+     */
+    unsigned queued(void) const { return m_queued; }
+
+    /**
+     * @brief   Get the highest number of queued jobs seen
+     * @return  Returns the maximum queue depth
+     */
+    unsigned maxQueued(void) const { return m_max_queued; }
+
+    /**
+     * @brief   Get statistics for each type of operation
+     * @return  Returns a map from operation name to statistics
+     */
+    const OpStatsMap& opStats(void) const { return m_op_stats; }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    struct Entry
+    {
+      std::string       op;
+      Job               job;
+      Done              done;
+      Clock::time_point posted;
+      Clock::duration   wait;
+      Clock::duration   run;
+    };
+
+    std::thread             m_thread;
+    std::mutex              m_mu;
+    std::condition_variable m_cond;
+    std::deque<Entry>       m_jobs;
+    std::deque<Entry>       m_done;
+    bool                    m_stop;
+    Async::FdWatch          m_done_watch;
+    int                     m_done_notify_wr;
+    unsigned                m_queued;
+    unsigned                m_max_queued;
+    OpStatsMap              m_op_stats;
+
+    ReflectorJobQueue(const ReflectorJobQueue&);
+    ReflectorJobQueue& operator=(const ReflectorJobQueue&);
+    void workerLoop(void);
+    void handleDone(Async::FdWatch *w);
+    void finish(Entry& entry);
+
+};  /* class ReflectorJobQueue */
+
+
+//} /* namespace */
+
+#endif /* REFLECTOR_JOB_QUEUE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
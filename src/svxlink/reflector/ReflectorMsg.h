@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2024 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -1395,6 +1395,160 @@ class MsgStartUdpEncryption : public ReflectorMsgBase<114>
 }; /* MsgStartUdpEncryption */
 
 
+/***************************** Trunk Messages *****************************/
+
+/**
+@brief   Trunk hello TCP network message
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This is the first message sent by both sides of a trunk between two reflector
+servers. It carries the trunk id of the sending reflector and an
+authentication challenge. The other side answer the challenge using a
+MsgAuthResponse message, with the callsign set to its own trunk id, calculated
+from the shared trunk secret.
+*/
+class MsgTrunkHello : public ReflectorMsgBase<200>
+{
+  public:
+    static const uint16_t MAJOR = 1;
+    static const uint16_t MINOR = 0;
+    MsgTrunkHello(const std::string& id="")
+      : m_major(MAJOR), m_minor(MINOR), m_id(id),
+        m_challenge(MsgAuthChallenge::LENGTH)
+    {
+      if (RAND_bytes(&m_challenge.front(), m_challenge.size()) != 1)
+      {
+        std::cerr << "*** WARNING: Failed to generate trunk challenge"
+                  << std::endl;
+        m_challenge.clear();
+      }
+    }
+
+    uint16_t majorVer(void) const { return m_major; }
+    uint16_t minorVer(void) const { return m_minor; }
+    const std::string& id(void) const { return m_id; }
+    const uint8_t *challenge(void) const
+    {
+      if (m_challenge.size() != MsgAuthChallenge::LENGTH)
+      {
+        return nullptr;
+      }
+      return &m_challenge[0];
+    }
+
+    ASYNC_MSG_MEMBERS(m_major, m_minor, m_id, m_challenge);
+
+  private:
+    uint16_t              m_major;
+    uint16_t              m_minor;
+    std::string           m_id;
+    std::vector<uint8_t>  m_challenge;
+}; /* MsgTrunkHello */
+
+
+/**
+@brief   Trunk talk group summary TCP network message
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message is sent over a trunk to tell the other reflector which talk
+groups that have clients connected to the sending reflector. Audio for a talk
+group is only sent over the trunk if the other side have clients on it. The
+full set is sent each time it change.
+*/
+class MsgTrunkTgSummary : public ReflectorMsgBase<201>
+{
+  public:
+    MsgTrunkTgSummary(void) {}
+    MsgTrunkTgSummary(const std::set<uint32_t>& tgs) : m_tgs(tgs) {}
+
+    const std::set<uint32_t>& tgs(void) const { return m_tgs; }
+
+    ASYNC_MSG_MEMBERS(m_tgs);
+
+  private:
+    std::set<uint32_t> m_tgs;
+}; /* MsgTrunkTgSummary */
+
+
+/**
+@brief   Trunk talker start TCP network message
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message is sent over all trunks when a client connected to the sending
+reflector become the talker on a talk group.
+*/
+class MsgTrunkTalkerStart : public ReflectorMsgBase<202>
+{
+  public:
+    MsgTrunkTalkerStart(uint32_t tg=0, const std::string& callsign="")
+      : m_tg(tg), m_callsign(callsign) {}
+
+    uint32_t tg(void) const { return m_tg; }
+    const std::string& callsign(void) const { return m_callsign; }
+
+    ASYNC_MSG_MEMBERS(m_tg, m_callsign);
+
+  private:
+    uint32_t    m_tg;
+    std::string m_callsign;
+}; /* MsgTrunkTalkerStart */
+
+
+/**
+@brief   Trunk talker stop TCP network message
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message is sent over all trunks when a client connected to the sending
+reflector stop being the talker on a talk group.
+*/
+class MsgTrunkTalkerStop : public ReflectorMsgBase<203>
+{
+  public:
+    MsgTrunkTalkerStop(uint32_t tg=0, const std::string& callsign="")
+      : m_tg(tg), m_callsign(callsign) {}
+
+    uint32_t tg(void) const { return m_tg; }
+    const std::string& callsign(void) const { return m_callsign; }
+
+    ASYNC_MSG_MEMBERS(m_tg, m_callsign);
+
+  private:
+    uint32_t    m_tg;
+    std::string m_callsign;
+}; /* MsgTrunkTalkerStop */
+
+
+/**
+@brief   Trunk audio TCP network message
+@author  Tobias Blomberg / SM0SVX
+@date    2026-10-18
+
+This message carry the payload of one MsgUdpAudio message from the talker on
+a talk group over a trunk. Only one copy is sent per trunk, no matter how
+many clients the other reflector have on the talk group.
+*/
+class MsgTrunkAudio : public ReflectorMsgBase<204>
+{
+  public:
+    MsgTrunkAudio(void) : m_tg(0) {}
+    MsgTrunkAudio(uint32_t tg, const std::vector<uint8_t>& audio_data)
+      : m_tg(tg), m_audio_data(audio_data) {}
+
+    uint32_t tg(void) const { return m_tg; }
+    const std::vector<uint8_t>& audioData(void) const { return m_audio_data; }
+
+    ASYNC_MSG_MEMBERS(m_tg, m_audio_data)
+
+  private:
+    uint32_t              m_tg;
+    std::vector<uint8_t>  m_audio_data;
+}; /* MsgTrunkAudio */
+
+
 /***************************** UDP Messages *****************************/
 
 /**
@@ -0,0 +1,403 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+
+#include "ReflectorMsg.h"
+#include "ReflectorUdpShards.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Load test for the UDP shards of the reflector.
+ *
+ * Usage: ReflectorShardBench [clients] [frames] [max shards]
+ *
+ * A number of simulated clients are set up on localhost, all on the same
+ * talk group. One client is talking and the rest are listening. The talker
+ * send encrypted audio frames to the shards. The main thread route each
+ * received frame to all listeners by queueing it on the shard that own the
+ * listener, where it is encrypted and sent. This is the same work that the
+ * reflector do for a talk group, without the protocol state. The number of
+ * delivered datagrams per second is measured for a growing number of shards.
+ * A limited number of frames are kept in flight so that no datagrams are
+ * dropped due to full socket buffers.
+ */
+
+namespace {
+const uint16_t  SHARD_PORT   = 15410;
+const size_t    FRAME_SIZE   = 160;
+const unsigned  WINDOW       = 8;
+const unsigned  RX_THREADS   = 2;
+
+using ClientId = UdpCipher::ClientId;
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+std::vector<uint8_t> randomBytes(size_t len)
+{
+  std::vector<uint8_t> bytes(len);
+  RAND_bytes(bytes.data(), bytes.size());
+  return bytes;
+}
+
+std::string packAAD(const UdpCipher::AAD& aad)
+{
+  std::ostringstream ss;
+  aad.pack(ss);
+  return ss.str();
+}
+
+  // Client side encryption with the same layout as EncryptedUdpSocket
+std::vector<uint8_t> encrypt(EVP_CIPHER_CTX* ctx,
+    const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv,
+    const std::string& aad, const std::vector<uint8_t>& data)
+{
+  std::vector<uint8_t> out(aad.size() + UdpCipher::TAGLEN + data.size() +
+                           EVP_MAX_BLOCK_LENGTH);
+  const uint8_t* aadp = reinterpret_cast<const uint8_t*>(aad.data());
+  int len = 0;
+  EVP_EncryptInit_ex(ctx, NULL, NULL, key.data(), iv.data());
+  EVP_EncryptUpdate(ctx, nullptr, &len, aadp, aad.size());
+  memcpy(out.data(), aad.data(), aad.size());
+  uint8_t* p = out.data() + aad.size() + UdpCipher::TAGLEN;
+  EVP_EncryptUpdate(ctx, p, &len, data.data(), data.size());
+  int tot = len;
+  EVP_EncryptFinal_ex(ctx, p + tot, &len);
+  tot += len;
+  EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, UdpCipher::TAGLEN,
+                      out.data() + aad.size());
+  out.resize(aad.size() + UdpCipher::TAGLEN + tot);
+  return out;
+}
+
+bool decrypt(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv,
+             const uint8_t* buf, size_t len, std::vector<uint8_t>& out)
+{
+  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+  const size_t hdrlen = UdpCipher::AADLEN + UdpCipher::TAGLEN;
+  int outlen = 0;
+  bool ok = (len >= hdrlen) &&
+    EVP_DecryptInit_ex(ctx, EVP_get_cipherbyname(UdpCipher::NAME), NULL,
+                       key.data(), iv.data()) &&
+    EVP_DecryptUpdate(ctx, nullptr, &outlen, buf, UdpCipher::AADLEN) &&
+    EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, UdpCipher::TAGLEN,
+                        const_cast<uint8_t*>(buf + UdpCipher::AADLEN));
+  if (ok)
+  {
+    out.resize(len - hdrlen + EVP_MAX_BLOCK_LENGTH);
+    ok = EVP_DecryptUpdate(ctx, out.data(), &outlen, buf + hdrlen,
+                           len - hdrlen);
+    int tot = outlen;
+    ok = ok && EVP_DecryptFinal_ex(ctx, out.data() + tot, &outlen);
+    out.resize(tot + outlen);
+  }
+  EVP_CIPHER_CTX_free(ctx);
+  return ok;
+}
+
+struct Client
+{
+  ClientId              id;
+  int                   sock;
+  uint16_t              port;
+  std::vector<uint8_t>  iv_rand;
+  std::vector<uint8_t>  key;
+  UdpCipher::IVCntr     tx_cntr = 1;
+  bool                  verified = false;
+};
+
+class Bench : public sigc::trackable
+{
+  public:
+    sigc::signal<void()> done;
+
+    Bench(unsigned client_cnt, unsigned frames, unsigned shard_cnt)
+      : frames(frames), shard_cnt(shard_cnt), clients(client_cnt)
+    {
+      for (unsigned i=0; i<client_cnt; ++i)
+      {
+        Client& c = clients[i];
+        c.id = i + 1;
+        c.sock = socket(AF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if ((bind(c.sock, reinterpret_cast<struct sockaddr*>(&addr),
+                  sizeof(addr)) < 0) ||
+            (getsockname(c.sock, reinterpret_cast<struct sockaddr*>(&addr),
+                         &len) < 0))
+        {
+          perror("bind");
+          exit(1);
+        }
+        c.port = ntohs(addr.sin_port);
+        c.iv_rand = randomBytes(UdpCipher::IVRANDLEN);
+        c.key = randomBytes(16);
+      }
+      if (!shards.initialize(SHARD_PORT, shard_cnt))
+      {
+        exit(1);
+      }
+      for (const auto& c : clients)
+      {
+        shards.setClientCipher(c.id, c.iv_rand, c.key);
+        shards.setClientSource(c.id, IpAddress("127.0.0.1"), c.port);
+      }
+      shards.datagramReceived.connect(mem_fun(*this, &Bench::routeFrame));
+    }
+
+    ~Bench(void)
+    {
+      quit = true;
+      for (auto& t : threads)
+      {
+        t.join();
+      }
+      for (const auto& c : clients)
+      {
+        close(c.sock);
+      }
+    }
+
+    void start(void)
+    {
+      start_time = wallTime();
+      threads.emplace_back(&Bench::talkerThread, this);
+      for (unsigned i=0; i<RX_THREADS; ++i)
+      {
+        threads.emplace_back(&Bench::listenerThread, this, i);
+      }
+    }
+
+    double elapsed(void) const { return end_time - start_time; }
+    uint64_t delivered(void) const { return rx_cnt; }
+    uint64_t expected(void) const
+    {
+      return uint64_t(frames) * (clients.size() - 1);
+    }
+    bool verifyFailed(void) const { return verify_failed; }
+
+  private:
+    unsigned                  frames;
+    unsigned                  shard_cnt;
+    std::vector<Client>       clients;
+    ReflectorUdpShards        shards;
+    std::vector<std::thread>  threads;
+    std::atomic<bool>         quit{false};
+    std::atomic<uint64_t>     rx_cnt{0};
+    std::atomic<bool>         verify_failed{false};
+    double                    start_time = 0.0;
+    double                    end_time = 0.0;
+    uint64_t                  routed = 0;
+
+      // The routing done by the reflector main thread for a talk group
+    void routeFrame(const IpAddress&, uint16_t, void* aad, int, void* buf,
+                    int count)
+    {
+      if (aad == nullptr)
+      {
+        std::cerr << "*** ERROR: Frame not decrypted by shard" << std::endl;
+        exit(1);
+      }
+      std::string data(static_cast<char*>(buf), count);
+      for (size_t i=1; i<clients.size(); ++i)
+      {
+        Client& c = clients[i];
+        std::vector<uint8_t> iv = UdpCipher::IV{c.iv_rand, 0, c.tx_cntr};
+        std::string aad = packAAD(UdpCipher::AAD{c.tx_cntr++});
+        shards.send(c.id % shard_cnt, IpAddress("127.0.0.1"), c.port,
+                    std::move(iv), c.key, std::move(aad), data);
+      }
+      ++routed;
+    }
+
+    void talkerThread(void)
+    {
+      Client& talker = clients[0];
+      EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+      EVP_EncryptInit_ex(ctx, EVP_get_cipherbyname(UdpCipher::NAME), NULL,
+                         NULL, NULL);
+      std::vector<uint8_t> frame(FRAME_SIZE, 0x5a);
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(SHARD_PORT);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      const uint64_t listeners = clients.size() - 1;
+      for (unsigned sent=0; (sent<frames) && !quit; ++sent)
+      {
+        while (!quit && (sent - rx_cnt / listeners >= WINDOW))
+        {
+          usleep(20);
+        }
+        UdpCipher::IVCntr cntr = talker.tx_cntr++;
+        std::vector<uint8_t> iv = UdpCipher::IV{talker.iv_rand, talker.id,
+                                                cntr};
+        auto dg = encrypt(ctx, talker.key, iv,
+                          packAAD(UdpCipher::AAD{cntr}), frame);
+        sendto(talker.sock, dg.data(), dg.size(), 0,
+               reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+      }
+      EVP_CIPHER_CTX_free(ctx);
+    }
+
+    void listenerThread(unsigned idx)
+    {
+      std::vector<struct pollfd> fds;
+      std::vector<Client*> owners;
+      for (size_t i=1+idx; i<clients.size(); i+=RX_THREADS)
+      {
+        fds.push_back({clients[i].sock, POLLIN, 0});
+        owners.push_back(&clients[i]);
+      }
+      std::vector<uint8_t> buf(65536);
+      std::vector<uint8_t> plain;
+      while (!quit)
+      {
+        if (poll(fds.data(), fds.size(), 10) <= 0)
+        {
+          continue;
+        }
+        for (size_t i=0; i<fds.size(); ++i)
+        {
+          if (!(fds[i].revents & POLLIN))
+          {
+            continue;
+          }
+          ssize_t len;
+          while ((len = recv(fds[i].fd, buf.data(), buf.size(),
+                             MSG_DONTWAIT)) > 0)
+          {
+              // Check that the first frame to each client can be decrypted
+            Client* c = owners[i];
+            if (!c->verified)
+            {
+              std::vector<uint8_t> iv = UdpCipher::IV{c->iv_rand, 0, 1};
+              if (!decrypt(c->key, iv, buf.data(), len, plain) ||
+                  (plain.size() != FRAME_SIZE))
+              {
+                verify_failed = true;
+              }
+              c->verified = true;
+            }
+            ++rx_cnt;
+          }
+        }
+        if (rx_cnt >= expected())
+        {
+          break;
+        }
+      }
+    }
+
+  public:
+    void checkDone(void)
+    {
+      if ((rx_cnt >= expected()) || (wallTime() - start_time > 30.0))
+      {
+        end_time = wallTime();
+        done();
+      }
+    }
+};
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned client_cnt = 50;
+  unsigned frames = 2000;
+  unsigned max_shards = 4;
+  if (argc > 1)
+  {
+    client_cnt = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    frames = atoi(argv[2]);
+  }
+  if (argc > 3)
+  {
+    max_shards = atoi(argv[3]);
+  }
+  if ((client_cnt < 2) || (frames < 1) || (max_shards < 1))
+  {
+    cerr << "Usage: ReflectorShardBench [clients] [frames] [max shards]\n";
+    exit(1);
+  }
+
+  CppApplication app;
+  int ret = 0;
+  printf("%7s %8s %10s %12s %10s\n", "Shards", "Clients", "Frames",
+         "Dgrams/s", "Frames/s");
+
+    // Run the benchmark for 1, 2, 4... shards. A benchmark object is not
+    // deleted from within its own signal handler.
+  unsigned shard_cnt = 0;
+  Bench *bench = 0;
+  Timer poll_timer(1, Timer::TYPE_PERIODIC);
+  std::function<void()> next = [&]()
+  {
+    if (bench != 0)
+    {
+      if ((bench->delivered() != bench->expected()) || bench->verifyFailed())
+      {
+        cerr << "*** ERROR: " << bench->delivered() << " of "
+             << bench->expected() << " datagrams delivered"
+             << (bench->verifyFailed() ? ", decryption failed" : "")
+             << endl;
+        ret = 1;
+      }
+      printf("%7u %8u %10u %12.0f %10.0f\n", shard_cnt, client_cnt, frames,
+             bench->delivered() / bench->elapsed(),
+             frames / bench->elapsed());
+      delete bench;
+      bench = 0;
+      if (shard_cnt * 2 > max_shards)
+      {
+        app.quit();
+        return;
+      }
+    }
+    shard_cnt = (shard_cnt == 0) ? 1 : shard_cnt * 2;
+    bench = new Bench(client_cnt, frames, shard_cnt);
+    bench->done.connect([&]() { poll_timer.setEnable(false);
+                                app.runTask([&]() { next(); }); });
+    bench->start();
+    poll_timer.setEnable(true);
+  };
+  poll_timer.expired.connect([&](Timer*) { if (bench) bench->checkDone(); });
+  app.runTask([&]() { next(); });
+  app.exec();
+
+  return ret;
+} /* main */
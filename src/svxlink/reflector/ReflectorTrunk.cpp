@@ -0,0 +1,644 @@
+/**
+@file   ReflectorTrunk.cpp
+@brief  A trunk link to another reflector server
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncConfig.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReflectorTrunk.h"
+#include "TrunkHandler.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ReflectorTrunk::ReflectorTrunk(TrunkHandler *handler,
+                               const std::string& local_id)
+  : m_handler(handler), m_local_id(local_id), m_client(0), m_con(0),
+    m_con_state(STATE_DISCONNECTED),
+    m_heartbeat_timer(1000, Timer::TYPE_PERIODIC, false),
+    m_reconnect_timer(RECONNECT_INTERVAL, Timer::TYPE_ONESHOT, false),
+    m_heartbeat_tx_cnt(HEARTBEAT_TX_CNT_RESET),
+    m_heartbeat_rx_cnt(HEARTBEAT_RX_CNT_RESET)
+{
+  m_heartbeat_timer.expired.connect(
+      mem_fun(*this, &ReflectorTrunk::handleHeartbeat));
+  m_reconnect_timer.expired.connect(
+      mem_fun(*this, &ReflectorTrunk::reconnect));
+} /* ReflectorTrunk::ReflectorTrunk */
+
+
+ReflectorTrunk::~ReflectorTrunk(void)
+{
+  delete m_client;
+} /* ReflectorTrunk::~ReflectorTrunk */
+
+
+bool ReflectorTrunk::initialize(Async::Config &cfg,
+                                const std::string& section,
+                                Async::SslContext& ssl_ctx)
+{
+  m_name = section;
+
+  if (!cfg.getValue(section, "PEER_ID", m_peer_id) || m_peer_id.empty())
+  {
+    cerr << "*** ERROR: Configuration variable " << section
+         << "/PEER_ID is not set" << endl;
+    return false;
+  }
+  if (m_peer_id == m_local_id)
+  {
+    cerr << "*** ERROR: The trunk peer id in " << section
+         << "/PEER_ID must not be the same as GLOBAL/TRUNK_ID" << endl;
+    return false;
+  }
+
+  if (!cfg.getValue(section, "SECRET", m_secret) || m_secret.empty())
+  {
+    cerr << "*** ERROR: Configuration variable " << section
+         << "/SECRET is not set" << endl;
+    return false;
+  }
+
+  std::string host;
+  cfg.getValue(section, "HOST", host);
+  m_peer_hostname = host;
+  cfg.getValue(section, "PEER_HOSTNAME", m_peer_hostname);
+  if (m_peer_hostname.empty())
+  {
+    cerr << "*** ERROR: Configuration variable " << section
+         << "/PEER_HOSTNAME must be set if " << section
+         << "/HOST is not set" << endl;
+    return false;
+  }
+
+  if (!host.empty())
+  {
+    uint16_t port = TrunkHandler::DEFAULT_PORT;
+    cfg.getValue(section, "PORT", port);
+    m_client = new FramedTcpClient(host, port);
+    m_client->setSslContext(ssl_ctx);
+    m_client->connected.connect(
+        mem_fun(*this, &ReflectorTrunk::onConnected));
+    m_client->sslConnectionReady.connect(
+        mem_fun(*this, &ReflectorTrunk::onSslConnectionReady));
+    m_client->verifyPeer.connect(
+        mem_fun(*this, &ReflectorTrunk::onVerifyPeer));
+    m_client->disconnected.connect(
+        mem_fun(*this, &ReflectorTrunk::onDisconnected));
+    m_client->frameReceived.connect(
+        mem_fun(*this, &ReflectorTrunk::onFrameReceived));
+    m_client->connect();
+  }
+
+  return true;
+} /* ReflectorTrunk::initialize */
+
+
+bool ReflectorTrunk::verifyPeerCertificate(Async::TcpConnection *con)
+{
+  Async::SslX509 cert(con->sslPeerCertificate());
+  if (cert.isNull() || (con->sslVerifyResult() != X509_V_OK))
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: The peer did not present a valid certificate" << endl;
+    return false;
+  }
+  if (!cert.matchHost(m_peer_hostname))
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: The peer certificate is "
+            "not valid for host \"" << m_peer_hostname << "\"" << endl;
+    cout << "------------- Peer Certificate --------------" << endl;
+    cert.print();
+    cout << "---------------------------------------------" << endl;
+    return false;
+  }
+  return true;
+} /* ReflectorTrunk::verifyPeerCertificate */
+
+
+bool ReflectorTrunk::acceptConnection(Async::FramedTcpConnection *con,
+                                      const MsgTrunkHello& hello)
+{
+  if (m_con != 0)
+  {
+    return false;
+  }
+
+  cout << "Trunk " << m_name << ": Incoming connection from "
+       << con->remoteHost() << ":" << con->remotePort() << endl;
+  m_con = con;
+  startHandshake();
+  handleHello(hello);
+  return true;
+} /* ReflectorTrunk::acceptConnection */
+
+
+void ReflectorTrunk::connectionClosed(Async::FramedTcpConnection *con)
+{
+  if ((con != 0) && (con == m_con))
+  {
+    cout << "Trunk " << m_name << ": Connection closed" << endl;
+    connectionLost();
+  }
+} /* ReflectorTrunk::connectionClosed */
+
+
+void ReflectorTrunk::sendMsg(const ReflectorMsg& msg)
+{
+  if ((m_con == 0) || !m_con->isConnected() ||
+      (m_con_state == STATE_EXPECT_SSL_CON_READY) ||
+      ((m_con_state != STATE_CONNECTED) && (msg.type() >= 100) &&
+       (msg.type() != MsgTrunkHello::TYPE)))
+  {
+    return;
+  }
+
+  ostringstream ss;
+  ReflectorMsg header(msg.type());
+  if (!header.pack(ss) || !msg.pack(ss))
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: Failed to pack TCP message"
+         << endl;
+    return;
+  }
+  m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
+  if (m_con->write(ss.str().data(), ss.str().size()) < 0)
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: Write failed due to '"
+         << strerror(errno) << "'. Message type=" << msg.type() << "."
+         << endl;
+    disconnect();
+  }
+} /* ReflectorTrunk::sendMsg */
+
+
+void ReflectorTrunk::onFrameReceived(Async::FramedTcpConnection *con,
+                                     std::vector<uint8_t>& data)
+{
+  if ((con != m_con) || (m_con_state == STATE_DISCONNECTED))
+  {
+    return;
+  }
+
+  stringstream ss;
+  ss.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+  ReflectorMsg header;
+  if (!header.unpack(ss))
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: Unpacking failed for TCP message header" << endl;
+    sendError("Protocol error");
+    return;
+  }
+
+  m_heartbeat_rx_cnt = HEARTBEAT_RX_CNT_RESET;
+
+  if ((m_con_state != STATE_CONNECTED) && (header.type() >= 100) &&
+      (header.type() != MsgTrunkHello::TYPE))
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: Message " << header.type()
+         << " received in unauthenticated state" << endl;
+    sendError("Protocol error");
+    return;
+  }
+
+  switch (header.type())
+  {
+    case MsgHeartbeat::TYPE:
+      break;
+    case MsgTrunkHello::TYPE:
+    {
+      MsgTrunkHello msg;
+      if (unpackMsg(ss, msg))
+      {
+        handleHello(msg);
+      }
+      break;
+    }
+    case MsgAuthResponse::TYPE:
+      handleAuthResponse(ss);
+      break;
+    case MsgError::TYPE:
+      handleMsgError(ss);
+      break;
+    case MsgTrunkTgSummary::TYPE:
+    {
+      MsgTrunkTgSummary msg;
+      if (unpackMsg(ss, msg))
+      {
+        m_peer_tgs = msg.tgs();
+      }
+      break;
+    }
+    case MsgTrunkTalkerStart::TYPE:
+    {
+      MsgTrunkTalkerStart msg;
+      if (unpackMsg(ss, msg))
+      {
+        m_handler->remoteTalkerStart(this, msg.tg(), msg.callsign());
+      }
+      break;
+    }
+    case MsgTrunkTalkerStop::TYPE:
+    {
+      MsgTrunkTalkerStop msg;
+      if (unpackMsg(ss, msg))
+      {
+        m_handler->remoteTalkerStop(this, msg.tg(), msg.callsign());
+      }
+      break;
+    }
+    case MsgTrunkAudio::TYPE:
+    {
+      MsgTrunkAudio msg;
+      if (unpackMsg(ss, msg))
+      {
+        m_handler->remoteAudio(this, msg.tg(), msg.audioData());
+      }
+      break;
+    }
+    default:
+      // Better ignoring unknown messages to make it easier to add messages to
+      // the protocol but still be backwards compatible
+      break;
+  }
+} /* ReflectorTrunk::onFrameReceived */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void ReflectorTrunk::onConnected(void)
+{
+  cout << "Trunk " << m_name << ": Connected to " << m_client->remoteHost()
+       << ":" << m_client->remotePort() << endl;
+  if (m_con != 0)
+  {
+    cout << "Trunk " << m_name << ": Already connected. Closing the "
+            "outgoing connection." << endl;
+    m_client->disconnect();
+    return;
+  }
+  m_con = m_client;
+  m_con_state = STATE_EXPECT_SSL_CON_READY;
+  m_heartbeat_rx_cnt = HEARTBEAT_RX_CNT_RESET;
+  m_heartbeat_timer.setEnable(true);
+  m_client->enableSsl(true);
+} /* ReflectorTrunk::onConnected */
+
+
+void ReflectorTrunk::onDisconnected(Async::TcpConnection *con,
+                                    Async::TcpConnection::DisconnectReason reason)
+{
+  cout << "Trunk " << m_name << ": Disconnected: "
+       << TcpConnection::disconnectReasonStr(reason) << endl;
+  if (con == m_con)
+  {
+    connectionLost();
+  }
+  else if (m_con == 0)
+  {
+    m_reconnect_timer.setEnable(true);
+  }
+} /* ReflectorTrunk::onDisconnected */
+
+
+void ReflectorTrunk::onSslConnectionReady(Async::TcpConnection *con)
+{
+  if ((con != m_con) || (m_con_state != STATE_EXPECT_SSL_CON_READY))
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: Unexpected TLS connection ready event" << endl;
+    disconnect();
+    return;
+  }
+  if (!verifyPeerCertificate(con))
+  {
+    disconnect();
+    return;
+  }
+  startHandshake();
+} /* ReflectorTrunk::onSslConnectionReady */
+
+
+bool ReflectorTrunk::onVerifyPeer(Async::TcpConnection *con,
+                                  bool preverify_ok,
+                                  X509_STORE_CTX *x509_store_ctx)
+{
+  Async::SslX509 cert(*x509_store_ctx);
+  preverify_ok = preverify_ok && !cert.isNull();
+  if (!preverify_ok)
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: Certificate verification failed for the peer" << endl;
+    cout << "------------- Peer Certificate --------------" << endl;
+    cert.print();
+    cout << "---------------------------------------------" << endl;
+  }
+  return preverify_ok;
+} /* ReflectorTrunk::onVerifyPeer */
+
+
+void ReflectorTrunk::startHandshake(void)
+{
+  m_con->setMaxRxFrameSize(MAX_PREAUTH_FRAME_SIZE);
+  m_con->setMaxTxFrameSize(ReflectorMsg::MAX_POSTAUTH_FRAME_SIZE);
+  m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
+  m_heartbeat_rx_cnt = HEARTBEAT_RX_CNT_RESET;
+  m_heartbeat_timer.setEnable(true);
+  m_con_state = STATE_EXPECT_HELLO;
+  m_hello = MsgTrunkHello(m_local_id);
+  sendMsg(m_hello);
+} /* ReflectorTrunk::startHandshake */
+
+
+void ReflectorTrunk::handleHello(const MsgTrunkHello& msg)
+{
+  if (m_con_state != STATE_EXPECT_HELLO)
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: Unexpected MsgTrunkHello message" << endl;
+    sendError("Protocol error");
+    return;
+  }
+  if (msg.majorVer() != MsgTrunkHello::MAJOR)
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: Unsupported trunk protocol version " << msg.majorVer()
+         << "." << msg.minorVer() << endl;
+    sendError("Unsupported trunk protocol version");
+    return;
+  }
+  if (msg.id() != m_peer_id)
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: Peer identified itself as \""
+         << msg.id() << "\" but \"" << m_peer_id << "\" was expected" << endl;
+    sendError("Unknown trunk peer");
+    return;
+  }
+  if ((msg.challenge() == nullptr) || (m_hello.challenge() == nullptr))
+  {
+    cerr << "*** ERROR[trunk " << m_name
+         << "]: Illegal trunk authentication challenge" << endl;
+    sendError("Protocol error");
+    return;
+  }
+  sendMsg(MsgAuthResponse(m_local_id, m_secret, msg.challenge()));
+  m_con_state = STATE_EXPECT_AUTH_RESPONSE;
+} /* ReflectorTrunk::handleHello */
+
+
+void ReflectorTrunk::handleAuthResponse(std::istream& is)
+{
+  MsgAuthResponse msg;
+  if (!unpackMsg(is, msg))
+  {
+    return;
+  }
+  if ((m_con_state != STATE_EXPECT_AUTH_RESPONSE) ||
+      (msg.callsign() != m_peer_id) ||
+      !msg.verify(m_secret, m_hello.challenge()))
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: Authentication failed"
+         << endl;
+    sendError("Access denied");
+    return;
+  }
+  cout << "Trunk " << m_name << ": Trunk to " << m_peer_id << " is up"
+       << endl;
+  m_con->setMaxRxFrameSize(ReflectorMsg::MAX_POSTAUTH_FRAME_SIZE);
+  m_con_state = STATE_CONNECTED;
+  m_handler->trunkConnected(this);
+} /* ReflectorTrunk::handleAuthResponse */
+
+
+void ReflectorTrunk::handleMsgError(std::istream& is)
+{
+  MsgError msg;
+  string message;
+  if (msg.unpack(is))
+  {
+    message = msg.message();
+  }
+  cout << "Trunk " << m_name << ": Error message received from peer: "
+       << message << endl;
+  disconnect();
+} /* ReflectorTrunk::handleMsgError */
+
+
+template <class T>
+bool ReflectorTrunk::unpackMsg(std::istream& is, T& msg)
+{
+  if (!msg.unpack(is))
+  {
+    cerr << "*** ERROR[trunk " << m_name << "]: Could not unpack message "
+         << msg.type() << endl;
+    sendError("Protocol error");
+    return false;
+  }
+  return true;
+} /* ReflectorTrunk::unpackMsg */
+
+
+void ReflectorTrunk::sendError(const std::string& msg)
+{
+  MsgError err(msg);
+  ostringstream ss;
+  ReflectorMsg header(err.type());
+  if ((m_con != 0) && header.pack(ss) && err.pack(ss))
+  {
+    m_con->write(ss.str().data(), ss.str().size());
+  }
+  disconnect();
+} /* ReflectorTrunk::sendError */
+
+
+void ReflectorTrunk::disconnect(void)
+{
+  FramedTcpConnection *con = m_con;
+  if (con == 0)
+  {
+    return;
+  }
+  bool outgoing = (con == m_client);
+  connectionLost();
+  con->disconnect();
+  if (!outgoing)
+  {
+      // Let the server know that the connection is gone so that it can
+      // clean up after it
+    con->disconnected(con, FramedTcpConnection::DR_ORDERED_DISCONNECT);
+  }
+} /* ReflectorTrunk::disconnect */
+
+
+void ReflectorTrunk::connectionLost(void)
+{
+  bool was_connected = (m_con_state == STATE_CONNECTED);
+  m_con = 0;
+  m_con_state = STATE_DISCONNECTED;
+  m_heartbeat_timer.setEnable(false);
+  m_peer_tgs.clear();
+  if (m_client != 0)
+  {
+    m_reconnect_timer.setEnable(true);
+  }
+  if (was_connected)
+  {
+    cout << "Trunk " << m_name << ": Trunk to " << m_peer_id << " is down"
+         << endl;
+    m_handler->trunkDisconnected(this);
+  }
+} /* ReflectorTrunk::connectionLost */
+
+
+void ReflectorTrunk::handleHeartbeat(Async::Timer *t)
+{
+  if (--m_heartbeat_tx_cnt == 0)
+  {
+    sendMsg(MsgHeartbeat());
+  }
+
+  if (--m_heartbeat_rx_cnt == 0)
+  {
+    cout << "Trunk " << m_name << ": Heartbeat timeout" << endl;
+    sendError("Trunk heartbeat timeout");
+  }
+} /* ReflectorTrunk::handleHeartbeat */
+
+
+void ReflectorTrunk::reconnect(Async::Timer *t)
+{
+    // Spread out the reconnect attempts a bit so that two reflectors that
+    // both connect to each other do not keep colliding
+  m_reconnect_timer.setTimeout(RECONNECT_INTERVAL / 2 +
+                               std::rand() % RECONNECT_INTERVAL);
+  if ((m_client != 0) && (m_con == 0) && m_client->isIdle())
+  {
+    m_client->connect();
+  }
+} /* ReflectorTrunk::reconnect */
+
+
+
+/*
+ * This file has not been truncated
+ */
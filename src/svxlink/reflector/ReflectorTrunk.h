@@ -0,0 +1,290 @@
+/**
+@file   ReflectorTrunk.h
+@brief  A trunk link to another reflector server
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef REFLECTOR_TRUNK_INCLUDED
+#define REFLECTOR_TRUNK_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <string>
+#include <set>
+#include <vector>
+#include <cstdint>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTcpClient.h>
+#include <AsyncFramedTcpConnection.h>
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReflectorMsg.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class Config;
+};
+
+class TrunkHandler;
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A trunk link to another reflector server
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class handle one trunk between this reflector and another reflector,
+the peer. The trunk is a TLS connection that carry talker state, a summary
+of the talk groups in use on each side and the audio for talk groups that
+have listeners on the other side. If a host is configured for the trunk,
+this side connect to the peer. Otherwise the connection is accepted by the
+TrunkHandler and handed over to the trunk when the peer has identified
+itself.
+
+The TLS handshake is done before anything else is sent on the connection.
+Both sides use their server certificate and the peer certificate must be
+valid for the configured peer host name. When the TLS connection is up, the
+peers also authenticate each other using a shared secret.
+*/
+class ReflectorTrunk : public sigc::trackable
+{
+  public:
+    static const uint32_t MAX_PREAUTH_FRAME_SIZE = 256;
+
+    /**
+     * @brief   Constructor
+     * @param   handler The trunk handler that own this trunk
+     * @param   local_id The trunk id of this reflector
+     */
+    ReflectorTrunk(TrunkHandler *handler, const std::string& local_id);
+
+    /**
+     * @brief   Destructor
+     */
+    ~ReflectorTrunk(void);
+
+    /**
+     * @brief   Initialize the trunk
+     * @param   cfg The configuration object to read the trunk setup from
+     * @param   section The configuration section for the trunk
+     * @param   ssl_ctx The TLS context to use for outgoing connections
+     * @return  Returns \em true on success or else \em false
+     */
+    bool initialize(Async::Config &cfg, const std::string& section,
+                    Async::SslContext& ssl_ctx);
+
+    /**
+     * @brief   Get the name of the trunk
+     * @return  Returns the name of the configuration section for the trunk
+     */
+    const std::string& name(void) const { return m_name; }
+
+    /**
+     * @brief   Get the trunk id of the peer
+     * @return  Returns the trunk id of the reflector at the other end
+     */
+    const std::string& peerId(void) const { return m_peer_id; }
+
+    /**
+     * @brief   Check if the trunk is up
+     * @return  Returns \em true if the trunk is connected and authenticated
+     */
+    bool isConnected(void) const { return m_con_state == STATE_CONNECTED; }
+
+    /**
+     * @brief   Check if the peer have clients on a talk group
+     * @param   tg The talk group
+     * @return  Returns \em true if the peer want audio for the talk group
+     */
+    bool peerHasTG(uint32_t tg) const { return m_peer_tgs.count(tg) > 0; }
+
+    /**
+     * @brief   Check the certificate that the peer presented
+     * @param   con The TLS connection to the peer
+     * @return  Returns \em true if the certificate is valid for the peer
+     */
+    bool verifyPeerCertificate(Async::TcpConnection *con);
+
+    /**
+     * @brief   Take over an incoming connection from the peer
+     * @param   con The connection
+     * @param   hello The hello message received on the connection
+     * @return  Returns \em true if the connection was accepted
+     *
+     * The connection is not accepted if the trunk already have a connection.
+     */
+    bool acceptConnection(Async::FramedTcpConnection *con,
+                          const MsgTrunkHello& hello);
+
+    /**
+     * @brief   Tell the trunk that an incoming connection has been closed
+     * @param   con The connection that was closed
+     */
+    void connectionClosed(Async::FramedTcpConnection *con);
+
+    /**
+     * @brief   Handle a frame received on the trunk connection
+     * @param   con The connection that the frame was received on
+     * @param   data The frame data
+     *
+     * Frames on incoming connections are routed here by the trunk handler.
+     */
+    void onFrameReceived(Async::FramedTcpConnection *con,
+                         std::vector<uint8_t>& data);
+
+    /**
+     * @brief   Send a message to the peer
+     * @param   msg The message to send
+     *
+     * Nothing is sent if the trunk is not up.
+     */
+    void sendMsg(const ReflectorMsg& msg);
+
+  private:
+    using FramedTcpClient = Async::TcpClient<Async::FramedTcpConnection>;
+
+    typedef enum
+    {
+      STATE_DISCONNECTED, STATE_EXPECT_SSL_CON_READY, STATE_EXPECT_HELLO,
+      STATE_EXPECT_AUTH_RESPONSE, STATE_CONNECTED
+    } ConState;
+
+    static const unsigned HEARTBEAT_TX_CNT_RESET  = 10;
+    static const unsigned HEARTBEAT_RX_CNT_RESET  = 15;
+    static const unsigned RECONNECT_INTERVAL      = 5000;
+
+    TrunkHandler*               m_handler;
+    std::string                 m_local_id;
+    std::string                 m_name;
+    std::string                 m_peer_id;
+    std::string                 m_peer_hostname;
+    std::string                 m_secret;
+    FramedTcpClient*            m_client;
+    Async::FramedTcpConnection* m_con;
+    ConState                    m_con_state;
+    MsgTrunkHello               m_hello;
+    std::set<uint32_t>          m_peer_tgs;
+    Async::Timer                m_heartbeat_timer;
+    Async::Timer                m_reconnect_timer;
+    unsigned                    m_heartbeat_tx_cnt;
+    unsigned                    m_heartbeat_rx_cnt;
+
+    ReflectorTrunk(const ReflectorTrunk&);
+    ReflectorTrunk& operator=(const ReflectorTrunk&);
+    void onConnected(void);
+    void onDisconnected(Async::TcpConnection *con,
+                        Async::TcpConnection::DisconnectReason reason);
+    void onSslConnectionReady(Async::TcpConnection *con);
+    bool onVerifyPeer(Async::TcpConnection *con, bool preverify_ok,
+                      X509_STORE_CTX *x509_store_ctx);
+    void startHandshake(void);
+    void handleHello(const MsgTrunkHello& msg);
+    void handleAuthResponse(std::istream& is);
+    void handleMsgError(std::istream& is);
+    template <class T> bool unpackMsg(std::istream& is, T& msg);
+    void sendError(const std::string& msg);
+    void disconnect(void);
+    void connectionLost(void);
+    void handleHeartbeat(Async::Timer *t);
+    void reconnect(Async::Timer *t);
+
+};  /* class ReflectorTrunk */
+
+
+//} /* namespace */
+
+#endif /* REFLECTOR_TRUNK_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,731 @@
+/**
+@file   ReflectorUdpShards.cpp
+@brief  Worker threads that share the reflector UDP port
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+
+#include <iostream>
+#include <sstream>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <cassert>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReflectorUdpShards.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+class ReflectorUdpShards::Shard
+{
+  public:
+    std::atomic<uint64_t> rx_datagrams{0};
+    std::atomic<uint64_t> rx_dropped{0};
+    std::atomic<uint64_t> tx_datagrams{0};
+    std::atomic<uint64_t> tx_dropped{0};
+
+    Shard(ReflectorUdpShards& owner) : m_owner(owner) {}
+
+    ~Shard(void)
+    {
+      if (m_thread.joinable())
+      {
+        {
+          std::lock_guard<std::mutex> lk(m_mu);
+          m_quit = true;
+        }
+        wakeup();
+        m_thread.join();
+      }
+      for (int fd : { m_sock, m_wake_rd, m_wake_wr })
+      {
+        if (fd >= 0)
+        {
+          ::close(fd);
+        }
+      }
+      EVP_CIPHER_CTX_free(m_enc_ctx);
+      EVP_CIPHER_CTX_free(m_dec_ctx);
+    }
+
+    bool start(uint16_t port)
+    {
+      m_cipher = EVP_get_cipherbyname(UdpCipher::NAME);
+      m_enc_ctx = EVP_CIPHER_CTX_new();
+      m_dec_ctx = EVP_CIPHER_CTX_new();
+      if ((m_cipher == nullptr) || (m_enc_ctx == nullptr) ||
+          (m_dec_ctx == nullptr) ||
+          !EVP_EncryptInit_ex(m_enc_ctx, m_cipher, NULL, NULL, NULL) ||
+          !EVP_DecryptInit_ex(m_dec_ctx, m_cipher, NULL, NULL, NULL))
+      {
+        std::cerr << "*** ERROR: Could not set up cipher "
+                  << UdpCipher::NAME << " for UDP shard" << std::endl;
+        return false;
+      }
+
+      m_sock = socket(AF_INET, SOCK_DGRAM, 0);
+      if (m_sock < 0)
+      {
+        perror("socket in ReflectorUdpShards");
+        return false;
+      }
+      int on = 1;
+      if (setsockopt(m_sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0)
+      {
+        perror("setsockopt(SO_REUSEPORT) in ReflectorUdpShards");
+        return false;
+      }
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = INADDR_ANY;
+      if (::bind(m_sock, reinterpret_cast<struct sockaddr*>(&addr),
+                 sizeof(addr)) < 0)
+      {
+        perror("bind in ReflectorUdpShards");
+        return false;
+      }
+
+      int fds[2];
+      if (pipe(fds) < 0)
+      {
+        perror("pipe in ReflectorUdpShards");
+        return false;
+      }
+      m_wake_rd = fds[0];
+      m_wake_wr = fds[1];
+      fcntl(m_wake_rd, F_SETFL, O_NONBLOCK);
+
+      m_thread = std::thread(&Shard::threadFunc, this);
+      return true;
+    }
+
+    void send(const IpAddress& addr, uint16_t port, std::vector<uint8_t> iv,
+              std::vector<uint8_t> key, std::string aad, std::string data)
+    {
+      bool was_empty = false;
+      {
+        std::lock_guard<std::mutex> lk(m_mu);
+        was_empty = m_tx.empty();
+        m_tx.push_back({addr, port, std::move(iv), std::move(key),
+                        std::move(aad), std::move(data)});
+      }
+        // The thread empty the whole queue on each wakeup so it only need
+        // to be woken up when the first datagram is queued
+      if (was_empty)
+      {
+        wakeup();
+      }
+    }
+
+  private:
+    static const int MAX_RX_BATCH = 64;
+
+    struct TxDatagram
+    {
+      IpAddress             addr;
+      uint16_t              port;
+      std::vector<uint8_t>  iv;
+      std::vector<uint8_t>  key;
+      std::string           aad;
+      std::string           data;
+    };
+
+    ReflectorUdpShards&     m_owner;
+    int                     m_sock = -1;
+    int                     m_wake_rd = -1;
+    int                     m_wake_wr = -1;
+    std::thread             m_thread;
+    std::mutex              m_mu;
+    std::deque<TxDatagram>  m_tx;
+    bool                    m_quit = false;
+    const EVP_CIPHER*       m_cipher = nullptr;
+    EVP_CIPHER_CTX*         m_enc_ctx = nullptr;
+    EVP_CIPHER_CTX*         m_dec_ctx = nullptr;
+    std::vector<uint8_t>    m_txbuf;
+
+    void wakeup(void)
+    {
+      char ch = 0;
+      if ((::write(m_wake_wr, &ch, 1) < 0) && (errno != EAGAIN))
+      {
+        perror("write in ReflectorUdpShards");
+      }
+    }
+
+    void threadFunc(void)
+    {
+      std::vector<RxDatagram> rx;
+      std::deque<TxDatagram> tx;
+      std::vector<uint8_t> buf(65536);
+      for (;;)
+      {
+        struct pollfd fds[2] = {
+          { m_sock, POLLIN, 0 }, { m_wake_rd, POLLIN, 0 }
+        };
+        if (poll(fds, 2, -1) < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          perror("poll in ReflectorUdpShards");
+          return;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+          char tmp[64];
+          while (::read(m_wake_rd, tmp, sizeof(tmp)) > 0) {}
+          bool quit = false;
+          {
+            std::lock_guard<std::mutex> lk(m_mu);
+            tx.swap(m_tx);
+            quit = m_quit;
+          }
+          for (const auto& dg : tx)
+          {
+            sendDatagram(dg);
+          }
+          tx.clear();
+          if (quit)
+          {
+            return;
+          }
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+          for (int i=0; i<MAX_RX_BATCH; ++i)
+          {
+            struct sockaddr_in addr;
+            socklen_t addr_len = sizeof(addr);
+            ssize_t len = recvfrom(m_sock, buf.data(), buf.size(),
+                MSG_DONTWAIT, reinterpret_cast<struct sockaddr*>(&addr),
+                &addr_len);
+            if (len < 0)
+            {
+              if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+              {
+                perror("recvfrom in ReflectorUdpShards");
+              }
+              break;
+            }
+            ++rx_datagrams;
+            rx.emplace_back();
+            if (!processReceived(IpAddress(addr.sin_addr),
+                                 ntohs(addr.sin_port), buf.data(), len,
+                                 rx.back()))
+            {
+              ++rx_dropped;
+              rx.pop_back();
+            }
+          }
+          if (!rx.empty())
+          {
+            m_owner.queueReceived(rx);
+            rx.clear();
+          }
+        }
+      }
+    }
+
+      // Decrypt a received datagram if it is from a known client. This
+      // mirror what Reflector::udpCipherDataReceived do for the main socket.
+    bool processReceived(const IpAddress& addr, uint16_t port,
+                         const uint8_t* buf, size_t len, RxDatagram& dg)
+    {
+      dg.addr = addr;
+      dg.port = port;
+      dg.decrypted = false;
+      if (len >= UdpCipher::AADLEN)
+      {
+        std::stringstream ss;
+        ss.write(reinterpret_cast<const char*>(buf), UdpCipher::AADLEN);
+        UdpCipher::AAD aad;
+        if (!aad.unpack(ss))
+        {
+          return false;
+        }
+        ClientId id = 0;
+        size_t aadlen = UdpCipher::AADLEN;
+        Cipher cipher;
+        bool known = false;
+        if (aad.iv_cntr == 0)
+        {
+          UdpCipher::InitialAAD iaad;
+          aadlen = iaad.packedSize();
+          ss.clear();
+          ss.str("");
+          ss.write(reinterpret_cast<const char*>(buf), aadlen);
+          if ((len < aadlen) || !iaad.unpack(ss) ||
+              !m_owner.lookupCipher(iaad.client_id, cipher))
+          {
+            return false;
+          }
+          id = iaad.client_id;
+          known = true;
+        }
+        else
+        {
+          known = m_owner.lookupSource(std::make_pair(addr, port), id) &&
+                  m_owner.lookupCipher(id, cipher);
+        }
+        if (known)
+        {
+          std::vector<uint8_t> iv = UdpCipher::IV{cipher.iv_rand, id,
+                                                  aad.iv_cntr};
+          if (!decrypt(cipher.key, iv, buf, aadlen, buf + aadlen,
+                       len - aadlen, dg.data))
+          {
+            return false;
+          }
+          if (aad.iv_cntr == 0)
+          {
+            m_owner.setClientSource(id, addr, port);
+          }
+          dg.aad.assign(buf, buf + aadlen);
+          dg.decrypted = true;
+          return true;
+        }
+      }
+      dg.data.assign(buf, buf + len);
+      return true;
+    }
+
+    bool decrypt(const std::vector<uint8_t>& key,
+                 const std::vector<uint8_t>& iv, const uint8_t* aad,
+                 size_t aadlen, const uint8_t* buf, size_t len,
+                 std::vector<uint8_t>& out)
+    {
+      if ((len < UdpCipher::TAGLEN) ||
+          !EVP_DecryptInit_ex(m_dec_ctx, NULL, NULL, key.data(), iv.data()))
+      {
+        return false;
+      }
+      int outlen = 0;
+      if (!EVP_DecryptUpdate(m_dec_ctx, nullptr, &outlen, aad, aadlen) ||
+          !EVP_CIPHER_CTX_ctrl(m_dec_ctx, EVP_CTRL_AEAD_SET_TAG,
+                               UdpCipher::TAGLEN,
+                               const_cast<uint8_t*>(buf)))
+      {
+        return false;
+      }
+      buf += UdpCipher::TAGLEN;
+      len -= UdpCipher::TAGLEN;
+      out.resize(len + EVP_MAX_BLOCK_LENGTH);
+      if (!EVP_DecryptUpdate(m_dec_ctx, out.data(), &outlen, buf, len))
+      {
+        return false;
+      }
+      int totlen = outlen;
+      if (!EVP_DecryptFinal_ex(m_dec_ctx, out.data() + totlen, &outlen))
+      {
+        return false;
+      }
+      out.resize(totlen + outlen);
+      return true;
+    }
+
+    void sendDatagram(const TxDatagram& dg)
+    {
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(dg.data.data());
+      size_t len = dg.data.size();
+      if (!dg.key.empty())
+      {
+        if (!encrypt(dg))
+        {
+          ++tx_dropped;
+          return;
+        }
+        data = m_txbuf.data();
+        len = m_txbuf.size();
+      }
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(dg.port);
+      addr.sin_addr = dg.addr.ip4Addr();
+      if (sendto(m_sock, data, len, 0,
+                 reinterpret_cast<struct sockaddr*>(&addr),
+                 sizeof(addr)) < 0)
+      {
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+          perror("sendto in ReflectorUdpShards");
+        }
+        ++tx_dropped;
+        return;
+      }
+      ++tx_datagrams;
+    }
+
+      // Same layout as EncryptedUdpSocket::write: AAD, tag, ciphertext
+    bool encrypt(const TxDatagram& dg)
+    {
+      const size_t aadlen = dg.aad.size();
+      const uint8_t* aad = reinterpret_cast<const uint8_t*>(dg.aad.data());
+      const uint8_t* in = reinterpret_cast<const uint8_t*>(dg.data.data());
+      m_txbuf.resize(aadlen + UdpCipher::TAGLEN + dg.data.size() +
+                     EVP_MAX_BLOCK_LENGTH);
+      if (!EVP_EncryptInit_ex(m_enc_ctx, NULL, NULL, dg.key.data(),
+                              dg.iv.data()))
+      {
+        return false;
+      }
+      int outlen = 0;
+      if ((aadlen > 0) &&
+          !EVP_EncryptUpdate(m_enc_ctx, nullptr, &outlen, aad, aadlen))
+      {
+        return false;
+      }
+      std::memcpy(m_txbuf.data(), aad, aadlen);
+      uint8_t* out = m_txbuf.data() + aadlen + UdpCipher::TAGLEN;
+      if (!EVP_EncryptUpdate(m_enc_ctx, out, &outlen, in, dg.data.size()))
+      {
+        return false;
+      }
+      int totlen = outlen;
+      if (!EVP_EncryptFinal_ex(m_enc_ctx, out + totlen, &outlen))
+      {
+        return false;
+      }
+      totlen += outlen;
+      if (!EVP_CIPHER_CTX_ctrl(m_enc_ctx, EVP_CTRL_AEAD_GET_TAG,
+                               UdpCipher::TAGLEN, m_txbuf.data() + aadlen))
+      {
+        return false;
+      }
+      m_txbuf.resize(aadlen + UdpCipher::TAGLEN + totlen);
+      return true;
+    }
+}; /* ReflectorUdpShards::Shard */
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ReflectorUdpShards::ReflectorUdpShards(void)
+  : m_rx_notify_wr(-1)
+{
+} /* ReflectorUdpShards::ReflectorUdpShards */
+
+
+ReflectorUdpShards::~ReflectorUdpShards(void)
+{
+  for (auto& shard : m_shards)
+  {
+    delete shard;
+  }
+  m_shards.clear();
+  int rx_notify_rd = m_rx_watch.fd();
+  m_rx_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+  if (rx_notify_rd >= 0)
+  {
+    ::close(rx_notify_rd);
+  }
+  if (m_rx_notify_wr >= 0)
+  {
+    ::close(m_rx_notify_wr);
+  }
+} /* ReflectorUdpShards::~ReflectorUdpShards */
+
+
+bool ReflectorUdpShards::initialize(uint16_t port, unsigned shards)
+{
+  int fds[2];
+  if (pipe(fds) < 0)
+  {
+    perror("pipe in ReflectorUdpShards::initialize");
+    return false;
+  }
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  m_rx_notify_wr = fds[1];
+  m_rx_watch.setFd(fds[0], FdWatch::FD_WATCH_RD);
+  m_rx_watch.setEnabled(true);
+  m_rx_watch.activity.connect(
+      sigc::mem_fun(*this, &ReflectorUdpShards::handleReceived));
+
+  for (unsigned i=0; i<shards; ++i)
+  {
+    Shard *shard = new Shard(*this);
+    m_shards.push_back(shard);
+    if (!shard->start(port))
+    {
+      return false;
+    }
+  }
+  return true;
+} /* ReflectorUdpShards::initialize */
+
+
+void ReflectorUdpShards::setClientCipher(ClientId id,
+    const std::vector<uint8_t>& iv_rand, const std::vector<uint8_t>& key)
+{
+  std::lock_guard<std::mutex> lk(m_table_mu);
+  Cipher& cipher = m_ciphers[id];
+  cipher.iv_rand = iv_rand;
+  cipher.key = key;
+} /* ReflectorUdpShards::setClientCipher */
+
+
+void ReflectorUdpShards::setClientSource(ClientId id, const IpAddress& addr,
+                                         uint16_t port)
+{
+  const ClientSrc src = std::make_pair(addr, port);
+  std::lock_guard<std::mutex> lk(m_table_mu);
+  auto cit = m_client_srcs.find(id);
+  if (cit != m_client_srcs.end())
+  {
+    if (cit->second == src)
+    {
+      return;
+    }
+    eraseSource(cit->second, id);
+  }
+  m_sources[src] = id;
+  m_client_srcs[id] = src;
+} /* ReflectorUdpShards::setClientSource */
+
+
+void ReflectorUdpShards::removeClient(ClientId id)
+{
+  std::lock_guard<std::mutex> lk(m_table_mu);
+  m_ciphers.erase(id);
+  auto cit = m_client_srcs.find(id);
+  if (cit != m_client_srcs.end())
+  {
+    eraseSource(cit->second, id);
+    m_client_srcs.erase(cit);
+  }
+} /* ReflectorUdpShards::removeClient */
+
+
+void ReflectorUdpShards::send(unsigned shard, const IpAddress& addr,
+                              uint16_t port, std::vector<uint8_t> iv,
+                              std::vector<uint8_t> key, std::string aad,
+                              std::string data)
+{
+  assert(shard < m_shards.size());
+  m_shards[shard]->send(addr, port, std::move(iv), std::move(key),
+                        std::move(aad), std::move(data));
+} /* ReflectorUdpShards::send */
+
+
+ReflectorUdpShards::Stats ReflectorUdpShards::stats(void)
+{
+  Stats stats;
+  for (const auto& shard : m_shards)
+  {
+    stats.rx_datagrams += shard->rx_datagrams;
+    stats.rx_dropped += shard->rx_dropped;
+    stats.tx_datagrams += shard->tx_datagrams;
+    stats.tx_dropped += shard->tx_dropped;
+  }
+  return stats;
+} /* ReflectorUdpShards::stats */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+bool ReflectorUdpShards::lookupCipher(ClientId id, Cipher& cipher) const
+{
+  std::lock_guard<std::mutex> lk(m_table_mu);
+  auto it = m_ciphers.find(id);
+  if ((it == m_ciphers.end()) || it->second.key.empty())
+  {
+    return false;
+  }
+  cipher = it->second;
+  return true;
+} /* ReflectorUdpShards::lookupCipher */
+
+
+bool ReflectorUdpShards::lookupSource(const ClientSrc& src,
+                                      ClientId& id) const
+{
+  std::lock_guard<std::mutex> lk(m_table_mu);
+  auto it = m_sources.find(src);
+  if (it == m_sources.end())
+  {
+    return false;
+  }
+  id = it->second;
+  return true;
+} /* ReflectorUdpShards::lookupSource */
+
+
+void ReflectorUdpShards::eraseSource(const ClientSrc& src, ClientId id)
+{
+    // The source may have been taken over by another client
+  auto it = m_sources.find(src);
+  if ((it != m_sources.end()) && (it->second == id))
+  {
+    m_sources.erase(it);
+  }
+} /* ReflectorUdpShards::eraseSource */
+
+
+void ReflectorUdpShards::queueReceived(std::vector<RxDatagram>& dgs)
+{
+  bool was_empty = false;
+  {
+    std::lock_guard<std::mutex> lk(m_rx_mu);
+    was_empty = m_rx_queue.empty();
+    for (auto& dg : dgs)
+    {
+      m_rx_queue.push_back(std::move(dg));
+    }
+  }
+  if (was_empty)
+  {
+    char ch = 0;
+    if ((::write(m_rx_notify_wr, &ch, 1) < 0) && (errno != EAGAIN))
+    {
+      perror("write in ReflectorUdpShards::queueReceived");
+    }
+  }
+} /* ReflectorUdpShards::queueReceived */
+
+
+void ReflectorUdpShards::handleReceived(FdWatch *w)
+{
+  char tmp[64];
+  while (::read(w->fd(), tmp, sizeof(tmp)) > 0) {}
+
+  std::deque<RxDatagram> dgs;
+  {
+    std::lock_guard<std::mutex> lk(m_rx_mu);
+    dgs.swap(m_rx_queue);
+  }
+  for (auto& dg : dgs)
+  {
+    datagramReceived(dg.addr, dg.port,
+        dg.decrypted ? dg.aad.data() : nullptr, dg.aad.size(),
+        dg.data.data(), dg.data.size());
+  }
+} /* ReflectorUdpShards::handleReceived */
+
+
+
+/*
+ * This file has not been truncated
+ */
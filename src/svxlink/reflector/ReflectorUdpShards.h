@@ -0,0 +1,287 @@
+/**
+@file   ReflectorUdpShards.h
+@brief  Worker threads that share the reflector UDP port
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef REFLECTOR_UDP_SHARDS_INCLUDED
+#define REFLECTOR_UDP_SHARDS_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <vector>
+#include <string>
+#include <map>
+#include <deque>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncIpAddress.h>
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReflectorMsg.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Worker threads that share the reflector UDP port
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+Each shard is a worker thread that own a UDP socket bound to the reflector
+UDP port using SO_REUSEPORT. The kernel spread the incoming traffic over all
+sockets bound to the port. The shards do the per datagram work, that is the
+system calls and the AEAD decryption and encryption. All protocol state,
+like clients, talk groups and sequence numbers, is still handled in the main
+thread which also do the routing between the shards.
+
+Decrypted datagrams are delivered to the main thread through the
+datagramReceived signal. Datagrams that cannot be decrypted by a shard, e.g.
+from V2 clients, are delivered as is with no associated data. To be able to
+decrypt datagrams, the shards need to know the cipher parameters and UDP
+source for each client. These are kept in a table that is updated by the
+main thread.
+*/
+class ReflectorUdpShards
+{
+  public:
+    using ClientId = UdpCipher::ClientId;
+
+    /**
+     * @brief   Statistics for all shards
+     */
+    struct Stats
+    {
+      uint64_t rx_datagrams = 0;  ///< Received datagrams
+      uint64_t rx_dropped   = 0;  ///< Dropped received datagrams
+      uint64_t tx_datagrams = 0;  ///< Sent datagrams
+      uint64_t tx_dropped   = 0;  ///< Datagrams that could not be sent
+    };
+
+    /**
+     * @brief   Default constructor
+     */
+    ReflectorUdpShards(void);
+
+    /**
+     * @brief   Destructor
+     */
+    ~ReflectorUdpShards(void);
+
+    /**
+     * @brief   Start the shards
+     * @param   port The UDP port to bind to
+     * @param   shards The number of worker shards to start
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * All other sockets bound to the same port must also use SO_REUSEPORT.
+     */
+    bool initialize(uint16_t port, unsigned shards);
+
+    /**
+     * @brief   Get the number of worker shards
+     * @return  Returns the number of worker shards
+     */
+    unsigned size(void) const { return m_shards.size(); }
+
+    /**
+     * @brief   Set the cipher parameters for a client
+     * @param   id The client id
+     * @param   iv_rand The random part of the initialization vector
+     * @param   key The cipher key
+     */
+    void setClientCipher(ClientId id, const std::vector<uint8_t>& iv_rand,
+                         const std::vector<uint8_t>& key);
+
+    /**
+     * @brief   Set the UDP source address for a client
+     * @param   id The client id
+     * @param   addr The source IP address
+     * @param   port The source UDP port
+     *
+     * A client only have one source. A previously set source for the client
+     * is replaced.
+     */
+    void setClientSource(ClientId id, const Async::IpAddress& addr,
+                         uint16_t port);
+
+    /**
+     * @brief   Remove all information about a client
+     * @param   id The client id
+     */
+    void removeClient(ClientId id);
+
+    /**
+     * @brief   Encrypt and send a datagram from a shard
+     * @param   shard The index of the shard to send from
+     * @param   addr The destination IP address
+     * @param   port The destination UDP port
+     * @param   iv The initialization vector to encrypt with
+     * @param   key The key to encrypt with, empty to send unencrypted
+     * @param   aad The associated data
+     * @param   data The data to encrypt and send
+     *
+     * The datagram is queued and sent by the shard thread. If the key is
+     * empty the data is sent as is.
+     */
+    void send(unsigned shard, const Async::IpAddress& addr, uint16_t port,
+              std::vector<uint8_t> iv, std::vector<uint8_t> key,
+              std::string aad, std::string data);
+
+    /**
+     * @brief   Get statistics for all shards
+     * @return  Returns the summed statistics
+     */
+    Stats stats(void);
+
+    /**
+     * @brief   A signal that is emitted when a datagram has been received
+     * @param   addr The IP address the datagram was received from
+     * @param   port The remote UDP port
+     * @param   aad The associated data or nullptr if not decrypted
+     * @param   aadlen The length of the associated data
+     * @param   buf The decrypted data
+     * @param   count The length of the data
+     */
+    sigc::signal<void(const Async::IpAddress&, uint16_t, void*, int,
+                      void*, int)> datagramReceived;
+
+  private:
+    class Shard;
+    struct Cipher
+    {
+      std::vector<uint8_t>  iv_rand;
+      std::vector<uint8_t>  key;
+    };
+    struct RxDatagram
+    {
+      Async::IpAddress      addr;
+      uint16_t              port;
+      bool                  decrypted;
+      std::vector<uint8_t>  aad;
+      std::vector<uint8_t>  data;
+    };
+    using ClientSrc = std::pair<Async::IpAddress, uint16_t>;
+
+    std::vector<Shard*>                 m_shards;
+    Async::FdWatch                      m_rx_watch;
+    int                                 m_rx_notify_wr;
+
+    std::mutex                          m_rx_mu;
+    std::deque<RxDatagram>              m_rx_queue;
+
+    mutable std::mutex                  m_table_mu;
+    std::map<ClientId, Cipher>          m_ciphers;
+    std::map<ClientSrc, ClientId>       m_sources;
+    std::map<ClientId, ClientSrc>       m_client_srcs;
+
+    ReflectorUdpShards(const ReflectorUdpShards&);
+    ReflectorUdpShards& operator=(const ReflectorUdpShards&);
+    bool lookupCipher(ClientId id, Cipher& cipher) const;
+    bool lookupSource(const ClientSrc& src, ClientId& id) const;
+    void eraseSource(const ClientSrc& src, ClientId id);
+    void queueReceived(std::vector<RxDatagram>& dgs);
+    void handleReceived(Async::FdWatch *w);
+
+};  /* class ReflectorUdpShards */
+
+
+//} /* namespace */
+
+#endif /* REFLECTOR_UDP_SHARDS_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
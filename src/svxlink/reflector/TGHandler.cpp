@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2021 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -168,8 +168,12 @@ bool TGHandler::switchTo(ReflectorClient *client, uint32_t tg)
       m_cfg->getValue(ss.str(), "AUTO_QSY_AFTER", tg_info->auto_qsy_after_s);
       m_id_map[tg] = tg_info;
     }
-    tg_info->clients.insert(client);
+    tg_info->clients.push_back(client);
     m_client_map[client] = tg_info;
+    if ((tg_info->clients.size() == 1) && (m_monitor_map.count(tg) == 0))
+    {
+      tgUsageChanged(tg, true);
+    }
   }
 
   //printTGStatus();
@@ -191,21 +195,83 @@ void TGHandler::removeClient(ReflectorClient* client)
     removeClientP(tg_info, client);
     //printTGStatus();
   }
+  setMonitoredTGs(client, std::set<uint32_t>());
 } /* TGHandler::removeClient */
 
 
-const TGHandler::ClientSet& TGHandler::clientsForTG(uint32_t tg) const
+const TGHandler::ClientList& TGHandler::clientsForTG(uint32_t tg) const
 {
-  static const TGHandler::ClientSet empty_set;
+  static const TGHandler::ClientList empty_list;
   IdMap::const_iterator id_map_it = m_id_map.find(tg);
   if (id_map_it == m_id_map.end())
   {
-    return empty_set;
+    return empty_list;
   }
   return id_map_it->second->clients;
 } /* TGHandler::clientsForTG */
 
 
+void TGHandler::setMonitoredTGs(ReflectorClient* client,
+                                const std::set<uint32_t>& tgs)
+{
+  std::set<uint32_t> old_tgs;
+  ClientMonitorMap::iterator client_it = m_client_monitor_map.find(client);
+  if (client_it != m_client_monitor_map.end())
+  {
+    old_tgs.swap(client_it->second);
+    m_client_monitor_map.erase(client_it);
+  }
+  if (!tgs.empty())
+  {
+    m_client_monitor_map[client] = tgs;
+  }
+
+  for (const auto& tg : old_tgs)
+  {
+    if (tgs.count(tg) == 0)
+    {
+      MonitorMap::iterator it = m_monitor_map.find(tg);
+      if (it != m_monitor_map.end())
+      {
+        eraseClient(it->second, client);
+        if (it->second.empty())
+        {
+          m_monitor_map.erase(it);
+          if (m_id_map.count(tg) == 0)
+          {
+            tgUsageChanged(tg, false);
+          }
+        }
+      }
+    }
+  }
+  for (const auto& tg : tgs)
+  {
+    if (old_tgs.count(tg) == 0)
+    {
+      ClientList& monitors = m_monitor_map[tg];
+      monitors.push_back(client);
+      if ((monitors.size() == 1) && (m_id_map.count(tg) == 0))
+      {
+        tgUsageChanged(tg, true);
+      }
+    }
+  }
+} /* TGHandler::setMonitoredTGs */
+
+
+const TGHandler::ClientList& TGHandler::monitorsForTG(uint32_t tg) const
+{
+  static const TGHandler::ClientList empty_list;
+  MonitorMap::const_iterator it = m_monitor_map.find(tg);
+  if (it == m_monitor_map.end())
+  {
+    return empty_list;
+  }
+  return it->second;
+} /* TGHandler::monitorsForTG */
+
+
 void TGHandler::setTalkerForTG(uint32_t tg, ReflectorClient* new_talker)
 {
   IdMap::const_iterator id_map_it = m_id_map.find(tg);
@@ -391,16 +457,32 @@ void TGHandler::removeClientP(TGInfo *tg_info, ReflectorClient* client)
   {
     tg_info->talker = 0;
   }
-  tg_info->clients.erase(client);
+  eraseClient(tg_info->clients, client);
   m_client_map.erase(client);
   if (tg_info->clients.empty())
   {
-    m_id_map.erase(tg_info->id);
+    uint32_t tg = tg_info->id;
+    m_id_map.erase(tg);
     delete tg_info;
+    if (m_monitor_map.count(tg) == 0)
+    {
+      tgUsageChanged(tg, false);
+    }
   }
 } /* TGHandler::removeClientP */
 
 
+void TGHandler::eraseClient(ClientList& clients, ReflectorClient* client)
+{
+  ClientList::iterator it = std::find(clients.begin(), clients.end(), client);
+  if (it != clients.end())
+  {
+    *it = clients.back();
+    clients.pop_back();
+  }
+} /* TGHandler::eraseClient */
+
+
 void TGHandler::printTGStatus(void)
 {
   std::cout << "### ----------- BEGIN ----------------" << std::endl;
@@ -409,7 +491,7 @@ void TGHandler::printTGStatus(void)
   {
     TGInfo *tg_info = it->second;
     std::cout << "### " << tg_info->id << ": ";
-    for (ClientSet::const_iterator it = tg_info->clients.begin();
+    for (ClientList::const_iterator it = tg_info->clients.begin();
          it != tg_info->clients.end(); ++it)
     {
       ReflectorClient* client = *it;
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxReflector - An audio reflector for connecting SvxLink Servers
-Copyright (C) 2003-2024 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <map>
 #include <set>
+#include <vector>
 #include <sigc++/sigc++.h>
 #include <sys/time.h>
 
@@ -117,7 +118,7 @@ the system.
 class TGHandler : public sigc::trackable
 {
   public:
-    typedef std::set<ReflectorClient*> ClientSet;
+    typedef std::vector<ReflectorClient*> ClientList;
 
     static TGHandler* instance(void)
     {
@@ -155,7 +156,31 @@ class TGHandler : public sigc::trackable
 
     void removeClient(ReflectorClient* client);
 
-    const ClientSet& clientsForTG(uint32_t tg) const;
+    /**
+     * @brief   Get the clients that have selected a talk group
+     * @param   tg The talk group
+     * @return  Returns a dense list of the clients on the talk group
+     *
+     * The list is kept up to date as clients switch talk group so it can be
+     * iterated directly when routing audio, without looking at clients on
+     * other talk groups. The order of the clients is undefined.
+     */
+    const ClientList& clientsForTG(uint32_t tg) const;
+
+    /**
+     * @brief   Set the talk groups that a client is monitoring
+     * @param   client The client
+     * @param   tgs The new set of monitored talk groups
+     */
+    void setMonitoredTGs(ReflectorClient* client,
+                         const std::set<uint32_t>& tgs);
+
+    /**
+     * @brief   Get the clients that are monitoring a talk group
+     * @param   tg The talk group
+     * @return  Returns a dense list of the clients monitoring the talk group
+     */
+    const ClientList& monitorsForTG(uint32_t tg) const;
 
     void setTalkerForTG(uint32_t tg, ReflectorClient* client);
 
@@ -176,13 +201,24 @@ class TGHandler : public sigc::trackable
 
     sigc::signal<void(uint32_t)> requestAutoQsy;
 
+    /**
+     * @brief   A signal that is emitted when the use of a talk group change
+     * @param   tg The talk group
+     * @param   used \em true if the talk group got its first user or
+     *               \em false if the last user left it
+     *
+     * A user is a client that has either selected or is monitoring the talk
+     * group.
+     */
+    sigc::signal<void(uint32_t, bool)> tgUsageChanged;
+
   private:
     static const time_t TALKER_AUDIO_TIMEOUT = 3; // Max three seconds gap
 
     struct TGInfo
     {
       uint32_t          id;
-      ClientSet         clients;
+      ClientList        clients;
       ReflectorClient*  talker;
       struct timeval    last_talker_timestamp;
       unsigned          sql_timeout_cnt;
@@ -198,10 +234,15 @@ class TGHandler : public sigc::trackable
     };
     typedef std::map<uint32_t, TGInfo*>               IdMap;
     typedef std::map<const ReflectorClient*, TGInfo*> ClientMap;
+    typedef std::map<uint32_t, ClientList>            MonitorMap;
+    typedef std::map<const ReflectorClient*, std::set<uint32_t>>
+                                                      ClientMonitorMap;
 
     const Async::Config*  m_cfg;
     IdMap                 m_id_map;
     ClientMap             m_client_map;
+    MonitorMap            m_monitor_map;
+    ClientMonitorMap      m_client_monitor_map;
     Async::Timer          m_timeout_timer;
     unsigned              m_sql_timeout;
     unsigned              m_sql_timeout_blocktime;
@@ -210,6 +251,7 @@ class TGHandler : public sigc::trackable
     TGHandler& operator=(const TGHandler&);
     void checkTimers(Async::Timer *t);
     void removeClientP(TGInfo *tg_info, ReflectorClient* client);
+    static void eraseClient(ClientList& clients, ReflectorClient* client);
     void printTGStatus(void);
 };  /* class TGHandler */
 
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+
+#include "ReflectorClient.h"
+#include "TGHandler.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark the cost of finding the receivers of an audio frame.
+ *
+ * Usage: TGRoutingBench [clients per TG] [frames]
+ *
+ * For a growing number of connected clients, spread out over talk groups
+ * with only a few clients each, the time to find the receivers of one audio
+ * frame is measured. The filter scan is the old way of evaluating an
+ * ExceptFilter/TgFilter pair against every connected client. The index is
+ * the per talk group client list kept by the TGHandler. Only the receiver
+ * selection is measured. No packets are sent so no real clients are needed.
+ */
+
+namespace {
+typedef map<const void*, ReflectorClient*> ClientConMap;
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+double runScan(const ClientConMap& con_map, uint32_t tg,
+               ReflectorClient* talker, unsigned frames, size_t& receivers)
+{
+  const auto filter = ReflectorClient::mkAndFilter(
+      ReflectorClient::ExceptFilter(talker),
+      ReflectorClient::TgFilter(tg));
+  receivers = 0;
+  double start = cpuTime();
+  for (unsigned i=0; i<frames; ++i)
+  {
+    for (const auto& item : con_map)
+    {
+      if (filter(item.second))
+      {
+        ++receivers;
+      }
+    }
+  }
+  return cpuTime() - start;
+}
+
+double runIndex(uint32_t tg, ReflectorClient* talker, unsigned frames,
+                size_t& receivers)
+{
+  receivers = 0;
+  double start = cpuTime();
+  for (unsigned i=0; i<frames; ++i)
+  {
+    for (ReflectorClient* client : TGHandler::instance()->clientsForTG(tg))
+    {
+      if (client != talker)
+      {
+        ++receivers;
+      }
+    }
+  }
+  return cpuTime() - start;
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned clients_per_tg = 4;
+  unsigned frames = 10000;
+  if (argc > 1)
+  {
+    clients_per_tg = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    frames = atoi(argv[2]);
+  }
+  if ((clients_per_tg < 1) || (frames < 1))
+  {
+    cerr << "Usage: TGRoutingBench [clients per TG] [frames]\n";
+    exit(1);
+  }
+
+  CppApplication app;
+  Config cfg;
+  TGHandler::instance()->setConfig(&cfg);
+
+    // The clients are only used as keys so any unique address will do
+  const size_t max_clients = 10000;
+  vector<char> client_storage(max_clients);
+  ClientConMap con_map;
+
+  printf("%8s %12s %12s %8s\n", "Clients", "Scan ns/fr", "Index ns/fr",
+         "Speedup");
+  int ret = 0;
+  size_t client_cnt = 0;
+  for (size_t total : {10, 100, 1000, 10000})
+  {
+    for (; client_cnt<total; ++client_cnt)
+    {
+      ReflectorClient *client =
+        reinterpret_cast<ReflectorClient*>(&client_storage[client_cnt]);
+      con_map[client] = client;
+      uint32_t tg = 1 + client_cnt / clients_per_tg;
+      TGHandler::instance()->switchTo(client, tg);
+    }
+
+    uint32_t tg = 1;
+    ReflectorClient *talker = TGHandler::instance()->clientsForTG(tg).front();
+    size_t scan_receivers = 0;
+    size_t index_receivers = 0;
+    double scan_time = runScan(con_map, tg, talker, frames, scan_receivers);
+    double index_time = runIndex(tg, talker, frames, index_receivers);
+    if (scan_receivers != index_receivers)
+    {
+      cerr << "*** ERROR: Receiver count mismatch: scan=" << scan_receivers
+           << " index=" << index_receivers << endl;
+      ret = 1;
+    }
+    printf("%8zu %12.1f %12.1f %8.1f\n", total,
+           1.0e9 * scan_time / frames, 1.0e9 * index_time / frames,
+           scan_time / index_time);
+  }
+
+  for (const auto& item : con_map)
+  {
+    TGHandler::instance()->switchTo(item.second, 0);
+  }
+
+  return ret;
+} /* main */
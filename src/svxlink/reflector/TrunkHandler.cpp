@@ -0,0 +1,590 @@
+/**
+@file   TrunkHandler.cpp
+@brief  Handle the trunks to other reflector servers
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncConfig.h>
+#include <AsyncApplication.h>
+#include <common.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "TrunkHandler.h"
+#include "ReflectorTrunk.h"
+#include "ReflectorMsg.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+TrunkHandler::TrunkHandler(void)
+  : m_srv(0), m_summary_pending(false),
+    m_talker_timer(1000, Timer::TYPE_PERIODIC, false)
+{
+  m_talker_timer.expired.connect(
+      mem_fun(*this, &TrunkHandler::checkTalkerTimeouts));
+} /* TrunkHandler::TrunkHandler */
+
+
+TrunkHandler::~TrunkHandler(void)
+{
+  m_cons.clear();
+  for (auto& trunk : m_trunks)
+  {
+    delete trunk;
+  }
+  m_trunks.clear();
+  delete m_srv;
+} /* TrunkHandler::~TrunkHandler */
+
+
+bool TrunkHandler::initialize(Async::Config &cfg,
+                              Async::SslContext& ssl_ctx)
+{
+  std::string trunks;
+  if (!cfg.getValue("GLOBAL", "TRUNKS", trunks) || trunks.empty())
+  {
+    return true;
+  }
+
+  if (!cfg.getValue("GLOBAL", "TRUNK_ID", m_local_id) || m_local_id.empty())
+  {
+    cerr << "*** ERROR: GLOBAL/TRUNK_ID must be set when GLOBAL/TRUNKS is set"
+         << endl;
+    return false;
+  }
+
+  std::string listen_port(std::to_string(DEFAULT_PORT));
+  cfg.getValue("GLOBAL", "TRUNK_LISTEN_PORT", listen_port);
+  m_srv = new FramedTcpServer(listen_port);
+  m_srv->setConnectionThrottling(10, 0.1, 1000);
+  m_srv->setSslContext(ssl_ctx);
+  m_srv->clientConnected.connect(
+      mem_fun(*this, &TrunkHandler::clientConnected));
+  m_srv->clientDisconnected.connect(
+      mem_fun(*this, &TrunkHandler::clientDisconnected));
+
+  std::vector<std::string> sections;
+  SvxLink::splitStr(sections, trunks, ",");
+  for (const auto& section : sections)
+  {
+    ReflectorTrunk *trunk = new ReflectorTrunk(this, m_local_id);
+    m_trunks.push_back(trunk);
+    if (!trunk->initialize(cfg, section, ssl_ctx))
+    {
+      return false;
+    }
+    for (const auto& other : m_trunks)
+    {
+      if ((other != trunk) && (other->peerId() == trunk->peerId()))
+      {
+        cerr << "*** ERROR: The trunks " << other->name() << " and "
+             << trunk->name() << " have the same PEER_ID" << endl;
+        return false;
+      }
+    }
+  }
+
+  cout << "Trunk id " << m_local_id << " with " << m_trunks.size()
+       << " trunk(s), listening on port " << listen_port << endl;
+
+  return true;
+} /* TrunkHandler::initialize */
+
+
+size_t TrunkHandler::connectedCount(void) const
+{
+  size_t cnt = 0;
+  for (const auto& trunk : m_trunks)
+  {
+    if (trunk->isConnected())
+    {
+      ++cnt;
+    }
+  }
+  return cnt;
+} /* TrunkHandler::connectedCount */
+
+
+void TrunkHandler::setLocalTGUsed(uint32_t tg, bool used)
+{
+  if (used)
+  {
+    m_local_tgs.insert(tg);
+  }
+  else
+  {
+    m_local_tgs.erase(tg);
+  }
+  if (!m_trunks.empty() && !m_summary_pending)
+  {
+    m_summary_pending = true;
+    Application::app().runTask(mem_fun(*this, &TrunkHandler::sendSummary));
+  }
+} /* TrunkHandler::setLocalTGUsed */
+
+
+void TrunkHandler::localTalkerStart(uint32_t tg, const std::string& callsign)
+{
+  if (m_trunks.empty())
+  {
+    return;
+  }
+  m_local_talkers[tg] = callsign;
+  sendToAll(MsgTrunkTalkerStart(tg, callsign));
+} /* TrunkHandler::localTalkerStart */
+
+
+void TrunkHandler::localTalkerStop(uint32_t tg, const std::string& callsign)
+{
+  auto it = m_local_talkers.find(tg);
+  if (it == m_local_talkers.end())
+  {
+    return;
+  }
+  m_local_talkers.erase(it);
+  sendToAll(MsgTrunkTalkerStop(tg, callsign));
+} /* TrunkHandler::localTalkerStop */
+
+
+void TrunkHandler::localAudio(uint32_t tg, const std::vector<uint8_t>& audio)
+{
+  if (m_local_talkers.count(tg) == 0)
+  {
+    return;
+  }
+  const MsgTrunkAudio msg(tg, audio);
+  for (const auto& trunk : m_trunks)
+  {
+    if (trunk->isConnected() && trunk->peerHasTG(tg))
+    {
+      trunk->sendMsg(msg);
+    }
+  }
+} /* TrunkHandler::localAudio */
+
+
+const std::string& TrunkHandler::remoteTalkerForTG(uint32_t tg) const
+{
+  static const std::string no_talker;
+  auto it = m_remote_talkers.find(tg);
+  if (it == m_remote_talkers.end())
+  {
+    return no_talker;
+  }
+  return it->second.callsign;
+} /* TrunkHandler::remoteTalkerForTG */
+
+
+void TrunkHandler::trunkConnected(ReflectorTrunk *trunk)
+{
+  trunk->sendMsg(MsgTrunkTgSummary(m_local_tgs));
+  for (const auto& item : m_local_talkers)
+  {
+    trunk->sendMsg(MsgTrunkTalkerStart(item.first, item.second));
+  }
+} /* TrunkHandler::trunkConnected */
+
+
+void TrunkHandler::trunkDisconnected(ReflectorTrunk *trunk)
+{
+  std::vector<uint32_t> tgs;
+  for (const auto& item : m_remote_talkers)
+  {
+    if (item.second.trunk == trunk)
+    {
+      tgs.push_back(item.first);
+    }
+  }
+  for (const auto& tg : tgs)
+  {
+    clearRemoteTalker(tg);
+  }
+} /* TrunkHandler::trunkDisconnected */
+
+
+void TrunkHandler::remoteTalkerStart(ReflectorTrunk *trunk, uint32_t tg,
+                                     const std::string& callsign)
+{
+    // The talker on the reflector with the lowest trunk id win
+  auto local_it = m_local_talkers.find(tg);
+  if (local_it != m_local_talkers.end())
+  {
+    if (m_local_id < trunk->peerId())
+    {
+      return;
+    }
+    const std::string local_callsign = local_it->second;
+    cout << callsign << ": Trunk talker on TG #" << tg << " from "
+         << trunk->peerId() << " preempts local talker "
+         << local_callsign << endl;
+    localTalkerPreempted(tg);
+    localTalkerStop(tg, local_callsign);
+  }
+
+  auto remote_it = m_remote_talkers.find(tg);
+  if (remote_it != m_remote_talkers.end())
+  {
+    const RemoteTalker& talker = remote_it->second;
+    if ((talker.trunk != trunk) &&
+        (talker.trunk->peerId() < trunk->peerId()))
+    {
+      return;
+    }
+    if ((talker.trunk == trunk) && (talker.callsign == callsign))
+    {
+      return;
+    }
+  }
+
+  setRemoteTalker(tg, trunk, callsign);
+} /* TrunkHandler::remoteTalkerStart */
+
+
+void TrunkHandler::remoteTalkerStop(ReflectorTrunk *trunk, uint32_t tg,
+                                    const std::string& callsign)
+{
+  auto it = m_remote_talkers.find(tg);
+  if ((it != m_remote_talkers.end()) && (it->second.trunk == trunk) &&
+      (it->second.callsign == callsign))
+  {
+    clearRemoteTalker(tg);
+  }
+} /* TrunkHandler::remoteTalkerStop */
+
+
+void TrunkHandler::remoteAudio(ReflectorTrunk *trunk, uint32_t tg,
+                               const std::vector<uint8_t>& audio)
+{
+    // Audio from a talker that lost the arbitration is dropped
+  auto it = m_remote_talkers.find(tg);
+  if ((it == m_remote_talkers.end()) || (it->second.trunk != trunk))
+  {
+    return;
+  }
+  gettimeofday(&it->second.last_audio, NULL);
+  remoteAudioReceived(tg, audio);
+} /* TrunkHandler::remoteAudio */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void TrunkHandler::clientConnected(Async::FramedTcpConnection *con)
+{
+  con->setMaxRxFrameSize(ReflectorTrunk::MAX_PREAUTH_FRAME_SIZE);
+  m_cons[con] = 0;
+  con->frameReceived.connect(mem_fun(*this, &TrunkHandler::onFrameReceived));
+  con->verifyPeer.connect(mem_fun(*this, &TrunkHandler::onVerifyPeer));
+    // Nothing is sent in clear text on a trunk so the TLS handshake is
+    // started directly. No frames are received until it is done.
+  con->enableSsl(true);
+} /* TrunkHandler::clientConnected */
+
+
+void TrunkHandler::clientDisconnected(Async::FramedTcpConnection *con,
+    Async::FramedTcpConnection::DisconnectReason reason)
+{
+  auto it = m_cons.find(con);
+  if (it == m_cons.end())
+  {
+    return;
+  }
+  ReflectorTrunk *trunk = it->second;
+  m_cons.erase(it);
+  if (trunk != 0)
+  {
+    trunk->connectionClosed(con);
+  }
+} /* TrunkHandler::clientDisconnected */
+
+
+void TrunkHandler::onFrameReceived(Async::FramedTcpConnection *con,
+                                   std::vector<uint8_t>& data)
+{
+  auto it = m_cons.find(con);
+  assert(it != m_cons.end());
+  if (it->second != 0)
+  {
+    it->second->onFrameReceived(con, data);
+  }
+  else
+  {
+    acceptConnection(con, data);
+  }
+} /* TrunkHandler::onFrameReceived */
+
+
+void TrunkHandler::acceptConnection(Async::FramedTcpConnection *con,
+                                    std::vector<uint8_t>& data)
+{
+    // The first message on an incoming trunk connection must be a hello
+    // that tell which peer that is connecting
+  std::stringstream ss;
+  ss.write(reinterpret_cast<const char*>(data.data()), data.size());
+  ReflectorMsg header;
+  MsgTrunkHello hello;
+  if (!header.unpack(ss) || (header.type() != MsgTrunkHello::TYPE) ||
+      !hello.unpack(ss))
+  {
+    cerr << "*** ERROR: Protocol error on incoming trunk connection from "
+         << con->remoteHost() << ":" << con->remotePort() << endl;
+    rejectConnection(con, "Protocol error");
+    return;
+  }
+
+  for (const auto& trunk : m_trunks)
+  {
+    if (trunk->peerId() == hello.id())
+    {
+      if (!trunk->verifyPeerCertificate(con))
+      {
+        rejectConnection(con, "Access denied");
+        return;
+      }
+        // The connection must be routed to the trunk before it is accepted
+        // since the handshake may fail and close the connection directly
+      m_cons[con] = trunk;
+      if (!trunk->acceptConnection(con, hello))
+      {
+        m_cons[con] = 0;
+        cerr << "*** WARNING: Trunk " << trunk->name()
+             << ": Rejecting incoming connection from "
+             << con->remoteHost() << ":" << con->remotePort()
+             << " since the trunk is already connected" << endl;
+        rejectConnection(con, "Trunk already connected");
+      }
+      return;
+    }
+  }
+
+  cerr << "*** WARNING: Incoming trunk connection from unknown peer \""
+       << hello.id() << "\" at " << con->remoteHost() << ":"
+       << con->remotePort() << endl;
+  rejectConnection(con, "Unknown trunk peer");
+} /* TrunkHandler::acceptConnection */
+
+
+void TrunkHandler::rejectConnection(Async::FramedTcpConnection *con,
+                                    const std::string& msg)
+{
+  MsgError err(msg);
+  std::ostringstream ss;
+  ReflectorMsg header(err.type());
+  if (header.pack(ss) && err.pack(ss))
+  {
+    con->write(ss.str().data(), ss.str().size());
+  }
+  con->disconnect();
+  con->disconnected(con, FramedTcpConnection::DR_ORDERED_DISCONNECT);
+} /* TrunkHandler::rejectConnection */
+
+
+bool TrunkHandler::onVerifyPeer(Async::TcpConnection *con, bool preverify_ok,
+                                X509_STORE_CTX *x509_store_ctx)
+{
+  Async::SslX509 cert(*x509_store_ctx);
+  preverify_ok = preverify_ok && !cert.isNull();
+  if (!preverify_ok)
+  {
+    cerr << "*** ERROR: Certificate verification failed for incoming trunk "
+            "connection from " << con->remoteHost() << ":"
+         << con->remotePort() << endl;
+    cout << "------------- Peer Certificate --------------" << endl;
+    cert.print();
+    cout << "---------------------------------------------" << endl;
+  }
+  return preverify_ok;
+} /* TrunkHandler::onVerifyPeer */
+
+
+void TrunkHandler::sendSummary(void)
+{
+  m_summary_pending = false;
+  sendToAll(MsgTrunkTgSummary(m_local_tgs));
+} /* TrunkHandler::sendSummary */
+
+
+void TrunkHandler::sendToAll(const ReflectorMsg& msg)
+{
+  for (const auto& trunk : m_trunks)
+  {
+    trunk->sendMsg(msg);
+  }
+} /* TrunkHandler::sendToAll */
+
+
+void TrunkHandler::setRemoteTalker(uint32_t tg, ReflectorTrunk *trunk,
+                                   const std::string& callsign)
+{
+  std::string old_callsign;
+  auto it = m_remote_talkers.find(tg);
+  if (it != m_remote_talkers.end())
+  {
+    old_callsign = it->second.callsign;
+  }
+  RemoteTalker& talker = m_remote_talkers[tg];
+  talker.trunk = trunk;
+  talker.callsign = callsign;
+  gettimeofday(&talker.last_audio, NULL);
+  m_talker_timer.setEnable(true);
+  remoteTalkerUpdated(tg, old_callsign, callsign);
+} /* TrunkHandler::setRemoteTalker */
+
+
+void TrunkHandler::clearRemoteTalker(uint32_t tg)
+{
+  auto it = m_remote_talkers.find(tg);
+  if (it == m_remote_talkers.end())
+  {
+    return;
+  }
+  std::string callsign = it->second.callsign;
+  m_remote_talkers.erase(it);
+  if (m_remote_talkers.empty())
+  {
+    m_talker_timer.setEnable(false);
+  }
+  remoteTalkerUpdated(tg, callsign, "");
+} /* TrunkHandler::clearRemoteTalker */
+
+
+void TrunkHandler::checkTalkerTimeouts(Async::Timer *t)
+{
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  std::vector<uint32_t> timed_out;
+  for (const auto& item : m_remote_talkers)
+  {
+    struct timeval diff;
+    timersub(&now, &item.second.last_audio, &diff);
+    if (diff.tv_sec > TALKER_AUDIO_TIMEOUT)
+    {
+      cout << item.second.callsign << ": Trunk talker audio timeout on TG #"
+           << item.first << endl;
+      timed_out.push_back(item.first);
+    }
+  }
+  for (const auto& tg : timed_out)
+  {
+    clearRemoteTalker(tg);
+  }
+} /* TrunkHandler::checkTalkerTimeouts */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,349 @@
+/**
+@file   TrunkHandler.h
+@brief  Handle the trunks to other reflector servers
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef TRUNK_HANDLER_INCLUDED
+#define TRUNK_HANDLER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <sys/time.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTcpServer.h>
+#include <AsyncFramedTcpConnection.h>
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class Config;
+};
+
+class ReflectorTrunk;
+class ReflectorMsg;
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Handle the trunks to other reflector servers
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+Trunks make it possible to spread the nodes of a network over more than one
+reflector server. The reflectors must be connected in a full mesh, that is
+each reflector must have a trunk to every other reflector in the network.
+Nothing received on a trunk is ever sent out on another trunk so there can
+be no loops.
+
+This class keep track of the talkers on the other reflectors and decide who
+is allowed to talk when two reflectors get a talker on the same talk group at
+the same time. The talker on the reflector with the lowest trunk id win. Both
+sides of a trunk see both talkers so they come to the same conclusion without
+any extra negotiation.
+
+Audio from a local talker is sent once over each trunk where the peer have
+clients on the talk group.
+
+All trunk connections are encrypted using TLS. The server certificate of the
+reflector is used on both incoming and outgoing connections and the peer must
+present a certificate that can be verified using the CA bundle.
+*/
+class TrunkHandler : public sigc::trackable
+{
+  public:
+    static const uint16_t DEFAULT_PORT = 5302;
+
+    /**
+     * @brief   Default constructor
+     */
+    TrunkHandler(void);
+
+    /**
+     * @brief   Destructor
+     */
+    ~TrunkHandler(void);
+
+    /**
+     * @brief   Initialize the trunks
+     * @param   cfg A previously initialized configuration object
+     * @param   ssl_ctx The TLS context to use for the trunk connections
+     * @return  Returns \em true on success or else \em false
+     *
+     * Nothing is done if no trunks are configured. The TLS context must
+     * have the server certificate and the CA bundle loaded.
+     */
+    bool initialize(Async::Config &cfg, Async::SslContext& ssl_ctx);
+
+    /**
+     * @brief   Get the trunk id of this reflector
+     * @return  Returns the trunk id
+     */
+    const std::string& localId(void) const { return m_local_id; }
+
+    /**
+     * @brief   Get the number of configured trunks
+     * @return  Returns the number of trunks
+     */
+    size_t size(void) const { return m_trunks.size(); }
+
+    /**
+     * @brief   Get the number of trunks that are up
+     * @return  Returns the number of connected and authenticated trunks
+     */
+    size_t connectedCount(void) const;
+
+    /**
+     * @brief   Set if a talk group is used by local clients
+     * @param   tg The talk group
+     * @param   used \em true if at least one local client use the talk group
+     *
+     * The summary of used talk groups is sent to the peers once the current
+     * main loop iteration is done so that many changes are sent together.
+     */
+    void setLocalTGUsed(uint32_t tg, bool used);
+
+    /**
+     * @brief   Tell the peers that a local client has started talking
+     * @param   tg The talk group
+     * @param   callsign The callsign of the talker
+     */
+    void localTalkerStart(uint32_t tg, const std::string& callsign);
+
+    /**
+     * @brief   Tell the peers that a local client has stopped talking
+     * @param   tg The talk group
+     * @param   callsign The callsign of the talker
+     */
+    void localTalkerStop(uint32_t tg, const std::string& callsign);
+
+    /**
+     * @brief   Send audio from a local talker to the peers
+     * @param   tg The talk group
+     * @param   audio The encoded audio
+     *
+     * The audio is sent once on each trunk where the peer have clients on
+     * the talk group.
+     */
+    void localAudio(uint32_t tg, const std::vector<uint8_t>& audio);
+
+    /**
+     * @brief   Get the talker on another reflector
+     * @param   tg The talk group
+     * @return  Returns the callsign of the talker or an empty string
+     */
+    const std::string& remoteTalkerForTG(uint32_t tg) const;
+
+    /**
+     * @brief   A signal that is emitted when a remote talker change
+     * @param   tg The talk group
+     * @param   old_callsign The old talker or empty if there was none
+     * @param   new_callsign The new talker or empty if there is none
+     */
+    sigc::signal<void(uint32_t, const std::string&,
+                      const std::string&)> remoteTalkerUpdated;
+
+    /**
+     * @brief   A signal that is emitted when audio is received from a peer
+     * @param   tg The talk group
+     * @param   audio The encoded audio
+     */
+    sigc::signal<void(uint32_t, const std::vector<uint8_t>&)>
+      remoteAudioReceived;
+
+    /**
+     * @brief   A signal that is emitted when a local talker lose to a remote
+     * @param   tg The talk group
+     *
+     * The local talker must be stopped by the receiver of the signal. The
+     * remote talker is set up when the signal returns.
+     */
+    sigc::signal<void(uint32_t)> localTalkerPreempted;
+
+    /**
+     * @brief   Called by a trunk when it has been authenticated
+     * @param   trunk The trunk
+     */
+    void trunkConnected(ReflectorTrunk *trunk);
+
+    /**
+     * @brief   Called by a trunk when it has gone down
+     * @param   trunk The trunk
+     */
+    void trunkDisconnected(ReflectorTrunk *trunk);
+
+    /**
+     * @brief   Called by a trunk when a peer talker has started talking
+     * @param   trunk The trunk
+     * @param   tg The talk group
+     * @param   callsign The callsign of the talker
+     */
+    void remoteTalkerStart(ReflectorTrunk *trunk, uint32_t tg,
+                           const std::string& callsign);
+
+    /**
+     * @brief   Called by a trunk when a peer talker has stopped talking
+     * @param   trunk The trunk
+     * @param   tg The talk group
+     * @param   callsign The callsign of the talker
+     */
+    void remoteTalkerStop(ReflectorTrunk *trunk, uint32_t tg,
+                          const std::string& callsign);
+
+    /**
+     * @brief   Called by a trunk when audio has been received
+     * @param   trunk The trunk
+     * @param   tg The talk group
+     * @param   audio The encoded audio
+     */
+    void remoteAudio(ReflectorTrunk *trunk, uint32_t tg,
+                     const std::vector<uint8_t>& audio);
+
+  private:
+    using FramedTcpServer = Async::TcpServer<Async::FramedTcpConnection>;
+
+    static const time_t TALKER_AUDIO_TIMEOUT = 3; // Max three seconds gap
+
+    struct RemoteTalker
+    {
+      ReflectorTrunk*   trunk;
+      std::string       callsign;
+      struct timeval    last_audio;
+    };
+    typedef std::map<Async::FramedTcpConnection*, ReflectorTrunk*> ConMap;
+
+    std::string                       m_local_id;
+    FramedTcpServer*                  m_srv;
+    ConMap                            m_cons;
+    std::vector<ReflectorTrunk*>      m_trunks;
+    std::set<uint32_t>                m_local_tgs;
+    bool                              m_summary_pending;
+    std::map<uint32_t, std::string>   m_local_talkers;
+    std::map<uint32_t, RemoteTalker>  m_remote_talkers;
+    Async::Timer                      m_talker_timer;
+
+    TrunkHandler(const TrunkHandler&);
+    TrunkHandler& operator=(const TrunkHandler&);
+    void clientConnected(Async::FramedTcpConnection *con);
+    void clientDisconnected(Async::FramedTcpConnection *con,
+        Async::FramedTcpConnection::DisconnectReason reason);
+    void onFrameReceived(Async::FramedTcpConnection *con,
+                         std::vector<uint8_t>& data);
+    void acceptConnection(Async::FramedTcpConnection *con,
+                          std::vector<uint8_t>& data);
+    void rejectConnection(Async::FramedTcpConnection *con,
+                          const std::string& msg);
+    bool onVerifyPeer(Async::TcpConnection *con, bool preverify_ok,
+                      X509_STORE_CTX *x509_store_ctx);
+    void sendSummary(void);
+    void sendToAll(const ReflectorMsg& msg);
+    void setRemoteTalker(uint32_t tg, ReflectorTrunk *trunk,
+                         const std::string& callsign);
+    void clearRemoteTalker(uint32_t tg);
+    void checkTalkerTimeouts(Async::Timer *t);
+
+};  /* class TrunkHandler */
+
+
+//} /* namespace */
+
+#endif /* TRUNK_HANDLER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,462 @@
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <functional>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+#include <AsyncSslContext.h>
+#include <AsyncSslKeypair.h>
+#include <AsyncSslX509.h>
+#include <AsyncSslX509Extensions.h>
+
+#include "TrunkHandler.h"
+#include "TGHandler.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Test of the reflector trunks on localhost.
+ *
+ * Usage: TrunkTest [frames]
+ *
+ * Three reflectors, A, B and C, are set up in one process with trunks in a
+ * full mesh. Only the trunk handling of each reflector is used. The clients
+ * are simulated by telling the trunk handler which talk groups that are in
+ * use and by starting and stopping talkers the same way that the reflector
+ * do it. For reflector B, the use of talk group 500 is instead tracked by the
+ * TGHandler, to check that a talk group with only monitoring clients is
+ * announced to the peers. The test check that audio only is sent over trunks
+ * where the peer have clients on the talk group, that audio is never
+ * delivered more than once, that talker conflicts are resolved the same way
+ * on all reflectors and that remote talkers are removed when a trunk goes
+ * down.
+ *
+ * The trunks run over TLS using certificates from a CA created by the test.
+ * Two more reflectors, D and E, try to set up trunks to A. D connect to A
+ * using a certificate issued by another CA. A connect to E, which use a
+ * certificate issued for the host name of C.
+ */
+
+namespace {
+const uint16_t BASE_PORT = 15500;
+
+std::string hostname(const std::string& id)
+{
+  return std::string(1, tolower(id[0])) + ".trunk.test";
+}
+
+class TestCa
+{
+  public:
+    TestCa(const std::string& dir, const std::string& name)
+      : m_dir(dir), m_name(name)
+    {
+      m_pkey.generate(2048);
+      m_cert.setSerialNumber();
+      m_cert.setVersion(SslX509::VERSION_3);
+      m_cert.addIssuerName("CN", name);
+      m_cert.setSubjectName(m_cert.issuerName());
+      SslX509Extensions exts;
+      exts.addBasicConstraints("critical, CA:TRUE");
+      exts.addKeyUsage("critical, cRLSign, digitalSignature, keyCertSign");
+      m_cert.addExtensions(exts);
+      m_cert.setValidityTime(1);
+      m_cert.setPublicKey(m_pkey);
+      m_cert.sign(m_pkey);
+      m_cert.writePemFile(caFile());
+    }
+
+    std::string caFile(void) const { return m_dir + "/" + m_name + ".crt"; }
+
+      // Issue a certificate like the server certificate of the reflector
+    bool issue(const std::string& file_base, const std::string& host)
+    {
+      SslKeypair pkey;
+      SslX509 cert;
+      if (!pkey.generate(2048))
+      {
+        return false;
+      }
+      cert.setSerialNumber();
+      cert.setVersion(SslX509::VERSION_3);
+      cert.setIssuerName(m_cert.subjectName());
+      cert.addSubjectName("CN", host);
+      SslX509Extensions exts;
+      exts.addBasicConstraints("critical, CA:FALSE");
+      exts.addKeyUsage(
+          "critical, digitalSignature, keyEncipherment, keyAgreement");
+      exts.addExtKeyUsage("serverAuth, clientAuth");
+      exts.addSubjectAltNames("DNS:" + host);
+      cert.addExtensions(exts);
+      cert.setValidityTime(1);
+      cert.setPublicKey(pkey);
+      cert.sign(m_pkey);
+      return pkey.writePrivateKeyFile(file_base + ".key") &&
+             cert.writePemFile(file_base + ".crt");
+    }
+
+  private:
+    std::string m_dir;
+    std::string m_name;
+    SslKeypair  m_pkey;
+    SslX509     m_cert;
+};
+
+class Node : public sigc::trackable
+{
+  public:
+    std::string                 id;
+    bool                        connect_all = false;
+    SslContext                  ssl_ctx;
+    TrunkHandler                trunks;
+    std::map<uint32_t, unsigned> clients;
+    std::map<uint32_t, std::string> local_talkers;
+    std::map<uint32_t, std::string> remote_talkers;
+    std::map<uint32_t, unsigned> rx_frames;
+
+    Node(const std::string& id) : id(id)
+    {
+      trunks.remoteTalkerUpdated.connect(
+          mem_fun(*this, &Node::onRemoteTalkerUpdated));
+      trunks.remoteAudioReceived.connect(
+          mem_fun(*this, &Node::onRemoteAudioReceived));
+      trunks.localTalkerPreempted.connect(
+          mem_fun(*this, &Node::onLocalTalkerPreempted));
+    }
+
+    bool initialize(const std::vector<std::string>& peers, TestCa& issuer,
+                    const std::string& cert_host, const TestCa& trusted,
+                    const std::string& dir)
+    {
+      std::string file_base = dir + "/" + id;
+      if (!issuer.issue(file_base, cert_host) ||
+          !ssl_ctx.setCertificateFiles(file_base + ".key",
+                                       file_base + ".crt") ||
+          !ssl_ctx.setCaCertificateFile(trusted.caFile()))
+      {
+        cerr << "*** ERROR: Failed to set up the certificate for " << id
+             << endl;
+        return false;
+      }
+      cfg.setValue("GLOBAL", "TRUNK_ID", id);
+      cfg.setValue("GLOBAL", "TRUNK_LISTEN_PORT", port(id));
+      std::string sections;
+      for (const auto& peer : peers)
+      {
+        std::string section = "TRUNK_" + peer;
+        sections += (sections.empty() ? "" : ",") + section;
+        cfg.setValue(section, "PEER_ID", peer);
+        cfg.setValue(section, "SECRET", "secret");
+        cfg.setValue(section, "PEER_HOSTNAME", hostname(peer));
+          // The reflector with the lowest id connect
+        if ((id < peer) || connect_all)
+        {
+          cfg.setValue(section, "HOST", "127.0.0.1");
+          cfg.setValue(section, "PORT", port(peer));
+        }
+      }
+      cfg.setValue("GLOBAL", "TRUNKS", sections);
+      return trunks.initialize(cfg, ssl_ctx);
+    }
+
+    void join(uint32_t tg, unsigned cnt=1)
+    {
+      if (clients[tg] == 0)
+      {
+        trunks.setLocalTGUsed(tg, true);
+      }
+      clients[tg] += cnt;
+    }
+
+      // Mirror what the reflector do when a client start sending audio
+    bool talk(uint32_t tg, const std::string& callsign)
+    {
+      if (!trunks.remoteTalkerForTG(tg).empty() ||
+          (local_talkers.count(tg) > 0))
+      {
+        return false;
+      }
+      local_talkers[tg] = callsign;
+      trunks.localTalkerStart(tg, callsign);
+      return true;
+    }
+
+    void sendAudio(uint32_t tg, unsigned frames)
+    {
+      if (local_talkers.count(tg) == 0)
+      {
+        return;
+      }
+      std::vector<uint8_t> frame(60, 0xa5);
+      for (unsigned i=0; i<frames; ++i)
+      {
+        trunks.localAudio(tg, frame);
+      }
+    }
+
+    void stopTalking(uint32_t tg)
+    {
+      auto it = local_talkers.find(tg);
+      if (it != local_talkers.end())
+      {
+        std::string callsign = it->second;
+        local_talkers.erase(it);
+        trunks.localTalkerStop(tg, callsign);
+      }
+    }
+
+  private:
+    Config cfg;
+
+    static std::string port(const std::string& id)
+    {
+      return std::to_string(BASE_PORT + (id[0] - 'A'));
+    }
+
+    void onRemoteTalkerUpdated(uint32_t tg, const std::string&,
+                               const std::string& new_callsign)
+    {
+      if (new_callsign.empty())
+      {
+        remote_talkers.erase(tg);
+      }
+      else
+      {
+        remote_talkers[tg] = new_callsign;
+      }
+    }
+
+    void onRemoteAudioReceived(uint32_t tg, const std::vector<uint8_t>&)
+    {
+      rx_frames[tg] += 1;
+    }
+
+    void onLocalTalkerPreempted(uint32_t tg)
+    {
+      stopTalking(tg);
+    }
+};
+
+int failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+  printf("%-4s %s\n", ok ? "ok" : "FAIL", what.c_str());
+  if (!ok)
+  {
+    ++failures;
+  }
+}
+
+std::string talkerOn(const Node& node, uint32_t tg)
+{
+  auto it = node.remote_talkers.find(tg);
+  return (it != node.remote_talkers.end()) ? it->second : "";
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned frames = 100;
+  if (argc > 1)
+  {
+    frames = atoi(argv[1]);
+  }
+  if (frames < 1)
+  {
+    cerr << "Usage: TrunkTest [frames]\n";
+    exit(1);
+  }
+
+  CppApplication app;
+  char dir_template[] = "/tmp/TrunkTestXXXXXX";
+  const char *dir = mkdtemp(dir_template);
+  if (dir == nullptr)
+  {
+    perror("mkdtemp");
+    exit(1);
+  }
+  TestCa ca(dir, "ca");
+  TestCa rogue_ca(dir, "rogue_ca");
+  Config tg_cfg;
+  TGHandler *tg_handler = TGHandler::instance();
+  tg_handler->setConfig(&tg_cfg);
+    // The clients are only used as keys so any unique address will do
+  char client_storage[2];
+  ReflectorClient *b_monitor =
+    reinterpret_cast<ReflectorClient*>(&client_storage[0]);
+  ReflectorClient *b_client =
+    reinterpret_cast<ReflectorClient*>(&client_storage[1]);
+
+  Node *a = new Node("A");
+  Node *b = new Node("B");
+  Node *c = new Node("C");
+  Node *d = new Node("D");
+  Node *e = new Node("E");
+  d->connect_all = true;
+    // Start listening before connecting to avoid waiting for reconnects
+  if (!c->initialize({"A", "B"}, ca, hostname("C"), ca, dir) ||
+      !b->initialize({"A", "C"}, ca, hostname("B"), ca, dir) ||
+      !e->initialize({"A"}, ca, hostname("C"), ca, dir) ||
+      !a->initialize({"B", "C", "D", "E"}, ca, hostname("A"), ca, dir) ||
+      !d->initialize({"A"}, rogue_ca, hostname("D"), ca, dir))
+  {
+    exit(1);
+  }
+  tg_handler->tgUsageChanged.connect(
+      mem_fun(b->trunks, &TrunkHandler::setLocalTGUsed));
+
+    // Each step is run when the messages from the previous step have had
+    // time to reach the other reflectors
+  std::vector<std::function<void()>> steps;
+  steps.push_back([&]()
+  {
+    check((a->trunks.connectedCount() == 2) &&
+          (b->trunks.connectedCount() == 2) &&
+          (c->trunks.connectedCount() == 2), "All trunks up");
+    check(d->trunks.connectedCount() == 0,
+          "D with a certificate from an unknown CA not connected");
+    check(e->trunks.connectedCount() == 0,
+          "E with a certificate for the host of C not connected");
+    a->join(100, 5);
+    b->join(100, 10);
+    c->join(300, 3);
+  });
+  steps.push_back([&]()
+  {
+    check(a->talk(100, "SM0AAA"), "A get talker on TG 100");
+    a->sendAudio(100, frames);
+  });
+  steps.push_back([&]()
+  {
+    check(talkerOn(*b, 100) == "SM0AAA", "B see talker SM0AAA on TG 100");
+    check(talkerOn(*c, 100) == "SM0AAA", "C see talker SM0AAA on TG 100");
+    check(b->rx_frames[100] == frames,
+          "B got " + std::to_string(b->rx_frames[100]) + " of " +
+          std::to_string(frames) + " frames, one copy for 10 clients");
+    check(c->rx_frames[100] == 0, "C with no clients on TG 100 got no audio");
+    check(!b->talk(100, "SM0BBB"), "B cannot talk over remote talker");
+    a->stopTalking(100);
+  });
+  steps.push_back([&]()
+  {
+    check(talkerOn(*b, 100).empty() && talkerOn(*c, 100).empty(),
+          "Talker stop seen by B and C");
+      // B and C start talking on the same TG before they know about
+      // each other
+    b->join(300);
+    check(b->talk(300, "SM0BBB") && c->talk(300, "SM0CCC"),
+          "B and C both get local talker on TG 300");
+  });
+  steps.push_back([&]()
+  {
+    check((b->local_talkers.count(300) == 1) && talkerOn(*b, 300).empty(),
+          "B keep its talker on TG 300");
+    check((c->local_talkers.count(300) == 0) &&
+          (talkerOn(*c, 300) == "SM0BBB"), "C preempted by B on TG 300");
+    check(talkerOn(*a, 300) == "SM0BBB", "A see SM0BBB as talker on TG 300");
+    a->join(300);
+    c->sendAudio(300, frames);
+  });
+  steps.push_back([&]()
+  {
+    check(a->rx_frames[300] == 0, "Audio from preempted talker dropped");
+    b->sendAudio(300, frames);
+  });
+  steps.push_back([&]()
+  {
+    check((a->rx_frames[300] == frames) && (c->rx_frames[300] == frames),
+          "A and C got each frame from B exactly once");
+    check(b->rx_frames[300] == 0, "No audio looped back to B");
+    b->stopTalking(300);
+    tg_handler->setMonitoredTGs(b_monitor, {500});
+  });
+  steps.push_back([&]()
+  {
+    check(a->talk(500, "SM0AAA"), "A get talker on TG 500");
+    a->sendAudio(500, frames);
+  });
+  steps.push_back([&]()
+  {
+    check(b->rx_frames[500] == frames,
+          "B with only a monitoring client on TG 500 got the audio");
+    check(c->rx_frames[500] == 0, "C with no clients on TG 500 got no audio");
+    a->stopTalking(500);
+      // A client selecting and leaving the talk group must not make it
+      // unused while the monitor is still there
+    tg_handler->switchTo(b_client, 500);
+    tg_handler->switchTo(b_client, 0);
+  });
+  steps.push_back([&]()
+  {
+    check(a->talk(500, "SM0AAA"), "A get talker on TG 500 again");
+    a->sendAudio(500, frames);
+  });
+  steps.push_back([&]()
+  {
+    check(b->rx_frames[500] == 2 * frames,
+          "B still get audio on TG 500 after a selecting client left");
+    a->stopTalking(500);
+    tg_handler->removeClient(b_monitor);
+  });
+  steps.push_back([&]()
+  {
+    check(a->talk(500, "SM0AAA"), "A get talker on TG 500 a third time");
+    a->sendAudio(500, frames);
+  });
+  steps.push_back([&]()
+  {
+    check(b->rx_frames[500] == 2 * frames,
+          "B got no audio on TG 500 after the monitor left");
+    a->stopTalking(500);
+    check(c->talk(400, "SM0CCC"), "C get talker on TG 400");
+  });
+  steps.push_back([&]()
+  {
+    check(talkerOn(*a, 400) == "SM0CCC", "A see SM0CCC on TG 400");
+    delete c;
+    c = 0;
+  });
+  steps.push_back([&]()
+  {
+    check(talkerOn(*a, 400).empty() && talkerOn(*b, 400).empty(),
+          "Remote talker removed when trunk to C went down");
+    check((a->trunks.connectedCount() == 1) &&
+          (b->trunks.connectedCount() == 1), "Trunk A-B still up");
+  });
+
+  size_t step = 0;
+  Timer step_timer(300, Timer::TYPE_PERIODIC);
+  step_timer.expired.connect([&](Timer*)
+  {
+    if (step < steps.size())
+    {
+      steps[step++]();
+    }
+    else
+    {
+      app.quit();
+    }
+  });
+  app.exec();
+
+  delete e;
+  delete d;
+  delete c;
+  delete b;
+  delete a;
+
+  std::system((std::string("rm -rf ") + dir).c_str());
+
+  printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+} /* main */
@@ -10,7 +10,7 @@ server core (e.g. via a TCP/IP network).
 
 \verbatim
 RemoteTrx - A remote receiver for the SvxLink server
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -66,6 +66,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncConfig.h>
 #include <AsyncFdWatch.h>
 #include <AsyncAudioIO.h>
+#include <AsyncMetricsHttpServer.h>
 #include <Rx.h>
 #include <Tx.h>
 #include <common.h>
@@ -488,6 +489,13 @@ int main(int argc, char **argv)
     stdin_watch->activity.connect(sigc::ptr_fun(&stdinHandler));
   }
   
+  Async::MetricsHttpServer* metrics_server = nullptr;
+  std::string metrics_port;
+  if (cfg.getValue("GLOBAL", "METRICS_HTTP_PORT", metrics_port))
+  {
+    metrics_server = new Async::MetricsHttpServer(metrics_port);
+  }
+
   NetRxAdapterFactory net_rx_adapter_factory;
   NetTxAdapterFactory net_tx_adapter_factory;
 
@@ -534,6 +542,8 @@ int main(int argc, char **argv)
   }
   trx_handlers.clear();
 
+  delete metrics_server;
+
   if (stdin_watch != 0)
   {
     delete stdin_watch;
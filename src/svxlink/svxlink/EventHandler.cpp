@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <chrono>
 
 
 /****************************************************************************
@@ -144,6 +145,8 @@ EventHandler::EventHandler(const string& event_script, const string& logic_name)
   Tcl_CreateCommand(interp, "playTone", playToneHandler, this, NULL);
   Tcl_CreateCommand(interp, "recordStart", recordHandler, this, NULL);
   Tcl_CreateCommand(interp, "recordStop", recordHandler, this, NULL);
+  Tcl_CreateCommand(interp, "beginBatch", batchHandler, this, NULL);
+  Tcl_CreateCommand(interp, "endBatch", batchHandler, this, NULL);
   Tcl_CreateCommand(interp, "deactivateModule", deactivateModuleHandler,
                     this, NULL);
   Tcl_CreateCommand(interp, "publishStateEvent", publishStateEventHandler,
@@ -231,7 +234,26 @@ bool EventHandler::processEvent(const string& event)
     return false;
   }
   
+    // The time used by each event is measured per Tcl namespace, that is
+    // per logic or module, e.g. "SimplexLogic::Parrot"
+  std::string scope("global");
+  std::string::size_type scope_end = event.rfind("::", event.find(' '));
+  if (scope_end != std::string::npos)
+  {
+    scope = event.substr(0, scope_end);
+  }
+  Async::Metrics::Histogram*& hist = event_time[scope];
+  if (hist == nullptr)
+  {
+    hist = &Async::Metrics::instance().histogram(
+        "svxlink_tcl_event_seconds",
+        "Time used to handle events in the Tcl event handler",
+        Async::Metrics::exponentialBuckets(0.0001, 4.0, 8),
+        {{"scope", scope}});
+  }
+
   bool success = true;
+  auto start = std::chrono::steady_clock::now();
   Tcl_Preserve(interp);
   if (Tcl_Eval(interp, (event + ";").c_str()) != TCL_OK)
   {
@@ -241,6 +263,9 @@ bool EventHandler::processEvent(const string& event)
     success = false;
   }
   Tcl_Release(interp);
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  hist->observe(elapsed.count());
   
   return success;
   
@@ -384,6 +409,33 @@ int EventHandler::recordHandler(ClientData cdata, Tcl_Interp *irp,
 }
 
 
+int EventHandler::batchHandler(ClientData cdata, Tcl_Interp *irp,
+      	      	      	      int argc, const char *argv[])
+{
+  if(argc != 1)
+  {
+    static char begin_msg[] = "Usage: beginBatch";
+    static char end_msg[] = "Usage: endBatch";
+    Tcl_SetResult(irp, (strcmp(argv[0], "beginBatch") == 0) ? begin_msg
+                                                            : end_msg,
+                  TCL_STATIC);
+    return TCL_ERROR;
+  }
+
+  EventHandler *self = static_cast<EventHandler *>(cdata);
+  if (strcmp(argv[0], "beginBatch") == 0)
+  {
+    self->beginBatch();
+  }
+  else
+  {
+    self->endBatch();
+  }
+
+  return TCL_OK;
+}
+
+
 int EventHandler::deactivateModuleHandler(ClientData cdata, Tcl_Interp *irp,
       	      	      	      int argc, const char *argv[])
 {
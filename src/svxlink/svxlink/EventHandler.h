@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -40,6 +40,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <sstream>
 #include <functional>
+#include <map>
 
 
 /****************************************************************************
@@ -48,6 +49,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncMetrics.h>
 
 
 /****************************************************************************
@@ -219,6 +221,18 @@ class EventHandler : public sigc::trackable
      */
     sigc::signal<void(const std::string&, int, int)> playDtmf;
 
+    /**
+     * @brief 	A signal that is emitted when the TCL script want to start
+     *	      	collecting played items into a batch
+     */
+    sigc::signal<void()> beginBatch;
+
+    /**
+     * @brief 	A signal that is emitted when the TCL script want to render
+     *	      	and play the batch of collected items
+     */
+    sigc::signal<void()> endBatch;
+
     /**
      * @brief 	A signal that is emitted when the TCL script want to start
      *	      	a recording
@@ -278,9 +292,12 @@ class EventHandler : public sigc::trackable
   protected:
 
   private:
+    using EventTimeMap = std::map<std::string, Async::Metrics::Histogram*>;
+
     std::string   event_script;
     std::string   logic_name;
     Tcl_Interp *  interp;
+    EventTimeMap  event_time;
 
     static int playFileHandler(ClientData cdata, Tcl_Interp *irp,
       	      	    int argc, const char *argv[]);
@@ -290,6 +307,8 @@ class EventHandler : public sigc::trackable
       	      	    int argc, const char *argv[]);
     static int recordHandler(ClientData cdata, Tcl_Interp *irp,
       	      	    int argc, const char *argv[]);
+    static int batchHandler(ClientData cdata, Tcl_Interp *irp,
+      	      	    int argc, const char *argv[]);
     static int deactivateModuleHandler(ClientData cdata, Tcl_Interp *irp,
       	      	    int argc, const char *argv[]);
     static int publishStateEventHandler(ClientData cdata, Tcl_Interp *irp,
@@ -10,7 +10,7 @@ specific logic core classes (e.g. SimplexLogic and RepeaterLogic).
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -60,6 +60,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <AsyncConfig.h>
 #include <AsyncTimer.h>
+#include <AsyncApplication.h>
 #include <Rx.h>
 #include <Tx.h>
 #include "SvxStats.h"
@@ -632,6 +633,8 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
   event_handler->publishStateEvent.connect(
           mem_fun(*this, &Logic::onPublishStateEvent));
   event_handler->playDtmf.connect(mem_fun(*this, &Logic::playDtmf));
+  event_handler->beginBatch.connect(mem_fun(*this, &Logic::beginBatch));
+  event_handler->endBatch.connect(mem_fun(*this, &Logic::endBatch));
   event_handler->injectDtmf.connect(mem_fun(*this, &Logic::injectDtmf));
   event_handler->getConfigValue.connect(
           sigc::mem_fun(*this, &Logic::getConfigValue));
@@ -841,6 +844,25 @@ void Logic::playDtmf(const std::string& digits, int amp, int len)
 } /* Logic::playDtmf */
 
 
+void Logic::beginBatch(void)
+{
+  msg_handler->beginBatch();
+} /* Logic::beginBatch */
+
+
+void Logic::endBatch(void)
+{
+  msg_handler->endBatch();
+
+  if (!msg_handler->isIdle())
+  {
+    updateTxCtcss(true, TX_CTCSS_ANNOUNCEMENT);
+  }
+
+  checkIdle();
+} /* Logic::endBatch */
+
+
 void Logic::recordStart(const string& filename, unsigned max_time)
 {
   recordStop();
@@ -1706,7 +1728,7 @@ void Logic::sendRgrSound(void)
 void Logic::timeoutNextMinute(void)
 {
   struct timeval tv;
-  gettimeofday(&tv, NULL);
+  Application::app().getTimeOfDay(&tv);
   struct tm tm;
   localtime_r(&tv.tv_sec, &tm);
   tm.tm_min += 1;
@@ -1725,7 +1747,7 @@ void Logic::everyMinute(AtTimer *t)
 void Logic::timeoutNextSecond(void)
 {
   struct timeval tv;
-  gettimeofday(&tv, NULL);
+  Application::app().getTimeOfDay(&tv);
   struct tm tm;
   localtime_r(&tv.tv_sec, &tm);
   tm.tm_sec += 1;
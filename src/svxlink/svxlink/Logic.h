@@ -10,7 +10,7 @@ specific logic core classes (e.g. SimplexLogic and RepeaterLogic).
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2004-2025  Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026  Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -173,6 +173,8 @@ class Logic : public LogicBase
     virtual void playSilence(int length);
     virtual void playTone(int fq, int amp, int len);
     virtual void playDtmf(const std::string& digits, int amp, int len);
+    void beginBatch(void);
+    void endBatch(void);
     void recordStart(const std::string& filename, unsigned max_time);
     void recordStop(void);
     void injectDtmf(const std::string& digits, int len);
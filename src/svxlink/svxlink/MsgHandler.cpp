@@ -8,7 +8,7 @@ This file contains an object that handles the playback of audio clips.
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2015 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -38,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <dirent.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <math.h>
@@ -52,6 +53,11 @@ extern "C" {
 #include <cstring>
 #include <fstream>
 #include <cerrno>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
 
 
 
@@ -108,6 +114,8 @@ class QueueItem
     virtual bool initialize(void) { return true; }
     virtual int readSamples(float *samples, int len) = 0;
     virtual void unreadSamples(int len) = 0;
+      // An estimate of the number of samples left to read. Zero if unknown.
+    virtual size_t samplesLeft(void) const { return 0; }
     
     bool idleMarked(void) const { return idle_marked; }
   
@@ -123,6 +131,7 @@ class SilenceQueueItem : public QueueItem
       	silence_left(sample_rate * len / 1000) {}
     int readSamples(float *samples, int len);
     void unreadSamples(int len);
+    size_t samplesLeft(void) const { return max(silence_left, 0); }
 
   private:
     int len;
@@ -138,6 +147,7 @@ class ToneQueueItem : public QueueItem
       	tone_len(sample_rate * len / 1000), pos(0), sample_rate(sample_rate) {}
     int readSamples(float *samples, int len);
     void unreadSamples(int len);
+    size_t samplesLeft(void) const { return max(tone_len - pos, 0); }
 
   private:
     int fq;
@@ -157,6 +167,7 @@ class DtmfQueueItem : public QueueItem
         tone_len(sample_rate * len / 1000), pos(0), sample_rate(sample_rate) {}
     int readSamples(float *samples, int len);
     void unreadSamples(int len);
+    size_t samplesLeft(void) const { return max(tone_len - pos, 0); }
 
   private:
     int fqh;
@@ -177,6 +188,7 @@ class RawFileQueueItem : public QueueItem
     bool initialize(void);
     int readSamples(float *samples, int len);
     void unreadSamples(int len);
+    size_t samplesLeft(void) const;
 
   private:
     string  filename;
@@ -194,6 +206,7 @@ class GsmFileQueueItem : public QueueItem
     bool initialize(void);
     int readSamples(float *samples, int len);
     void unreadSamples(int len);
+    size_t samplesLeft(void) const;
 
   private:
     static const int BUFSIZE = 160;
@@ -219,6 +232,10 @@ class WavFileQueueItem : public QueueItem
     bool initialize(void);
     int readSamples(float *samples, int len);
     void unreadSamples(int len);
+    size_t samplesLeft(void) const
+    {
+      return (subchunk2size - data_read) / sizeof(short);
+    }
 
   private:
     string    filename;
@@ -242,6 +259,75 @@ class WavFileQueueItem : public QueueItem
     int read16bitValue(uint8_t *ptr, uint16_t *val);
 };
 
+class ClipQueueItem : public QueueItem
+{
+  public:
+    typedef std::shared_ptr<const std::vector<float> > Clip;
+
+    ClipQueueItem(Clip clip, bool idle_marked)
+      : QueueItem(idle_marked), clip(clip), pos(0) {}
+    int readSamples(float *samples, int len);
+    void unreadSamples(int len);
+    size_t samplesLeft(void) const { return clip->size() - pos; }
+
+  private:
+    Clip    clip;
+    size_t  pos;
+
+};
+
+  // The cache of decoded sound clips shared by all MsgHandler objects. It may
+  // be accessed both from the main thread and from the preload thread.
+class ClipCache
+{
+  public:
+    typedef ClipQueueItem::Clip Clip;
+
+    static ClipCache& instance(void)
+    {
+      static ClipCache cache;
+      return cache;
+    }
+
+    ~ClipCache(void);
+    void setMaxSize(size_t max_bytes);
+    Clip get(const std::string& path);
+    void preload(const std::string& dir);
+    MsgHandler::ClipCacheStats stats(void);
+
+  private:
+    struct Entry
+    {
+      Clip                              clip;
+      struct timespec                   mtime;
+      off_t                             size;
+      std::list<std::string>::iterator  lru_pos;
+    };
+    typedef std::map<std::string, Entry> EntryMap;
+
+    std::mutex              mu;
+    EntryMap                entries;
+    std::list<std::string>  lru;            // Most recently used first
+    size_t                  max_bytes = 0;
+    size_t                  bytes = 0;
+    uint64_t                hits = 0;
+    uint64_t                misses = 0;
+    uint64_t                evictions = 0;
+    std::thread             preload_thread;
+    std::atomic<bool>       stop_preload{false};
+
+    ClipCache(void) {}
+    ClipCache(const ClipCache&);
+    ClipCache& operator=(const ClipCache&);
+    Clip lookup(const std::string& path, const struct stat& st,
+                bool count_stats);
+    bool insert(const std::string& path, const struct stat& st, Clip clip,
+                bool may_evict);
+    void evict(size_t needed);
+    void erase(EntryMap::iterator it);
+    bool preloadDir(const std::string& dir, unsigned& cnt);
+};
+
 
 
 /****************************************************************************
@@ -250,6 +336,9 @@ class WavFileQueueItem : public QueueItem
  *
  ****************************************************************************/
 
+static QueueItem *createFileQueueItem(const string& path, bool idle_marked);
+static bool loadClip(const string& path, vector<float>& samples);
+static size_t estimateClipBytes(const string& path, off_t file_size);
 
 
 /****************************************************************************
@@ -277,7 +366,7 @@ class WavFileQueueItem : public QueueItem
 
 MsgHandler::MsgHandler(int sample_rate)
   : sample_rate(sample_rate), nesting_level(0), pending_play_next(false),
-    current(0), is_writing_message(false), non_idle_cnt(0)
+    current(0), is_writing_message(false), non_idle_cnt(0), batch_level(0)
 {
   
 }
@@ -289,21 +378,35 @@ MsgHandler::~MsgHandler(void)
 } /* MsgHandler::~MsgHandler */
 
 
+void MsgHandler::setClipCacheSize(size_t max_bytes)
+{
+  ClipCache::instance().setMaxSize(max_bytes);
+} /* MsgHandler::setClipCacheSize */
+
+
+void MsgHandler::preloadClips(const string& dir)
+{
+  ClipCache::instance().preload(dir);
+} /* MsgHandler::preloadClips */
+
+
+MsgHandler::ClipCacheStats MsgHandler::clipCacheStats(void)
+{
+  return ClipCache::instance().stats();
+} /* MsgHandler::clipCacheStats */
+
+
 void MsgHandler::playFile(const string& path, bool idle_marked)
 {
   QueueItem *item = 0;
-  const char *ext = strrchr(path.c_str(), '.');
-  if (strcmp(ext, ".gsm") == 0)
-  {
-    item = new GsmFileQueueItem(path, idle_marked);
-  }
-  else if (strcmp(ext, ".wav") == 0)
+  ClipCache::Clip clip = ClipCache::instance().get(path);
+  if (clip != nullptr)
   {
-    item = new WavFileQueueItem(path, idle_marked);
+    item = new ClipQueueItem(clip, idle_marked);
   }
   else
   {
-    item = new RawFileQueueItem(path, idle_marked);
+    item = createFileQueueItem(path, idle_marked);
   }
   addItemToQueue(item);
 } /* MsgHandler::playFile */
@@ -381,6 +484,12 @@ void MsgHandler::end(void)
   --nesting_level;
   if (nesting_level == 0)
   {
+    if (batch_level > 0)
+    {
+      cerr << "*** WARNING: Message batch not ended. Ending it now.\n";
+      batch_level = 1;
+      endBatch();
+    }
     if (pending_play_next)
     {
       pending_play_next = false;
@@ -396,6 +505,27 @@ void MsgHandler::end(void)
 } /* MsgHandler::end */
 
 
+void MsgHandler::beginBatch(void)
+{
+  ++batch_level;
+} /* MsgHandler::beginBatch */
+
+
+void MsgHandler::endBatch(void)
+{
+  if (batch_level == 0)
+  {
+    cerr << "*** WARNING: MsgHandler::endBatch called without a matching "
+            "beginBatch\n";
+    return;
+  }
+  if (--batch_level == 0)
+  {
+    renderBatch();
+  }
+} /* MsgHandler::endBatch */
+
+
 void MsgHandler::resumeOutput(void)
 {
   if (current != 0)
@@ -431,6 +561,12 @@ void MsgHandler::allSamplesFlushed(void)
 
 void MsgHandler::addItemToQueue(QueueItem *item)
 {
+  if (batch_level > 0)
+  {
+    batch_items.push_back(item);
+    return;
+  }
+
   is_writing_message = true;
   if (!item->idleMarked())
   {
@@ -547,9 +683,73 @@ void MsgHandler::clearP(void)
   non_idle_cnt = 0;
 
   msg_queue.clear();
+
+    // Batch items have not been counted as non idle so just delete them
+  for (it=batch_items.begin(); it!=batch_items.end(); ++it)
+  {
+    delete *it;
+  }
+  batch_items.clear();
 } /* MsgHandler::clearP */
 
 
+void MsgHandler::renderBatch(void)
+{
+  if (batch_items.empty())
+  {
+    return;
+  }
+
+    // There is nothing to gain from rendering a single item
+  if (batch_items.size() == 1)
+  {
+    QueueItem *item = batch_items.front();
+    batch_items.clear();
+    addItemToQueue(item);
+    return;
+  }
+
+    // Initialize all items first so that the whole buffer can be allocated
+    // in one go. Items that fail to initialize are dropped.
+  bool idle_marked = true;
+  size_t samples_left = 0;
+  list<QueueItem*>::iterator it = batch_items.begin();
+  while (it != batch_items.end())
+  {
+    QueueItem *item = *it;
+    idle_marked = idle_marked && item->idleMarked();
+    if (!item->initialize())
+    {
+      delete item;
+      it = batch_items.erase(it);
+      continue;
+    }
+    samples_left += item->samplesLeft();
+    ++it;
+  }
+
+  std::shared_ptr<vector<float> > samples(new vector<float>);
+  samples->reserve(samples_left);
+  for (it=batch_items.begin(); it!=batch_items.end(); ++it)
+  {
+    QueueItem *item = *it;
+    float buf[WRITE_BLOCK_SIZE];
+    int read_cnt;
+    while ((read_cnt = item->readSamples(buf, WRITE_BLOCK_SIZE)) > 0)
+    {
+      samples->insert(samples->end(), buf, buf + read_cnt);
+    }
+    delete item;
+  }
+  batch_items.clear();
+
+  if (!samples->empty())
+  {
+    addItemToQueue(new ClipQueueItem(samples, idle_marked));
+  }
+} /* MsgHandler::renderBatch */
+
+
 
 /****************************************************************************
  *
@@ -582,6 +782,18 @@ bool RawFileQueueItem::initialize(void)
 } /* RawFileQueueItem::initialize */
 
 
+size_t RawFileQueueItem::samplesLeft(void) const
+{
+  struct stat st;
+  if ((file == -1) || (fstat(file, &st) != 0))
+  {
+    return 0;
+  }
+  off_t pos = lseek(file, 0, SEEK_CUR);
+  return (st.st_size - max(pos, off_t(0))) / sizeof(short);
+} /* RawFileQueueItem::samplesLeft */
+
+
 int RawFileQueueItem::readSamples(float *samples, int len)
 {
   short buf[len];
@@ -658,6 +870,19 @@ bool GsmFileQueueItem::initialize(void)
 } /* GsmFileQueueItem::initialize */
 
 
+size_t GsmFileQueueItem::samplesLeft(void) const
+{
+  struct stat st;
+  if ((file == -1) || (fstat(file, &st) != 0))
+  {
+    return 0;
+  }
+  off_t pos = lseek(file, 0, SEEK_CUR);
+  return (st.st_size - max(pos, off_t(0))) / sizeof(gsm_frame) * BUFSIZE +
+         (BUFSIZE - buf_pos);
+} /* GsmFileQueueItem::samplesLeft */
+
+
 int GsmFileQueueItem::readSamples(float *samples, int len)
 {
   int read_cnt = 0;
@@ -1085,6 +1310,301 @@ void DtmfQueueItem::unreadSamples(int len)
 
 
 
+/****************************************************************************
+ *
+ * Private member functions for class ClipQueueItem
+ *
+ ****************************************************************************/
+
+int ClipQueueItem::readSamples(float *samples, int len)
+{
+  int read_cnt = min(static_cast<size_t>(len), clip->size() - pos);
+  memcpy(samples, clip->data() + pos, sizeof(*samples) * read_cnt);
+  pos += read_cnt;
+  return read_cnt;
+} /* ClipQueueItem::readSamples */
+
+
+void ClipQueueItem::unreadSamples(int len)
+{
+  assert(static_cast<size_t>(len) <= pos);
+  pos -= len;
+} /* ClipQueueItem::unreadSamples */
+
+
+
+/****************************************************************************
+ *
+ * Member functions for class ClipCache
+ *
+ ****************************************************************************/
+
+ClipCache::~ClipCache(void)
+{
+  stop_preload = true;
+  if (preload_thread.joinable())
+  {
+    preload_thread.join();
+  }
+} /* ClipCache::~ClipCache */
+
+
+void ClipCache::setMaxSize(size_t max_bytes)
+{
+  lock_guard<mutex> lock(mu);
+  this->max_bytes = max_bytes;
+  evict(0);
+} /* ClipCache::setMaxSize */
+
+
+ClipCache::Clip ClipCache::get(const string& path)
+{
+  size_t max_size;
+  {
+    lock_guard<mutex> lock(mu);
+    max_size = max_bytes;
+  }
+  if (max_size == 0)
+  {
+    return Clip();
+  }
+
+    // A file that cannot be found is left to the ordinary file queue items
+    // to report
+  struct stat st;
+  if ((stat(path.c_str(), &st) != 0) || !S_ISREG(st.st_mode))
+  {
+    return Clip();
+  }
+
+  Clip clip = lookup(path, st, true);
+  if ((clip != nullptr) || (estimateClipBytes(path, st.st_size) > max_size))
+  {
+    return clip;
+  }
+
+  std::shared_ptr<vector<float> > samples(new vector<float>);
+  if (!loadClip(path, *samples))
+  {
+    return Clip();
+  }
+  clip = samples;
+  insert(path, st, clip, true);
+  return clip;
+} /* ClipCache::get */
+
+
+void ClipCache::preload(const string& dir)
+{
+  if (preload_thread.joinable())
+  {
+    preload_thread.join();
+  }
+  stop_preload = false;
+  preload_thread = std::thread([this, dir]()
+    {
+      unsigned cnt = 0;
+      preloadDir(dir, cnt);
+      MsgHandler::ClipCacheStats st = stats();
+      cout << "Preloaded " << cnt << " sound clips from \"" << dir
+           << "\" (" << st.bytes / 1024 << "kB in cache)" << endl;
+    });
+} /* ClipCache::preload */
+
+
+MsgHandler::ClipCacheStats ClipCache::stats(void)
+{
+  lock_guard<mutex> lock(mu);
+  MsgHandler::ClipCacheStats st;
+  st.hits = hits;
+  st.misses = misses;
+  st.evictions = evictions;
+  st.clips = entries.size();
+  st.bytes = bytes;
+  return st;
+} /* ClipCache::stats */
+
+
+ClipCache::Clip ClipCache::lookup(const string& path, const struct stat& st,
+                                  bool count_stats)
+{
+  lock_guard<mutex> lock(mu);
+  EntryMap::iterator it = entries.find(path);
+  if ((it != entries.end()) && (it->second.size == st.st_size) &&
+      (it->second.mtime.tv_sec == st.st_mtim.tv_sec) &&
+      (it->second.mtime.tv_nsec == st.st_mtim.tv_nsec))
+  {
+    lru.splice(lru.begin(), lru, it->second.lru_pos);
+    if (count_stats)
+    {
+      ++hits;
+    }
+    return it->second.clip;
+  }
+  if (count_stats)
+  {
+    ++misses;
+  }
+  return Clip();
+} /* ClipCache::lookup */
+
+
+bool ClipCache::insert(const string& path, const struct stat& st, Clip clip,
+                       bool may_evict)
+{
+  lock_guard<mutex> lock(mu);
+  size_t clip_bytes = sizeof(float) * clip->size();
+  EntryMap::iterator it = entries.find(path);
+  size_t old_bytes = (it != entries.end()) ?
+                     sizeof(float) * it->second.clip->size() : 0;
+  if ((clip_bytes > max_bytes) ||
+      (!may_evict && (bytes - old_bytes + clip_bytes > max_bytes)))
+  {
+    return false;
+  }
+  if (it != entries.end())
+  {
+    erase(it);
+  }
+  evict(clip_bytes);
+
+  Entry& entry = entries[path];
+  entry.clip = clip;
+  entry.mtime = st.st_mtim;
+  entry.size = st.st_size;
+  entry.lru_pos = lru.insert(lru.begin(), path);
+  bytes += clip_bytes;
+  return true;
+} /* ClipCache::insert */
+
+
+void ClipCache::evict(size_t needed)
+{
+  while (!lru.empty() && (bytes + needed > max_bytes))
+  {
+    erase(entries.find(lru.back()));
+    ++evictions;
+  }
+} /* ClipCache::evict */
+
+
+void ClipCache::erase(EntryMap::iterator it)
+{
+  bytes -= sizeof(float) * it->second.clip->size();
+  lru.erase(it->second.lru_pos);
+  entries.erase(it);
+} /* ClipCache::erase */
+
+
+bool ClipCache::preloadDir(const string& dir, unsigned& cnt)
+{
+  DIR *dp = opendir(dir.c_str());
+  if (dp == 0)
+  {
+    cerr << "*** WARNING: Could not open sound clip directory \"" << dir
+         << "\": " << strerror(errno) << endl;
+    return true;
+  }
+
+  bool is_full = false;
+  struct dirent *de;
+  while (!is_full && !stop_preload && ((de = readdir(dp)) != 0))
+  {
+    if (de->d_name[0] == '.')
+    {
+      continue;
+    }
+    string path = dir + "/" + de->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+      continue;
+    }
+    if (S_ISDIR(st.st_mode))
+    {
+      is_full = !preloadDir(path, cnt);
+      continue;
+    }
+    const char *ext = strrchr(de->d_name, '.');
+    if (!S_ISREG(st.st_mode) || (ext == 0) ||
+        ((strcmp(ext, ".wav") != 0) && (strcmp(ext, ".gsm") != 0) &&
+         (strcmp(ext, ".raw") != 0)) ||
+        (lookup(path, st, false) != nullptr))
+    {
+      continue;
+    }
+    std::shared_ptr<vector<float> > samples(new vector<float>);
+    if (loadClip(path, *samples))
+    {
+      if (!insert(path, st, samples, false))
+      {
+        is_full = true;
+      }
+      else
+      {
+        ++cnt;
+      }
+    }
+  }
+  closedir(dp);
+
+  return !is_full;
+} /* ClipCache::preloadDir */
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+static QueueItem *createFileQueueItem(const string& path, bool idle_marked)
+{
+  const char *ext = strrchr(path.c_str(), '.');
+  if ((ext != 0) && (strcmp(ext, ".gsm") == 0))
+  {
+    return new GsmFileQueueItem(path, idle_marked);
+  }
+  else if ((ext != 0) && (strcmp(ext, ".wav") == 0))
+  {
+    return new WavFileQueueItem(path, idle_marked);
+  }
+  return new RawFileQueueItem(path, idle_marked);
+} /* createFileQueueItem */
+
+
+static bool loadClip(const string& path, vector<float>& samples)
+{
+  QueueItem *item = createFileQueueItem(path, true);
+  bool success = item->initialize();
+  if (success)
+  {
+    samples.reserve(item->samplesLeft());
+    float buf[WRITE_BLOCK_SIZE];
+    int read_cnt;
+    while ((read_cnt = item->readSamples(buf, WRITE_BLOCK_SIZE)) > 0)
+    {
+      samples.insert(samples.end(), buf, buf + read_cnt);
+    }
+  }
+  delete item;
+  return success;
+} /* loadClip */
+
+
+static size_t estimateClipBytes(const string& path, off_t file_size)
+{
+  const char *ext = strrchr(path.c_str(), '.');
+  if ((ext != 0) && (strcmp(ext, ".gsm") == 0))
+  {
+    return file_size / sizeof(gsm_frame) * 160 * sizeof(float);
+  }
+  return file_size / sizeof(short) * sizeof(float);
+} /* estimateClipBytes */
+
+
+
 /*
  * This file has not been truncated
  */
@@ -8,7 +8,7 @@ This file contains an object that handles the playback of audio clips.
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2015 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <list>
 #include <map>
+#include <cstdint>
 
 #include <sigc++/sigc++.h>
 
@@ -119,10 +120,61 @@ class QueueItem;
 @date   2005-10-22
 
 This class handles the playback of audio clips.
+
+Sound clip files can be cached in memory as decoded samples so that clips that
+are played often, like identifications and roger beeps, do not have to be read
+and decoded from disk each time they are played. The cache is shared by all
+MsgHandler objects and is disabled by default. Use setClipCacheSize to enable
+it.
+
+A sequence of items making up one announcement, like a time or a callsign, can
+be put in a batch using beginBatch and endBatch. The items in a batch are
+rendered into one buffer when the batch is ended so that the announcement is
+played back without per item file handling in between.
 */
 class MsgHandler : public sigc::trackable, public Async::AudioSource
 {
   public:
+    /**
+     * @brief Statistics for the sound clip cache
+     */
+    struct ClipCacheStats
+    {
+      uint64_t  hits;       ///< Number of plays served from the cache
+      uint64_t  misses;     ///< Number of plays that had to read the file
+      uint64_t  evictions;  ///< Number of clips evicted to stay within budget
+      size_t    clips;      ///< Number of clips currently in the cache
+      size_t    bytes;      ///< Memory used by the cached clips
+    };
+
+    /**
+     * @brief   Set the memory budget for the sound clip cache
+     * @param   max_bytes The max number of bytes to use for cached clips
+     *
+     * Decoded clips are cached keyed on path and file modification time.
+     * When the budget is exceeded, the least recently played clips are
+     * evicted. Clips that would not fit in the cache on their own are
+     * streamed from disk as usual. Setting the budget to zero disable the
+     * cache and empty it.
+     */
+    static void setClipCacheSize(size_t max_bytes);
+
+    /**
+     * @brief   Preload sound clips into the cache
+     * @param   dir The directory to preload clips from
+     *
+     * All .wav, .gsm and .raw files found in the given directory, and its
+     * subdirectories, are decoded and put into the cache in a background
+     * thread. Preloading stop when the cache is full.
+     */
+    static void preloadClips(const std::string& dir);
+
+    /**
+     * @brief   Get the sound clip cache statistics
+     * @return  Returns the current statistics
+     */
+    static ClipCacheStats clipCacheStats(void);
+
     /**
      * @brief 	Default constuctor
      * @param	sample_rate The sample rate of the playback system
@@ -212,6 +264,34 @@ class MsgHandler : public sigc::trackable, public Async::AudioSource
      * executed.
      */
     void end(void);    
+
+    /**
+     * @brief 	Mark the beginning of a batch of items
+     *
+     * All files, silence, tones and DTMF digits played after this call are
+     * collected until endBatch is called. They are then rendered into one
+     * contiguous buffer that is put in the message queue as a single item.
+     * Batches may be nested. Only the outermost batch is rendered.
+     */
+    void beginBatch(void);
+
+    /**
+     * @brief 	Mark the end of a batch of items
+     *
+     * When the outermost batch is ended, all the collected items are
+     * rendered and queued for playback. Items that cannot be initialized,
+     * like missing files, are skipped. The rendered item is idle marked only
+     * if all items in the batch were idle marked. A batch that is still open
+     * when the outermost end() is called is ended automatically.
+     */
+    void endBatch(void);
+
+    /**
+     * @brief 	Check if a batch is being collected
+     * @return	Returns \em true if beginBatch has been called more times
+     *          than endBatch
+     */
+    bool isBatching(void) const { return batch_level > 0; }
     
     /**
      * @brief 	A signal that is emitted when all messages has been written
@@ -245,6 +325,8 @@ class MsgHandler : public sigc::trackable, public Async::AudioSource
     QueueItem 	      	    *current;
     bool      	      	    is_writing_message;
     int       	      	    non_idle_cnt;
+    int                     batch_level;
+    std::list<QueueItem*>   batch_items;
     
     MsgHandler(const MsgHandler&);
     MsgHandler& operator=(const MsgHandler&);
@@ -253,6 +335,7 @@ class MsgHandler : public sigc::trackable, public Async::AudioSource
     void writeSamples(void);
     void deleteQueueItem(QueueItem *item);
     void clearP(void);
+    void renderBatch(void);
 
 }; /* class MsgHandler */
 
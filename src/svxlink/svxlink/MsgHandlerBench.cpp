@@ -0,0 +1,236 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#include <unistd.h>
+
+#include <AsyncAudioSink.h>
+
+#include "MsgHandler.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark the playback of announcements made up of many sound clips.
+ *
+ * Usage: MsgHandlerBench [announcements]
+ *
+ * Two typical announcements are played: a time, "twelve thirtyfour PM", and a
+ * spelled callsign, "sierra mike zero sierra victor x-ray". Each announcement
+ * is played as a sequence of separate items, as it has always been done, and
+ * as one rendered batch, both with the sound clip cache disabled and enabled.
+ * The time to first sample is measured from the start of the announcement to
+ * when the first sample reach the sink. The max gap is the longest time
+ * between two writes to the sink during an announcement, which is where the
+ * item switches show up. All times are averages over all announcements.
+ * The sound clips are generated as raw files in a temporary directory.
+ */
+
+namespace {
+const int     SAMPLE_RATE     = 16000;
+const size_t  CLIP_CACHE_SIZE = 16 * 1024 * 1024;
+
+double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+class TimingSink : public AudioSink
+{
+  public:
+    double    first_sample = 0.0;
+    double    last_write = 0.0;
+    double    max_gap = 0.0;
+    unsigned  writes = 0;
+    size_t    samples = 0;
+
+    void reset(void)
+    {
+      first_sample = last_write = max_gap = 0.0;
+      writes = 0;
+      samples = 0;
+    }
+
+    int writeSamples(const float *, int count)
+    {
+      double now = wallTime();
+      if (writes == 0)
+      {
+        first_sample = now;
+      }
+      else
+      {
+        max_gap = max(max_gap, now - last_write);
+      }
+      last_write = now;
+      ++writes;
+      samples += count;
+      return count;
+    }
+
+    void flushSamples(void)
+    {
+      sourceAllSamplesFlushed();
+    }
+};
+
+struct Result
+{
+  double    ttfs = 0.0;
+  double    total = 0.0;
+  double    max_gap = 0.0;
+  unsigned  writes = 0;
+  size_t    samples = 0;
+};
+
+void writeClip(const string& path, int length_ms, int fq)
+{
+  vector<short> pcm(SAMPLE_RATE * length_ms / 1000);
+  for (size_t i=0; i<pcm.size(); ++i)
+  {
+    pcm[i] = static_cast<short>(
+        8000.0 * sin(2.0 * M_PI * fq * i / SAMPLE_RATE));
+  }
+  ofstream os(path.c_str(), ios::binary);
+  os.write(reinterpret_cast<const char*>(&pcm[0]),
+           pcm.size() * sizeof(pcm[0]));
+}
+
+Result play(MsgHandler& mh, TimingSink& sink, const vector<string>& clips,
+            bool batch, int announcements)
+{
+  Result res;
+  for (int i=0; i<announcements; ++i)
+  {
+    sink.reset();
+    double start = wallTime();
+    mh.begin();
+    if (batch)
+    {
+      mh.beginBatch();
+    }
+    for (const auto& clip : clips)
+    {
+      if (clip.empty())
+      {
+        mh.playSilence(100);
+      }
+      else
+      {
+        mh.playFile(clip);
+      }
+    }
+    if (batch)
+    {
+      mh.endBatch();
+    }
+    mh.end();
+    res.ttfs += sink.first_sample - start;
+    res.total += sink.last_write - start;
+    res.max_gap += sink.max_gap;
+    res.writes = sink.writes;
+    res.samples = sink.samples;
+  }
+  res.ttfs /= announcements;
+  res.total /= announcements;
+  res.max_gap /= announcements;
+  return res;
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  int announcements = 200;
+  if (argc > 1)
+  {
+    announcements = atoi(argv[1]);
+  }
+  if (announcements < 1)
+  {
+    cerr << "Usage: MsgHandlerBench [announcements]\n";
+    exit(1);
+  }
+
+  char dir_template[] = "/tmp/MsgHandlerBench.XXXXXX";
+  const char *dir = mkdtemp(dir_template);
+  if (dir == 0)
+  {
+    perror("mkdtemp");
+    exit(1);
+  }
+  vector<string> files;
+  const char *names[] = {
+    "12", "3X", "4", "PM", "phonetic_s", "phonetic_m", "phonetic_0",
+    "phonetic_v", "phonetic_x"
+  };
+  for (size_t i=0; i<sizeof(names)/sizeof(*names); ++i)
+  {
+    string path = string(dir) + "/" + names[i] + ".raw";
+    writeClip(path, 350 + 20 * i, 400 + 100 * i);
+    files.push_back(path);
+  }
+
+  const string d(string(dir) + "/");
+  const vector<string> time_clips = {
+    d + "12.raw", d + "3X.raw", d + "4.raw", "", d + "PM.raw"
+  };
+  const vector<string> call_clips = {
+    d + "phonetic_s.raw", d + "phonetic_m.raw", d + "phonetic_0.raw",
+    d + "phonetic_s.raw", d + "phonetic_v.raw", d + "phonetic_x.raw"
+  };
+
+  MsgHandler mh(SAMPLE_RATE);
+  TimingSink sink;
+  mh.registerSink(&sink);
+
+  int ret = 0;
+  printf("%-9s %-6s %-9s %10s %10s %10s %7s\n", "Announce", "Cache", "Mode",
+         "TTFS us", "Total us", "MaxGap us", "Writes");
+  for (size_t cache_size : {size_t(0), CLIP_CACHE_SIZE})
+  {
+    MsgHandler::setClipCacheSize(cache_size);
+    for (const auto *clips : { &time_clips, &call_clips })
+    {
+      size_t samples = 0;
+      for (bool batch : { false, true })
+      {
+        Result res = play(mh, sink, *clips, batch, announcements);
+        if ((samples != 0) && (res.samples != samples))
+        {
+          cerr << "*** ERROR: Sample count mismatch: " << samples
+               << " != " << res.samples << endl;
+          ret = 1;
+        }
+        samples = res.samples;
+        printf("%-9s %-6s %-9s %10.1f %10.1f %10.1f %7u\n",
+               (clips == &time_clips) ? "time" : "callsign",
+               (cache_size > 0) ? "on" : "off",
+               batch ? "batch" : "sequence", 1.0e6 * res.ttfs,
+               1.0e6 * res.total, 1.0e6 * res.max_gap, res.writes);
+      }
+    }
+  }
+  MsgHandler::ClipCacheStats stats = MsgHandler::clipCacheStats();
+  printf("Clip cache: hits=%llu misses=%llu\n",
+         static_cast<unsigned long long>(stats.hits),
+         static_cast<unsigned long long>(stats.misses));
+
+  for (const auto& path : files)
+  {
+    unlink(path.c_str());
+  }
+  rmdir(dir);
+
+  return ret;
+} /* main */
@@ -0,0 +1,626 @@
+/**
+@file	 QsoFileWriter.cpp
+@brief   Write QSO recorder audio to file from a background thread
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+#include <algorithm>
+#include <iostream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioContainer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "QsoFileWriter.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+  // The number of samples to collect before handing them to the worker
+#define CHUNK_SIZE        (INTERNAL_SAMPLE_RATE / 10)
+
+  // The max number of samples waiting for the worker before dropping audio
+#define MAX_BACKLOG       (60 * INTERNAL_SAMPLE_RATE)
+
+  // The size of the buffer that encoded data is collected in before writing
+#define WRITE_BUF_SIZE    (256 * 1024)
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+namespace {
+  double elapsedSince(const struct timespec& ts);
+};
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+QsoFileWriter::QsoFileWriter(const string& format)
+  : format(format), is_open(false), samples_written(0), max_samples(0),
+    high_water_mark(0), high_water_mark_reached(false), notifier_wr(-1),
+    quit(false), backlog(0), max_backlog(0), dropped(0), latency_sum(0.0),
+    latency_cnt(0), max_latency(0.0), max_write_time(0.0), w_fd(-1),
+    w_size(0)
+{
+  timerclear(&begin_timestamp);
+  timerclear(&end_timestamp);
+  notifier_watch.activity.connect(
+      sigc::mem_fun(*this, &QsoFileWriter::handleResults));
+} /* QsoFileWriter::QsoFileWriter */
+
+
+QsoFileWriter::~QsoFileWriter(void)
+{
+  if (worker.joinable())
+  {
+    queuePendingSamples();
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      quit = true;
+    }
+    cond.notify_one();
+    worker.join();
+    handleResults();
+  }
+
+  int fd = notifier_watch.fd();
+  if (fd >= 0)
+  {
+    notifier_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+    close(fd);
+  }
+  if (notifier_wr >= 0)
+  {
+    close(notifier_wr);
+  }
+} /* QsoFileWriter::~QsoFileWriter */
+
+
+bool QsoFileWriter::initialize(void)
+{
+  AudioContainer *container = createAudioContainer(format);
+  if (container == nullptr)
+  {
+    cerr << "*** ERROR: Unknown audio container format \"" << format
+         << "\"" << endl;
+    return false;
+  }
+  extension = container->filenameExtension();
+  delete container;
+
+  int fd[2];
+  if (pipe(fd) != 0)
+  {
+    perror("QsoFileWriter pipe");
+    return false;
+  }
+  notifier_watch.setFd(fd[0], FdWatch::FD_WATCH_RD);
+  notifier_watch.setEnabled(true);
+  notifier_wr = fd[1];
+
+  w_buf.reserve(WRITE_BUF_SIZE);
+  worker = std::thread(&QsoFileWriter::writerThread, this);
+
+  return true;
+} /* QsoFileWriter::initialize */
+
+
+bool QsoFileWriter::openFile(const string& path)
+{
+  if (is_open || !worker.joinable())
+  {
+    return false;
+  }
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    errorOccurred(string("open: ") + strerror(errno));
+    return false;
+  }
+
+  is_open = true;
+  samples_written = 0;
+  high_water_mark_reached = false;
+  timerclear(&begin_timestamp);
+  timerclear(&end_timestamp);
+
+  Command cmd;
+  cmd.type = Command::OPEN;
+  cmd.fd = fd;
+  cmd.path = path;
+  queueCommand(cmd);
+
+  return true;
+} /* QsoFileWriter::openFile */
+
+
+void QsoFileWriter::closeFile(const string& new_path)
+{
+  if (!is_open)
+  {
+    return;
+  }
+  queuePendingSamples();
+  is_open = false;
+
+  Command cmd;
+  cmd.type = Command::CLOSE;
+  cmd.fd = -1;
+  cmd.path = new_path;
+  queueCommand(cmd);
+} /* QsoFileWriter::closeFile */
+
+
+void QsoFileWriter::setMaxRecordingTime(unsigned time_ms, unsigned hw_time_ms)
+{
+  max_samples = time_ms * (INTERNAL_SAMPLE_RATE / 1000);
+  high_water_mark = hw_time_ms * (INTERNAL_SAMPLE_RATE / 1000);
+} /* QsoFileWriter::setMaxRecordingTime */
+
+
+QsoFileWriter::Stats QsoFileWriter::stats(bool reset)
+{
+  std::lock_guard<std::mutex> lock(mu);
+  Stats st;
+  st.backlog = backlog;
+  st.max_backlog = max_backlog;
+  st.dropped = dropped;
+  st.avg_latency = (latency_cnt > 0) ? latency_sum / latency_cnt : 0.0;
+  st.max_latency = max_latency;
+  st.max_write_time = max_write_time;
+  if (reset)
+  {
+    max_backlog = backlog;
+    dropped = 0;
+    latency_sum = 0.0;
+    latency_cnt = 0;
+    max_latency = 0.0;
+    max_write_time = 0.0;
+  }
+  return st;
+} /* QsoFileWriter::stats */
+
+
+int QsoFileWriter::writeSamples(const float *samples, int count)
+{
+  assert(count > 0);
+
+  if (!is_open)
+  {
+    return count;
+  }
+
+  if (max_samples > 0)
+  {
+    if (samples_written >= max_samples)
+    {
+      return count;
+    }
+    count = min(static_cast<unsigned>(count), max_samples - samples_written);
+  }
+
+  gettimeofday(&end_timestamp, NULL);
+  if (!timerisset(&begin_timestamp))
+  {
+    long usec = static_cast<long>(1000000LL * count / INTERNAL_SAMPLE_RATE);
+    struct timeval block_time = { 0,  usec };
+    timersub(&end_timestamp, &block_time, &begin_timestamp);
+  }
+
+  pending.insert(pending.end(), samples, samples + count);
+  if (pending.size() >= CHUNK_SIZE)
+  {
+    queuePendingSamples();
+  }
+  samples_written += count;
+
+  if ((high_water_mark > 0) && (samples_written >= high_water_mark))
+  {
+    high_water_mark_reached = true;
+  }
+
+  if ((max_samples > 0) && (samples_written >= max_samples))
+  {
+    maxRecordingTimeReached();
+  }
+
+  return count;
+} /* QsoFileWriter::writeSamples */
+
+
+void QsoFileWriter::flushSamples(void)
+{
+  queuePendingSamples();
+  sourceAllSamplesFlushed();
+  if (is_open && high_water_mark_reached)
+  {
+    high_water_mark_reached = false;
+    maxRecordingTimeReached();
+  }
+} /* QsoFileWriter::flushSamples */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void QsoFileWriter::queueCommand(Command& cmd)
+{
+  clock_gettime(CLOCK_MONOTONIC, &cmd.queued);
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    if (cmd.type == Command::SAMPLES)
+    {
+      if (backlog + cmd.samples.size() > MAX_BACKLOG)
+      {
+        dropped += cmd.samples.size();
+        return;
+      }
+      backlog += cmd.samples.size();
+      max_backlog = max(max_backlog, backlog);
+    }
+    commands.push_back(std::move(cmd));
+  }
+  cond.notify_one();
+} /* QsoFileWriter::queueCommand */
+
+
+void QsoFileWriter::queuePendingSamples(void)
+{
+  if (pending.empty())
+  {
+    return;
+  }
+  Command cmd;
+  cmd.type = Command::SAMPLES;
+  cmd.fd = -1;
+  cmd.samples.swap(pending);
+  queueCommand(cmd);
+  pending.reserve(CHUNK_SIZE);
+} /* QsoFileWriter::queuePendingSamples */
+
+
+void QsoFileWriter::handleResults(FdWatch *w)
+{
+  if (w != 0)
+  {
+    char buf[64];
+    if (read(w->fd(), buf, sizeof(buf)) < 0)
+    {
+      perror("QsoFileWriter read");
+    }
+  }
+
+  std::deque<Result> done;
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    done.swap(results);
+  }
+  for (const auto& result : done)
+  {
+    if (!result.errmsg.empty())
+    {
+      errorOccurred(result.errmsg);
+    }
+    if (!result.path.empty())
+    {
+      fileClosed(result.path, result.size);
+    }
+  }
+} /* QsoFileWriter::handleResults */
+
+
+void QsoFileWriter::writerThread(void)
+{
+  std::unique_lock<std::mutex> lock(mu);
+  for (;;)
+  {
+    cond.wait(lock, [this] { return quit || !commands.empty(); });
+    if (commands.empty())
+    {
+      break;
+    }
+    Command cmd = std::move(commands.front());
+    commands.pop_front();
+    lock.unlock();
+
+    switch (cmd.type)
+    {
+      case Command::OPEN:
+        workerOpen(cmd);
+        break;
+      case Command::SAMPLES:
+        workerSamples(cmd);
+        break;
+      case Command::CLOSE:
+        workerClose(cmd);
+        break;
+    }
+
+    lock.lock();
+  }
+} /* QsoFileWriter::writerThread */
+
+
+void QsoFileWriter::workerOpen(Command& cmd)
+{
+  w_fd = cmd.fd;
+  w_path = cmd.path;
+  w_size = 0;
+  w_errmsg.clear();
+  w_buf.clear();
+  w_container.reset(createAudioContainer(format));
+  w_container->writeBlock.connect(
+      [this](const char *buf, size_t len)
+      {
+        w_buf.insert(w_buf.end(), buf, buf + len);
+        if (w_buf.size() >= WRITE_BUF_SIZE)
+        {
+          workerFlush();
+        }
+      });
+
+    // Leave room for the header. It is written when the file is closed
+    // since some containers, like WAV, store the length of the audio in it.
+  size_t header_size = w_container->headerSize();
+  if ((header_size > 0) &&
+      (lseek(w_fd, header_size, SEEK_SET) != static_cast<off_t>(header_size)))
+  {
+    workerSetError("lseek");
+  }
+  w_size = header_size;
+} /* QsoFileWriter::workerOpen */
+
+
+void QsoFileWriter::workerSamples(Command& cmd)
+{
+  if (w_container != nullptr)
+  {
+    w_container->writeSamples(cmd.samples.data(), cmd.samples.size());
+  }
+
+  double latency = elapsedSince(cmd.queued);
+  std::lock_guard<std::mutex> lock(mu);
+  backlog -= cmd.samples.size();
+  latency_sum += latency;
+  latency_cnt += 1;
+  max_latency = max(max_latency, latency);
+} /* QsoFileWriter::workerSamples */
+
+
+void QsoFileWriter::workerClose(Command& cmd)
+{
+  if (w_container == nullptr)
+  {
+    return;
+  }
+
+  w_container->endStream();
+  workerFlush();
+
+  size_t header_size = w_container->headerSize();
+  if (header_size > 0)
+  {
+    const char *header = w_container->header();
+    if (pwrite(w_fd, header, header_size, 0) !=
+        static_cast<ssize_t>(header_size))
+    {
+      workerSetError("pwrite");
+    }
+  }
+  w_container.reset();
+
+  if (close(w_fd) != 0)
+  {
+    workerSetError("close");
+  }
+  w_fd = -1;
+
+  Result result;
+  result.size = w_size;
+  if (cmd.path.empty())
+  {
+    if (unlink(w_path.c_str()) != 0)
+    {
+      workerSetError("unlink");
+    }
+  }
+  else if (rename(w_path.c_str(), cmd.path.c_str()) != 0)
+  {
+    workerSetError("rename");
+  }
+  else
+  {
+    result.path = cmd.path;
+  }
+  result.errmsg = w_errmsg;
+
+  {
+    std::lock_guard<std::mutex> lock(mu);
+    results.push_back(std::move(result));
+  }
+  const char ch = 1;
+  if (write(notifier_wr, &ch, 1) != 1)
+  {
+    // The main thread will pick the result up on the next notification
+  }
+} /* QsoFileWriter::workerClose */
+
+
+void QsoFileWriter::workerFlush(void)
+{
+  if (w_buf.empty() || (w_fd < 0))
+  {
+    w_buf.clear();
+    return;
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  const char *ptr = w_buf.data();
+  size_t left = w_buf.size();
+  while (left > 0)
+  {
+    ssize_t ret = write(w_fd, ptr, left);
+    if (ret < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      workerSetError("write");
+      break;
+    }
+    ptr += ret;
+    left -= ret;
+  }
+  w_size += w_buf.size() - left;
+  w_buf.clear();
+
+  double write_time = elapsedSince(start);
+  std::lock_guard<std::mutex> lock(mu);
+  max_write_time = max(max_write_time, write_time);
+} /* QsoFileWriter::workerFlush */
+
+
+void QsoFileWriter::workerSetError(const string& what)
+{
+  if (w_errmsg.empty())
+  {
+    w_errmsg = what + " \"" + w_path + "\": " + strerror(errno);
+  }
+} /* QsoFileWriter::workerSetError */
+
+
+
+/****************************************************************************
+ *
+ * Private functions
+ *
+ ****************************************************************************/
+
+namespace {
+  double elapsedSince(const struct timespec& ts)
+  {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - ts.tv_sec) + (now.tv_nsec - ts.tv_nsec) / 1.0e9;
+  } /* elapsedSince */
+};
+
+
+
+/*
+ * This file has not been truncated
+ */
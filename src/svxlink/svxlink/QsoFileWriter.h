@@ -0,0 +1,348 @@
+/**
+@file	 QsoFileWriter.h
+@brief   Write QSO recorder audio to file from a background thread
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef QSO_FILE_WRITER_INCLUDED
+#define QSO_FILE_WRITER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/time.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class AudioContainer;
+};
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Write QSO recorder audio to file from a background thread
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class is an audio sink that write the audio to a file using one of the
+Async audio containers, e.g. "wav" or "opus". The samples are only copied in
+the main thread. Encoding, file writes and closing of files are done in a
+worker thread. The encoded data is collected in a large buffer that is
+appended to the file in one write. When a file have been completely written
+and renamed, the fileClosed signal is emitted in the main thread.
+
+One writer is used for a whole sequence of files. A new file can be opened
+directly after the previous one have been closed, without waiting for the
+worker thread to finish the previous file.
+*/
+class QsoFileWriter : public Async::AudioSink
+{
+  public:
+    /**
+     * @brief Statistics for the writer
+     */
+    struct Stats
+    {
+      size_t    backlog;        ///< Samples waiting to be encoded
+      size_t    max_backlog;    ///< The largest backlog seen
+      uint64_t  dropped;        ///< Samples dropped due to a full backlog
+      double    avg_latency;    ///< Avg time from queueing to encoded (s)
+      double    max_latency;    ///< Max time from queueing to encoded (s)
+      double    max_write_time; ///< Longest single file write (s)
+    };
+
+    /**
+     * @brief 	Constuctor
+     * @param   format The name of the audio container to use, e.g. "opus"
+     */
+    explicit QsoFileWriter(const std::string& format);
+
+    /**
+     * @brief 	Destructor
+     *
+     * Files that are queued for writing are completed before the destructor
+     * return.
+     */
+    ~QsoFileWriter(void);
+
+    /**
+     * @brief   Initialize the writer
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * The worker thread is started by this function. It will fail if the
+     * audio container format is not known.
+     */
+    bool initialize(void);
+
+    /**
+     * @brief   Get the filename extension for the chosen container format
+     * @return  Returns the filename extension, e.g. "opus"
+     */
+    const std::string& filenameExtension(void) const { return extension; }
+
+    /**
+     * @brief   Open a new file
+     * @param   path The path of the file to write to
+     * @return  Returns \em true on success or \em false on failure
+     *
+     * The file is created in the calling thread so that errors are reported
+     * directly. All other file operations are done in the worker thread.
+     */
+    bool openFile(const std::string& path);
+
+    /**
+     * @brief   Close the current file
+     * @param   new_path The path to rename the file to when it is written
+     *
+     * The file is completed in the background and then renamed to the given
+     * path. If the new path is empty the file is removed instead.
+     */
+    void closeFile(const std::string& new_path);
+
+    /**
+     * @brief   Check if a file is open
+     * @return  Returns \em true if a file is open
+     */
+    bool isOpen(void) const { return is_open; }
+
+    /**
+     * @brief   Set the maximum recording time per file
+     * @param   time_ms The hard limit in milliseconds
+     * @param   hw_time_ms The soft limit in milliseconds
+     *
+     * When the hard limit is reached, the maxRecordingTimeReached signal is
+     * emitted. When the soft limit have been reached, the signal is emitted
+     * on the next flush. Zero means no limit.
+     */
+    void setMaxRecordingTime(unsigned time_ms, unsigned hw_time_ms=0);
+
+    /**
+     * @brief   Get the number of samples written to the current file
+     * @return  Returns the number of samples written
+     */
+    unsigned samplesWritten(void) const { return samples_written; }
+
+    /**
+     * @brief   Get the time when the first sample was written
+     * @return  Returns the timestamp of the first sample in the file
+     */
+    const struct timeval &beginTimestamp(void) const { return begin_timestamp; }
+
+    /**
+     * @brief   Get the time when the last sample was written
+     * @return  Returns the timestamp of the last sample in the file
+     */
+    const struct timeval &endTimestamp(void) const { return end_timestamp; }
+
+    /**
+     * @brief   Get statistics for the writer
+     * @param   reset Set to \em true to reset the counters, max and average
+     *                values
+     * @return  Returns the current statistics
+     */
+    Stats stats(bool reset=false);
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief   A signal that is emitted when the max recording time is reached
+     */
+    sigc::signal<void()> maxRecordingTimeReached;
+
+    /**
+     * @brief   A signal that is emitted when a file have been written
+     * @param   path The final path of the file
+     * @param   size The size of the file in bytes
+     */
+    sigc::signal<void(const std::string&, uint64_t)> fileClosed;
+
+    /**
+     * @brief   A signal that is emitted when writing a file failed
+     * @param   errmsg A description of the error
+     */
+    sigc::signal<void(const std::string&)> errorOccurred;
+
+  private:
+    struct Command
+    {
+      enum Type { OPEN, SAMPLES, CLOSE };
+      Type                type;
+      int                 fd;
+      std::string         path;
+      std::vector<float>  samples;
+      struct timespec     queued;
+    };
+    struct Result
+    {
+      std::string         path;
+      uint64_t            size;
+      std::string         errmsg;
+    };
+
+    std::string             format;
+    std::string             extension;
+    bool                    is_open;
+    std::vector<float>      pending;
+    unsigned                samples_written;
+    unsigned                max_samples;
+    unsigned                high_water_mark;
+    bool                    high_water_mark_reached;
+    struct timeval          begin_timestamp;
+    struct timeval          end_timestamp;
+    Async::FdWatch          notifier_watch;
+    int                     notifier_wr;
+
+    std::thread             worker;
+    std::mutex              mu;
+    std::condition_variable cond;
+    std::deque<Command>     commands;
+    std::deque<Result>      results;
+    bool                    quit;
+    size_t                  backlog;
+    size_t                  max_backlog;
+    uint64_t                dropped;
+    double                  latency_sum;
+    uint64_t                latency_cnt;
+    double                  max_latency;
+    double                  max_write_time;
+
+      // Only accessed by the worker thread
+    std::unique_ptr<Async::AudioContainer>  w_container;
+    int                                     w_fd;
+    std::string                             w_path;
+    std::vector<char>                       w_buf;
+    uint64_t                                w_size;
+    std::string                             w_errmsg;
+
+    QsoFileWriter(const QsoFileWriter&);
+    QsoFileWriter& operator=(const QsoFileWriter&);
+    void queueCommand(Command& cmd);
+    void queuePendingSamples(void);
+    void handleResults(Async::FdWatch *w=0);
+    void writerThread(void);
+    void workerOpen(Command& cmd);
+    void workerSamples(Command& cmd);
+    void workerClose(Command& cmd);
+    void workerFlush(void);
+    void workerSetError(const std::string& what);
+
+};  /* class QsoFileWriter */
+
+
+//} /* namespace */
+
+#endif /* QSO_FILE_WRITER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
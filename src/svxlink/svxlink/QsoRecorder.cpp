@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2015 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -42,6 +42,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
+#include <cerrno>
 
 
 /****************************************************************************
@@ -51,7 +52,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncAudioSelector.h>
-#include <AsyncAudioRecorder.h>
 #include <AsyncConfig.h>
 #include <AsyncTimer.h>
 #include <AsyncExec.h>
@@ -64,6 +64,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "QsoRecorder.h"
+#include "QsoFileWriter.h"
 #include "Logic.h"
 
 
@@ -97,9 +98,9 @@ using namespace Async;
 class QsoRecorder::FileEncoder : public Exec
 {
   public:
-    string basename;
-    FileEncoder(const char *shell, string basename)
-      : Exec(shell), basename(basename)
+    string filename;
+    FileEncoder(const char *shell, string filename)
+      : Exec(shell), filename(filename)
     {}
 };
 
@@ -140,9 +141,9 @@ namespace {
  ****************************************************************************/
 
 QsoRecorder::QsoRecorder(Logic *logic)
-  : recorder(0), hard_chunk_limit(0), soft_chunk_limit(0), max_dirsize(0),
-    default_active(false), tmo_timer(0), logic(logic), qso_tmo_timer(0),
-    min_samples(0)
+  : writer(0), hard_chunk_limit(0), soft_chunk_limit(0), max_dirsize(0),
+    rec_dir_size(0), default_active(false), tmo_timer(0), logic(logic),
+    qso_tmo_timer(0), min_samples(0)
 {
   selector = new AudioSelector;
 } /* QsoRecorder::QsoRecorder */
@@ -151,6 +152,8 @@ QsoRecorder::QsoRecorder(Logic *logic)
 QsoRecorder::~QsoRecorder(void)
 {
   setEnabled(false);
+  selector->unregisterSink();
+  delete writer;
   delete selector;
   delete tmo_timer;
   delete qso_tmo_timer;
@@ -173,7 +176,34 @@ bool QsoRecorder::initialize(const Config &cfg, const string &name)
 
   unsigned max_dirsize = 0;
   cfg.getValue(name, "MAX_DIRSIZE", max_dirsize);
-  setMaxRecDirSize(max_dirsize * 1024 * 1024);
+  setMaxRecDirSize(static_cast<uint64_t>(max_dirsize) * 1024 * 1024);
+
+  string format("wav");
+  cfg.getValue(name, "FORMAT", format);
+  writer = new QsoFileWriter(format);
+  if (!writer->initialize())
+  {
+    cerr << "*** WARNING: Could not use audio format \"" << format
+         << "\" for the QSO recorder in logic " << logic->name()
+         << ". Falling back to \"wav\".\n";
+    delete writer;
+    writer = new QsoFileWriter("wav");
+    if (!writer->initialize())
+    {
+      cerr << "*** ERROR: Could not initialize the QSO recorder file writer "
+              "in logic " << logic->name() << endl;
+      delete writer;
+      writer = 0;
+      return false;
+    }
+  }
+  writer->setMaxRecordingTime(hard_chunk_limit, soft_chunk_limit);
+  writer->maxRecordingTimeReached.connect(
+      mem_fun(*this, &QsoRecorder::openNewFile));
+  writer->fileClosed.connect(mem_fun(*this, &QsoRecorder::onFileClosed));
+  writer->errorOccurred.connect(mem_fun(*this, &QsoRecorder::onError));
+  selector->registerSink(writer);
+  scanRecDir();
 
   cfg.getValue(name, "DEFAULT_ACTIVE", default_active);
   setEnabled(default_active);
@@ -220,12 +250,12 @@ void QsoRecorder::addSource(Async::AudioSource *source, int prio)
 
 void QsoRecorder::setEnabled(bool enable)
 {
-  if ((recorder == 0) && enable)
+  if (!recorderIsActive() && enable)
   {
     cout << logic->name() << ": Activating QSO recorder\n";
     openFile();
   }
-  else if ((recorder != 0) && !enable)
+  else if (recorderIsActive() && !enable)
   {
     cout << logic->name() << ": Deactivating QSO recorder\n";
     closeFile();
@@ -242,15 +272,25 @@ void QsoRecorder::setMaxChunkTime(unsigned max_time, unsigned soft_time)
   {
     soft_chunk_limit = (max_time - soft_time) * 1000;
   }
+  if (writer != 0)
+  {
+    writer->setMaxRecordingTime(hard_chunk_limit, soft_chunk_limit);
+  }
 } /* QsoRecorder::setChunkTime */
 
 
-void QsoRecorder::setMaxRecDirSize(unsigned max_size)
+void QsoRecorder::setMaxRecDirSize(uint64_t max_size)
 {
   max_dirsize = max_size;
 } /* QsoRecorder::setMaxRecDirSize */
 
 
+bool QsoRecorder::recorderIsActive(void) const
+{
+  return (writer != 0) && writer->isOpen();
+} /* QsoRecorder::recorderIsActive */
+
+
 
 /****************************************************************************
  *
@@ -275,23 +315,17 @@ void QsoRecorder::openNewFile(void)
 
 void QsoRecorder::openFile(void)
 {
-  if (recorder == 0)
+  if ((writer != 0) && !writer->isOpen())
   {
     string filename(rec_dir);
     filename += "/.qsorec_";
     filename += logic->name();
-    filename += ".wav";
-    recorder = new AudioRecorder(filename);
-    recorder->setMaxRecordingTime(hard_chunk_limit, soft_chunk_limit);
-    recorder->maxRecordingTimeReached.connect(
-        mem_fun(*this, &QsoRecorder::openNewFile));
-    recorder->errorOccurred.connect(mem_fun(*this, &QsoRecorder::onError));
-    selector->registerSink(recorder, true);
-    if (!recorder->initialize())
+    filename += ".";
+    filename += writer->filenameExtension();
+    if (!writer->openFile(filename))
     {
-      cerr << "*** ERROR: Could not open QsoRecorder file \"" << filename 
-           << " for writing in logic " << logic->name() << ": "
-           << recorder->errorMsg() << endl;
+      cerr << "*** ERROR: Could not open QsoRecorder file \"" << filename
+           << "\" for writing in logic " << logic->name() << endl;
     }
   }
 } /* QsoRecorder::openFile */
@@ -299,22 +333,14 @@ void QsoRecorder::openFile(void)
 
 void QsoRecorder::closeFile(void)
 {
-  if (recorder != 0)
+  if (recorderIsActive())
   {
-    string oldpath(rec_dir + "/.qsorec_" + logic->name() + ".wav");
-
-    if (!recorder->closeFile())
-    {
-      cerr << "*** ERROR: Failed to close QsoRecorder file \"" << oldpath
-           << "\" in logic " << logic->name() << ": " << recorder->errorMsg()
-           << endl;
-    }
-
-    if (recorder->samplesWritten() > min_samples)
+    string newpath;
+    if (writer->samplesWritten() > min_samples)
     {
       string basename("qsorec_" + logic->name() + "_");
 
-      const struct timeval &begin_time = recorder->beginTimestamp();
+      const struct timeval &begin_time = writer->beginTimestamp();
       struct tm tm;
       localtime_r(&begin_time.tv_sec, &tm);
       char timestamp[256];
@@ -323,66 +349,82 @@ void QsoRecorder::closeFile(void)
 
       basename += "_";
 
-      const struct timeval &end_time = recorder->endTimestamp();
+      const struct timeval &end_time = writer->endTimestamp();
       localtime_r(&end_time.tv_sec, &tm);
       strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H%M%S", &tm);
       basename += timestamp;
-      string newpath = rec_dir + "/" + basename + ".wav";
-      if (rename(oldpath.c_str(), newpath.c_str()) != 0)
-      {
-        perror("QsoRecorder rename");
-      }
-
-      cout << logic->name() << ": Wrote QSO recorder file "
-           << basename << ".wav\n";
-
-        // Execute external audio file handler (e.g. encoder) if configured
-      if (!encoder_cmd.empty())
-      {
-        cout << logic->name() << ": Starting encoding for file "
-             << basename << ".wav\n";
-        const char *shell = getenv("SHELL");
-        if (shell == NULL)
-        {
-          shell = "/bin/sh";
-        }
-        FileEncoder *enc = new FileEncoder(shell, basename);
-        enc->appendArgument("-c");
-        string cmdline(encoder_cmd);
-        replace_all(cmdline, "%f", newpath);
-        replace_all(cmdline, "%d", rec_dir);
-        replace_all(cmdline, "%b", basename);
-        replace_all(cmdline, "%n", basename + ".wav");
-        enc->appendArgument(cmdline);
-        enc->stdoutData.connect(
-            mem_fun(*this, &QsoRecorder::handleEncoderPrintouts));
-        enc->stderrData.connect(
-            mem_fun(*this, &QsoRecorder::handleEncoderPrintouts));
-        enc->exited.connect(
-            sigc::bind(mem_fun(*this, &QsoRecorder::encoderExited), enc));
-        enc->nice();
-        enc->setTimeout(60*60); // One hour timeout
-        enc->run();
-      }
-    }
-    else
-    {
-      if (unlink(oldpath.c_str()) != 0)
-      {
-        perror("QsoRecorder unlink");
-      }
+      newpath = rec_dir + "/" + basename + "." + writer->filenameExtension();
     }
 
-    delete recorder;
-    recorder = 0;
-
-    cleanupDirectory();
+      // The file is completed and renamed in the background. If no new
+      // path is given, the file is removed. The onFileClosed function is
+      // called when a renamed file is ready.
+    writer->closeFile(newpath);
   }
 } /* QsoRecorder::closeFile */
 
 
-void QsoRecorder::cleanupDirectory(void)
+void QsoRecorder::onFileClosed(const std::string& path, uint64_t size)
 {
+  string filename(path.substr(path.rfind('/') + 1));
+  string basename(filename.substr(0, filename.rfind('.')));
+
+  QsoFileWriter::Stats stats = writer->stats(true);
+  cout << logic->name() << ": Wrote QSO recorder file " << filename
+       << " (" << size << " bytes, latency avg/max "
+       << static_cast<unsigned>(1000.0 * stats.avg_latency) << "/"
+       << static_cast<unsigned>(1000.0 * stats.max_latency)
+       << "ms, max backlog "
+       << (1000 * stats.max_backlog / INTERNAL_SAMPLE_RATE) << "ms";
+  if (stats.dropped > 0)
+  {
+    cout << ", dropped " << (1000 * stats.dropped / INTERNAL_SAMPLE_RATE)
+         << "ms";
+  }
+  cout << ")\n";
+
+  rec_dir_size -= rec_files[filename];
+  rec_files[filename] = size;
+  rec_dir_size += size;
+
+    // Execute external audio file handler (e.g. encoder) if configured
+  if (!encoder_cmd.empty())
+  {
+    cout << logic->name() << ": Starting encoding for file "
+         << filename << "\n";
+    const char *shell = getenv("SHELL");
+    if (shell == NULL)
+    {
+      shell = "/bin/sh";
+    }
+    FileEncoder *enc = new FileEncoder(shell, filename);
+    enc->appendArgument("-c");
+    string cmdline(encoder_cmd);
+    replace_all(cmdline, "%f", path);
+    replace_all(cmdline, "%d", rec_dir);
+    replace_all(cmdline, "%b", basename);
+    replace_all(cmdline, "%n", filename);
+    enc->appendArgument(cmdline);
+    enc->stdoutData.connect(
+        mem_fun(*this, &QsoRecorder::handleEncoderPrintouts));
+    enc->stderrData.connect(
+        mem_fun(*this, &QsoRecorder::handleEncoderPrintouts));
+    enc->exited.connect(
+        sigc::bind(mem_fun(*this, &QsoRecorder::encoderExited), enc));
+    enc->nice();
+    enc->setTimeout(60*60); // One hour timeout
+    enc->run();
+  }
+
+  cleanupDirectory();
+} /* QsoRecorder::onFileClosed */
+
+
+void QsoRecorder::scanRecDir(void)
+{
+  rec_files.clear();
+  rec_dir_size = 0;
+
   if (max_dirsize == 0)
   {
     return;
@@ -396,34 +438,49 @@ void QsoRecorder::cleanupDirectory(void)
     return;
   }
 
-  unsigned tot_size = 0;
   for (int i=0; i<n; ++i)
   {
-    int idx = n - i - 1;
-    //cout << namelist[idx]->d_name;
     string path(rec_dir);
     path += "/";
-    path += namelist[idx]->d_name;
-    free(namelist[idx]);
+    path += namelist[i]->d_name;
 
     struct stat buf;
       // coverity[fs_check_call]
-    if (stat(path.c_str(), &buf) < 0)
+    if (stat(path.c_str(), &buf) == 0)
     {
-      perror("QsoRecorder stat");
-      continue;
+      rec_files[namelist[i]->d_name] = buf.st_size;
+      rec_dir_size += buf.st_size;
     }
-    tot_size += buf.st_size;
-    //cout << " " << buf.st_size;
-    //cout << " " << tot_size;
-    if (tot_size > max_dirsize)
+    else
     {
-      //cout << " (delete)";
-      unlink(path.c_str());
+      perror("QsoRecorder stat");
     }
-    //cout << endl;
+    free(namelist[i]);
   }
   free(namelist);
+} /* QsoRecorder::scanRecDir */
+
+
+void QsoRecorder::cleanupDirectory(void)
+{
+  if (max_dirsize == 0)
+  {
+    return;
+  }
+
+    // The file names contain the time of the recording so the oldest
+    // recordings are first in the index.
+  while ((rec_dir_size > max_dirsize) && !rec_files.empty())
+  {
+    auto it = rec_files.begin();
+    string path(rec_dir + "/" + it->first);
+    if ((unlink(path.c_str()) != 0) && (errno != ENOENT))
+    {
+      perror("QsoRecorder unlink");
+    }
+    rec_dir_size -= it->second;
+    rec_files.erase(it);
+  }
 } /* QsoRecorder::cleanupDirectory */
 
 
@@ -450,7 +507,7 @@ void QsoRecorder::checkTimeoutTimers(void)
   if (qso_tmo_timer != 0)
   {
     qso_tmo_timer->setEnable(recorderIsActive()
-                             && (recorder->samplesWritten() > 0)
+                             && (writer->samplesWritten() > 0)
                              && logic->isIdle());
   }
 } /* QsoRecorder::checkTimeoutTimers */
@@ -465,7 +522,7 @@ void QsoRecorder::handleEncoderPrintouts(const char *buf, int cnt)
 void QsoRecorder::encoderExited(QsoRecorder::FileEncoder *enc)
 {
   cout << logic->name() << ": Encoding done for file "
-             << enc->basename << ".wav\n";
+             << enc->filename << "\n";
   if (enc->ifExited() && (enc->exitStatus() != 0))
   {
     cerr << "*** ERROR: QSO recorder external audio file handler in logic "
@@ -479,13 +536,17 @@ void QsoRecorder::encoderExited(QsoRecorder::FileEncoder *enc)
          << "signal " << enc->termSig() << endl;
   }
   delete enc;
+
+    // The external handler may have replaced or removed the file
+  scanRecDir();
+  cleanupDirectory();
 } /* QsoRecorder::encoderExited */
 
 
-void QsoRecorder::onError(void)
+void QsoRecorder::onError(const std::string& errmsg)
 {
-  cerr << "*** ERROR: The QsoRecorder in logic " << logic->name() 
-       << " failed: " << recorder->errorMsg() << endl;
+  cerr << "*** ERROR: The QsoRecorder in logic " << logic->name()
+       << " failed: " << errmsg << endl;
 } /* QsoRecorder::onError */
 
 
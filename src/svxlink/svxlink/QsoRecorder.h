@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2010 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -35,6 +35,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <string>
+#include <map>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -62,13 +64,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace Async
 {
   class AudioSelector;
-  class AudioRecorder;
   class Config;
   class Timer;
   class Exec;
 };
 
 class Logic;
+class QsoFileWriter;
 
 
 /****************************************************************************
@@ -157,7 +159,7 @@ class QsoRecorder
      * @brief   Check if the recorder is enabled or not
      * @returns Returns \em true if the recorder is enabled or else \em false
      */
-    bool isEnabled(void) const { return (recorder != 0); }
+    bool isEnabled(void) const { return recorderIsActive(); }
 
     /**
      * @brief   Set the maximum size of ech recorded file
@@ -170,9 +172,17 @@ class QsoRecorder
      */
     void setMaxChunkTime(unsigned max_time, unsigned soft_time=0);
 
-    void setMaxRecDirSize(unsigned max_size);
+    /**
+     * @brief   Set the maximum total size of the recordings directory
+     * @param   max_size The max size in bytes. Zero means no limit.
+     *
+     * When the limit is exceeded, the oldest recordings are removed. The
+     * size of the directory is tracked in an index that is updated as files
+     * are written so the directory do not have to be rescanned each time.
+     */
+    void setMaxRecDirSize(uint64_t max_size);
 
-    bool recorderIsActive(void) const { return (recorder != 0); }
+    bool recorderIsActive(void) const;
 
   protected:
 
@@ -180,11 +190,13 @@ class QsoRecorder
     class FileEncoder;
 
     Async::AudioSelector  *selector;
-    Async::AudioRecorder  *recorder;
+    QsoFileWriter         *writer;
     std::string           rec_dir;
     unsigned              hard_chunk_limit;
     unsigned              soft_chunk_limit;
-    unsigned              max_dirsize;
+    uint64_t              max_dirsize;
+    std::map<std::string, uint64_t> rec_files;
+    uint64_t              rec_dir_size;
     bool                  default_active;
     Async::Timer          *tmo_timer;
     Logic                 *logic;
@@ -197,12 +209,14 @@ class QsoRecorder
     void openNewFile(void);
     void openFile(void);
     void closeFile(void);
+    void onFileClosed(const std::string& path, uint64_t size);
+    void scanRecDir(void);
     void cleanupDirectory(void);
     void timerExpired(void);
     void checkTimeoutTimers(void);
     void handleEncoderPrintouts(const char *buf, int cnt);
     void encoderExited(FileEncoder *enc);
-    void onError(void);
+    void onError(const std::string& errmsg);
 
 };  /* class QsoRecorder */
 
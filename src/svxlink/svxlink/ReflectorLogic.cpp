@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -172,6 +172,7 @@ ReflectorLogic::ReflectorLogic(void)
     m_reconnect_timer(60000, Timer::TYPE_ONESHOT, false),
     /*m_next_udp_tx_seq(0),*/ m_next_udp_rx_seq(0),
     m_heartbeat_timer(1000, Timer::TYPE_PERIODIC, false), m_dec(0),
+    m_jitter_buffer(0),
     m_flush_timeout_timer(3000, Timer::TYPE_ONESHOT, false),
     m_udp_heartbeat_tx_cnt_reset(DEFAULT_UDP_HEARTBEAT_TX_CNT_RESET),
     m_udp_heartbeat_tx_cnt(0), m_udp_heartbeat_rx_cnt(0),
@@ -432,6 +433,10 @@ bool ReflectorLogic::initialize(Async::Config& cfgobj, const std::string& logic_
               << m_crtfile << "'." << std::endl;
   }
 
+    // Resume the TLS session on reconnect to save the server from doing a
+    // full handshake when many nodes reconnect at the same time
+  m_ssl_ctx.enableSessionResumption("SvxLink");
+
   cfg().getValue(name(), "CERT_DOWNLOAD_CA_BUNDLE", m_download_ca_bundle);
   if (!cfg().getValue(name(), "CERT_CAFILE", m_cafile))
   {
@@ -518,17 +523,34 @@ bool ReflectorLogic::initialize(Async::Config& cfgobj, const std::string& logic_
   m_enc_endpoint = prev_src;
   prev_src = 0;
 
+    // Create jitter buffer
+  unsigned jitter_buffer_delay = 0;
+  cfg().getValue(name(), "JITTER_BUFFER_DELAY", jitter_buffer_delay);
+  unsigned jitter_buffer_max_delay = 0;
+  cfg().getValue(name(), "JITTER_BUFFER_MAX_DELAY", jitter_buffer_max_delay);
+  if (jitter_buffer_max_delay > 0)
+  {
+    m_jitter_buffer = new Async::AudioAdaptiveJitterBuffer;
+    m_jitter_buffer->setDelayRange(jitter_buffer_delay,
+                                   jitter_buffer_max_delay);
+    m_jitter_buffer->talkSpurtEnded.connect(
+        mem_fun(*this, &ReflectorLogic::jitterBufferSpurtEnded));
+  }
+
     // Create dummy audio codec used before setting the real encoder
   if (!setAudioCodec("DUMMY")) { return false; }
   prev_src = m_dec;
 
-    // Create jitter buffer
+  if (m_jitter_buffer != 0)
+  {
+    prev_src->registerSink(m_jitter_buffer, true);
+    prev_src = m_jitter_buffer;
+  }
+
   AudioFifo *fifo = new Async::AudioFifo(2*INTERNAL_SAMPLE_RATE);
   prev_src->registerSink(fifo, true);
   prev_src = fifo;
-  unsigned jitter_buffer_delay = 0;
-  cfg().getValue(name(), "JITTER_BUFFER_DELAY", jitter_buffer_delay);
-  if (jitter_buffer_delay > 0)
+  if ((m_jitter_buffer == 0) && (jitter_buffer_delay > 0))
   {
     fifo->setPrebufSamples(jitter_buffer_delay * INTERNAL_SAMPLE_RATE / 1000);
   }
@@ -1022,10 +1044,22 @@ void ReflectorLogic::onDisconnected(TcpConnection*,
     m_flush_timeout_timer.setEnable(false);
     m_enc->allEncodedSamplesFlushed();
   }
-  if (timerisset(&m_last_talker_timestamp))
+  if (m_jitter_buffer != 0)
+  {
+    m_jitter_buffer->reset();
+    timerclear(&m_last_talker_timestamp);
+  }
+  else if (timerisset(&m_last_talker_timestamp))
   {
     m_dec->flushEncodedSamples();
     timerclear(&m_last_talker_timestamp);
+  }
+    // If the reflector disconnect right after the TLS handshake, e.g. since
+    // our certificate in a resumed session has expired, the session must
+    // not be resumed again
+  if (m_con_state == STATE_EXPECT_AUTH_ANSWER)
+  {
+    m_ssl_ctx.clearSession();
   }
   m_con_state = STATE_DISCONNECTED;
   processEvent("reflector_connection_status_update 0");
@@ -1057,7 +1091,9 @@ bool ReflectorLogic::onVerifyPeer(TcpConnection *con, bool preverify_ok,
 
 void ReflectorLogic::onSslConnectionReady(TcpConnection*)
 {
-  std::cout << name() << ": Encrypted connection established" << std::endl;
+  std::cout << name() << ": Encrypted connection established"
+            << (m_con.sslSessionReused() ? " (session resumed)" : "")
+            << std::endl;
 
   if (m_con_state != STATE_EXPECT_SSL_CON_READY)
   {
@@ -2140,22 +2176,40 @@ void ReflectorLogic::udpDatagramReceived(const IpAddress& addr, uint16_t port,
   //}
 
     // Check sequence number
-  if (m_aad.iv_cntr < m_next_udp_rx_seq) // Frame out of sequence (ignore)
+  const bool is_audio = (header.type() == MsgUdpAudio::TYPE) ||
+                        (header.type() == MsgUdpFlushSamples::TYPE);
+  if (m_aad.iv_cntr < m_next_udp_rx_seq) // Frame out of sequence
   {
-    std::cout << name()
-              << ": Dropping out of sequence UDP frame with seq="
-              << m_aad.iv_cntr << std::endl;
-    return;
+      // The adaptive jitter buffer put reordered audio frames back in order
+    if ((m_jitter_buffer == 0) || !is_audio)
+    {
+      if (m_jitter_buffer != 0)
+      {
+        m_jitter_buffer->skipSequence(m_aad.iv_cntr);
+      }
+      std::cout << name()
+                << ": Dropping out of sequence UDP frame with seq="
+                << m_aad.iv_cntr << std::endl;
+      return;
+    }
   }
-  else if (m_aad.iv_cntr > m_next_udp_rx_seq) // Frame lost
+  else
   {
-    std::cout << name() << ": UDP frame(s) lost. Expected seq="
-              << m_next_udp_rx_seq
-              << " but received " << m_aad.iv_cntr
-              << ". Resetting next expected sequence number to "
-              << (m_aad.iv_cntr + 1) << std::endl;
+    if ((m_aad.iv_cntr > m_next_udp_rx_seq) && (m_jitter_buffer == 0))
+    {
+      std::cout << name() << ": UDP frame(s) lost. Expected seq="
+                << m_next_udp_rx_seq
+                << " but received " << m_aad.iv_cntr
+                << ". Resetting next expected sequence number to "
+                << (m_aad.iv_cntr + 1) << std::endl;
+    }
+    m_next_udp_rx_seq = m_aad.iv_cntr + 1;
+  }
+
+  if ((m_jitter_buffer != 0) && !is_audio)
+  {
+    m_jitter_buffer->skipSequence(m_aad.iv_cntr);
   }
-  m_next_udp_rx_seq = m_aad.iv_cntr + 1;
 
   m_udp_heartbeat_rx_cnt = UDP_HEARTBEAT_RX_CNT_RESET;
 
@@ -2203,14 +2257,33 @@ void ReflectorLogic::udpDatagramReceived(const IpAddress& addr, uint16_t port,
       if (!msg.audioData().empty())
       {
         gettimeofday(&m_last_talker_timestamp, NULL);
-        m_dec->writeEncodedSamples(
-            &msg.audioData().front(), msg.audioData().size());
+        if (m_jitter_buffer != 0)
+        {
+          m_jitter_buffer->writeFrame(m_aad.iv_cntr,
+              &msg.audioData().front(), msg.audioData().size());
+        }
+        else
+        {
+          m_dec->writeEncodedSamples(
+              &msg.audioData().front(), msg.audioData().size());
+        }
+      }
+      else if (m_jitter_buffer != 0)
+      {
+        m_jitter_buffer->skipSequence(m_aad.iv_cntr);
       }
       break;
     }
 
     case MsgUdpFlushSamples::TYPE:
-      m_dec->flushEncodedSamples();
+      if (m_jitter_buffer != 0)
+      {
+        m_jitter_buffer->flushAt(m_aad.iv_cntr);
+      }
+      else
+      {
+        m_dec->flushEncodedSamples();
+      }
       timerclear(&m_last_talker_timestamp);
       break;
 
@@ -2340,7 +2413,14 @@ void ReflectorLogic::handleTimerTick(Async::Timer *t)
     if (diff.tv_sec > 3)
     {
       cout << name() << ": Last talker audio timeout" << endl;
-      m_dec->flushEncodedSamples();
+      if (m_jitter_buffer != 0)
+      {
+        m_jitter_buffer->flush();
+      }
+      else
+      {
+        m_dec->flushEncodedSamples();
+      }
       timerclear(&m_last_talker_timestamp);
     }
   }
@@ -2376,6 +2456,29 @@ void ReflectorLogic::handleTimerTick(Async::Timer *t)
 } /* ReflectorLogic::handleTimerTick */
 
 
+void ReflectorLogic::jitterBufferSpurtEnded(
+    const Async::AudioAdaptiveJitterBuffer::Stats& stats)
+{
+  Json::Value event(Json::objectValue);
+  event["name"] = name();
+  event["delay"] = stats.delay;
+  event["jitter"] = static_cast<int>(stats.jitter + 0.5f);
+  event["received"] = stats.received;
+  event["late"] = stats.late;
+  event["lost"] = stats.lost;
+  event["concealed"] = stats.concealed;
+  event["underruns"] = stats.underruns;
+  Json::StreamWriterBuilder builder;
+  builder["commentStyle"] = "None";
+  builder["indentation"] = ""; //The JSON document is written on a single line
+  Json::StreamWriter* writer = builder.newStreamWriter();
+  std::stringstream os;
+  writer->write(event, &os);
+  delete writer;
+  publishStateEvent("ReflectorLogic:jitter_buffer", os.str());
+} /* ReflectorLogic::jitterBufferSpurtEnded */
+
+
 bool ReflectorLogic::setAudioCodec(const std::string& codec_name)
 {
   delete m_enc;
@@ -2413,6 +2516,10 @@ bool ReflectorLogic::setAudioCodec(const std::string& codec_name)
   AudioSink *sink = 0;
   if (m_dec != 0)
   {
+    if (m_jitter_buffer != 0)
+    {
+      m_jitter_buffer->setDecoder(0);
+    }
     sink = m_dec->sink();
     m_dec->unregisterSink();
     delete m_dec;
@@ -2433,6 +2540,10 @@ bool ReflectorLogic::setAudioCodec(const std::string& codec_name)
   {
     m_dec->registerSink(sink, true);
   }
+  if (m_jitter_buffer != 0)
+  {
+    m_jitter_buffer->setDecoder(m_dec);
+  }
 
   opt_prefix = string(m_dec->name()) + "_DEC_";
   names = cfg().listSection(name());
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2023 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -51,6 +51,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncFramedTcpConnection.h>
 #include <AsyncTimer.h>
 #include <AsyncAudioFifo.h>
+#include <AsyncAudioAdaptiveJitterBuffer.h>
 #include <AsyncAudioStreamStateDetector.h>
 
 
@@ -237,6 +238,7 @@ class ReflectorLogic : public LogicBase
     UdpCipher::IVCntr                 m_next_udp_rx_seq;
     Async::Timer                      m_heartbeat_timer;
     Async::AudioDecoder*              m_dec;
+    Async::AudioAdaptiveJitterBuffer* m_jitter_buffer;
     Async::Timer                      m_flush_timeout_timer;
     unsigned                          m_udp_heartbeat_tx_cnt_reset;
     unsigned                          m_udp_heartbeat_tx_cnt;
@@ -328,6 +330,8 @@ class ReflectorLogic : public LogicBase
     void allEncodedSamplesFlushed(void);
     void flushTimeout(Async::Timer *t=0);
     void handleTimerTick(Async::Timer *t);
+    void jitterBufferSpurtEnded(
+        const Async::AudioAdaptiveJitterBuffer::Stats& stats);
     bool setAudioCodec(const std::string& codec_name);
     bool codecIsAvailable(const std::string &codec_name);
     void tgSelectTimerExpired(void);
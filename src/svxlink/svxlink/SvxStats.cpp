@@ -1,4 +1,6 @@
 #include "SvxStats.h"
+#include "MsgHandler.h"
+#include <LocationInfo.h>
 
 #include <AsyncTimer.h>
 
@@ -412,6 +414,8 @@ std::string SvxStats::formatStatsLine()
   const int64_t frn_rx_age_s = age_s(last_frn_rx_monotonic);
   const int64_t frn_tx_age_s = age_s(last_frn_tx_monotonic);
 
+  const MsgHandler::ClipCacheStats clips = MsgHandler::clipCacheStats();
+
   std::ostringstream os;
   os.setf(std::ios::fixed);
   os << "STATS"
@@ -461,8 +465,23 @@ std::string SvxStats::formatStatsLine()
      << " cmd_bc_attempt_1h=" << cmd_1h.bc_attempt
      << " cmd_avg_ms_1h=" << (cmd_1h.cnt_ms ? (cmd_1h.sum_ms / cmd_1h.cnt_ms) : 0)
      << " cmd_max_ms_1h=" << cmd_1h.max_ms
+
+     << " clip_cache_hits=" << clips.hits
+     << " clip_cache_misses=" << clips.misses
+     << " clip_cache_evictions=" << clips.evictions
+     << " clip_cache_kb=" << clips.bytes / 1024
      ;
 
+  if (LocationInfo::has_instance())
+  {
+    const LocationInfo::UpdateStats aprs =
+      LocationInfo::instance()->updateStats();
+    os << " aprs_updates_sent=" << aprs.sent
+       << " aprs_updates_suppressed=" << aprs.suppressed
+       << " aprs_update_avg_ms=" << std::lrint(1000.0 * aprs.avg_latency)
+       << " aprs_update_max_ms=" << std::lrint(1000.0 * aprs.max_latency);
+  }
+
   
   return os.str();
 }
@@ -614,6 +633,31 @@ std::vector<std::string> SvxStats::formatStatsGroups()
     out.push_back(os.str());
   }
 
+  // Sound clip cache
+  {
+    const MsgHandler::ClipCacheStats clips = MsgHandler::clipCacheStats();
+    std::ostringstream os;
+    os << "CLIPS hits=" << clips.hits
+       << " misses=" << clips.misses
+       << " evict=" << clips.evictions
+       << " clips=" << clips.clips
+       << " size=" << clips.bytes / 1024 << "kB";
+    out.push_back(os.str());
+  }
+
+  // APRS status updates
+  if (LocationInfo::has_instance())
+  {
+    const LocationInfo::UpdateStats aprs =
+      LocationInfo::instance()->updateStats();
+    std::ostringstream os;
+    os << "APRS sent=" << aprs.sent
+       << " suppressed=" << aprs.suppressed
+       << " avg=" << std::lrint(1000.0 * aprs.avg_latency) << "ms"
+       << " max=" << std::lrint(1000.0 * aprs.max_latency) << "ms";
+    out.push_back(os.str());
+  }
+
   return out;
 }
 
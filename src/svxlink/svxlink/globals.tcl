@@ -289,6 +289,26 @@ proc playMsg {context msg {warn 1}} {
 }
 
 
+#
+# Run the given script with all played messages collected into one batch. The
+# batch is rendered into one contiguous buffer before playback start so that
+# an announcement made up of many small clips, like a time or a callsign, is
+# played back without any per clip file handling in between. Batches may be
+# nested.
+#
+#   body - The script to run in the scope of the caller
+#
+proc playBatch {body} {
+  beginBatch
+  set code [catch {uplevel 1 $body} result options]
+  endBatch
+  if {$code == 1} {
+    return -options $options $result
+  }
+  return $result
+}
+
+
 #
 # Recursively print the TCL namespace tree
 #
@@ -13,22 +13,24 @@
 #   word -- The word to spell
 #
 proc spellWord {word} {
-  set phonetic_spelling [getConfigValue $::logic_name PHONETIC_SPELLING 1]
-  set word [string tolower $word];
-  for {set i 0} {$i < [string length $word]} {set i [expr $i + 1]} {
-    set char [string index $word $i];
-    if {[regexp {[a-z0-9]} $char]} {
-      if {$phonetic_spelling == 0} {
-        playMsg "Default" "$char";
-      } else {
-        playMsg "Default" "phonetic_$char";
+  playBatch {
+    set phonetic_spelling [getConfigValue $::logic_name PHONETIC_SPELLING 1]
+    set word [string tolower $word];
+    for {set i 0} {$i < [string length $word]} {set i [expr $i + 1]} {
+      set char [string index $word $i];
+      if {[regexp {[a-z0-9]} $char]} {
+        if {$phonetic_spelling == 0} {
+          playMsg "Default" "$char";
+        } else {
+          playMsg "Default" "phonetic_$char";
+        }
+      } elseif {$char == "/"} {
+        playMsg "Default" "slash";
+      } elseif {$char == "-"} {
+        playMsg "Default" "dash";
+      } elseif {$char == "*"} {
+        playMsg "Default" "star";
       }
-    } elseif {$char == "/"} {
-      playMsg "Default" "slash";
-    } elseif {$char == "-"} {
-      playMsg "Default" "dash";
-    } elseif {$char == "*"} {
-      playMsg "Default" "star";
     }
   }
 }
@@ -41,16 +43,18 @@ proc spellWord {word} {
 # a given number. There is no check that it's a valid number.
 #
 proc spellNumber {number} {
-  for {set i 0} {$i < [string length $number]} {set i [expr $i + 1]} {
-    set ch [string index $number $i];
-    if {$ch == "."} {
-      playMsg "Default" "decimal"
-    } elseif {$ch == "+"} {
-      playMsg "Default" "plus"
-    } elseif {$ch == "-"} {
-      playMsg "Default" "minus"
-    } else {
-      playMsg "Default" "$ch";
+  playBatch {
+    for {set i 0} {$i < [string length $number]} {set i [expr $i + 1]} {
+      set ch [string index $number $i];
+      if {$ch == "."} {
+        playMsg "Default" "decimal"
+      } elseif {$ch == "+"} {
+        playMsg "Default" "plus"
+      } elseif {$ch == "-"} {
+        playMsg "Default" "minus"
+      } else {
+        playMsg "Default" "$ch";
+      }
     }
   }
 }
@@ -130,42 +134,44 @@ proc playThreeDigitNumber {number} {
 #	+1.5	- plus one point five
 #
 proc playNumber {number} {
-  if {![regexp {^\s*([+-])?(\d*)(?:\.(\d+))?\s*$} $number \
-        -> sign integer fraction]} {
-    printError "Invalid number '$number' in playNumber"
-    return
-  }
+  playBatch {
+    if {![regexp {^\s*([+-])?(\d*)(?:\.(\d+))?\s*$} $number \
+          -> sign integer fraction]} {
+      printError "Invalid number '$number' in playNumber"
+      return
+    }
 
-  if {[string length "$integer"] == 0} {
-    set integer "0"
-  }
+    if {[string length "$integer"] == 0} {
+      set integer "0"
+    }
 
-  if [expr double("$integer.$fraction") != 0.0] {
-    if {$sign == "+"} {
-      playMsg "Default" "plus"
-    } elseif  {$sign == "-"} {
-      playMsg "Default" "minus"
+    if [expr double("$integer.$fraction") != 0.0] {
+      if {$sign == "+"} {
+        playMsg "Default" "plus"
+      } elseif  {$sign == "-"} {
+        playMsg "Default" "minus"
+      }
     }
-  }
 
-  if {$fraction != ""} {
-    playNumber $integer;
-    playMsg "Default" "decimal";
-    spellNumber $fraction;
-    return;
-  }
+    if {$fraction != ""} {
+      playNumber $integer;
+      playMsg "Default" "decimal";
+      spellNumber $fraction;
+      return;
+    }
 
-  while {[string length $integer] > 0} {
-    set len [string length $integer];
-    if {$len == 1} {
-      playMsg "Default" $integer;
-      set integer "";
-    } elseif {$len % 2 == 0} {
-      playTwoDigitNumber [string range $integer 0 1];
-      set integer [string range $integer 2 end];
-    } else {
-      playThreeDigitNumber [string range $integer 0 2];
-      set integer [string range $integer 3 end];
+    while {[string length $integer] > 0} {
+      set len [string length $integer];
+      if {$len == 1} {
+        playMsg "Default" $integer;
+        set integer "";
+      } elseif {$len % 2 == 0} {
+        playTwoDigitNumber [string range $integer 0 1];
+        set integer [string range $integer 2 end];
+      } else {
+        playThreeDigitNumber [string range $integer 0 2];
+        set integer [string range $integer 3 end];
+      }
     }
   }
 }
@@ -175,55 +181,57 @@ proc playNumber {number} {
 # Say the time specified by function arguments "hour" and "minute".
 #
 proc playTime {hour minute} {
-  set time_format [getConfigValue $::logic_name TIME_FORMAT 12]
+  playBatch {
+    set time_format [getConfigValue $::logic_name TIME_FORMAT 12]
 
-  # Strip white space and leading zeros. Check ranges.
-  if {[scan $hour "%d" hour] != 1 || $hour < 0 || $hour > 23} {
-    error "playTime: Non digit hour or value out of range: $hour"
-  }
-  if {[scan $minute "%d" minute] != 1 || $minute < 0 || $minute > 59} {
-    error "playTime: Non digit minute or value out of range: $hour"
-  }
-
-  if {$time_format == 24} {
-    if {$hour == 0} {
-      set hour "00"
-    } elseif {[string length $hour] == 1} {
-      set hour "o$hour";
+    # Strip white space and leading zeros. Check ranges.
+    if {[scan $hour "%d" hour] != 1 || $hour < 0 || $hour > 23} {
+      error "playTime: Non digit hour or value out of range: $hour"
     }
-    playTwoDigitNumber $hour;
-
-    if {$minute != 0} {
-      if {[string length $minute] == 1} {
-        set minute "o$minute";
-      }
-      playTwoDigitNumber $minute;
+    if {[scan $minute "%d" minute] != 1 || $minute < 0 || $minute > 59} {
+      error "playTime: Non digit minute or value out of range: $hour"
     }
-    playMsg "Default" "hours";
-    playSilence 100;
-  } else {
-    # Anything not 24 will fail back to 12 hour default
-    if {$hour < 12} {
-      set ampm "AM";
+
+    if {$time_format == 24} {
       if {$hour == 0} {
-        set hour 12;
+        set hour "00"
+      } elseif {[string length $hour] == 1} {
+        set hour "o$hour";
+      }
+      playTwoDigitNumber $hour;
+
+      if {$minute != 0} {
+        if {[string length $minute] == 1} {
+          set minute "o$minute";
+        }
+        playTwoDigitNumber $minute;
       }
+      playMsg "Default" "hours";
+      playSilence 100;
     } else {
-      set ampm "PM";
-      if {$hour > 12} {
-        set hour [expr $hour - 12];
+      # Anything not 24 will fail back to 12 hour default
+      if {$hour < 12} {
+        set ampm "AM";
+        if {$hour == 0} {
+          set hour 12;
+        }
+      } else {
+        set ampm "PM";
+        if {$hour > 12} {
+          set hour [expr $hour - 12];
+        }
       }
-    }
   
-    playMsg "Default" [expr $hour];
-    if {$minute != 0} {
-      if {[string length $minute] == 1} {
-        set minute "o$minute";
+      playMsg "Default" [expr $hour];
+      if {$minute != 0} {
+        if {[string length $minute] == 1} {
+          set minute "o$minute";
+        }
+        playTwoDigitNumber $minute;
       }
-      playTwoDigitNumber $minute;
+      playSilence 100;
+      playMsg "Core" $ampm;
     }
-    playSilence 100;
-    playMsg "Core" $ampm;
   }
 }
 
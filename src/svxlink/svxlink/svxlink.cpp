@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -58,6 +58,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncTimer.h>
 #include <AsyncFdWatch.h>
 #include <AsyncAudioIO.h>
+#include <AsyncMetricsHttpServer.h>
 #include <LocationInfo.h>
 #include <common.h>
 #include <config.h>
@@ -74,6 +75,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Logic.h"
 #include "LinkManager.h"
 #include "SvxStats.h"
+#include "MsgHandler.h"
 
 
 /****************************************************************************
@@ -140,6 +142,7 @@ namespace {
   int                   daemonize = 0;
   int                   reset = 0;
   int                   quiet = 0;
+  int                   virtual_clock = 0;
   vector<LogicBase*>    logic_vec;
   FdWatch*              stdin_watch = 0;
   LogWriter             logwriter;
@@ -180,6 +183,11 @@ int main(int argc, char **argv)
 
   parse_arguments(argc, const_cast<const char **>(argv));
 
+  if (virtual_clock)
+  {
+    app.setVirtualClock(true);
+  }
+
   if (daemonize && (daemon(1, 0) == -1))
   {
     perror("daemon");
@@ -373,7 +381,7 @@ int main(int argc, char **argv)
   logwriter.setTimestampFormat(tstamp_format);
 
   cout << PROGRAM_NAME " v" SVXLINK_VERSION
-          " Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX\n\n";
+          " Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX\n\n";
   cout << PROGRAM_NAME " comes with ABSOLUTELY NO WARRANTY. "
           "This is free software, and you are\n";
   cout << "welcome to redistribute it in accordance with the terms "
@@ -444,6 +452,18 @@ int main(int argc, char **argv)
     }
   }
 
+  unsigned clip_cache_size = 0;
+  cfg.getValue("GLOBAL", "SOUND_CLIP_CACHE_SIZE", clip_cache_size);
+  MsgHandler::setClipCacheSize(1024 * static_cast<size_t>(clip_cache_size));
+  if (clip_cache_size > 0)
+  {
+    string clip_preload_dir;
+    if (cfg.getValue("GLOBAL", "SOUND_CLIP_CACHE_PRELOAD", clip_preload_dir))
+    {
+      MsgHandler::preloadClips(clip_preload_dir);
+    }
+  }
+
   initialize_logics(cfg);
 
   // Start periodic statistics logging (configurable)
@@ -462,6 +482,13 @@ int main(int argc, char **argv)
   SvxStats::instance().loadPersistedTotals();
   SvxStats::instance().start(stats_int_s);
 
+  Async::MetricsHttpServer* metrics_server = nullptr;
+  std::string metrics_port;
+  if (cfg.getValue("GLOBAL", "METRICS_HTTP_PORT", metrics_port))
+  {
+    metrics_server = new Async::MetricsHttpServer(metrics_port);
+  }
+
 
   if (LinkManager::hasInstance())
   {
@@ -493,6 +520,10 @@ int main(int argc, char **argv)
             << std::endl;
   app.exec();
 
+  app.printLoopStats(std::cout);
+
+  delete metrics_server;
+
   LinkManager::deleteInstance();
   LocationInfo::deleteInstance();
 
@@ -558,6 +589,9 @@ static void parse_arguments(int argc, const char **argv)
 	    "Initialize all hardware to initial state then quit", NULL},
     {"quiet", 0, POPT_ARG_NONE, &quiet, 0,
 	    "Don't print any info messages, just warnings and errors", NULL},
+    {"virtual-clock", 0, POPT_ARG_NONE, &virtual_clock, 0,
+	    "Run timers on a simulated clock to replay recorded audio "
+            "faster than real time", NULL},
     {"version", 0, POPT_ARG_NONE, &print_version, 0,
 	    "Print the application version string", NULL},
     {NULL, 0, 0, NULL, 0}
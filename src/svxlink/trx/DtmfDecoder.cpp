@@ -57,6 +57,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "S54sDtmfDecoder.h"
 #include "AfskDtmfDecoder.h"
 #include "PtyDtmfDecoder.h"
+#include "ReplayDtmfDecoder.h"
 
 
 /****************************************************************************
@@ -141,6 +142,10 @@ DtmfDecoder *DtmfDecoder::create(Rx *rx, Config &cfg, const string& name)
   {
     dec = new Dh1dmSwDtmfDecoder(cfg, name);
   }
+  else if (type == "REPLAY")
+  {
+    dec = new ReplayDtmfDecoder(cfg, name);
+  }
   else
   {
     cerr << "*** ERROR: Unknown DTMF decoder type \"" << type << "\" "
@@ -43,6 +43,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
+#include <AsyncApplication.h>
 
 
 /****************************************************************************
@@ -171,7 +172,7 @@ void HwDtmfDecoder::digitActive(char digit)
 
   state = STATE_ACTIVE;
   last_detected_digit = digit;
-  gettimeofday(&det_timestamp, NULL);
+  Async::Application::app().getTimeOfDay(&det_timestamp);
   digitActivated(digit);
   timeout_timer = new Timer(MAX_ACTIVE_TIME * 1000);
   timeout_timer->expired.connect(mem_fun(*this, &HwDtmfDecoder::timeout));
@@ -229,7 +230,7 @@ void HwDtmfDecoder::setIdle(void)
   timeout_timer = 0;
   
   struct timeval diff, now;
-  gettimeofday(&now, NULL);
+  Async::Application::app().getTimeOfDay(&now);
   timersub(&now, &det_timestamp, &diff);
   digitDeactivated(last_detected_digit,
       diff.tv_sec * 1000 + diff.tv_usec / 1000);
@@ -0,0 +1,211 @@
+/**
+@file	 ReplayDtmfDecoder.cpp
+@brief   A DTMF decoder that replay DTMF digits from an event file
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <cctype>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReplayDtmfDecoder.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace sigc;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ReplayDtmfDecoder::ReplayDtmfDecoder(Config &cfg, const string &name)
+  : HwDtmfDecoder(cfg, name), digit_timer(0, Timer::TYPE_ONESHOT, false)
+{
+  digit_timer.expired.connect(sigc::hide(
+        sigc::mem_fun(*this, &ReplayDtmfDecoder::digitIdle)));
+} /* ReplayDtmfDecoder::ReplayDtmfDecoder */
+
+
+ReplayDtmfDecoder::~ReplayDtmfDecoder(void)
+{
+} /* ReplayDtmfDecoder::~ReplayDtmfDecoder */
+
+
+bool ReplayDtmfDecoder::initialize(void)
+{
+  if (!HwDtmfDecoder::initialize())
+  {
+    return false;
+  }
+
+  string event_file;
+  if (!cfg().getValue(name(), "REPLAY_EVENT_FILE", event_file))
+  {
+    cerr << "*** ERROR: Config variable " << name()
+      	 << "/REPLAY_EVENT_FILE not specified\n";
+    return false;
+  }
+
+  if (!events.open(event_file))
+  {
+    return false;
+  }
+  events.eventReceived.connect(
+      sigc::mem_fun(*this, &ReplayDtmfDecoder::eventReceived));
+  events.start();
+
+  return true;
+} /* ReplayDtmfDecoder::initialize */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void ReplayDtmfDecoder::eventReceived(const string& name, const string& args)
+{
+  if (name != "DTMF")
+  {
+    return;
+  }
+
+  istringstream ss(args);
+  char digit = '?';
+  int duration = DEFAULT_DIGIT_DURATION;
+  ss >> digit >> duration;
+  digit = toupper(digit);
+  if (digit == 'E')
+  {
+    digit = '*';
+  }
+  else if (digit == 'F')
+  {
+    digit = '#';
+  }
+  if (!(((digit >= '0') && (digit <= '9')) ||
+        ((digit >= 'A') && (digit <= 'D')) ||
+        (digit == '*') || (digit == '#')))
+  {
+    cerr << "*** WARNING: Illegal DTMF digit in replay event file for "
+         << this->name() << ": " << args << endl;
+    return;
+  }
+
+  digitActive(digit);
+  digit_timer.setTimeout(max(duration, 0));
+  digit_timer.setEnable(true);
+} /* ReplayDtmfDecoder::eventReceived */
+
+
+
+/*
+ * This file has not been truncated
+ */
+
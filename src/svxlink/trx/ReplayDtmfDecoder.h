@@ -0,0 +1,185 @@
+/**
+@file	 ReplayDtmfDecoder.h
+@brief   A DTMF decoder that replay DTMF digits from an event file
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef REPLAY_DTMF_DECODER_INCLUDED
+#define REPLAY_DTMF_DECODER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "HwDtmfDecoder.h"
+#include "ReplayEventFile.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief   A DTMF decoder that replay DTMF digits from an event file
+ * @author  Tobias Blomberg / SM0SVX
+ * @date    2026-10-18
+ *
+ * This class read DTMF digits from a replay event file (see ReplayEventFile),
+ * given by the REPLAY_EVENT_FILE configuration variable. Lines on the form
+ * "<time_ms> DTMF <digit> [<duration_ms>]" will activate the given digit for
+ * the given duration (default 100ms). It is used together with the file
+ * audio device to replay a recorded session.
+ */
+class ReplayDtmfDecoder : public HwDtmfDecoder
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param 	cfg A previously initialised configuration object
+     * @param 	name The name of the receiver configuration section
+     */
+    ReplayDtmfDecoder(Async::Config &cfg, const std::string &name);
+
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~ReplayDtmfDecoder(void);
+
+    /**
+     * @brief 	Initialize the DTMF decoder
+     * @returns Returns \em true if the initialization was successful or
+     *          else \em false.
+     *
+     * Call this function to initialize the DTMF decoder. It must be called
+     * before using it.
+     */
+    virtual bool initialize(void);
+
+    /**
+     * @brief 	Write samples into the DTMF decoder
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count) { return count; }
+
+    /**
+     * @brief 	Tell the DTMF decoder to flush the previously written samples
+     *
+     * This function is used to tell the sink to flush previously written
+     * samples. When done flushing, the sink should call the
+     * sourceAllSamplesFlushed function.
+     */
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+
+    /**
+     * @brief   The detection time for this detector
+     * @returns Returns the detection time in milliseconds
+     *
+     * This function will return the time in milliseconds that it will take
+     * for the detector to detect a DTMF digit. That is, the time from the
+     * moment when the tone is activated until the digitActivated signal is
+     * emitted.
+     * The time can for example be used in a DTMF muting function.
+     */
+    virtual int detectionTime(void) const { return 0; }
+
+  protected:
+
+  private:
+    static const int DEFAULT_DIGIT_DURATION = 100;
+
+    ReplayEventFile events;
+    Async::Timer    digit_timer;
+
+    void eventReceived(const std::string& name, const std::string& args);
+
+};  /* class ReplayDtmfDecoder */
+
+
+//} /* namespace */
+
+#endif /* REPLAY_DTMF_DECODER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
+
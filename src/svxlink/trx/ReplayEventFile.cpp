@@ -0,0 +1,242 @@
+/**
+@file	 ReplayEventFile.cpp
+@brief   Read timestamped receiver events from a file
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReplayEventFile.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ReplayEventFile::ReplayEventFile(void)
+  : next_event(0), timer(0, Timer::TYPE_ONESHOT, false)
+{
+  timerclear(&start_time);
+  timer.expired.connect(mem_fun(*this, &ReplayEventFile::onTimerExpired));
+} /* ReplayEventFile::ReplayEventFile */
+
+
+ReplayEventFile::~ReplayEventFile(void)
+{
+} /* ReplayEventFile::~ReplayEventFile */
+
+
+bool ReplayEventFile::open(const string& filename)
+{
+  ifstream is(filename.c_str());
+  if (!is)
+  {
+    cerr << "*** ERROR: Could not open replay event file \"" << filename
+         << "\"\n";
+    return false;
+  }
+
+  events.clear();
+  next_event = 0;
+  string line;
+  unsigned lineno = 0;
+  while (getline(is, line))
+  {
+    ++lineno;
+    istringstream ss(line);
+    Event event;
+    if (!(ss >> event.time_ms))
+    {
+      ss.clear();
+      string first;
+      if (!(ss >> first) || (first[0] == '#'))
+      {
+        continue;
+      }
+      cerr << "*** ERROR: Illegal timestamp in replay event file \""
+           << filename << "\" on line " << lineno << endl;
+      return false;
+    }
+    if (!(ss >> event.name))
+    {
+      cerr << "*** ERROR: Missing event name in replay event file \""
+           << filename << "\" on line " << lineno << endl;
+      return false;
+    }
+    getline(ss >> ws, event.args);
+    events.push_back(event);
+  }
+
+  stable_sort(events.begin(), events.end(),
+      [](const Event& a, const Event& b) { return a.time_ms < b.time_ms; });
+
+  return true;
+
+} /* ReplayEventFile::open */
+
+
+void ReplayEventFile::start(void)
+{
+  Application::app().getTimeOfDay(&start_time);
+  next_event = 0;
+  scheduleNext();
+} /* ReplayEventFile::start */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void ReplayEventFile::scheduleNext(void)
+{
+  if (next_event >= events.size())
+  {
+    timer.setEnable(false);
+    return;
+  }
+
+  struct timeval now, diff;
+  Application::app().getTimeOfDay(&now);
+  timersub(&now, &start_time, &diff);
+  long long elapsed_ms = static_cast<long long>(diff.tv_sec) * 1000
+                         + diff.tv_usec / 1000;
+  long long timeout = events[next_event].time_ms - elapsed_ms;
+  timer.setTimeout(static_cast<int>(max(timeout, 0LL)));
+  timer.setEnable(true);
+} /* ReplayEventFile::scheduleNext */
+
+
+void ReplayEventFile::onTimerExpired(Timer *t)
+{
+  struct timeval now, diff;
+  Application::app().getTimeOfDay(&now);
+  timersub(&now, &start_time, &diff);
+  long long elapsed_ms = static_cast<long long>(diff.tv_sec) * 1000
+                         + diff.tv_usec / 1000;
+  while ((next_event < events.size()) &&
+         (events[next_event].time_ms <= elapsed_ms))
+  {
+    const Event& event = events[next_event++];
+    eventReceived(event.name, event.args);
+  }
+  scheduleNext();
+} /* ReplayEventFile::onTimerExpired */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,197 @@
+/**
+@file	 ReplayEventFile.h
+@brief   Read timestamped receiver events from a file
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef REPLAY_EVENT_FILE_INCLUDED
+#define REPLAY_EVENT_FILE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <sys/time.h>
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	Read timestamped receiver events from a file
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This class read a file containing timestamped receiver events, like squelch
+and DTMF events, and emit them at the correct time relative to when the
+start function was called. It is used to replay recorded sessions together
+with the file audio device. The file format is line based:
+
+  <time in milliseconds> <event name> [<arguments>]
+
+Empty lines and lines starting with '#' are ignored. Example:
+
+  # Squelch open after 1.2 seconds, DTMF digit 5 for 100ms, squelch close
+  1200 SQL 1
+  1350 DTMF 5 100
+  5400 SQL 0
+
+The timing is handled using Async::Timer objects so when the application
+virtual clock is enabled, the events will be kept in sync with the replayed
+audio.
+*/
+class ReplayEventFile : public sigc::trackable
+{
+  public:
+    /**
+     * @brief 	Default constructor
+     */
+    ReplayEventFile(void);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~ReplayEventFile(void);
+
+    /**
+     * @brief 	Read events from the given file
+     * @param 	filename The path to the event file
+     * @return	Return \em true on success or else \em false
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief   Start emitting events
+     *
+     * The event timestamps are relative to the time when this function is
+     * called.
+     */
+    void start(void);
+
+    /**
+     * @brief   A signal that is emitted when an event is due
+     * @param   name The name of the event (e.g. SQL or DTMF)
+     * @param   args The arguments to the event
+     */
+    sigc::signal<void(const std::string&, const std::string&)> eventReceived;
+
+  private:
+    struct Event
+    {
+      long long   time_ms;
+      std::string name;
+      std::string args;
+    };
+    typedef std::vector<Event> EventList;
+
+    EventList           events;
+    EventList::size_type next_event;
+    struct timeval      start_time;
+    Async::Timer        timer;
+
+    ReplayEventFile(const ReplayEventFile&);
+    ReplayEventFile& operator=(const ReplayEventFile&);
+    void scheduleNext(void);
+    void onTimerExpired(Async::Timer *t);
+
+};  /* class ReplayEventFile */
+
+
+//} /* namespace */
+
+#endif /* REPLAY_EVENT_FILE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
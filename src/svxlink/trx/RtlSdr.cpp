@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2015 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -280,20 +280,24 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
 {
   //cout << "RtlSdr::handleIq: samp_count=" << samp_count << endl;
 
-  vector<Sample> iq;
-  iq.reserve(samp_count);
-  for (int idx=0; idx<samp_count; ++idx)
+    // The I and Q values are converted as one array of interleaved bytes
+    // into the float array of the complex output samples. The loop is kept
+    // simple, without branches, so that the compiler can vectorize it. The
+    // output buffer is kept between calls so it's only allocated once.
+  iq_buf.resize(samp_count);
+  const uint8_t *in = reinterpret_cast<const uint8_t*>(samples);
+  float *out = reinterpret_cast<float*>(iq_buf.data());
+  const int val_count = 2 * samp_count;
+  uint8_t max_val = 0;
+  for (int idx=0; idx<val_count; ++idx)
   {
-    if ((dist_print_cnt == 0) &&
-        ((samples[idx].real() == 255) || (samples[idx].imag() == 255)))
-    {
-      dist_print_cnt = samp_rate;
-    }
-    float i = samples[idx].real();
-    i = i / 127.5f - 1.0f;
-    float q = samples[idx].imag();
-    q = q / 127.5f - 1.0f;
-    iq.push_back(complex<float>(i, q));
+    max_val = (in[idx] > max_val) ? in[idx] : max_val;
+    out[idx] = in[idx] * (1.0f / 127.5f) - 1.0f;
+  }
+
+  if ((dist_print_cnt == 0) && (max_val == 255))
+  {
+    dist_print_cnt = samp_rate;
   }
 
   if (dist_print_cnt > 0)
@@ -310,7 +314,7 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
     }
   }
 
-  iqReceived(iq);
+  iqReceived(iq_buf);
 } /* RtlSdr::handleIq */
 
 
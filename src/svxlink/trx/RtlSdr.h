@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2015 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -294,9 +294,11 @@ class RtlSdr : public sigc::trackable
      *
      * Connecting to this signal is the way to get samples from the DVB-T
      * dongle. The format is a vector of complex floats (I/Q) with a range from
-     * -1 to 1.
+     * -1 to 1. The same vector is passed to all connected slots and it is
+     * reused for the next block so a slot that need to keep the samples after
+     * it returns must copy them.
      */
-    sigc::signal<void(std::vector<Sample>)> iqReceived;
+    sigc::signal<void(const std::vector<Sample>&)> iqReceived;
 
     /**
      * @brief   A signal that is emitted when the ready state changes
@@ -416,6 +418,7 @@ class RtlSdr : public sigc::trackable
     bool              use_digital_agc_set;
     bool              use_digital_agc;
     int               dist_print_cnt;
+    std::vector<Sample> iq_buf;
 
     RtlSdr(const RtlSdr&);
     RtlSdr& operator=(const RtlSdr&);
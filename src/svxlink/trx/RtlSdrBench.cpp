@@ -0,0 +1,183 @@
+#include <iostream>
+#include <vector>
+#include <complex>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#include "RtlSdr.h"
+
+using namespace std;
+
+
+/*
+ * Benchmark for the conversion and distribution of IQ samples from an RTL
+ * dongle.
+ *
+ * Usage: RtlSdrBench [channels] [seconds]
+ *
+ * Blocks of random 8 bit IQ samples, 10 ms each at 2.4 MS/s, are converted
+ * to complex floats and delivered to the given number of channels. The
+ * conversion is first done using the old per sample loop, as a reference,
+ * and then by RtlSdr. Delivery is measured both by passing a copy of each
+ * block to each channel, as was done before, and by passing the same block
+ * by reference. The throughput is printed in MB/s of raw IQ data and the
+ * output from RtlSdr is checked against the reference conversion.
+ */
+
+namespace {
+const unsigned SAMP_RATE  = 2400000;
+const int      BLOCK_SIZE = SAMP_RATE / 100;
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+class BenchRtlSdr : public RtlSdr
+{
+  public:
+    void feed(const std::vector<std::complex<uint8_t>>& block)
+    {
+      handleIq(block.data(), block.size());
+    }
+
+    bool isReady(void) const override { return true; }
+    const std::string displayName(void) const override { return "bench"; }
+
+  protected:
+    void handleSetTunerIfGain(uint16_t, int16_t) override {}
+    void handleSetCenterFq(uint32_t) override {}
+    void handleSetSampleRate(uint32_t) override {}
+    void handleSetGainMode(uint32_t) override {}
+    void handleSetGain(int32_t) override {}
+    void handleSetFqCorr(int) override {}
+    void handleEnableTestMode(bool) override {}
+    void handleEnableDigitalAgc(bool) override {}
+};
+
+void convertReference(std::vector<RtlSdr::Sample>& iq,
+                      const std::vector<std::complex<uint8_t>>& block)
+{
+  iq.clear();
+  iq.reserve(block.size());
+  for (const auto& samp : block)
+  {
+    float i = samp.real();
+    i = i / 127.5f - 1.0f;
+    float q = samp.imag();
+    q = q / 127.5f - 1.0f;
+    iq.push_back(complex<float>(i, q));
+  }
+}
+
+struct Channel
+{
+  float sum = 0.0f;
+  void iqReceived(const std::vector<RtlSdr::Sample>& samples)
+  {
+    sum += samples.front().real() + samples.back().imag();
+  }
+  void iqReceivedCopy(std::vector<RtlSdr::Sample> samples)
+  {
+    sum += samples.front().real() + samples.back().imag();
+  }
+};
+
+void printResult(const char* name, unsigned blocks, unsigned channels,
+                 double time)
+{
+  double mbytes = 2.0 * BLOCK_SIZE * blocks / 1.0e6;
+  printf("%-20s %3u channels: %8.1f MB/s (%5.2f%% of one core at %.1f MS/s)\n",
+         name, channels, mbytes / time,
+         100.0 * time / (static_cast<double>(BLOCK_SIZE) * blocks / SAMP_RATE),
+         SAMP_RATE / 1.0e6);
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  unsigned channels = 8;
+  unsigned seconds = 10;
+  if (argc > 1)
+  {
+    channels = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seconds = atoi(argv[2]);
+  }
+  if (seconds < 1)
+  {
+    cerr << "Usage: RtlSdrBench [channels] [seconds]\n";
+    exit(1);
+  }
+  const unsigned blocks = seconds * 100;
+
+  std::mt19937 rng(4711);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<std::vector<std::complex<uint8_t>>> input(16);
+  for (auto& block : input)
+  {
+    block.resize(BLOCK_SIZE);
+    for (auto& samp : block)
+    {
+      samp = std::complex<uint8_t>(dist(rng), dist(rng));
+    }
+  }
+
+  std::vector<Channel> chs(channels);
+
+    // Old conversion, each channel get its own copy of the block
+  sigc::signal<void(std::vector<RtlSdr::Sample>)> copy_sig;
+  for (auto& ch : chs)
+  {
+    copy_sig.connect(sigc::mem_fun(ch, &Channel::iqReceivedCopy));
+  }
+  std::vector<RtlSdr::Sample> ref;
+  double start = cpuTime();
+  for (unsigned i=0; i<blocks; ++i)
+  {
+    convertReference(ref, input[i % input.size()]);
+    copy_sig(ref);
+  }
+  printResult("Reference + copy", blocks, channels, cpuTime() - start);
+
+    // New conversion, all channels get the same block
+  BenchRtlSdr rtl;
+  for (auto& ch : chs)
+  {
+    rtl.iqReceived.connect(sigc::mem_fun(ch, &Channel::iqReceived));
+  }
+  start = cpuTime();
+  for (unsigned i=0; i<blocks; ++i)
+  {
+    rtl.feed(input[i % input.size()]);
+  }
+  printResult("RtlSdr + shared", blocks, channels, cpuTime() - start);
+
+    // Check the output from RtlSdr against the reference conversion
+  float max_err = 0.0f;
+  rtl.iqReceived.connect([&](const std::vector<RtlSdr::Sample>& samples)
+      {
+        for (size_t idx=0; idx<samples.size(); ++idx)
+        {
+          max_err = std::max(max_err, std::abs(samples[idx] - ref[idx]));
+        }
+      });
+  for (const auto& block : input)
+  {
+    convertReference(ref, block);
+    rtl.feed(block);
+  }
+  printf("Max conversion error: %g\n", max_err);
+
+  bool ok = (max_err < 1.0e-6f);
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+} /* main */
@@ -54,6 +54,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Rx.h"
 #include "SigLevDet.h"
 #include "SigLevDetNoise.h"
+#include "SigLevDetNoiseBank.h"
 #include "SigLevDetTone.h"
 #include "SigLevDetDdr.h"
 #include "SigLevDetSim.h"
@@ -143,6 +144,8 @@ SigLevDet* createSigLevDet(Async::Config& cfg, const std::string& name)
 {
   static SigLevDetSpecificFactory<SigLevDetNone> none_siglev_factory;
   static SigLevDetSpecificFactory<SigLevDetNoise> noise_siglev_factory;
+  static SigLevDetSpecificFactory<SigLevDetNoiseBank>
+    noise_bank_siglev_factory;
   static SigLevDetSpecificFactory<SigLevDetTone> tone_siglev_factory;
   static SigLevDetSpecificFactory<SigLevDetDdr> ddr_siglev_factory;
   static SigLevDetSpecificFactory<SigLevDetSim> sim_siglev_factory;
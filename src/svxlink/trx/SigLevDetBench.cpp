@@ -0,0 +1,142 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#include <AsyncConfig.h>
+
+#include "SigLevDet.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Benchmark and compare the NOISE and the NOISE_BANK signal level detectors.
+ *
+ * Usage: SigLevDetBench [channels] [seconds]
+ *
+ * The same noise, with a different level for each channel, is fed through
+ * one NOISE detector and one NOISE_BANK detector per channel. The CPU time
+ * used per channel and audio second is printed together with the largest
+ * difference in the measured signal level between the two detector types.
+ */
+
+namespace {
+const int BLOCK_SIZE = 256;
+
+double cpuTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+vector<SigLevDet*> createDetectors(Config& cfg, const string& type,
+                                   int channels)
+{
+  vector<SigLevDet*> dets;
+  for (int ch=0; ch<channels; ++ch)
+  {
+    string name = type + "_Rx" + to_string(ch + 1);
+    cfg.setValue(name, "SIGLEV_DET", type);
+    SigLevDet *det = createSigLevDet(cfg, name);
+    if (det == 0)
+    {
+      exit(1);
+    }
+    det->setIntegrationTime(1000);
+    dets.push_back(det);
+  }
+  return dets;
+}
+
+double run(vector<SigLevDet*>& dets, const vector<vector<float> >& audio)
+{
+  double start = cpuTime();
+  size_t len = audio[0].size();
+  for (size_t pos=0; pos<len; pos+=BLOCK_SIZE)
+  {
+    for (size_t ch=0; ch<dets.size(); ++ch)
+    {
+      dets[ch]->writeSamples(&audio[ch][pos], BLOCK_SIZE);
+    }
+  }
+  return cpuTime() - start;
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  int channels = 12;
+  int seconds = 60;
+  if (argc > 1)
+  {
+    channels = atoi(argv[1]);
+  }
+  if (argc > 2)
+  {
+    seconds = atoi(argv[2]);
+  }
+  if ((channels < 1) || (seconds < 1))
+  {
+    cerr << "Usage: SigLevDetBench [channels] [seconds]\n";
+    exit(1);
+  }
+
+  size_t len = static_cast<size_t>(seconds) * INTERNAL_SAMPLE_RATE;
+  len -= len % BLOCK_SIZE;
+  mt19937 gen(4711);
+  normal_distribution<float> noise(0.0f, 1.0f);
+  vector<vector<float> > audio(channels);
+  for (int ch=0; ch<channels; ++ch)
+  {
+    float level = 0.5f / (ch + 1);
+    audio[ch].resize(len);
+    for (auto& sample : audio[ch])
+    {
+      sample = level * noise(gen);
+    }
+  }
+
+  Config cfg;
+  vector<SigLevDet*> noise_dets = createDetectors(cfg, "NOISE", channels);
+  vector<SigLevDet*> bank_dets = createDetectors(cfg, "NOISE_BANK", channels);
+
+  double noise_time = run(noise_dets, audio);
+  double bank_time = run(bank_dets, audio);
+
+  float max_diff = 0.0f;
+  for (int ch=0; ch<channels; ++ch)
+  {
+    float diff = noise_dets[ch]->siglevIntegrated() -
+                 bank_dets[ch]->siglevIntegrated();
+    max_diff = max(max_diff, abs(diff));
+    diff = noise_dets[ch]->lastSiglev() - bank_dets[ch]->lastSiglev();
+    max_diff = max(max_diff, abs(diff));
+  }
+
+  printf("Channels                   : %d\n", channels);
+  printf("Audio length               : %ds\n", seconds);
+  printf("NOISE      CPU/ch/audio s  : %.1fus\n",
+         1.0e6 * noise_time / channels / seconds);
+  printf("NOISE_BANK CPU/ch/audio s  : %.1fus\n",
+         1.0e6 * bank_time / channels / seconds);
+  printf("Speedup                    : %.2f\n", noise_time / bank_time);
+  printf("Max siglev difference      : %g\n", max_diff);
+
+  for (auto det : noise_dets)
+  {
+    delete det;
+  }
+  for (auto det : bank_dets)
+  {
+    delete det;
+  }
+
+  return (max_diff < 0.01f) ? 0 : 1;
+} /* main */
@@ -136,16 +136,7 @@ SigLevDetNoise::~SigLevDetNoise(void)
 bool SigLevDetNoise::initialize(Config &cfg, const string& name,
                                 int sample_rate)
 {
-  this->sample_rate = sample_rate;
-  block_len = BLOCK_TIME * sample_rate / 1000;
-  if (sample_rate >= 16000)
-  {
-    filter = new AudioFilter("BpBu4/5000-5500", sample_rate);
-  }
-  else
-  {
-    filter = new AudioFilter("HpBu4/3500", sample_rate);
-  }
+  filter = new AudioFilter(filterSpec(sample_rate), sample_rate);
   setHandler(filter);
   sigc_sink = new SigCAudioSink;
   sigc_sink->sigWriteSamples.connect(
@@ -153,15 +144,8 @@ bool SigLevDetNoise::initialize(Config &cfg, const string& name,
   sigc_sink->sigFlushSamples.connect(
       mem_fun(*sigc_sink, &SigCAudioSink::allSamplesFlushed));
   sigc_sink->registerSource(filter);
-  setIntegrationTime(0);
-
-  cfg.getValue(name, "SIGLEV_OFFSET", offset);
-  cfg.getValue(name, "SIGLEV_SLOPE", slope);
-  cfg.getValue(name, "SIGLEV_BOGUS_THRESH", bogus_thresh);
 
-  reset();
-
-  return SigLevDet::initialize(cfg, name, sample_rate);
+  return initDetector(cfg, name, sample_rate);
 
 } /* SigLevDetNoise::initialize */
 
@@ -265,12 +249,11 @@ float SigLevDetNoise::siglevIntegrated(void) const
 
 void SigLevDetNoise::reset(void)
 {
-  filter->reset();
-  update_counter = 0;
-  ss_values.clear();
-  ss_idx.clear();
-  ss_cnt = 0;
-  ss = 0.0;
+  if (filter != 0)
+  {
+    filter->reset();
+  }
+  resetIntegration();
 } /* SigLevDetNoise::reset */
 
 
@@ -281,6 +264,68 @@ void SigLevDetNoise::reset(void)
  *
  ****************************************************************************/
 
+const char *SigLevDetNoise::filterSpec(int sample_rate)
+{
+  if (sample_rate >= 16000)
+  {
+    return "BpBu4/5000-5500";
+  }
+  return "HpBu4/3500";
+} /* SigLevDetNoise::filterSpec */
+
+
+bool SigLevDetNoise::initDetector(Config &cfg, const string& name,
+                                  int sample_rate)
+{
+  this->sample_rate = sample_rate;
+  block_len = BLOCK_TIME * sample_rate / 1000;
+  setIntegrationTime(0);
+
+  cfg.getValue(name, "SIGLEV_OFFSET", offset);
+  cfg.getValue(name, "SIGLEV_SLOPE", slope);
+  cfg.getValue(name, "SIGLEV_BOGUS_THRESH", bogus_thresh);
+
+  reset();
+
+  return SigLevDet::initialize(cfg, name, sample_rate);
+} /* SigLevDetNoise::initDetector */
+
+
+void SigLevDetNoise::addBlockPower(double ss)
+{
+  SsSetIter it = ss_values.insert(ss);
+  ss_idx.push_back(it);
+  if (ss_idx.size() > integration_time / block_len)
+  {
+    ss_values.erase(*ss_idx.begin());
+    ss_idx.pop_front();
+  }
+} /* SigLevDetNoise::addBlockPower */
+
+
+void SigLevDetNoise::samplesProcessed(int count)
+{
+  if (update_interval > 0)
+  {
+    update_counter += count;
+    if (update_counter >= update_interval)
+    {
+      signalLevelUpdated(siglevIntegrated());
+      update_counter = 0;
+    }
+  }
+} /* SigLevDetNoise::samplesProcessed */
+
+
+void SigLevDetNoise::resetIntegration(void)
+{
+  update_counter = 0;
+  ss_values.clear();
+  ss_idx.clear();
+  ss_cnt = 0;
+  ss = 0.0;
+} /* SigLevDetNoise::resetIntegration */
+
 
 
 /****************************************************************************
@@ -297,28 +342,13 @@ int SigLevDetNoise::processSamples(float *samples, int count)
     ss += static_cast<double>(sample) * sample;
     if (++ss_cnt >= block_len)
     {
-      SsSetIter it = ss_values.insert(ss);
-      ss_idx.push_back(it);
-      if (ss_idx.size() > integration_time / block_len)
-      {
-        ss_values.erase(*ss_idx.begin());
-        ss_idx.pop_front();
-      }
-
+      addBlockPower(ss);
       ss = 0.0;
       ss_cnt = 0;
     }
   }
 
-  if (update_interval > 0)
-  {
-    update_counter += count;
-    if (update_counter >= update_interval)
-    {
-      signalLevelUpdated(siglevIntegrated());
-      update_counter = 0;
-    }
-  }
+  samplesProcessed(count);
   
   return count;
   
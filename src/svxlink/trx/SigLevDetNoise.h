@@ -206,14 +206,56 @@ class SigLevDetNoise : public SigLevDet
      
     
   protected:
-    
+    static const unsigned BLOCK_TIME          = 25;     // milliseconds
+
+    /**
+     * @brief   Get the noise filter specification to use
+     * @param   sample_rate The sample rate used
+     * @return  Returns a filter specification (see Async::AudioFilter)
+     */
+    static const char *filterSpec(int sample_rate);
+
+    /**
+     * @brief   Initialize all but the noise filter
+     * @param   cfg An initialized config object
+     * @param   name The name of the config section to read config from
+     * @param	sample_rate The rate with which samples enter the detector
+     * @return 	Return \em true on success, or \em false on failure
+     */
+    bool initDetector(Async::Config &cfg, const std::string& name,
+                      int sample_rate);
+
+    /**
+     * @brief   Get the length of a power integration block
+     * @return  Returns the number of samples in a block
+     */
+    unsigned blockLen(void) const { return block_len; }
+
+    /**
+     * @brief   Add the power for a filtered block of samples
+     * @param   ss The sum of the squared samples in the block
+     */
+    void addBlockPower(double ss);
+
+    /**
+     * @brief   Tell the detector that a number of samples have been processed
+     * @param   count The number of samples processed
+     *
+     * This function will emit the signalLevelUpdated signal if the
+     * continuous update interval has passed.
+     */
+    void samplesProcessed(int count);
+
+    /**
+     * @brief   Reset the integration state but not the filter
+     */
+    void resetIntegration(void);
+
   private:
     typedef std::multiset<double> SsSet;
     typedef SsSet::const_iterator SsSetIter;
     typedef std::list<SsSetIter>  SsIndexList;
 
-    static const unsigned BLOCK_TIME          = 25;     // milliseconds
-
     unsigned                  sample_rate;
     unsigned                  block_len;
     Async::AudioFilter	      *filter;
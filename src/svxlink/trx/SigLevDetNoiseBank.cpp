@@ -0,0 +1,404 @@
+/**
+@file	 SigLevDetNoiseBank.cpp
+@brief   A noise signal level detector sharing DSP with other receivers
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+#include <map>
+#include <limits>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioFilterBank.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "SigLevDetNoiseBank.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief The filter bank and power integrator shared by all receivers
+ *
+ * There is one bank per sample rate. The filtered samples for all channels
+ * are stored interleaved, one frame per sample time, so that both the
+ * filter and the power integration can be done in tight loops over the
+ * channels. All active channels share the same block phase. A channel that
+ * join in the middle of a block will have its first block discarded.
+ */
+class SigLevDetNoiseBank::Bank
+{
+  public:
+    static Bank *instance(int sample_rate)
+    {
+      auto& banks = bankMap();
+      auto it = banks.find(sample_rate);
+      if (it == banks.end())
+      {
+        it = banks.insert(make_pair(sample_rate, new Bank(sample_rate))).first;
+      }
+      return it->second;
+    }
+
+    static void release(Bank *bank)
+    {
+      if (bank->users == 0)
+      {
+        bankMap().erase(bank->sample_rate);
+        delete bank;
+      }
+    }
+
+    size_t addChannel(SigLevDetNoiseBank *det)
+    {
+      size_t ch = 0;
+      while ((ch < chans.size()) && (chans[ch].det != 0))
+      {
+        ++ch;
+      }
+      if (ch == chans.size())
+      {
+        chans.push_back(Channel());
+        filter.setChannels(chans.size());
+        ss.resize(chans.size(), 0.0);
+      }
+        // A new channel start out as active so that all receivers that are
+        // set up at the same time will be aligned to the same block phase
+      chans[ch].det = det;
+      chans[ch].active = true;
+      chans[ch].discard = (phase != 0);
+      ++users;
+      return ch;
+    }
+
+    void removeChannel(size_t ch)
+    {
+      chans[ch] = Channel();
+      --users;
+    }
+
+    void resetChannel(size_t ch)
+    {
+      filter.reset(ch);
+      ss[ch] = 0.0;
+      chans[ch].discard = (phase != 0);
+    }
+
+    void writeSamples(size_t ch, const float *samples, int count)
+    {
+      Channel& chan = chans[ch];
+      if (!chan.active)
+      {
+        chan.active = true;
+        chan.pending.clear();
+        resetChannel(ch);
+      }
+      chan.pending.insert(chan.pending.end(), samples, samples + count);
+
+        // Take channels that have stopped delivering audio out of the
+        // interleaved processing so that they do not stall the others
+      if (chan.pending.size() > max_backlog)
+      {
+        for (auto& other : chans)
+        {
+          if (other.active &&
+              (other.pending.size() + max_backlog / 2 < chan.pending.size()))
+          {
+            other.active = false;
+            other.pending.clear();
+          }
+        }
+      }
+
+      size_t avail = numeric_limits<size_t>::max();
+      for (const auto& c : chans)
+      {
+        if (c.active)
+        {
+          avail = min(avail, c.pending.size());
+        }
+      }
+      if ((avail > 0) && (avail != numeric_limits<size_t>::max()))
+      {
+        process(avail);
+      }
+    }
+
+  private:
+    typedef std::map<int, Bank*> BankMap;
+
+    struct Channel
+    {
+      SigLevDetNoiseBank *  det     = 0;
+      std::vector<float>    pending;
+      bool                  active  = false;
+      bool                  discard = false;
+    };
+
+    int                   sample_rate;
+    size_t                block_len;
+    size_t                max_backlog;
+    AudioFilterBank       filter;
+    std::vector<Channel>  chans;
+    std::vector<float>    frames;
+    std::vector<double>   ss;
+    size_t                phase   = 0;
+    unsigned              users   = 0;
+
+    static BankMap& bankMap(void)
+    {
+      static BankMap bank_map;
+      return bank_map;
+    }
+
+    Bank(int sample_rate)
+      : sample_rate(sample_rate),
+        block_len(BLOCK_TIME * sample_rate / 1000),
+        max_backlog(MAX_BACKLOG * sample_rate / 1000),
+        filter(filterSpec(sample_rate), sample_rate, 0)
+    {
+    }
+
+    void process(size_t cnt)
+    {
+      const size_t nch = chans.size();
+      frames.resize(cnt * nch);
+      for (size_t ch=0; ch<nch; ++ch)
+      {
+        const Channel& chan = chans[ch];
+        for (size_t i=0; i<cnt; ++i)
+        {
+          frames[i * nch + ch] = chan.active ? chan.pending[i] : 0.0f;
+        }
+      }
+
+      filter.processFrames(frames.data(), frames.data(), cnt);
+
+      double *acc = ss.data();
+      size_t pos = 0;
+      while (pos < cnt)
+      {
+        size_t seg = min(cnt - pos, block_len - phase);
+        for (size_t i=pos; i<pos+seg; ++i)
+        {
+          const float *y = &frames[i * nch];
+          for (size_t ch=0; ch<nch; ++ch)
+          {
+            acc[ch] += static_cast<double>(y[ch]) * y[ch];
+          }
+        }
+        pos += seg;
+        phase += seg;
+        if (phase >= block_len)
+        {
+          for (size_t ch=0; ch<nch; ++ch)
+          {
+            Channel& chan = chans[ch];
+            if (chan.active)
+            {
+              if (chan.discard)
+              {
+                chan.discard = false;
+              }
+              else
+              {
+                chan.det->addBlockPower(acc[ch]);
+              }
+            }
+            acc[ch] = 0.0;
+          }
+          phase = 0;
+        }
+      }
+
+      for (auto& chan : chans)
+      {
+        if (chan.active)
+        {
+          chan.pending.erase(chan.pending.begin(),
+                             chan.pending.begin() + cnt);
+        }
+      }
+
+        // Signal level updates are emitted last since a handler may reset
+        // the detector
+      for (size_t ch=0; ch<nch; ++ch)
+      {
+        if (chans[ch].active && (chans[ch].det != 0))
+        {
+          chans[ch].det->samplesProcessed(cnt);
+        }
+      }
+    }
+}; /* SigLevDetNoiseBank::Bank */
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+SigLevDetNoiseBank::SigLevDetNoiseBank(void)
+  : bank(0), channel(0)
+{
+} /* SigLevDetNoiseBank::SigLevDetNoiseBank */
+
+
+SigLevDetNoiseBank::~SigLevDetNoiseBank(void)
+{
+  if (bank != 0)
+  {
+    bank->removeChannel(channel);
+    Bank::release(bank);
+    bank = 0;
+  }
+} /* SigLevDetNoiseBank::~SigLevDetNoiseBank */
+
+
+bool SigLevDetNoiseBank::initialize(Async::Config &cfg,
+                                    const std::string& name, int sample_rate)
+{
+  bank = Bank::instance(sample_rate);
+  channel = bank->addChannel(this);
+  return initDetector(cfg, name, sample_rate);
+} /* SigLevDetNoiseBank::initialize */
+
+
+void SigLevDetNoiseBank::reset(void)
+{
+  if (bank != 0)
+  {
+    bank->resetChannel(channel);
+  }
+  resetIntegration();
+} /* SigLevDetNoiseBank::reset */
+
+
+int SigLevDetNoiseBank::writeSamples(const float *samples, int count)
+{
+  if (bank != 0)
+  {
+    bank->writeSamples(channel, samples, count);
+  }
+  return count;
+} /* SigLevDetNoiseBank::writeSamples */
+
+
+void SigLevDetNoiseBank::flushSamples(void)
+{
+  sourceAllSamplesFlushed();
+} /* SigLevDetNoiseBank::flushSamples */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
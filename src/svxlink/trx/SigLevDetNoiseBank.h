@@ -0,0 +1,192 @@
+/**
+@file	 SigLevDetNoiseBank.h
+@brief   A noise signal level detector sharing DSP with other receivers
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef SIG_LEV_DET_NOISE_BANK_INCLUDED
+#define SIG_LEV_DET_NOISE_BANK_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "SigLevDetNoise.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A noise signal level detector sharing DSP with other receivers
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This signal level detector calculate exactly the same thing as the NOISE
+detector (SigLevDetNoise) so the SIGLEV_SLOPE and SIGLEV_OFFSET values
+calculated by the siglevdetcal utility can be used unchanged. The difference
+is that all receivers using the NOISE_BANK detector share one filter bank.
+Incoming audio is buffered per receiver and when all active receivers have
+delivered audio, the filtering and power integration is done for all
+receivers in one interleaved pass. This is a lot cheaper than running one
+filter per receiver when there are many receivers, like at a voter site.
+
+A receiver that stop delivering audio, e.g. because its audio device have been
+closed, will be taken out of the interleaved processing when the other
+receivers have buffered MAX_BACKLOG milliseconds of audio. It will be put back
+when it start delivering audio again.
+*/
+class SigLevDetNoiseBank : public SigLevDetNoise
+{
+  public:
+      /// The name of this class when used by the object factory
+    static constexpr const char* OBJNAME = "NOISE_BANK";
+
+      /// Max audio in milliseconds to buffer while waiting for a receiver
+    static const unsigned MAX_BACKLOG = 100;
+
+    /**
+     * @brief 	Default constuctor
+     */
+    explicit SigLevDetNoiseBank(void);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~SigLevDetNoiseBank(void);
+
+    /**
+     * @brief 	Initialize the signal detector
+     * @param   cfg An initialized config object
+     * @param   name The name of the config section to read config from
+     * @param	sample_rate The rate with which samples enter the detector
+     * @return 	Return \em true on success, or \em false on failure
+     */
+    virtual bool initialize(Async::Config &cfg, const std::string& name,
+                            int sample_rate);
+
+    /**
+     * @brief   Reset the signal level detector
+     */
+    virtual void reset(void);
+
+    /**
+     * @brief 	Write samples into this audio sink
+     * @param 	samples The buffer containing the samples
+     * @param 	count The number of samples in the buffer
+     * @return	Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief 	Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void);
+
+  protected:
+
+  private:
+    class Bank;
+
+    Bank *    bank;
+    size_t    channel;
+
+    SigLevDetNoiseBank(const SigLevDetNoiseBank&);
+    SigLevDetNoiseBank& operator=(const SigLevDetNoiseBank&);
+
+};  /* class SigLevDetNoiseBank */
+
+
+//} /* namespace */
+
+#endif /* SIG_LEV_DET_NOISE_BANK_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -8,7 +8,7 @@ This file contains the base class for implementing a squelch detector
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2004-2021  Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026  Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -287,6 +287,16 @@ class Squelch : public sigc::trackable, public Async::AudioSink
      */
     virtual bool isOpen(void) const { return m_open && (m_timeout_left != 0); }
 
+    /**
+     * @brief   Check if the squelch state is only updated by audio samples
+     * @return  Returns \em true if the state is derived from the audio
+     *
+     * A squelch detector that get its state from an external source, like a
+     * GPIO pin, only report state changes. It must therefore not be reset
+     * while the line may be active, since the state would then be lost.
+     */
+    virtual bool isAudioDriven(void) const { return false; }
+
     /**
      * @brief   Get the last squelch activity info
      * @return  Returns the last squelch activity info
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2021 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -31,6 +31,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <iostream>
+#include <iomanip>
 #include <iterator>
 #include <set>
 
@@ -78,20 +79,11 @@ using namespace std;
 class SquelchCombine::Node
 {
   public:
-    typedef std::set<std::string> SquelchStates;
     Node(const std::string& name) : m_name(name) {}
     virtual ~Node(void) {}
     const std::string name(void) const { return m_name; }
-    virtual void print(std::ostream& os) = 0;
-    virtual bool initialize(Async::Config& cfg) = 0;
-    virtual void reset(void) = 0;
-    virtual void restart(void) = 0;
-    virtual void processSamples(const float *samples, int count) = 0;
-    virtual bool isOpen(void) const = 0;
-    virtual std::string activityInfo(void) const = 0;
-    virtual SquelchStates& squelchStates(SquelchStates& states) = 0;
-    sigc::signal<void(bool)> squelchOpen;
-    sigc::signal<void(float)> toneDetected;
+    virtual void print(std::ostream& os) const = 0;
+    virtual bool evaluate(uint32_t states, uint32_t& used) const = 0;
 
   private:
     std::string m_name;
@@ -101,84 +93,19 @@ class SquelchCombine::Node
 class SquelchCombine::LeafNode : public SquelchCombine::Node
 {
   public:
-    LeafNode(const std::string n) : Node(n) {}
+    LeafNode(const std::string n, size_t idx)
+      : Node(n), m_mask((idx < MAX_LEAVES) ? (1U << idx) : 0) {}
 
-    virtual ~LeafNode(void)
-    {
-      delete m_squelch;
-      m_squelch = nullptr;
-    }
-
-    virtual void print(std::ostream& os) { os << name(); }
-
-    virtual bool initialize(Async::Config& cfg)
-    {
-      string sql_det_str;
-      if (!cfg.getValue(name(), "SQL_DET", sql_det_str))
-      {
-        cerr << "*** ERROR: Config variable " << name() << "/SQL_DET not set\n";
-        return false;
-      }
-      m_squelch = createSquelch(sql_det_str);
-      if ((m_squelch == nullptr) || !m_squelch->initialize(cfg, name()))
-      {
-        std::cerr << "*** ERROR: Squelch detector initialization failed for \""
-                  << name() << "\"\n";
-        return false;
-      }
-      m_squelch->squelchOpen.connect(squelchOpen.make_slot());
-      m_squelch->toneDetected.connect(toneDetected.make_slot());
-      return true;
-    }
-
-    virtual bool isOpen(void) const { return m_squelch->isOpen(); }
-
-    virtual std::string activityInfo(void) const
-    {
-      std::string act_info = name();
-      if (m_squelch->isOpen())
-      {
-        act_info += "*";
-      }
-      if (!m_squelch->activityInfo().empty())
-      {
-        if (!m_squelch->isOpen())
-        {
-          act_info += "=";
-        }
-        act_info += m_squelch->activityInfo();
-      }
-      return act_info;
-    }
-
-    virtual void reset(void) { m_squelch->reset(); }
-
-    virtual void restart(void) { m_squelch->restart(); }
+    virtual void print(std::ostream& os) const { os << name(); }
 
-    virtual void processSamples(const float *samples, int count)
+    virtual bool evaluate(uint32_t states, uint32_t& used) const
     {
-      int pos = 0;
-      do {
-        int ret = m_squelch->writeSamples(samples, count);
-        if (ret < 1)
-        {
-          std::cout << "*** WARNING: Failed to write samples to squelch "
-                       "detector \"" << name() << "\" in squelch combiner."
-                    << std::endl;
-          break;
-        }
-        pos += ret;
-      } while (pos < count);
-    }
-
-    virtual SquelchStates& squelchStates(SquelchStates& states)
-    {
-      states.emplace(activityInfo());
-      return states;
+      used |= m_mask;
+      return (states & m_mask) != 0;
     }
 
   private:
-    Squelch* m_squelch = nullptr;
+    uint32_t m_mask;
 }; /* SquelchCombine::LeafNode */
 
 
@@ -188,8 +115,6 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
     UnaryOpNode(const std::string& name, Node *node)
       : Node(name), m_node(node)
     {
-      m_node->squelchOpen.connect(squelchOpen.make_slot());
-      m_node->toneDetected.connect(toneDetected.make_slot());
     }
 
     virtual ~UnaryOpNode(void)
@@ -198,43 +123,13 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
       m_node = nullptr;
     }
 
-    virtual void print(std::ostream& os)
+    virtual void print(std::ostream& os) const
     {
       os << name() << "(";
       m_node->print(os);
       os << ")";
     }
 
-    virtual bool initialize(Async::Config& cfg)
-    {
-      return m_node->initialize(cfg);
-    }
-
-    virtual void reset(void)
-    {
-      m_node->reset();
-    }
-
-    virtual void restart(void)
-    {
-      m_node->restart();
-    }
-
-    virtual void processSamples(const float *samples, int count)
-    {
-      m_node->processSamples(samples, count);
-    }
-
-    virtual SquelchStates& squelchStates(SquelchStates& states)
-    {
-      return m_node->squelchStates(states);
-    }
-
-    virtual std::string activityInfo(void) const
-    {
-      return name() + "(" + m_node->activityInfo() + ")";
-    }
-
   protected:
     Node* m_node;
 }; /* SquelchCombine::UnaryOpNode */
@@ -243,7 +138,11 @@ class SquelchCombine::UnaryOpNode : public SquelchCombine::Node
 struct SquelchCombine::NegationOpNode : public SquelchCombine::UnaryOpNode
 {
   NegationOpNode(Node* node) : UnaryOpNode("NOT", node) {}
-  virtual bool isOpen(void) const { return !m_node->isOpen(); }
+
+  virtual bool evaluate(uint32_t states, uint32_t& used) const
+  {
+    return !m_node->evaluate(states, used);
+  }
 }; /* SquelchCombine::NegationOpNode */
 
 
@@ -253,12 +152,6 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
     BinaryOpNode(const std::string& n, Node* l, Node* r)
       : Node(n), m_left(l), m_right(r)
     {
-      m_left->squelchOpen.connect(
-          sigc::mem_fun(*this, &BinaryOpNode::onSquelchOpen));
-      m_left->toneDetected.connect(toneDetected.make_slot());
-      m_right->squelchOpen.connect(
-          sigc::mem_fun(*this, &BinaryOpNode::onSquelchOpen));
-      m_right->toneDetected.connect(toneDetected.make_slot());
     }
 
     virtual ~BinaryOpNode(void)
@@ -269,7 +162,7 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
       m_right = nullptr;
     }
 
-    virtual void print(std::ostream& os)
+    virtual void print(std::ostream& os) const
     {
       os << name() << "(";
       m_left->print(os);
@@ -278,60 +171,21 @@ class SquelchCombine::BinaryOpNode : public SquelchCombine::Node
       os << ")";
     }
 
-    virtual bool initialize(Async::Config& cfg)
-    {
-      return m_left->initialize(cfg) && m_right->initialize(cfg);
-    }
-
-    virtual void reset(void)
-    {
-      m_left->reset();
-      m_right->reset();
-    }
-
-    virtual void restart(void)
-    {
-      m_left->restart();
-      m_right->restart();
-    }
-
-    virtual void processSamples(const float *samples, int count)
-    {
-      m_left->processSamples(samples, count);
-      m_right->processSamples(samples, count);
-    }
-
-    void onSquelchOpen(bool is_open)
-    {
-      squelchOpen(isOpen());
-    }
-
-    virtual SquelchStates& squelchStates(SquelchStates& states)
-    {
-      m_left->squelchStates(states);
-      m_right->squelchStates(states);
-      return states;
-    }
-
-    virtual std::string activityInfo(void) const
-    {
-      return name() + "(" + m_left->activityInfo() + ", " +
-             m_right->activityInfo() + ")";
-    }
-
   protected:
     Node* m_left;
     Node* m_right;
 }; /* SquelchCombine::BinaryOpNode */
 
 
+  // The right operand is only evaluated if needed, which is what make it
+  // possible to suspend subsquelches that cannot affect the outcome.
 struct SquelchCombine::OrOpNode : public SquelchCombine::BinaryOpNode
 {
   OrOpNode(Node* l, Node* r) : BinaryOpNode("OR", l, r) {}
 
-  virtual bool isOpen(void) const
+  virtual bool evaluate(uint32_t states, uint32_t& used) const
   {
-    return m_left->isOpen() || m_right->isOpen();
+    return m_left->evaluate(states, used) || m_right->evaluate(states, used);
   }
 }; /* SquelchCombine::OrOpNode */
 
@@ -340,9 +194,9 @@ struct SquelchCombine::AndOpNode : public SquelchCombine::BinaryOpNode
 {
   AndOpNode(Node* l, Node* r) : BinaryOpNode("AND", l, r) {}
 
-  virtual bool isOpen(void) const
+  virtual bool evaluate(uint32_t states, uint32_t& used) const
   {
-    return m_left->isOpen() && m_right->isOpen();
+    return m_left->evaluate(states, used) && m_right->evaluate(states, used);
   }
 }; /* SquelchCombine::AndOpNode */
 
@@ -385,7 +239,15 @@ SquelchCombine::SquelchCombine(void)
 
 SquelchCombine::~SquelchCombine(void)
 {
+  if (m_suspend)
+  {
+    printStats();
+  }
   delete m_comb;
+  for (auto& leaf : m_leaves)
+  {
+    delete leaf.squelch;
+  }
 } /* SquelchCombine::~SquelchCombine */
 
 
@@ -400,6 +262,8 @@ bool SquelchCombine::initialize(Async::Config& cfg,
     return false;
   }
 
+  cfg.getValue(rx_name, "SQL_COMBINE_SUSPEND", m_suspend);
+
   if (!tokenize(expr_str))
   {
     return false;
@@ -427,24 +291,39 @@ bool SquelchCombine::initialize(Async::Config& cfg,
   m_comb->print(std::cout);
   std::cout << std::endl;
 
-  m_comb->squelchOpen.connect(
-      sigc::mem_fun(*this, &SquelchCombine::onSquelchOpen));
-  m_comb->toneDetected.connect(toneDetected.make_slot());
+  if (!compileExpression())
+  {
+    std::cout << "*** ERROR: Failed to create combined squelch for RX \""
+              << rx_name << "\"" << std::endl;
+    return false;
+  }
 
-  return m_comb->initialize(cfg) && Squelch::initialize(cfg, rx_name);
+    // The expression tree is not needed anymore after compilation
+  delete m_comb;
+  m_comb = nullptr;
+
+  return initLeaves(cfg) && Squelch::initialize(cfg, rx_name);
 } /* SquelchCombine::initialize */
 
 
 void SquelchCombine::reset(void)
 {
-  m_comb->reset();
+  for (auto& leaf : m_leaves)
+  {
+    leaf.squelch->reset();
+  }
+  m_states = 0;
+  m_active = m_eval_table.empty() ? 0 : activeLeaves(m_states);
   Squelch::reset();
 } /* SquelchCombine::reset */
 
 
 void SquelchCombine::restart(void)
 {
-  m_comb->restart();
+  for (auto& leaf : m_leaves)
+  {
+    leaf.squelch->restart();
+  }
   Squelch::restart();
 } /* SquelchCombine::restart */
 
@@ -457,7 +336,33 @@ void SquelchCombine::restart(void)
 
 int SquelchCombine::processSamples(const float *samples, int count)
 {
-  m_comb->processSamples(samples, count);
+  for (size_t idx=0; idx<m_leaves.size(); ++idx)
+  {
+    Leaf& leaf = m_leaves[idx];
+    if ((m_active & (1U << idx)) == 0)
+    {
+      leaf.skipped_blocks += 1;
+      leaf.skipped_samples += count;
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int pos = 0;
+    do {
+      int ret = leaf.squelch->writeSamples(samples + pos, count - pos);
+      if (ret < 1)
+      {
+        std::cout << "*** WARNING: Failed to write samples to squelch "
+                     "detector \"" << leaf.name << "\" in squelch combiner."
+                  << std::endl;
+        break;
+      }
+      pos += ret;
+    } while (pos < count);
+    leaf.dsp_time += std::chrono::steady_clock::now() - start;
+    leaf.blocks += 1;
+    leaf.samples += count;
+  }
   return count;
 } /* SquelchCombine::processSamples */
 
@@ -468,14 +373,62 @@ int SquelchCombine::processSamples(const float *samples, int count)
  *
  ****************************************************************************/
 
+void SquelchCombine::onLeafSquelchOpen(bool is_open, size_t idx)
+{
+  if (is_open)
+  {
+    m_states |= (1U << idx);
+  }
+  else
+  {
+    m_states &= ~(1U << idx);
+  }
+  updateState();
+} /* SquelchCombine::onLeafSquelchOpen */
+
+
+void SquelchCombine::updateState(void)
+{
+  uint32_t active = activeLeaves(m_states);
+  uint32_t suspended = m_active & ~active;
+  m_active = active;
+
+    // A suspended subsquelch is reset so that it does not keep a stale open
+    // state around. Since the expression did not consult the subsquelch,
+    // clearing its state bit cannot change the outcome. Only subsquelches
+    // driven by the audio are suspended so the state will be detected again
+    // when the subsquelch is resumed.
+  for (size_t idx=0; suspended != 0; ++idx, suspended >>= 1)
+  {
+    if (suspended & 1)
+    {
+      m_leaves[idx].squelch->reset();
+      m_states &= ~(1U << idx);
+    }
+  }
+
+  onSquelchOpen((m_eval_table[m_states] & OPEN_BIT) != 0);
+} /* SquelchCombine::updateState */
+
+
+uint32_t SquelchCombine::activeLeaves(uint32_t states) const
+{
+  return (m_eval_table[states] | ~m_audio_leaves) & m_all_leaves;
+} /* SquelchCombine::activeLeaves */
+
+
 void SquelchCombine::onSquelchOpen(bool is_open)
 {
   if (is_open != signalDetected())
   {
+    std::set<std::string> states;
+    for (const auto& leaf : m_leaves)
+    {
+      states.emplace(leafActivityInfo(leaf));
+    }
     std::string info;
     info.reserve(127);
-    SquelchCombine::Node::SquelchStates states;
-    for (const auto& state : m_comb->squelchStates(states))
+    for (const auto& state : states)
     {
       if (!info.empty())
       {
@@ -484,11 +437,126 @@ void SquelchCombine::onSquelchOpen(bool is_open)
       info += state;
     }
     setSignalDetected(is_open, info);
-    //setSignalDetected(is_open, m_comb->activityInfo());
   }
 } /* SquelchCombine::onSquelchOpen */
 
 
+std::string SquelchCombine::leafActivityInfo(const Leaf& leaf) const
+{
+  std::string act_info = leaf.name;
+  if (leaf.squelch->isOpen())
+  {
+    act_info += "*";
+  }
+  if (!leaf.squelch->activityInfo().empty())
+  {
+    if (!leaf.squelch->isOpen())
+    {
+      act_info += "=";
+    }
+    act_info += leaf.squelch->activityInfo();
+  }
+  return act_info;
+} /* SquelchCombine::leafActivityInfo */
+
+
+bool SquelchCombine::initLeaves(Async::Config& cfg)
+{
+  for (size_t idx=0; idx<m_leaves.size(); ++idx)
+  {
+    Leaf& leaf = m_leaves[idx];
+    string sql_det_str;
+    if (!cfg.getValue(leaf.name, "SQL_DET", sql_det_str))
+    {
+      cerr << "*** ERROR: Config variable " << leaf.name
+           << "/SQL_DET not set\n";
+      return false;
+    }
+    leaf.squelch = createSquelch(sql_det_str);
+    if ((leaf.squelch == nullptr) || !leaf.squelch->initialize(cfg, leaf.name))
+    {
+      std::cerr << "*** ERROR: Squelch detector initialization failed for \""
+                << leaf.name << "\"\n";
+      return false;
+    }
+    leaf.squelch->squelchOpen.connect(sigc::bind(
+          sigc::mem_fun(*this, &SquelchCombine::onLeafSquelchOpen), idx));
+    leaf.squelch->toneDetected.connect(toneDetected.make_slot());
+    if (leaf.squelch->isAudioDriven())
+    {
+      m_audio_leaves |= (1U << idx);
+    }
+  }
+  m_active = activeLeaves(m_states);
+  return true;
+} /* SquelchCombine::initLeaves */
+
+
+bool SquelchCombine::compileExpression(void)
+{
+  if (m_leaves.size() > MAX_LEAVES)
+  {
+    std::cerr << "*** ERROR: Too many squelch detectors in squelch combiner "
+                 "expression. Max is " << MAX_LEAVES << std::endl;
+    return false;
+  }
+
+  m_all_leaves = (1U << m_leaves.size()) - 1;
+  m_eval_table.resize(1U << m_leaves.size());
+  for (uint32_t states=0; states<m_eval_table.size(); ++states)
+  {
+    uint32_t used = 0;
+    bool is_open = m_comb->evaluate(states, used);
+    m_eval_table[states] = (is_open ? OPEN_BIT : 0) |
+                           (m_suspend ? used : m_all_leaves);
+  }
+  m_states = 0;
+  m_active = activeLeaves(m_states);
+
+  return true;
+} /* SquelchCombine::compileExpression */
+
+
+void SquelchCombine::printStats(void) const
+{
+  for (const auto& leaf : m_leaves)
+  {
+    if ((leaf.blocks == 0) && (leaf.skipped_blocks == 0))
+    {
+      continue;
+    }
+    double dsp_ms =
+      std::chrono::duration<double, std::milli>(leaf.dsp_time).count();
+    double saved_ms = 0.0;
+    if (leaf.samples > 0)
+    {
+      saved_ms = dsp_ms * leaf.skipped_samples / leaf.samples;
+    }
+    std::cout << rxName() << ": Combined squelch \"" << leaf.name << "\": "
+              << leaf.blocks << " blocks processed, "
+              << leaf.skipped_blocks << " blocks suspended, "
+              << std::fixed << std::setprecision(1)
+              << dsp_ms << "ms DSP time, approx. "
+              << saved_ms << "ms DSP time saved" << std::endl;
+  }
+} /* SquelchCombine::printStats */
+
+
+size_t SquelchCombine::leafIndex(const std::string& name)
+{
+  for (size_t idx=0; idx<m_leaves.size(); ++idx)
+  {
+    if (m_leaves[idx].name == name)
+    {
+      return idx;
+    }
+  }
+  m_leaves.emplace_back();
+  m_leaves.back().name = name;
+  return m_leaves.size() - 1;
+} /* SquelchCombine::leafIndex */
+
+
 bool SquelchCombine::tokenize(const std::string& expr)
 {
   string token;
@@ -564,7 +632,7 @@ SquelchCombine::Node* SquelchCombine::parseInstExpression(void)
   }
   m_tokens.pop_front();
 
-  return new LeafNode(inst);
+  return new LeafNode(inst, leafIndex(inst));
 } /* SquelchCombine::parseInstExpression */
 
 
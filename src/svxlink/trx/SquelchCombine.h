@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2021 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -36,6 +36,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <string>
 #include <deque>
+#include <vector>
+#include <chrono>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -135,6 +138,19 @@ SIGLEV_CLOSE_THRESH=2
 SQL_DET=COMBINE
 SQL_COMBINE=Rx1:CTCSS | Rx1:SIGLEV
 ...
+
+When the squelch is initialized, the expression is compiled into a flat
+evaluation table indexed by a bitmask holding the current state of all
+subsquelches. Each table entry hold the resulting squelch state and the set of
+subsquelches that would be consulted when evaluating the expression with
+short-circuit semantics. If SQL_COMBINE_SUSPEND is set, subsquelches that
+cannot affect the outcome will not be fed any audio until they are needed
+again, e.g. a CTCSS detector in the expression "Rx1:SIGLEV & Rx1:CTCSS" will
+be suspended while the signal level squelch is closed. A suspended subsquelch
+is reset so that it will start detection from the beginning when resumed. Only
+subsquelches that derive their state from the audio are suspended. Squelch
+detectors that report state changes from an external source, like GPIO, are
+always active since a state change that happen while suspended would be lost.
 */
 class SquelchCombine : public Squelch
 {
@@ -199,6 +215,7 @@ class SquelchCombine : public Squelch
 
   private:
     typedef std::deque<std::string> Tokens;
+    typedef std::vector<uint32_t>   EvalTable;
     class Node;
     class LeafNode;
     class UnaryOpNode;
@@ -207,10 +224,40 @@ class SquelchCombine : public Squelch
     struct OrOpNode;
     struct AndOpNode;
 
-    Tokens  m_tokens;
-    Node*   m_comb    = nullptr;
-
+    struct Leaf
+    {
+      std::string                           name;
+      Squelch*                              squelch         = nullptr;
+      unsigned long                         blocks          = 0;
+      unsigned long                         skipped_blocks  = 0;
+      unsigned long long                    samples         = 0;
+      unsigned long long                    skipped_samples = 0;
+      std::chrono::steady_clock::duration   dsp_time        {0};
+    };
+    typedef std::vector<Leaf> Leaves;
+
+    static const size_t   MAX_LEAVES  = 16;
+    static const uint32_t OPEN_BIT    = 0x80000000;
+
+    Tokens    m_tokens;
+    Node*     m_comb          = nullptr;
+    Leaves    m_leaves;
+    EvalTable m_eval_table;
+    uint32_t  m_all_leaves    = 0;
+    uint32_t  m_audio_leaves  = 0;
+    uint32_t  m_states        = 0;
+    uint32_t  m_active        = 0;
+    bool      m_suspend       = false;
+
+    void onLeafSquelchOpen(bool is_open, size_t idx);
+    void updateState(void);
+    uint32_t activeLeaves(uint32_t states) const;
     void onSquelchOpen(bool is_open);
+    std::string leafActivityInfo(const Leaf& leaf) const;
+    bool initLeaves(Async::Config& cfg);
+    bool compileExpression(void);
+    void printStats(void) const;
+    size_t leafIndex(const std::string& name);
     bool tokenize(const std::string& expr);
     Node* parseInstExpression(void);
     Node* parseUnaryOpExpression(void);
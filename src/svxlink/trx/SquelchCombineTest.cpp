@@ -0,0 +1,152 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncTimer.h>
+
+#include "Squelch.h"
+
+using namespace std;
+using namespace Async;
+
+
+/*
+ * Test of suspension in the combined squelch.
+ *
+ * The combined squelch "Rx1:VOX & Rx1:PTY" is set up with SQL_COMBINE_SUSPEND
+ * enabled. The PTY squelch is not consulted while the VOX squelch is closed
+ * but since it only report state changes, it must keep its state anyway. The
+ * PTY squelch is opened while the VOX is closed and the VOX is then opened
+ * and closed a couple of times without any new state change on the PTY.
+ */
+
+namespace {
+const int BLOCK_SIZE = 320;
+
+int failures = 0;
+
+void check(bool ok, const std::string& what)
+{
+  printf("%-4s %s\n", ok ? "ok" : "FAIL", what.c_str());
+  if (!ok)
+  {
+    ++failures;
+  }
+}
+
+void writeBlock(Squelch *sql, float amp)
+{
+  std::vector<float> block(BLOCK_SIZE);
+  for (int i=0; i<BLOCK_SIZE; ++i)
+  {
+    block[i] = amp * sinf(2.0f * M_PI * 1000.0f * i / INTERNAL_SAMPLE_RATE);
+  }
+  sql->writeSamples(block.data(), block.size());
+}
+
+void writePty(int fd, const char *cmd)
+{
+  if (write(fd, cmd, 1) != 1)
+  {
+    perror("write");
+    exit(1);
+  }
+}
+};
+
+
+int main(int argc, const char **argv)
+{
+  CppApplication app;
+
+  char dir_template[] = "/tmp/SquelchCombineTestXXXXXX";
+  const char *dir = mkdtemp(dir_template);
+  if (dir == nullptr)
+  {
+    perror("mkdtemp");
+    exit(1);
+  }
+  const std::string pty_path = std::string(dir) + "/sql";
+
+  Config cfg;
+  cfg.setValue("Rx1", "SQL_DET", "COMBINE");
+  cfg.setValue("Rx1", "SQL_COMBINE", "Rx1:VOX & Rx1:PTY");
+  cfg.setValue("Rx1", "SQL_COMBINE_SUSPEND", "1");
+  cfg.setValue("Rx1:VOX", "SQL_DET", "VOX");
+  cfg.setValue("Rx1:VOX", "VOX_FILTER_DEPTH", "20");
+  cfg.setValue("Rx1:VOX", "VOX_THRESH", "1000");
+  cfg.setValue("Rx1:PTY", "SQL_DET", "PTY");
+  cfg.setValue("Rx1:PTY", "PTY_PATH", pty_path);
+
+  Squelch *sql = createSquelch("COMBINE");
+  if ((sql == nullptr) || !sql->initialize(cfg, "Rx1"))
+  {
+    cerr << "*** ERROR: Could not initialize the combined squelch" << endl;
+    exit(1);
+  }
+
+  int pty_fd = open(pty_path.c_str(), O_WRONLY | O_NOCTTY);
+  if (pty_fd < 0)
+  {
+    perror("open");
+    exit(1);
+  }
+
+    // Each step is run when the PTY command from the previous step have
+    // been received by the squelch
+  std::vector<std::function<void()>> steps;
+  steps.push_back([&]()
+  {
+    writeBlock(sql, 0.0f);
+    check(!sql->isOpen(), "Closed with no signal");
+    writePty(pty_fd, "O");
+  });
+  steps.push_back([&]()
+  {
+    writeBlock(sql, 0.0f);
+    check(!sql->isOpen(), "Closed with only the PTY open");
+    writeBlock(sql, 0.5f);
+    check(sql->isOpen(),
+          "Open when VOX open after PTY was opened while not consulted");
+    writeBlock(sql, 0.0f);
+    check(!sql->isOpen(), "Closed when VOX close");
+    writeBlock(sql, 0.5f);
+    check(sql->isOpen(), "Open again when VOX open without a new PTY edge");
+    writePty(pty_fd, "Z");
+  });
+  steps.push_back([&]()
+  {
+    writeBlock(sql, 0.5f);
+    check(!sql->isOpen(), "Closed when PTY close");
+  });
+
+  size_t step = 0;
+  Timer step_timer(100, Timer::TYPE_PERIODIC);
+  step_timer.expired.connect([&](Timer*)
+  {
+    if (step < steps.size())
+    {
+      steps[step++]();
+    }
+    else
+    {
+      app.quit();
+    }
+  });
+  app.exec();
+
+  close(pty_fd);
+  delete sql;
+  rmdir(dir);
+
+  printf("%s: %d failure(s)\n", (failures == 0) ? "PASS" : "FAIL", failures);
+  return (failures == 0) ? 0 : 1;
+} /* main */
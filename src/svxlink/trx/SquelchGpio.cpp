@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2013 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -47,6 +47,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
+#include <AsyncFdWatch.h>
 
 
 /****************************************************************************
@@ -118,7 +119,8 @@ using namespace Async;
  ****************************************************************************/
 
 SquelchGpio::SquelchGpio(void)
-  : fd(-1), timer(0), active_low(false), gpio_path("/sys/class/gpio")
+  : fd(-1), timer(0), watch(0), active_low(false),
+    gpio_path("/sys/class/gpio")
 {
   
 } /* SquelchGpio::SquelchGpio */
@@ -128,6 +130,8 @@ SquelchGpio::~SquelchGpio(void)
 {
   delete timer;
   timer = 0;
+  delete watch;
+  watch = 0;
   if (fd >= 0)
   {
     close(fd);
@@ -159,23 +163,38 @@ bool SquelchGpio::initialize(Async::Config& cfg, const std::string& rx_name)
     sql_pin.erase(0, 1);
   }
 
-  stringstream ss;
-  ss << gpio_path << "/" << sql_pin << "/value";
-  fd = open(ss.str().c_str(), O_RDONLY);
+  const string pin_path = gpio_path + "/" + sql_pin;
+  const string value_path = pin_path + "/value";
+  fd = open(value_path.c_str(), O_RDONLY);
   if (fd < 0)
   {
-    cerr << "*** ERROR: Could not open GPIO device " << ss.str()
+    cerr << "*** ERROR: Could not open GPIO device " << value_path
          << " specified in " << rx_name << "/GPIO_SQL_PIN: "
          << strerror(errno) << endl;
     return false;
   }
 
-  timer = new Timer(100, Timer::TYPE_PERIODIC);
-  timer->expired.connect(
-      hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+  if (enableEdgeDetection(pin_path))
+  {
+    watch = new FdWatch(fd, FdWatch::FD_WATCH_PRI);
+    watch->activity.connect(
+        hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+  }
+  else
+  {
+    cerr << "*** WARNING: Could not enable edge detection for GPIO pin "
+         << pin_path << " specified in " << rx_name
+         << "/GPIO_SQL_PIN. Polling the pin state instead.\n";
+    timer = new Timer(100, Timer::TYPE_PERIODIC);
+    timer->expired.connect(
+        hide(mem_fun(*this, &SquelchGpio::readGpioValueData)));
+  }
+
+    // Read the initial state. This also clear any pending edge notification.
+  readGpioValueData();
 
   return true;
-}
+} /* SquelchGpio::initialize */
 
 
 
@@ -194,7 +213,47 @@ bool SquelchGpio::initialize(Async::Config& cfg, const std::string& rx_name)
  ****************************************************************************/
 
 /**
- * @brief  Called by a timer to periodically read the state of the GPIO pin
+ * @brief  Set the edge file of the GPIO pin so that both edges are reported
+ * @param  pin_path The sysfs path to the GPIO pin
+ * @return Returns \em true on success or else \em false
+ *
+ * The edge file may already have been set up by the script that exported
+ * the pin. Since the pin is usually owned by root, writing to the edge file
+ * may fail even though it's correctly set up so it's read back first.
+ */
+bool SquelchGpio::enableEdgeDetection(const string& pin_path)
+{
+  const string edge_path = pin_path + "/edge";
+  char edge[16];
+  int edge_fd = open(edge_path.c_str(), O_RDONLY);
+  if (edge_fd < 0)
+  {
+    return false;
+  }
+  ssize_t cnt = read(edge_fd, edge, sizeof(edge) - 1);
+  close(edge_fd);
+  if ((cnt >= 4) && (strncmp(edge, "both", 4) == 0))
+  {
+    return true;
+  }
+
+  edge_fd = open(edge_path.c_str(), O_WRONLY);
+  if (edge_fd < 0)
+  {
+    return false;
+  }
+  cnt = write(edge_fd, "both", 4);
+  close(edge_fd);
+  return (cnt == 4);
+} /* SquelchGpio::enableEdgeDetection */
+
+
+/**
+ * @brief  Called when the state of the GPIO pin may have changed
+ *
+ * This function is called when the kernel signal that the value of the pin
+ * has changed or, if edge detection could not be enabled, periodically by a
+ * timer.
  *
  * An example of reading a GPIO ports can be found at:
  * http://elinux.org/RPi_Low-level_peripherals#C_.2B_sysfs
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2013 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -63,6 +63,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace Async
 {
   class Timer;
+  class FdWatch;
 };
 
 
@@ -114,6 +115,11 @@ namespace Async
 This squelch detector read the squelch indicator signal from a GPIO input pin.
 A high level (3.3V) will be interpreted as squelch open and a low level (GND)
 will be interpreted as squelch close.
+
+The edge file of the pin is set to "both" so that the kernel signal an
+exceptional condition on the value file each time the pin change state. The
+state is then read as soon as it change. If edge detection cannot be
+enabled for the pin, the state is polled every 100 milliseconds instead.
 */
 class SquelchGpio : public Squelch
 {
@@ -142,13 +148,15 @@ class SquelchGpio : public Squelch
   protected:
 
   private:
-    int           fd;
-    Async::Timer  *timer;
-    bool          active_low;
-    std::string   gpio_path;
+    int             fd;
+    Async::Timer    *timer;
+    Async::FdWatch  *watch;
+    bool            active_low;
+    std::string     gpio_path;
 
     SquelchGpio(const SquelchGpio&);
     SquelchGpio& operator=(const SquelchGpio&);
+    bool enableEdgeDetection(const std::string& pin_path);
     void readGpioValueData(void);
 
 };  /* class SquelchGpio */
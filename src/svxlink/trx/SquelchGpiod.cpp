@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2003-2025 Tobias Blomberg / SM0SVX
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -32,6 +32,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <cstring>
 #include <cerrno>
+#include <ctime>
 #include <sstream>
 
 
@@ -99,6 +100,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+namespace {
+#if GPIOD_VERSION_MAJOR >= 2
+  const size_t EVENT_BUFFER_SIZE = 16;
+#endif
+};
+
 
 
 /****************************************************************************
@@ -108,17 +115,20 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 SquelchGpiod::SquelchGpiod(void)
-  : m_timer(100, Async::Timer::TYPE_PERIODIC)
 {
 } /* SquelchGpiod::SquelchGpiod */
 
 
 SquelchGpiod::~SquelchGpiod(void)
 {
-  m_timer.setEnable(false);
-  //m_watch.setEnabled(false);
+  m_watch.setEnabled(false);
 
 #if GPIOD_VERSION_MAJOR >= 2
+  if (m_event_buffer != nullptr)
+  {
+    gpiod_edge_event_buffer_free(m_event_buffer);
+    m_event_buffer = nullptr;
+  }
   if (m_request != nullptr)
   {
     gpiod_line_request_release(m_request);
@@ -230,6 +240,8 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
   }
 
   gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+  gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_BOTH);
+  gpiod_line_settings_set_event_clock(settings, GPIOD_LINE_CLOCK_MONOTONIC);
 
   if (active_low)
   {
@@ -313,24 +325,39 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
   gpiod_line_config_free(config);
   gpiod_line_settings_free(settings);
 
-    // Set up timer for polling
-  m_timer.expired.connect([=](Async::Timer*) {
-        enum gpiod_line_value val =
-          gpiod_line_request_get_value(m_request, m_line_offset);
-        if (val == GPIOD_LINE_VALUE_ERROR)
-        {
-          std::cerr << "*** WARNING: Read GPIOD line \"" << line
-                    << "\" failed for RX \"" << rx_name << "\": "
-                    << std::strerror(errno) << std::endl;
-          return;
-        }
-        setSignalDetected(val == GPIOD_LINE_VALUE_ACTIVE);
-      });
+  m_event_buffer = gpiod_edge_event_buffer_new(EVENT_BUFFER_SIZE);
+  if (m_event_buffer == nullptr)
+  {
+    std::cerr << "*** ERROR: Failed to create edge event buffer for RX \""
+              << rx_name << "\"" << std::endl;
+    return false;
+  }
+
+    // Read the initial state. Edge events that occurred before the value
+    // was read are already reflected in it so they are ignored.
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  m_read_ts = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+  enum gpiod_line_value val =
+    gpiod_line_request_get_value(m_request, m_line_offset);
+  if (val == GPIOD_LINE_VALUE_ERROR)
+  {
+    std::cerr << "*** ERROR: Read GPIOD line \"" << line
+              << "\" failed for RX \"" << rx_name << "\": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  setSignalDetected(val == GPIOD_LINE_VALUE_ACTIVE);
+
+  m_watch.activity.connect(
+      sigc::mem_fun(*this, &SquelchGpiod::readEdgeEvents));
+  m_watch.setFd(gpiod_line_request_get_fd(m_request),
+                Async::FdWatch::FD_WATCH_RD);
 #else
     // libgpiod v1
   struct gpiod_line_request_config req_cfg;
   req_cfg.consumer = "SvxLink";
-  req_cfg.request_type = GPIOD_LINE_REQUEST_DIRECTION_INPUT;
+  req_cfg.request_type = GPIOD_LINE_REQUEST_EVENT_BOTH_EDGES;
   req_cfg.flags = 0;
 
   if (active_low)
@@ -380,17 +407,19 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
     return false;
   }
 
-  m_timer.expired.connect([=](Async::Timer*) {
-        int val = gpiod_line_get_value(m_line);
-        if (val < 0)
-        {
-          std::cerr << "*** WARNING: Read GPIOD line \"" << line
-                    << "\" failed for RX \"" << rx_name << "\": "
-                    << std::strerror(errno) << std::endl;
-          return;
-        }
-        setSignalDetected(val > 0);
-      });
+  int val = gpiod_line_get_value(m_line);
+  if (val < 0)
+  {
+    std::cerr << "*** ERROR: Read GPIOD line \"" << line
+              << "\" failed for RX \"" << rx_name << "\": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  setSignalDetected(val > 0);
+
+  m_watch.activity.connect(
+      sigc::mem_fun(*this, &SquelchGpiod::readEdgeEvents));
+  m_watch.setFd(gpiod_line_event_get_fd(m_line), Async::FdWatch::FD_WATCH_RD);
 #endif
 
   return true;
@@ -403,30 +432,53 @@ bool SquelchGpiod::initialize(Async::Config& cfg, const std::string& rx_name)
  *
  ****************************************************************************/
 
-#if 0
-void SquelchGpiod::readGpioValueData(void)
+void SquelchGpiod::readEdgeEvents(Async::FdWatch* w)
 {
-  struct gpiod_line_event event;
-  int ret = gpiod_line_event_read_fd(m_watch.fd(), &event);
-  if (ret < 0)
+#if GPIOD_VERSION_MAJOR >= 2
+  int cnt = gpiod_line_request_read_edge_events(m_request, m_event_buffer,
+                                                EVENT_BUFFER_SIZE);
+  if (cnt < 0)
   {
-    std::cerr << "*** WARNING: SquelchGpiod::readGpioValueData: "
-                 "gpiod_line_event_read failed: "
-              << std::strerror(errno) << std::endl;
+    std::cerr << "*** WARNING: Read GPIOD edge events failed for RX \""
+              << rxName() << "\": " << std::strerror(errno) << std::endl;
     return;
   }
 
-  int event_type = event.event_type;
-  if (event_type == GPIOD_LINE_EVENT_RISING_EDGE)
+    // All events are applied in order so that a short squelch opening is
+    // not lost even if both edges are read at the same time. The edge
+    // type take the active low setting into account.
+  for (int i=0; i<cnt; ++i)
   {
-    setSignalDetected(true);
+    struct gpiod_edge_event* event =
+      gpiod_edge_event_buffer_get_event(m_event_buffer, i);
+    if (gpiod_edge_event_get_timestamp_ns(event) < m_read_ts)
+    {
+      continue;
+    }
+    setSignalDetected(gpiod_edge_event_get_event_type(event) ==
+                      GPIOD_EDGE_EVENT_RISING_EDGE);
+  }
+#else
+  struct gpiod_line_event event;
+  if (gpiod_line_event_read_fd(w->fd(), &event) < 0)
+  {
+    std::cerr << "*** WARNING: Read GPIOD edge event failed for RX \""
+              << rxName() << "\": " << std::strerror(errno) << std::endl;
+    return;
   }
-  else if (event_type == GPIOD_LINE_EVENT_FALLING_EDGE)
+
+    // The line value is read instead of using the event type since older
+    // kernels report edges of the physical level for active low lines
+  int val = gpiod_line_get_value(m_line);
+  if (val < 0)
   {
-    setSignalDetected(false);
+    std::cerr << "*** WARNING: Read GPIOD line failed for RX \""
+              << rxName() << "\": " << std::strerror(errno) << std::endl;
+    return;
   }
-} /* SquelchGpiod::readGpioValueData */
+  setSignalDetected(val > 0);
 #endif
+} /* SquelchGpiod::readEdgeEvents */
 
 
 /*
@@ -0,0 +1,200 @@
+/**
+@file	 SquelchReplay.h
+@brief   A squelch detector that replay squelch events from a file
+@author  Tobias Blomberg / SM0SVX
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2026 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef SQUELCH_REPLAY_INCLUDED
+#define SQUELCH_REPLAY_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReplayEventFile.h"
+#include "Squelch.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A squelch detector that replay squelch events from a file
+@author Tobias Blomberg / SM0SVX
+@date   2026-10-18
+
+This squelch detector read squelch state changes from a replay event file
+(see ReplayEventFile), given by the REPLAY_EVENT_FILE configuration variable.
+Lines on the form "<time_ms> SQL 1" open the squelch and "<time_ms> SQL 0"
+close it. It is used together with the file audio device to replay a
+recorded session.
+*/
+class SquelchReplay : public Squelch
+{
+  public:
+      /// The name of this class when used by the object factory
+    static constexpr const char* OBJNAME = "REPLAY";
+
+    /**
+     * @brief 	Default constuctor
+     */
+    SquelchReplay(void) {}
+
+    /**
+     * @brief 	Destructor
+     */
+    ~SquelchReplay(void) {}
+
+    /**
+     * @brief 	Initialize the squelch detector
+     * @param 	cfg A previsously initialized config object
+     * @param 	rx_name The name of the RX (config section name)
+     * @return	Returns \em true on success or else \em false
+     */
+    bool initialize(Async::Config& cfg, const std::string& rx_name)
+    {
+      if (!Squelch::initialize(cfg, rx_name))
+      {
+      	return false;
+      }
+
+      std::string event_file;
+      if (!cfg.getValue(rx_name, "REPLAY_EVENT_FILE", event_file))
+      {
+        std::cerr << "*** ERROR: Config variable " << rx_name
+                  << "/REPLAY_EVENT_FILE not set\n";
+        return false;
+      }
+      if (!events.open(event_file))
+      {
+        return false;
+      }
+      events.eventReceived.connect(
+          sigc::mem_fun(*this, &SquelchReplay::eventReceived));
+      events.start();
+
+      return true;
+    }
+
+  protected:
+    /**
+     * @brief 	Process the incoming samples in the squelch detector
+     * @param 	samples A buffer containing samples
+     * @param 	count The number of samples in the buffer
+     * @return	Return the number of processed samples
+     */
+    int processSamples(const float *samples, int count)
+    {
+      return count;
+    }
+
+  private:
+    ReplayEventFile events;
+
+    SquelchReplay(const SquelchReplay&);
+    SquelchReplay& operator=(const SquelchReplay&);
+
+    void eventReceived(const std::string& name, const std::string& args)
+    {
+      if (name == "SQL")
+      {
+        setSignalDetected(args != "0");
+      }
+    } /* eventReceived */
+
+};  /* class SquelchReplay */
+
+
+//} /* namespace */
+
+#endif /* SQUELCH_REPLAY_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -6,7 +6,7 @@
 
 \verbatim
 SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
-Copyright (C) 2004-2010  Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2026  Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -238,6 +238,12 @@ class SquelchSerial : public Squelch
       return true;
     }
 
+    /**
+     * @brief   Check if the squelch state is only updated by audio samples
+     * @return  Returns \em true since the state is derived from the audio
+     */
+    bool isAudioDriven(void) const { return true; }
+
   protected:
     /**
      * @brief 	Process the incoming samples in the squelch detector